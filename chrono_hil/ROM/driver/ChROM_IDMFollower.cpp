@@ -84,5 +84,32 @@ void ChROM_IDMFollower::Synchronize(double time, double step,
   m_path_follower->Advance(step);
 }
 
+void ChROM_IDMFollower::GetState(ChROM_IDMState &state) {
+  state.params = m_params;
+  state.dist = dist;
+  state.previous_pos = previousPos;
+  state.thero_speed = thero_speed;
+
+  state.random_state.clear();
+  if (m_enable_sto) {
+    std::ostringstream stream;
+    stream << m_gen << " " << m_d1 << " " << m_d2 << " " << m_d3 << " "
+           << m_d4;
+    state.random_state = stream.str();
+  }
+}
+
+void ChROM_IDMFollower::SetState(const ChROM_IDMState &state) {
+  m_params = state.params;
+  dist = state.dist;
+  previousPos = state.previous_pos;
+  thero_speed = state.thero_speed;
+
+  if (m_enable_sto && !state.random_state.empty()) {
+    std::istringstream stream(state.random_state);
+    stream >> m_gen >> m_d1 >> m_d2 >> m_d3 >> m_d4;
+  }
+}
+
 } // end namespace hil
 } // end namespace chrono
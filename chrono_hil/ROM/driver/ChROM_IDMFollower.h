@@ -23,6 +23,7 @@
 #include <cmath>
 #include <random>
 #include <string>
+#include <vector>
 #define MS_TO_MPH 2.23694
 #define MPH_TO_MS 0.44704
 #define AUDI_LENGTH 4.86
@@ -32,6 +33,15 @@
 namespace chrono {
 namespace hil {
 
+/// State of the IDM follower, see ChROM_IDMFollower::GetState
+struct ChROM_IDMState {
+  std::vector<double> params; ///< current behavior parameters
+  double dist = 0.0;          ///< travelled distance
+  ChVector<> previous_pos;
+  double thero_speed = 0.0;
+  std::string random_state; ///< generator and distributions, if stochastic
+};
+
 class CH_HIL_API ChROM_IDMFollower {
 public:
   ChROM_IDMFollower(
@@ -63,6 +73,9 @@ public:
     m_d4 = d4;
   }
 
+  /// Seed the generator of the stochastic parameters, for repeatable runs
+  void SetSeed(unsigned int seed) { m_gen.seed(seed); }
+
   void SetBehaviorParams(std::vector<double> new_params) {
     m_params = new_params;
   }
@@ -70,6 +83,14 @@ public:
   void Synchronize(double time, double step, double lead_distance,
                    double lead_speed);
 
+  /// Copy the state of the follower, the state of its path follower is
+  /// handled separately
+  void GetState(ChROM_IDMState &state);
+
+  /// Restore a state obtained with GetState. Stochasticity must be set up
+  /// the same way (SetSto) on both followers.
+  void SetState(const ChROM_IDMState &state);
+
 private:
   std::shared_ptr<ChROM_PathFollowerDriver> m_path_follower;
   std::shared_ptr<Ch_8DOF_vehicle> m_rom;
@@ -93,7 +114,7 @@ private:
   ChVector<> previousPos;
 
   // traveldistance
-  double dist;
+  double dist = 0.0;
   // theoretical speed
   double thero_speed = 0;
 };
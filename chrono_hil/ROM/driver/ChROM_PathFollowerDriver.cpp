@@ -35,27 +35,33 @@ ChROM_PathFollowerDriver::ChROM_PathFollowerDriver(
   m_sp_ki = PID_sp_ki;
   m_sp_kd = PID_sp_kd;
 
+  m_st_err = 0.0;
+  m_st_err_d = 0.0;
+  m_st_err_i = 0.0;
+  m_sp_err = 0.0;
+  m_sp_err_d = 0.0;
+  m_sp_err_i = 0.0;
+
   m_curve = curve;
   m_rom = rom;
-
-  m_tracker = chrono_types::make_shared<ChBezierCurveTracker>(m_curve);
 }
 
 DriverInputs ChROM_PathFollowerDriver::GetDriverInput() { return m_inputs; }
 
+ChVector<> ChROM_PathFollowerDriver::GetSentinel() {
+  return m_rom->GetChassisBody()
+      ->GetFrame_REF_to_abs()
+      .TransformPointLocalToParent(m_dist * ChWorldFrame::Forward());
+}
+
 void ChROM_PathFollowerDriver::Advance(double time_step) {
   ChVector<> cur_pos = m_rom->GetPos(); // current vehicle position
   ChVector<> cur_vel = m_rom->GetVel(); // current vehicle velocity
 
   // control steering of the vehicle
-  ChVector<> sentinel =
-      m_rom->GetChassisBody()
-          ->GetFrame_REF_to_abs()
-          .TransformPointLocalToParent(m_dist * ChWorldFrame::Forward());
-
-  ChVector<> target;
+  ChVector<> sentinel = GetSentinel();
 
-  m_tracker->calcClosestPoint(sentinel, target);
+  ChVector<> target = Track(sentinel);
 
   ChVector<> sentinel_vec = sentinel - cur_pos;
   ChWorldFrame::Project(sentinel_vec);
@@ -113,5 +119,58 @@ void ChROM_PathFollowerDriver::SetCruiseSpeed(double target_speed) {
   m_target_speed = target_speed;
 }
 
+void ChROM_PathFollowerDriver::GetState(ChROM_PathFollowerState &state) {
+  state.target_speed = m_target_speed;
+  state.st_err = m_st_err;
+  state.st_err_d = m_st_err_d;
+  state.st_err_i = m_st_err_i;
+  state.sp_err = m_sp_err;
+  state.sp_err_d = m_sp_err_d;
+  state.sp_err_i = m_sp_err_i;
+  state.inputs = m_inputs;
+  state.interval = m_interval;
+  state.param = m_param;
+}
+
+void ChROM_PathFollowerDriver::SetState(const ChROM_PathFollowerState &state) {
+  m_target_speed = state.target_speed;
+  m_st_err = state.st_err;
+  m_st_err_d = state.st_err_d;
+  m_st_err_i = state.st_err_i;
+  m_sp_err = state.sp_err;
+  m_sp_err_d = state.sp_err_d;
+  m_sp_err_i = state.sp_err_i;
+  m_inputs = state.inputs;
+  m_interval = static_cast<size_t>(state.interval);
+  m_param = state.param;
+}
+
+ChVector<> ChROM_PathFollowerDriver::Track(const ChVector<> &loc) {
+  size_t last = m_curve->getNumPoints() - 2;
+  bool closed = m_curve->IsClosed();
+  bool back = false, forward = false;
+  while (true) {
+    ChVector<> point = m_curve->calcClosestPoint(loc, m_interval, m_param);
+    // at the start of the interval, look in the previous one, unless that
+    // is where the search comes from; a closed curve wraps around
+    if (m_param < ROM_TRACK_PARAM_TOL && (m_interval > 0 || closed) &&
+        !forward) {
+      m_interval = m_interval > 0 ? m_interval - 1 : last;
+      m_param = 1.0;
+      back = true;
+      continue;
+    }
+    // at its end, look in the next one
+    if (m_param > 1.0 - ROM_TRACK_PARAM_TOL && (m_interval < last || closed) &&
+        !back) {
+      m_interval = m_interval < last ? m_interval + 1 : 0;
+      m_param = 0.0;
+      forward = true;
+      continue;
+    }
+    return point;
+  }
+}
+
 } // namespace hil
-} // namespace chrono
\ No newline at end of file
+} // namespace chrono
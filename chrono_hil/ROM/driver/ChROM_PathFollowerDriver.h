@@ -28,11 +28,26 @@
 #include "chrono_vehicle/ChSubsysDefs.h"
 #include "chrono_vehicle/ChWorldFrame.h"
 
+#include <cstdint>
 #include <string>
 
 namespace chrono {
 namespace hil {
 
+// curve parameter within which the closest point is at an interval end
+#define ROM_TRACK_PARAM_TOL 1e-6
+
+/// Controller state of the path follower, see ChROM_PathFollowerDriver::
+/// GetState
+struct ChROM_PathFollowerState {
+  double target_speed;
+  double st_err, st_err_d, st_err_i; ///< steering PID errors
+  double sp_err, sp_err_d, sp_err_i; ///< speed PID errors
+  DriverInputs inputs;
+  uint64_t interval; ///< curve interval of the last closest point
+  double param;      ///< curve parameter of the last closest point
+};
+
 class CH_HIL_API ChROM_PathFollowerDriver {
 
 public:
@@ -47,9 +62,24 @@ public:
   DriverInputs GetDriverInput();
   void SetCruiseSpeed(double target_speed);
 
+  /// Copy the PID controller state and the position of the curve search
+  void GetState(ChROM_PathFollowerState &state);
+
+  /// Restore a controller state obtained with GetState. The curve search
+  /// resumes where it left off, so a restored driver steers exactly as the
+  /// one it was copied from.
+  void SetState(const ChROM_PathFollowerState &state);
+
 private:
+  /// Closest point of the curve to loc, searched from the interval and
+  /// parameter of the previous one, as ChBezierCurveTracker does: the
+  /// search moves on to the neighbour intervals, and wraps around a closed
+  /// curve. Unlike the tracker, the search state is part of GetState.
+  ChVector<> Track(const ChVector<> &loc);
+
   std::shared_ptr<ChBezierCurve> m_curve;
-  std::shared_ptr<ChBezierCurveTracker> m_tracker;
+  size_t m_interval = 0; // curve interval of the last closest point
+  double m_param = 0.0;  // curve parameter of the last closest point
   std::shared_ptr<Ch_8DOF_vehicle> m_rom;
 
   // target spped
@@ -79,6 +109,8 @@ private:
   double m_dist;
 
   DriverInputs m_inputs;
+
+  ChVector<> GetSentinel();
 };
 
 } // namespace hil
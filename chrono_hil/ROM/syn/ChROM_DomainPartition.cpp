@@ -0,0 +1,81 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// Jason Zhou
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Authors: Jason Zhou
+// =============================================================================
+//
+// Partition of the map into rectangular regions, one per traffic domain
+//
+// =============================================================================
+#include "ChROM_DomainPartition.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace chrono {
+namespace hil {
+
+// distance from v to the interval [lo, hi)
+static double IntervalDistance(double v, double lo, double hi) {
+  if (v < lo)
+    return lo - v;
+  if (v > hi)
+    return v - hi;
+  return 0.0;
+}
+
+// bounds of interval i of the line split by cuts
+static void IntervalBounds(const std::vector<double> &cuts, int i, double &lo,
+                           double &hi) {
+  lo = i == 0 ? -HUGE_VAL : cuts[i - 1];
+  hi = i == static_cast<int>(cuts.size()) ? HUGE_VAL : cuts[i];
+}
+
+ChROM_DomainPartition::ChROM_DomainPartition(std::vector<double> x_cuts,
+                                             std::vector<double> y_cuts)
+    : m_x_cuts(x_cuts), m_y_cuts(y_cuts) {
+  std::sort(m_x_cuts.begin(), m_x_cuts.end());
+  std::sort(m_y_cuts.begin(), m_y_cuts.end());
+}
+
+int ChROM_DomainPartition::GetOwner(const ChVector<> &pos) const {
+  int i = static_cast<int>(
+      std::upper_bound(m_x_cuts.begin(), m_x_cuts.end(), pos.x()) -
+      m_x_cuts.begin());
+  int j = static_cast<int>(
+      std::upper_bound(m_y_cuts.begin(), m_y_cuts.end(), pos.y()) -
+      m_y_cuts.begin());
+  return j * static_cast<int>(m_x_cuts.size() + 1) + i;
+}
+
+double ChROM_DomainPartition::GetDistance(const ChVector<> &pos,
+                                          int domain) const {
+  int nx = static_cast<int>(m_x_cuts.size() + 1);
+  double x_lo, x_hi, y_lo, y_hi;
+  IntervalBounds(m_x_cuts, domain % nx, x_lo, x_hi);
+  IntervalBounds(m_y_cuts, domain / nx, y_lo, y_hi);
+  double dx = IntervalDistance(pos.x(), x_lo, x_hi);
+  double dy = IntervalDistance(pos.y(), y_lo, y_hi);
+  return std::sqrt(dx * dx + dy * dy);
+}
+
+void ChROM_DomainPartition::GetHaloDomains(const ChVector<> &pos, double width,
+                                           std::vector<int> &domains) const {
+  domains.clear();
+  int owner = GetOwner(pos);
+  for (int d = 0; d < GetNumDomains(); d++) {
+    if (d != owner && GetDistance(pos, d) <= width)
+      domains.push_back(d);
+  }
+}
+
+} // namespace hil
+} // namespace chrono
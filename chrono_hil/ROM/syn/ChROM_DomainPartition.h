@@ -0,0 +1,84 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// Jason Zhou
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Authors: Jason Zhou
+// =============================================================================
+//
+// Partition of the map into rectangular regions, one per traffic domain.
+// The regions form a grid given by cut lines along x and y; a ROM belongs to
+// the domain of the region its position falls in. The cut lines may be moved
+// during a run, see ChROM_TrafficDomain::EnableBalancing.
+//
+// =============================================================================
+#ifndef CH_ROM_DOMAIN_PARTITION_H
+#define CH_ROM_DOMAIN_PARTITION_H
+
+#include "../../ChApiHil.h"
+#include "chrono/core/ChVector.h"
+
+#include <vector>
+
+namespace chrono {
+namespace hil {
+
+class CH_HIL_API ChROM_DomainPartition {
+public:
+  /// Partition the map with cut lines at the given x and y coordinates
+  /// (sorted internally). n x cuts and m y cuts make (n + 1) * (m + 1)
+  /// domains, numbered along x first. No cuts at all make a single domain.
+  ChROM_DomainPartition(std::vector<double> x_cuts = {},
+                        std::vector<double> y_cuts = {});
+
+  int GetNumDomains() const {
+    return static_cast<int>((m_x_cuts.size() + 1) * (m_y_cuts.size() + 1));
+  }
+
+  /// Domain owning the point pos. Points on a cut line belong to the domain
+  /// on the positive side.
+  int GetOwner(const ChVector<> &pos) const;
+
+  /// Distance in the xy plane from pos to the region of a domain, 0 inside
+  double GetDistance(const ChVector<> &pos, int domain) const;
+
+  /// Domains other than the owner of pos whose region is within width of
+  /// pos, i.e. the domains which need pos in their halo
+  void GetHaloDomains(const ChVector<> &pos, double width,
+                      std::vector<int> &domains) const;
+
+  /// Cut lines along x (axis 0) or y (axis 1), sorted
+  const std::vector<double> &GetCuts(int axis) const {
+    return axis == 0 ? m_x_cuts : m_y_cuts;
+  }
+
+  /// Move cut line index of axis to value. The caller keeps the cuts
+  /// sorted.
+  void SetCut(int axis, int index, double value) {
+    (axis == 0 ? m_x_cuts : m_y_cuts)[index] = value;
+  }
+
+  /// Axis of a partition into strips, 0 if all cuts are along x, 1 if all
+  /// are along y, -1 for a grid or a single domain. Domain r of a strip
+  /// partition lies between cuts r - 1 and r.
+  int GetStripAxis() const {
+    if (m_x_cuts.empty() == m_y_cuts.empty())
+      return -1;
+    return m_x_cuts.empty() ? 1 : 0;
+  }
+
+private:
+  std::vector<double> m_x_cuts;
+  std::vector<double> m_y_cuts;
+};
+
+} // namespace hil
+} // namespace chrono
+
+#endif
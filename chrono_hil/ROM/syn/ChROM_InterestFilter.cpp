@@ -0,0 +1,139 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// Jason Zhou
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Authors: Jason Zhou
+// =============================================================================
+//
+// Area-of-interest filter used by the ROM distributor. Each client reports an
+// interest region, and only the ROMs inside that region are sent to it.
+//
+// =============================================================================
+#include "ChROM_InterestFilter.h"
+
+#include <cmath>
+
+namespace chrono {
+namespace hil {
+
+ChROM_InterestFilter::ChROM_InterestFilter(int num_clients, double hysteresis,
+                                           double angle_hysteresis) {
+  m_hysteresis = hysteresis;
+  m_angle_hysteresis = angle_hysteresis;
+  m_regions.resize(num_clients);
+  m_member.resize(num_clients);
+}
+
+void ChROM_InterestFilter::SetRegion(int client,
+                                     const ChROM_InterestRegion &region) {
+  m_regions[client] = region;
+}
+
+void ChROM_InterestFilter::SetRegion(int client,
+                                     const std::vector<float> &report) {
+  if (report.size() != ROM_INTEREST_REPORT_LEN)
+    return;
+
+  ChROM_InterestRegion region;
+  region.pos = ChVector<>(report[0], report[1], report[2]);
+  region.radius = report[3];
+  region.heading = report[4];
+  region.fov = report[5];
+  region.view_range = report[6];
+  m_regions[client] = region;
+}
+
+void ChROM_InterestFilter::EncodeRegion(const ChROM_InterestRegion &region,
+                                        std::vector<float> &report) {
+  report.clear();
+  report.push_back(region.pos.x());
+  report.push_back(region.pos.y());
+  report.push_back(region.pos.z());
+  report.push_back(region.radius);
+  report.push_back(region.heading);
+  report.push_back(region.fov);
+  report.push_back(region.view_range);
+}
+
+bool ChROM_InterestFilter::IsInside(const ChROM_InterestRegion &region,
+                                    const ChVector<> &pos, double margin,
+                                    double angle_margin) const {
+  // the z coordinate is ignored, ROMs are moving on a plane
+  double dx = pos.x() - region.pos.x();
+  double dy = pos.y() - region.pos.y();
+  double dist = std::sqrt(dx * dx + dy * dy);
+
+  if (dist <= region.radius + margin)
+    return true;
+
+  if (region.fov <= 0.0 || dist > region.view_range + margin)
+    return false;
+
+  // angle between view direction and direction to the ROM, in [0, pi]
+  double angle = std::abs(std::remainder(std::atan2(dy, dx) - region.heading,
+                                         2.0 * 3.14159265358979323846));
+  return angle <= 0.5 * region.fov + angle_margin;
+}
+
+void ChROM_InterestFilter::BuildFrame(int client,
+                                      const std::vector<ChVector<>> &rom_pos,
+                                      const std::vector<float> &rom_states,
+                                      int state_len,
+                                      std::vector<float> &frame) {
+  const ChROM_InterestRegion &region = m_regions[client];
+  std::vector<char> &member = m_member[client];
+  member.resize(rom_pos.size(), 0);
+
+  m_spawn.clear();
+  m_despawn.clear();
+  m_update.clear();
+
+  for (size_t i = 0; i < rom_pos.size(); i++) {
+    if (member[i]) {
+      // already of interest, keep it until it leaves the enlarged region
+      if (IsInside(region, rom_pos[i], m_hysteresis, m_angle_hysteresis)) {
+        m_update.push_back(i);
+      } else {
+        member[i] = 0;
+        m_despawn.push_back(i);
+      }
+    } else if (IsInside(region, rom_pos[i], 0.0, 0.0)) {
+      member[i] = 1;
+      m_spawn.push_back(i);
+      m_update.push_back(i);
+    }
+  }
+
+  frame.clear();
+  frame.reserve(3 + m_spawn.size() + m_despawn.size() +
+                m_update.size() * (state_len + 1));
+  frame.push_back(m_spawn.size());
+  frame.push_back(m_despawn.size());
+  frame.push_back(m_update.size());
+  for (int id : m_spawn)
+    frame.push_back(id);
+  for (int id : m_despawn)
+    frame.push_back(id);
+  for (int id : m_update) {
+    frame.push_back(id);
+    frame.insert(frame.end(), rom_states.begin() + id * state_len,
+                 rom_states.begin() + (id + 1) * state_len);
+  }
+}
+
+int ChROM_InterestFilter::GetNumActive(int client) const {
+  int count = 0;
+  for (char m : m_member[client])
+    count += m;
+  return count;
+}
+
+} // namespace hil
+} // namespace chrono
@@ -0,0 +1,104 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// Jason Zhou
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Authors: Jason Zhou
+// =============================================================================
+//
+// Area-of-interest filter used by the ROM distributor. Each client reports an
+// interest region, and only the ROMs inside that region are sent to it.
+//
+// =============================================================================
+#ifndef CH_ROM_INTEREST_FILTER_H
+#define CH_ROM_INTEREST_FILTER_H
+
+#include "../../ChApiHil.h"
+#include "chrono/core/ChVector.h"
+
+#include <limits>
+#include <vector>
+
+namespace chrono {
+namespace hil {
+
+/// Interest region reported by a SynChrono node to the ROM distributor.
+/// A ROM is of interest if it lies within radius of pos, or if it lies inside
+/// the view cone (heading, fov, view_range). The view cone is disabled when
+/// fov <= 0.
+struct ChROM_InterestRegion {
+  ChVector<> pos = ChVector<>(0.0, 0.0, 0.0); ///< center of the region
+  double radius = std::numeric_limits<double>::infinity(); ///< near radius
+  double heading = 0.0;    ///< yaw of the view direction [rad]
+  double fov = 0.0;        ///< full angle of the view cone [rad]
+  double view_range = 0.0; ///< range of the view cone [m]
+};
+
+/// Number of floats used to report an interest region over the network
+#define ROM_INTEREST_REPORT_LEN 7
+
+// Frame layout sent to each client by BuildFrame:
+// [n_spawn, n_despawn, n_update,
+//  spawn ids (n_spawn), despawn ids (n_despawn),
+//  (id, state[state_len]) * n_update]
+// Spawned ROMs are always part of the update block of the same frame.
+class CH_HIL_API ChROM_InterestFilter {
+public:
+  /// Create a filter for num_clients clients. A ROM which entered the region
+  /// of a client is only dropped once it is farther than hysteresis [m] (or
+  /// angle_hysteresis [rad] outside the view cone) from the region boundary.
+  ChROM_InterestFilter(int num_clients, double hysteresis = 10.0,
+                       double angle_hysteresis = 0.1);
+
+  /// Set the interest region of a client
+  void SetRegion(int client, const ChROM_InterestRegion &region);
+
+  /// Set the interest region of a client from a report received over the
+  /// network (see EncodeRegion). Reports of the wrong size are ignored.
+  void SetRegion(int client, const std::vector<float> &report);
+
+  /// Obtain the current interest region of a client
+  const ChROM_InterestRegion &GetRegion(int client) const {
+    return m_regions[client];
+  }
+
+  /// Update the membership of all ROMs for a client, and assemble the frame
+  /// to be sent. rom_states holds state_len floats per ROM, in the same order
+  /// as rom_pos.
+  void BuildFrame(int client, const std::vector<ChVector<>> &rom_pos,
+                  const std::vector<float> &rom_states, int state_len,
+                  std::vector<float> &frame);
+
+  /// Number of ROMs currently of interest to a client
+  int GetNumActive(int client) const;
+
+  /// Encode an interest region into ROM_INTEREST_REPORT_LEN floats
+  static void EncodeRegion(const ChROM_InterestRegion &region,
+                           std::vector<float> &report);
+
+private:
+  bool IsInside(const ChROM_InterestRegion &region, const ChVector<> &pos,
+                double margin, double angle_margin) const;
+
+  std::vector<ChROM_InterestRegion> m_regions;
+  std::vector<std::vector<char>> m_member; ///< membership per client and ROM
+
+  double m_hysteresis;
+  double m_angle_hysteresis;
+
+  // scratch buffers, reused from frame to frame
+  std::vector<int> m_spawn;
+  std::vector<int> m_despawn;
+  std::vector<int> m_update;
+};
+
+} // namespace hil
+} // namespace chrono
+
+#endif
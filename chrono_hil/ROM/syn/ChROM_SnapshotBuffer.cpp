@@ -0,0 +1,232 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// Jason Zhou
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Authors: Jason Zhou
+// =============================================================================
+//
+// Jitter buffer of the states received for one remote ROM
+//
+// =============================================================================
+#include "ChROM_SnapshotBuffer.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace chrono {
+namespace hil {
+
+// max number of states kept, far more than the playout delay needs
+#define ROM_SNAPSHOT_CAPACITY 64
+
+static double WrapAngle(double a) {
+  return a - 2.0 * M_PI * std::floor((a + M_PI) / (2.0 * M_PI));
+}
+
+static double Hermite(double x0, double v0, double x1, double v1, double h,
+                      double s) {
+  double s2 = s * s;
+  double s3 = s2 * s;
+  return (2 * s3 - 3 * s2 + 1) * x0 + (s3 - 2 * s2 + s) * h * v0 +
+         (-2 * s3 + 3 * s2) * x1 + (s3 - s2) * h * v1;
+}
+
+static ChVector<> Hermite(const ChVector<> &x0, const ChVector<> &v0,
+                          const ChVector<> &x1, const ChVector<> &v1, double h,
+                          double s) {
+  return ChVector<>(Hermite(x0.x(), v0.x(), x1.x(), v1.x(), h, s),
+                    Hermite(x0.y(), v0.y(), x1.y(), v1.y(), h, s),
+                    Hermite(x0.z(), v0.z(), x1.z(), v1.z(), h, s));
+}
+
+ChROM_SnapshotBuffer::ChROM_SnapshotBuffer(double playout_delay,
+                                           double max_extrapolation) {
+  m_delay = playout_delay;
+  m_max_extrapolation = max_extrapolation;
+}
+
+void ChROM_SnapshotBuffer::Clear() {
+  m_entries.clear();
+  m_extrapolating = false;
+  m_err_pos = ChVector<>(0.0, 0.0, 0.0);
+  m_err_yaw = 0.0;
+}
+
+void ChROM_SnapshotBuffer::Push(double t, const ChROM_Snapshot &snap) {
+  if (!m_entries.empty() && t <= m_entries.back().t) {
+    m_num_dropped++;
+    return;
+  }
+
+  Entry e = {t, snap};
+  if (!m_entries.empty()) {
+    const Entry &prev = m_entries.back();
+    double dt = t - prev.t;
+
+    // Euler angles: take the branch closest to the previous state
+    e.s.rot = ChVector<>(
+        prev.s.rot.x() + WrapAngle(snap.rot.x() - prev.s.rot.x()),
+        prev.s.rot.y() + WrapAngle(snap.rot.y() - prev.s.rot.y()),
+        prev.s.rot.z() + WrapAngle(snap.rot.z() - prev.s.rot.z()));
+
+    // wheel phases: take the branch closest to the phase predicted with the
+    // previous wheel speed, which may be more than half a turn per state
+    for (int w = 0; w < 4; w++) {
+      double rate = 0.0;
+      if (m_entries.size() >= 2) {
+        const Entry &prev2 = m_entries[m_entries.size() - 2];
+        rate = (prev.s.tire_rot[w] - prev2.s.tire_rot[w]) / (prev.t - prev2.t);
+      }
+      double predicted = prev.s.tire_rot[w] + rate * dt;
+      e.s.tire_rot[w] = predicted + WrapAngle(snap.tire_rot[w] - predicted);
+    }
+  }
+
+  m_entries.push_back(e);
+  if (m_entries.size() > ROM_SNAPSHOT_CAPACITY)
+    m_entries.pop_front();
+}
+
+void ChROM_SnapshotBuffer::Derivative(size_t i, ChROM_Snapshot &d) const {
+  size_t lo = i > 0 ? i - 1 : i;
+  size_t hi = i + 1 < m_entries.size() ? i + 1 : i;
+  if (lo == hi) {
+    d = ChROM_Snapshot();
+    return;
+  }
+
+  const ChROM_Snapshot &a = m_entries[lo].s;
+  const ChROM_Snapshot &b = m_entries[hi].s;
+  double h = m_entries[hi].t - m_entries[lo].t;
+  d.pos = (b.pos - a.pos) / h;
+  d.rot = (b.rot - a.rot) / h;
+  d.steering = (b.steering - a.steering) / h;
+  for (int w = 0; w < 4; w++)
+    d.tire_rot[w] = (b.tire_rot[w] - a.tire_rot[w]) / h;
+}
+
+void ChROM_SnapshotBuffer::Interpolate(size_t i, double t,
+                                       ChROM_Snapshot &out) const {
+  const Entry &e0 = m_entries[i];
+  const Entry &e1 = m_entries[i + 1];
+  ChROM_Snapshot d0, d1;
+  Derivative(i, d0);
+  Derivative(i + 1, d1);
+
+  double h = e1.t - e0.t;
+  double s = (t - e0.t) / h;
+  out.pos = Hermite(e0.s.pos, d0.pos, e1.s.pos, d1.pos, h, s);
+  out.rot = Hermite(e0.s.rot, d0.rot, e1.s.rot, d1.rot, h, s);
+  out.steering = std::max(
+      -1.0, std::min(1.0, Hermite(e0.s.steering, d0.steering, e1.s.steering,
+                                  d1.steering, h, s)));
+  for (int w = 0; w < 4; w++)
+    out.tire_rot[w] = Hermite(e0.s.tire_rot[w], d0.tire_rot[w],
+                              e1.s.tire_rot[w], d1.tire_rot[w], h, s);
+}
+
+void ChROM_SnapshotBuffer::Extrapolate(double t, ChROM_Snapshot &out) const {
+  const Entry &last = m_entries.back();
+  ChROM_Snapshot d;
+  Derivative(m_entries.size() - 1, d);
+  double dt = t - last.t;
+
+  out = last.s;
+
+  // constant speed and turn rate along the direction of travel
+  double vx = d.pos.x();
+  double vy = d.pos.y();
+  double speed = std::sqrt(vx * vx + vy * vy);
+  double yaw_rate = d.rot.z();
+  if (speed > 1e-6 && std::abs(yaw_rate) > 1e-6) {
+    double theta = std::atan2(vy, vx);
+    double theta_t = theta + yaw_rate * dt;
+    double r = speed / yaw_rate;
+    double dx = r * (std::sin(theta_t) - std::sin(theta));
+    double dy = -r * (std::cos(theta_t) - std::cos(theta));
+    out.pos = last.s.pos + ChVector<>(dx, dy, d.pos.z() * dt);
+  } else {
+    out.pos = last.s.pos + d.pos * dt;
+  }
+
+  out.rot = ChVector<>(last.s.rot.x(), last.s.rot.y(),
+                       last.s.rot.z() + yaw_rate * dt);
+  for (int w = 0; w < 4; w++)
+    out.tire_rot[w] = last.s.tire_rot[w] + d.tire_rot[w] * dt;
+}
+
+int ChROM_SnapshotBuffer::Evaluate(double t, ChROM_Snapshot &out) const {
+  const Entry &first = m_entries.front();
+  const Entry &last = m_entries.back();
+
+  if (t <= first.t || m_entries.size() < 2) {
+    out = t <= first.t ? first.s : last.s;
+    return t == first.t ? 1 : 0;
+  }
+
+  if (t > last.t) {
+    if (t - last.t > m_max_extrapolation) {
+      Extrapolate(last.t + m_max_extrapolation, out);
+      return 0;
+    }
+    Extrapolate(t, out);
+    return 2;
+  }
+
+  size_t i = 0;
+  while (m_entries[i + 1].t < t)
+    i++;
+  Interpolate(i, t, out);
+  return 1;
+}
+
+bool ChROM_SnapshotBuffer::Sample(double t, ChROM_Snapshot &out) {
+  if (m_entries.empty())
+    return false;
+
+  double t_play = t - m_delay;
+
+  // keep one state before the interpolation interval, for its derivative
+  while (m_entries.size() >= 3 && m_entries[2].t <= t_play)
+    m_entries.pop_front();
+
+  int mode = Evaluate(t_play, out);
+  if (mode == 1)
+    m_num_interpolated++;
+  else if (mode == 2)
+    m_num_extrapolated++;
+  else
+    m_num_held++;
+
+  // a late state corrected a dead-reckoned pose: instead of jumping, fade
+  // the error out, starting from the pose shown last
+  if (m_extrapolating && mode == 1) {
+    ChROM_Snapshot corrected;
+    Evaluate(m_last_t - m_delay, corrected);
+    m_err_pos = m_last_out.pos - corrected.pos;
+    m_err_yaw = m_last_out.rot.z() - corrected.rot.z();
+    m_blend_t0 = t;
+  }
+  m_extrapolating = mode != 1;
+
+  if (m_blend_time > 0.0 && t - m_blend_t0 < m_blend_time) {
+    double weight = 1.0 - (t - m_blend_t0) / m_blend_time;
+    out.pos = out.pos + m_err_pos * weight;
+    out.rot = ChVector<>(out.rot.x(), out.rot.y(),
+                         out.rot.z() + m_err_yaw * weight);
+  }
+
+  m_last_t = t;
+  m_last_out = out;
+  return true;
+}
+
+} // namespace hil
+} // namespace chrono
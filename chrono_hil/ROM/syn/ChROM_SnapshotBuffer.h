@@ -0,0 +1,119 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// Jason Zhou
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Authors: Jason Zhou
+// =============================================================================
+//
+// Jitter buffer of the states received for one remote ROM. States are played
+// back with a fixed delay: between two received states the pose is given by
+// a cubic Hermite spline, and past the newest state it is dead-reckoned with
+// the last velocity and yaw rate. Angles and wheel phases are unwrapped on
+// arrival, so that wrapping at +-pi (or 2 pi) never shows as a spin.
+//
+// =============================================================================
+#ifndef CH_ROM_SNAPSHOT_BUFFER_H
+#define CH_ROM_SNAPSHOT_BUFFER_H
+
+#include "../../ChApiHil.h"
+#include "chrono/core/ChVector.h"
+
+#include <cstdint>
+#include <deque>
+
+namespace chrono {
+namespace hil {
+
+/// State of a remote ROM, as sent by the ROM distributor
+struct ChROM_Snapshot {
+  ChVector<> pos = ChVector<>(0.0, 0.0, 0.0); ///< chassis position
+  ChVector<> rot = ChVector<>(0.0, 0.0, 0.0); ///< chassis Euler123 angles
+  double steering = 0.0;                      ///< normalized steering input
+  double tire_rot[4] = {0.0, 0.0, 0.0, 0.0};  ///< wheel phases [rad]
+};
+
+class CH_HIL_API ChROM_SnapshotBuffer {
+public:
+  /// Create a buffer which plays states back playout_delay [s] after they
+  /// were taken, and dead-reckons for at most max_extrapolation [s] when no
+  /// newer state arrived.
+  ChROM_SnapshotBuffer(double playout_delay = 0.05,
+                       double max_extrapolation = 0.25);
+
+  void SetPlayoutDelay(double delay) { m_delay = delay; }
+  double GetPlayoutDelay() const { return m_delay; }
+
+  void SetMaxExtrapolation(double time) { m_max_extrapolation = time; }
+
+  /// Time over which the error is faded out when a late state corrects a
+  /// dead-reckoned pose
+  void SetBlendTime(double time) { m_blend_time = time; }
+
+  /// Drop all states, e.g. when the zombie is reused for another ROM
+  void Clear();
+
+  /// Add the state of the ROM at time t. States which are not newer than the
+  /// newest state in the buffer are dropped.
+  void Push(double t, const ChROM_Snapshot &snap);
+
+  /// Evaluate the state to be shown at time t, which is the state at
+  /// t - playout_delay. Returns false if no state was received yet.
+  bool Sample(double t, ChROM_Snapshot &out);
+
+  bool IsEmpty() const { return m_entries.empty(); }
+
+  /// Number of samples which were interpolated, dead-reckoned, or held
+  /// (before the first state, or beyond the extrapolation limit)
+  uint64_t GetNumInterpolated() const { return m_num_interpolated; }
+  uint64_t GetNumExtrapolated() const { return m_num_extrapolated; }
+  uint64_t GetNumHeld() const { return m_num_held; }
+
+  /// Number of states dropped because they arrived out of order
+  uint64_t GetNumDropped() const { return m_num_dropped; }
+
+private:
+  struct Entry {
+    double t;
+    ChROM_Snapshot s; // angles unwrapped w.r.t. the previous entry
+  };
+
+  /// Time derivative of the state at entry i
+  void Derivative(size_t i, ChROM_Snapshot &d) const;
+
+  void Interpolate(size_t i, double t, ChROM_Snapshot &out) const;
+  void Extrapolate(double t, ChROM_Snapshot &out) const;
+
+  /// Evaluate without counting nor blending, returns 0 if held, 1 if
+  /// interpolated, and 2 if extrapolated
+  int Evaluate(double t, ChROM_Snapshot &out) const;
+
+  std::deque<Entry> m_entries;
+  double m_delay;
+  double m_max_extrapolation;
+  double m_blend_time = 0.1;
+
+  // correction faded out after dead reckoning
+  bool m_extrapolating = false;
+  double m_last_t = 0.0;
+  ChROM_Snapshot m_last_out;
+  double m_blend_t0 = 0.0;
+  ChVector<> m_err_pos = ChVector<>(0.0, 0.0, 0.0);
+  double m_err_yaw = 0.0;
+
+  uint64_t m_num_interpolated = 0;
+  uint64_t m_num_extrapolated = 0;
+  uint64_t m_num_held = 0;
+  uint64_t m_num_dropped = 0;
+};
+
+} // namespace hil
+} // namespace chrono
+
+#endif
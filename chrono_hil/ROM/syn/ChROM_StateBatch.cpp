@@ -0,0 +1,124 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// Jason Zhou
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Authors: Jason Zhou
+// =============================================================================
+//
+// Compact batched message carrying the state of many ROMs
+//
+// =============================================================================
+#include "ChROM_StateBatch.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+namespace chrono {
+namespace hil {
+
+template <typename T> static void Put(uint8_t *&p, T value) {
+  std::memcpy(p, &value, sizeof(T));
+  p += sizeof(T);
+}
+
+template <typename T> static T Get(const uint8_t *&p) {
+  T value;
+  std::memcpy(&value, p, sizeof(T));
+  p += sizeof(T);
+  return value;
+}
+
+// angle in [-pi, pi) on 16 bits
+static int16_t QuantizeAngle(double a) {
+  double turns = a / (2.0 * M_PI);
+  turns -= std::floor(turns + 0.5);
+  long q = std::lround(turns * 65536.0);
+  return static_cast<int16_t>(q >= 32768 ? q - 65536 : q);
+}
+
+static double AngleFromQuantized(int16_t q) {
+  return q * (2.0 * M_PI / 65536.0);
+}
+
+// phase in [0, 2 pi) on 16 bits
+static uint16_t QuantizePhase(double a) {
+  double turns = a / (2.0 * M_PI);
+  turns -= std::floor(turns);
+  return static_cast<uint16_t>(std::lround(turns * 65536.0) & 0xFFFF);
+}
+
+static double PhaseFromQuantized(uint16_t q) {
+  return q * (2.0 * M_PI / 65536.0);
+}
+
+void ChROM_StateBatch::Encode(std::vector<uint8_t> &buffer) const {
+  buffer.resize(GetEncodedSize(states.size()));
+  uint8_t *p = buffer.data();
+
+  Put<uint16_t>(p, ROM_BATCH_MAGIC);
+  Put<uint8_t>(p, ROM_BATCH_VERSION);
+  Put<uint8_t>(p, 0);
+  Put<uint32_t>(p, static_cast<uint32_t>(source));
+  Put<double>(p, time);
+  Put<uint32_t>(p, static_cast<uint32_t>(states.size()));
+
+  for (const ChROM_State &s : states) {
+    Put<uint16_t>(p, static_cast<uint16_t>(s.id));
+    Put<float>(p, static_cast<float>(s.pos.x()));
+    Put<float>(p, static_cast<float>(s.pos.y()));
+    Put<float>(p, static_cast<float>(s.pos.z()));
+    Put<int16_t>(p, QuantizeAngle(s.rot.x()));
+    Put<int16_t>(p, QuantizeAngle(s.rot.y()));
+    Put<int16_t>(p, QuantizeAngle(s.rot.z()));
+    float steering = std::max(-1.f, std::min(1.f, s.steering));
+    Put<int16_t>(p, static_cast<int16_t>(std::lround(steering * 32767.f)));
+    for (int w = 0; w < 4; w++)
+      Put<uint16_t>(p, QuantizePhase(s.tire_rot[w]));
+  }
+}
+
+bool ChROM_StateBatch::Decode(const uint8_t *data, size_t len) {
+  if (len < ROM_BATCH_HEADER_SIZE)
+    return false;
+
+  const uint8_t *p = data;
+  if (Get<uint16_t>(p) != ROM_BATCH_MAGIC ||
+      Get<uint8_t>(p) != ROM_BATCH_VERSION)
+    return false;
+  Get<uint8_t>(p);
+  uint32_t batch_source = Get<uint32_t>(p);
+  double batch_time = Get<double>(p);
+  uint32_t n = Get<uint32_t>(p);
+  if (len != GetEncodedSize(n))
+    return false;
+
+  source = batch_source;
+  time = batch_time;
+  states.resize(n);
+  for (ChROM_State &s : states) {
+    s.id = Get<uint16_t>(p);
+    double x = Get<float>(p);
+    double y = Get<float>(p);
+    double z = Get<float>(p);
+    s.pos = ChVector<>(x, y, z);
+    double roll = AngleFromQuantized(Get<int16_t>(p));
+    double pitch = AngleFromQuantized(Get<int16_t>(p));
+    double yaw = AngleFromQuantized(Get<int16_t>(p));
+    s.rot = ChVector<>(roll, pitch, yaw);
+    s.steering = Get<int16_t>(p) / 32767.f;
+    for (int w = 0; w < 4; w++)
+      s.tire_rot[w] = PhaseFromQuantized(Get<uint16_t>(p));
+  }
+  return true;
+}
+
+} // namespace hil
+} // namespace chrono
@@ -0,0 +1,77 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// Jason Zhou
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Authors: Jason Zhou
+// =============================================================================
+//
+// Compact batched message carrying the state of many ROMs simulated on one
+// node: pose, steering and wheel phases. Positions are sent as floats, angles
+// are quantized to 16 bits (about 1e-4 rad), so one ROM takes 30 bytes
+// instead of the 48 bytes of the float frame used by the ROM distributor.
+//
+// Layout, little endian:
+//   header: uint16 magic "RB", uint8 version, uint8 reserved,
+//           uint32 source node, float64 time, uint32 n
+//   ROM:    uint16 id, float32 pos[3], int16 rot[3], int16 steering,
+//           uint16 tire_rot[4]
+//
+// =============================================================================
+#ifndef CH_ROM_STATE_BATCH_H
+#define CH_ROM_STATE_BATCH_H
+
+#include "../../ChApiHil.h"
+#include "chrono/core/ChVector.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace chrono {
+namespace hil {
+
+#define ROM_BATCH_MAGIC 0x5242 // "RB"
+#define ROM_BATCH_VERSION 1
+#define ROM_BATCH_HEADER_SIZE 20
+#define ROM_BATCH_STATE_SIZE 30
+
+/// State of one ROM, as shown by its zombies
+struct ChROM_State {
+  int id = 0;                                 ///< global ROM id, < 65536
+  ChVector<> pos = ChVector<>(0.0, 0.0, 0.0); ///< chassis position
+  ChVector<> rot = ChVector<>(0.0, 0.0, 0.0); ///< chassis Euler123 angles
+  float steering = 0.f;                       ///< normalized steering input
+  float tire_rot[4] = {0.f, 0.f, 0.f, 0.f};   ///< wheel phases [rad]
+};
+
+class CH_HIL_API ChROM_StateBatch {
+public:
+  double time = 0.0; ///< simulation time of the states
+  int source = 0;    ///< node which simulates the ROMs
+  std::vector<ChROM_State> states;
+
+  /// Serialize the batch into buffer, which is resized to fit
+  void Encode(std::vector<uint8_t> &buffer) const;
+
+  /// Deserialize a batch, returns false (and leaves the batch untouched) if
+  /// the data is not a valid batch. Decoded angles are in [-pi, pi), wheel
+  /// phases in [0, 2 pi).
+  bool Decode(const uint8_t *data, size_t len);
+
+  /// Size of an encoded batch of num_roms ROMs [bytes]
+  static size_t GetEncodedSize(size_t num_roms) {
+    return ROM_BATCH_HEADER_SIZE + num_roms * ROM_BATCH_STATE_SIZE;
+  }
+};
+
+} // namespace hil
+} // namespace chrono
+
+#endif
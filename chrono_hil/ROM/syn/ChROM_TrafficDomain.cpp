@@ -0,0 +1,480 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// Jason Zhou
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Authors: Jason Zhou
+// =============================================================================
+//
+// One traffic domain of a ROM simulation split across processes
+//
+// =============================================================================
+#include "ChROM_TrafficDomain.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstring>
+#include <iostream>
+#include <limits>
+
+namespace chrono {
+namespace hil {
+
+template <typename T> static void Put(std::vector<uint8_t> &buffer, T value) {
+  size_t n = buffer.size();
+  buffer.resize(n + sizeof(T));
+  std::memcpy(buffer.data() + n, &value, sizeof(T));
+}
+
+// bounds-checked read, sets ok to false past the end of the data
+template <typename T>
+static T Get(const uint8_t *&p, const uint8_t *end, bool &ok) {
+  T value = T();
+  if (!ok || end - p < static_cast<ptrdiff_t>(sizeof(T))) {
+    ok = false;
+    return value;
+  }
+  std::memcpy(&value, p, sizeof(T));
+  p += sizeof(T);
+  return value;
+}
+
+static void PutVector(std::vector<uint8_t> &buffer, const ChVector<> &v) {
+  Put<double>(buffer, v.x());
+  Put<double>(buffer, v.y());
+  Put<double>(buffer, v.z());
+}
+
+static ChVector<> GetVector(const uint8_t *&p, const uint8_t *end, bool &ok) {
+  double x = Get<double>(p, end, ok);
+  double y = Get<double>(p, end, ok);
+  double z = Get<double>(p, end, ok);
+  return ChVector<>(x, y, z);
+}
+
+static void MakeGhost(Ch_8DOF_vehicle &rom, ChROM_Ghost &ghost) {
+  ghost.pos = rom.GetPos();
+  ghost.vel = rom.GetVel();
+  ghost.rot = rom.GetRot();
+  ghost.steering = rom.GetDriverInputs().m_steering;
+  for (int w = 0; w < 4; w++)
+    ghost.tire_rotation[w] = rom.GetTireRotation(w);
+}
+
+static void PutGhost(std::vector<uint8_t> &buffer, int id,
+                     const ChROM_Ghost &ghost) {
+  Put<int32_t>(buffer, id);
+  PutVector(buffer, ghost.pos);
+  PutVector(buffer, ghost.vel);
+  Put<double>(buffer, ghost.rot.e0());
+  Put<double>(buffer, ghost.rot.e1());
+  Put<double>(buffer, ghost.rot.e2());
+  Put<double>(buffer, ghost.rot.e3());
+  Put<double>(buffer, ghost.steering);
+  for (int w = 0; w < 4; w++)
+    Put<double>(buffer, ghost.tire_rotation[w]);
+}
+
+static ChROM_Ghost GetGhost(const uint8_t *&p, const uint8_t *end, bool &ok) {
+  ChROM_Ghost ghost;
+  ghost.pos = GetVector(p, end, ok);
+  ghost.vel = GetVector(p, end, ok);
+  double e0 = Get<double>(p, end, ok);
+  double e1 = Get<double>(p, end, ok);
+  double e2 = Get<double>(p, end, ok);
+  double e3 = Get<double>(p, end, ok);
+  ghost.rot = ChQuaternion<>(e0, e1, e2, e3);
+  ghost.steering = Get<double>(p, end, ok);
+  for (int w = 0; w < 4; w++)
+    ghost.tire_rotation[w] = Get<double>(p, end, ok);
+  return ghost;
+}
+
+ChROM_TrafficDomain::ChROM_TrafficDomain(
+    const ChROM_DomainPartition &partition, int rank, ChSystem *system,
+    VehicleFactory factory)
+    : m_partition(partition), m_rank(rank), m_system(system),
+      m_factory(factory) {
+  m_cost_clock = []() {
+    return std::chrono::duration<double>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+  };
+}
+
+void ChROM_TrafficDomain::AddLink(int rank,
+                                  std::shared_ptr<ChHilTransport> link) {
+  Link l;
+  l.rank = rank;
+  l.transport = link;
+  l.peer_load = -1.0;
+  l.pending_cut = std::numeric_limits<double>::quiet_NaN();
+  m_links.push_back(l);
+}
+
+void ChROM_TrafficDomain::EnableBalancing(int period, double tolerance) {
+  if (m_partition.GetStripAxis() < 0) {
+    std::cout << "domain " << m_rank << ": only strips are balanced"
+              << std::endl;
+    return;
+  }
+  m_balance_period = period;
+  m_balance_tolerance = tolerance;
+}
+
+int ChROM_TrafficDomain::GetCutIndex(int rank) const {
+  if (m_partition.GetStripAxis() < 0 || std::abs(rank - m_rank) != 1)
+    return -1;
+  return std::min(rank, m_rank);
+}
+
+void ChROM_TrafficDomain::Initialize() {
+  for (Link &link : m_links)
+    link.transport->Initialize();
+}
+
+bool ChROM_TrafficDomain::AddVehicle(const ChROM_TrafficVehicle &vehicle) {
+  if (m_partition.GetOwner(vehicle.rom->GetPos()) != m_rank)
+    return false;
+  m_vehicles[vehicle.id] = vehicle;
+  return true;
+}
+
+void ChROM_TrafficDomain::EncodeVehicle(const ChROM_TrafficVehicle &vehicle,
+                                        std::vector<uint8_t> &buffer) {
+  buffer.clear();
+
+  Ch_8DOF_state rom_state;
+  vehicle.rom->GetState(rom_state);
+  ChROM_PathFollowerState driver_state;
+  vehicle.driver->GetState(driver_state);
+  ChROM_IDMState idm_state;
+  vehicle.idm->GetState(idm_state);
+
+  // same build on both sides, the plain structs are copied as they are
+  buffer.resize(sizeof(rom_state) + sizeof(driver_state));
+  std::memcpy(buffer.data(), &rom_state, sizeof(rom_state));
+  std::memcpy(buffer.data() + sizeof(rom_state), &driver_state,
+              sizeof(driver_state));
+
+  Put<uint32_t>(buffer, static_cast<uint32_t>(idm_state.params.size()));
+  for (double param : idm_state.params)
+    Put<double>(buffer, param);
+  Put<double>(buffer, idm_state.dist);
+  PutVector(buffer, idm_state.previous_pos);
+  Put<double>(buffer, idm_state.thero_speed);
+  Put<uint32_t>(buffer, static_cast<uint32_t>(idm_state.random_state.size()));
+  buffer.insert(buffer.end(), idm_state.random_state.begin(),
+                idm_state.random_state.end());
+}
+
+bool ChROM_TrafficDomain::DecodeVehicle(const uint8_t *data, size_t len,
+                                        ChROM_TrafficVehicle &vehicle) {
+  Ch_8DOF_state rom_state;
+  ChROM_PathFollowerState driver_state;
+  if (len < sizeof(rom_state) + sizeof(driver_state))
+    return false;
+  std::memcpy(&rom_state, data, sizeof(rom_state));
+  std::memcpy(&driver_state, data + sizeof(rom_state), sizeof(driver_state));
+
+  const uint8_t *p = data + sizeof(rom_state) + sizeof(driver_state);
+  const uint8_t *end = data + len;
+  bool ok = true;
+
+  ChROM_IDMState idm_state;
+  uint32_t n_params = Get<uint32_t>(p, end, ok);
+  for (uint32_t i = 0; ok && i < n_params; i++)
+    idm_state.params.push_back(Get<double>(p, end, ok));
+  idm_state.dist = Get<double>(p, end, ok);
+  idm_state.previous_pos = GetVector(p, end, ok);
+  idm_state.thero_speed = Get<double>(p, end, ok);
+  uint32_t n_random = Get<uint32_t>(p, end, ok);
+  if (!ok || static_cast<size_t>(end - p) != n_random)
+    return false;
+  idm_state.random_state.assign(reinterpret_cast<const char *>(p), n_random);
+
+  // the driver looks ahead from the restored ROM
+  vehicle.rom->SetState(rom_state);
+  vehicle.driver->SetState(driver_state);
+  vehicle.idm->SetState(idm_state);
+  return true;
+}
+
+void ChROM_TrafficDomain::Exchange(double time) {
+  // boundaries decided in the previous step move before the migrants are
+  // picked, the neighbours moved them on receipt
+  int axis = m_partition.GetStripAxis();
+  for (Link &link : m_links) {
+    link.out.assign(ROM_DOMAIN_HEADER_SIZE, 0);
+    link.n_migrants = 0;
+    link.n_ghosts = 0;
+    link.peer_load = -1.0;
+    if (!std::isnan(link.pending_cut)) {
+      m_partition.SetCut(axis, GetCutIndex(link.rank), link.pending_cut);
+      m_num_rebalances++;
+    }
+  }
+
+  // mean cost of the period which just ended
+  bool report = m_balance_period > 0 && m_step > 0 &&
+                m_step % m_balance_period == 0;
+  if (report) {
+    m_load = m_cost_sum / m_balance_period;
+    m_cost_sum = 0.0;
+  }
+
+  // ROMs which left the region, they stay visible to the followers of this
+  // domain for the step through the ghosts
+  m_ghosts.clear();
+  for (auto it = m_vehicles.begin(); it != m_vehicles.end();) {
+    ChROM_TrafficVehicle &vehicle = it->second;
+    int owner = m_partition.GetOwner(vehicle.rom->GetPos());
+    Link *link = nullptr;
+    for (Link &l : m_links) {
+      if (l.rank == owner)
+        link = &l;
+    }
+    if (owner == m_rank || !link) {
+      if (owner != m_rank && !m_warned_link) {
+        std::cout << "domain " << m_rank << ": no link to domain " << owner
+                  << ", ROM " << vehicle.id << " is kept" << std::endl;
+        m_warned_link = true;
+      }
+      ++it;
+      continue;
+    }
+
+    EncodeVehicle(vehicle, m_state);
+    Put<int32_t>(link->out, vehicle.id);
+    Put<int32_t>(link->out, vehicle.leader_id);
+    Put<uint32_t>(link->out, static_cast<uint32_t>(m_state.size()));
+    link->out.insert(link->out.end(), m_state.begin(), m_state.end());
+    link->n_migrants++;
+
+    MakeGhost(*vehicle.rom, m_ghosts[vehicle.id]);
+
+    vehicle.rom->RemoveFromSystem(m_system);
+    it = m_vehicles.erase(it);
+    m_num_out++;
+  }
+
+  // halo of each neighbour
+  ChROM_Ghost ghost;
+  for (auto &entry : m_vehicles) {
+    ChROM_TrafficVehicle &vehicle = entry.second;
+    m_partition.GetHaloDomains(vehicle.rom->GetPos(), m_halo_width,
+                               m_halo_domains);
+    if (m_halo_domains.empty())
+      continue;
+    MakeGhost(*vehicle.rom, ghost);
+    for (int d : m_halo_domains) {
+      for (Link &link : m_links) {
+        if (link.rank != d)
+          continue;
+        PutGhost(link.out, vehicle.id, ghost);
+        link.n_ghosts++;
+      }
+    }
+  }
+
+  // send to all neighbours first, then wait for all of them
+  for (Link &link : m_links) {
+    std::vector<uint8_t> header;
+    Put<uint16_t>(header, ROM_DOMAIN_MAGIC);
+    Put<uint8_t>(header, ROM_DOMAIN_VERSION);
+    Put<uint8_t>(header, 0);
+    Put<uint32_t>(header, static_cast<uint32_t>(link.out.size()));
+    Put<uint32_t>(header, static_cast<uint32_t>(m_rank));
+    Put<double>(header, time);
+    Put<uint32_t>(header, link.n_migrants);
+    Put<uint32_t>(header, link.n_ghosts);
+    Put<double>(header, report ? m_load : -1.0);
+    Put<double>(header, link.pending_cut);
+    std::memcpy(link.out.data(), header.data(), ROM_DOMAIN_HEADER_SIZE);
+    link.pending_cut = std::numeric_limits<double>::quiet_NaN();
+
+    m_frame.assign((link.out.size() + sizeof(float) - 1) / sizeof(float), 0.f);
+    std::memcpy(m_frame.data(), link.out.data(), link.out.size());
+    link.transport->SendFrame(m_frame);
+  }
+
+  for (Link &link : m_links) {
+    if (link.transport->PollFrame(m_frame))
+      Receive(link, m_frame);
+  }
+
+  if (report)
+    Balance();
+}
+
+void ChROM_TrafficDomain::Receive(Link &link,
+                                  const std::vector<float> &frame) {
+  const uint8_t *data = reinterpret_cast<const uint8_t *>(frame.data());
+  const uint8_t *p = data;
+  const uint8_t *end = data + frame.size() * sizeof(float);
+  bool ok = true;
+
+  if (Get<uint16_t>(p, end, ok) != ROM_DOMAIN_MAGIC ||
+      Get<uint8_t>(p, end, ok) != ROM_DOMAIN_VERSION) {
+    std::cout << "domain " << m_rank << ": invalid frame dropped"
+              << std::endl;
+    return;
+  }
+  Get<uint8_t>(p, end, ok);
+  uint32_t len = Get<uint32_t>(p, end, ok);
+  Get<uint32_t>(p, end, ok); // source
+  Get<double>(p, end, ok);   // time
+  uint32_t n_migrants = Get<uint32_t>(p, end, ok);
+  uint32_t n_ghosts = Get<uint32_t>(p, end, ok);
+  double load = Get<double>(p, end, ok);
+  double cut = Get<double>(p, end, ok);
+  if (!ok || len > static_cast<size_t>(end - data)) {
+    std::cout << "domain " << m_rank << ": truncated frame dropped"
+              << std::endl;
+    return;
+  }
+  end = data + len;
+
+  link.peer_load = load;
+  int cut_index = GetCutIndex(link.rank);
+  if (!std::isnan(cut) && cut_index >= 0) {
+    // the boundary moves into the region of the sender, none of our ROMs
+    // changes side
+    m_partition.SetCut(m_partition.GetStripAxis(), cut_index, cut);
+    m_num_rebalances++;
+  }
+
+  for (uint32_t i = 0; ok && i < n_migrants; i++) {
+    int id = Get<int32_t>(p, end, ok);
+    int leader_id = Get<int32_t>(p, end, ok);
+    uint32_t n = Get<uint32_t>(p, end, ok);
+    if (!ok || static_cast<size_t>(end - p) < n)
+      break;
+
+    ChROM_TrafficVehicle vehicle = m_factory(id);
+    vehicle.id = id;
+    vehicle.leader_id = leader_id;
+    if (!DecodeVehicle(p, n, vehicle)) {
+      std::cout << "domain " << m_rank << ": invalid state of ROM " << id
+                << std::endl;
+      vehicle.rom->RemoveFromSystem(m_system);
+    } else {
+      m_vehicles[id] = vehicle;
+      m_num_in++;
+    }
+    p += n;
+  }
+
+  for (uint32_t i = 0; ok && i < n_ghosts; i++) {
+    int id = Get<int32_t>(p, end, ok);
+    ChROM_Ghost ghost = GetGhost(p, end, ok);
+    if (ok)
+      m_ghosts[id] = ghost;
+  }
+}
+
+void ChROM_TrafficDomain::Advance(double time, double step) {
+  Exchange(time);
+
+  // leaders as they are at the beginning of the step, before any ROM of
+  // this domain moves
+  m_lead_distance.clear();
+  m_lead_speed.clear();
+  for (auto &entry : m_vehicles) {
+    ChROM_TrafficVehicle &vehicle = entry.second;
+    ChVector<> pos = vehicle.rom->GetPos();
+    double distance = ROM_DOMAIN_FREE_ROAD;
+    double speed = vehicle.rom->GetVel().Length();
+
+    auto local = m_vehicles.find(vehicle.leader_id);
+    auto ghost = m_ghosts.find(vehicle.leader_id);
+    if (local != m_vehicles.end()) {
+      distance = (local->second.rom->GetPos() - pos).Length();
+      speed = local->second.rom->GetVel().Length();
+    } else if (ghost != m_ghosts.end()) {
+      distance = (ghost->second.pos - pos).Length();
+      speed = ghost->second.vel.Length();
+    } else if (vehicle.leader_id >= 0) {
+      m_num_missing++;
+    }
+    m_lead_distance.push_back(distance);
+    m_lead_speed.push_back(speed);
+  }
+
+  double start = m_balance_period > 0 ? m_cost_clock() : 0.0;
+  size_t i = 0;
+  for (auto &entry : m_vehicles) {
+    ChROM_TrafficVehicle &vehicle = entry.second;
+    vehicle.idm->Synchronize(time, step, m_lead_distance[i], m_lead_speed[i]);
+    DriverInputs inputs = vehicle.driver->GetDriverInput();
+    if (m_input_filter)
+      m_input_filter(vehicle, inputs);
+    vehicle.rom->Advance(time, inputs);
+    i++;
+  }
+  if (m_balance_period > 0)
+    m_cost_sum += m_cost_clock() - start;
+  m_step++;
+}
+
+void ChROM_TrafficDomain::Balance() {
+  int axis = m_partition.GetStripAxis();
+  const std::vector<double> &cuts = m_partition.GetCuts(axis);
+  // bounds of this strip, as they will be once the new boundaries apply
+  double lo = m_rank > 0 ? cuts[m_rank - 1] : -HUGE_VAL;
+  double hi = m_rank < static_cast<int>(cuts.size()) ? cuts[m_rank] : HUGE_VAL;
+
+  // the lower boundary first, then the upper one, each keeping the strip
+  // at least one halo wide
+  std::vector<Link *> order;
+  for (Link &link : m_links) {
+    if (link.rank == m_rank - 1)
+      order.insert(order.begin(), &link);
+    else if (link.rank == m_rank + 1)
+      order.push_back(&link);
+  }
+
+  std::vector<double> distances;
+  for (Link *link : order) {
+    if (link->peer_load < 0.0 || m_load <= 0.0 ||
+        m_load <= (1.0 + m_balance_tolerance) * link->peer_load)
+      continue;
+
+    bool lower = link->rank < m_rank;
+    double cut = lower ? lo : hi;
+    distances.clear();
+    for (auto &entry : m_vehicles) {
+      ChVector<> pos = entry.second.rom->GetPos();
+      distances.push_back(std::abs((axis == 0 ? pos.x() : pos.y()) - cut));
+    }
+    std::sort(distances.begin(), distances.end());
+
+    // share of the ROMs to hand over, half the relative excess
+    size_t n = static_cast<size_t>(distances.size() *
+                                   (m_load - link->peer_load) /
+                                   (2.0 * m_load));
+    if (n == 0 || n >= distances.size())
+      continue;
+    double shift = 0.5 * (distances[n - 1] + distances[n]);
+    double limit = (hi - lo) - m_halo_width;
+    shift = std::min(shift, limit);
+    if (shift <= 0.0)
+      continue;
+
+    if (lower)
+      lo += shift;
+    else
+      hi -= shift;
+    link->pending_cut = lower ? lo : hi;
+  }
+}
+
+} // namespace hil
+} // namespace chrono
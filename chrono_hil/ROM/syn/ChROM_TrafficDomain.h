@@ -0,0 +1,241 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// Jason Zhou
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Authors: Jason Zhou
+// =============================================================================
+//
+// One traffic domain of a ROM simulation split across processes. Each domain
+// owns the ROMs (vehicle, path follower and IDM follower) inside its region
+// of a ChROM_DomainPartition, and is linked to its neighbour domains by a
+// ChHilTransport. At the beginning of every step the domains swap one frame
+// with each neighbour, carrying:
+//  - the complete state of the ROMs which left for the neighbour region,
+//    which the neighbour rebuilds with its vehicle factory;
+//  - the halo, pose and velocity of the ROMs within the halo width of the
+//    neighbour region, so that IDM leaders across the boundary resolve and
+//    the neighbour can show them.
+//
+// All IDM followers of a step see their leader as it was at the beginning of
+// the step, whichever domain owns it. A single domain with the same scenario
+// gives the same trajectories as any partition, as long as the halo is wider
+// than the largest leader gap.
+//
+// With balancing enabled, the boundaries of a partition into strips follow
+// the load. Every domain times the stepping of its ROMs; every period steps
+// the neighbours swap their mean cost per step. The more loaded side of a
+// boundary, if it is above the other by more than the tolerance, picks the
+// new position of the boundary so that the share of its ROMs closest to it
+// moves over. It sends the boundary in its next frame and moves it just
+// before it looks for migrants, the other side moves it on receipt; the
+// ROMs that changed side migrate with their full state as usual. A
+// boundary only moves into the region of the side that decided it, keeping
+// that region at least one halo width wide, so no ROM is ever claimed by
+// both sides.
+//
+// Frame layout, bytes packed in the float frame, little endian:
+//   header:  uint16 magic "DM", uint8 version, uint8 reserved,
+//            uint32 byte length, uint32 source domain, float64 time,
+//            uint32 n_migrants, uint32 n_ghosts, float64 load (mean cost
+//            per step of the last period [s], negative if not sent),
+//            float64 boundary (new position of the boundary with the
+//            receiver, NaN if unchanged)
+//   migrant: int32 id, int32 leader id, uint32 n, n bytes of state
+//   ghost:   int32 id, float64 pos[3], float64 vel[3], float64 rot[4],
+//            float64 steering, float64 tire_rotation[4]
+//
+// =============================================================================
+#ifndef CH_ROM_TRAFFIC_DOMAIN_H
+#define CH_ROM_TRAFFIC_DOMAIN_H
+
+#include "../../ChApiHil.h"
+#include "../../network/ChHilTransport.h"
+#include "../driver/ChROM_IDMFollower.h"
+#include "../driver/ChROM_PathFollowerDriver.h"
+#include "../veh/Ch_8DOF_vehicle.h"
+#include "ChROM_DomainPartition.h"
+
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <memory>
+#include <vector>
+
+namespace chrono {
+namespace hil {
+
+#define ROM_DOMAIN_MAGIC 0x4D44 // "DM"
+#define ROM_DOMAIN_VERSION 4
+#define ROM_DOMAIN_HEADER_SIZE 44
+#define ROM_DOMAIN_GHOST_SIZE 124
+
+// lead distance used when a ROM has no leader, or its leader is out of reach
+#define ROM_DOMAIN_FREE_ROAD 1000.0
+
+/// A ROM and its drivers, as stepped by a traffic domain
+struct ChROM_TrafficVehicle {
+  int id = -1;        ///< global ROM id
+  int leader_id = -1; ///< ROM followed by the IDM, -1 for none
+  std::shared_ptr<Ch_8DOF_vehicle> rom;
+  std::shared_ptr<ChROM_PathFollowerDriver> driver;
+  std::shared_ptr<ChROM_IDMFollower> idm;
+};
+
+/// ROM owned by a neighbour domain, as seen through the halo
+struct ChROM_Ghost {
+  ChVector<> pos;
+  ChVector<> vel;
+  ChQuaternion<> rot;
+  double steering = 0.0;
+  double tire_rotation[4] = {0.0, 0.0, 0.0, 0.0};
+};
+
+class CH_HIL_API ChROM_TrafficDomain {
+public:
+  /// Build ROM id with its drivers as the scenario defines them, and
+  /// initialize it in the system of the domain. Used for the ROMs migrating
+  /// in, their state is restored right after.
+  typedef std::function<ChROM_TrafficVehicle(int id)> VehicleFactory;
+
+  /// Adjust the driver inputs of a ROM before it advances
+  typedef std::function<void(const ChROM_TrafficVehicle &, DriverInputs &)>
+      InputFilter;
+
+  /// Create domain rank of partition. ROMs leaving the domain are removed
+  /// from system.
+  ChROM_TrafficDomain(const ChROM_DomainPartition &partition, int rank,
+                      ChSystem *system, VehicleFactory factory);
+
+  /// Link to the neighbour domain rank. Domains only exchange ROMs and halo
+  /// with the domains they are linked to.
+  void AddLink(int rank, std::shared_ptr<ChHilTransport> link);
+
+  /// Wait for all links to be up
+  void Initialize();
+
+  /// ROMs within width [m] of a neighbour region are sent to its halo
+  void SetHaloWidth(double width) { m_halo_width = width; }
+
+  void SetInputFilter(InputFilter filter) { m_input_filter = filter; }
+
+  /// Move the boundaries with the neighbours to even out the load, judged
+  /// every period steps. A boundary moves when one side costs more than
+  /// (1 + tolerance) times the other. Only partitions into strips are
+  /// balanced, and all domains must use the same settings.
+  void EnableBalancing(int period, double tolerance = 0.2);
+
+  /// Clock timing the stepping of the ROMs [s], the steady clock by default.
+  /// A thread CPU clock ignores the time the domain is preempted.
+  void SetCostClock(std::function<double()> clock) { m_cost_clock = clock; }
+
+  /// Add a ROM of the scenario. Returns false, and ignores the ROM, if it
+  /// lies outside the region of this domain.
+  bool AddVehicle(const ChROM_TrafficVehicle &vehicle);
+
+  /// Advance the domain by one step: swap migrating ROMs and halo with the
+  /// neighbours, synchronize the IDM followers of all ROMs with their
+  /// leaders, then advance the ROMs. Blocks until every neighbour has sent
+  /// its frame for this step.
+  void Advance(double time, double step);
+
+  /// ROMs currently owned by this domain, by id
+  const std::map<int, ChROM_TrafficVehicle> &GetVehicles() const {
+    return m_vehicles;
+  }
+
+  int GetRank() const { return m_rank; }
+  int GetNumGhosts() const { return static_cast<int>(m_ghosts.size()); }
+
+  /// ROMs of the neighbours within the halo width of this region, by id, as
+  /// of the last exchange
+  const std::map<int, ChROM_Ghost> &GetGhosts() const { return m_ghosts; }
+  uint64_t GetNumMigratedIn() const { return m_num_in; }
+  uint64_t GetNumMigratedOut() const { return m_num_out; }
+
+  /// Number of IDM synchronizations whose leader was not found, neither in
+  /// this domain nor in the halo
+  uint64_t GetNumMissingLeaders() const { return m_num_missing; }
+
+  /// Mean cost per step of the last balancing period [s]
+  double GetLoad() const { return m_load; }
+
+  /// Boundary moves decided by this domain or its neighbours
+  uint64_t GetNumRebalances() const { return m_num_rebalances; }
+
+  /// Current partition, with the boundaries moved by balancing
+  const ChROM_DomainPartition &GetPartition() const { return m_partition; }
+
+  /// Serialize the complete state of a ROM and its drivers
+  static void EncodeVehicle(const ChROM_TrafficVehicle &vehicle,
+                            std::vector<uint8_t> &buffer);
+
+  /// Restore the state serialized by EncodeVehicle into a ROM built the same
+  /// way, returns false if the data is damaged
+  static bool DecodeVehicle(const uint8_t *data, size_t len,
+                            ChROM_TrafficVehicle &vehicle);
+
+private:
+  struct Link {
+    int rank;
+    std::shared_ptr<ChHilTransport> transport;
+    std::vector<uint8_t> out;
+    uint32_t n_migrants;
+    uint32_t n_ghosts;
+    double peer_load;   // load received in this step, negative if none
+    double pending_cut; // boundary to send in the next step, NaN if none
+  };
+
+  void Exchange(double time);
+  void Receive(Link &link, const std::vector<float> &frame);
+
+  /// Pick the new boundaries with the less loaded neighbours
+  void Balance();
+
+  /// Index of the cut between this domain and neighbour rank, -1 if they
+  /// do not share a strip boundary
+  int GetCutIndex(int rank) const;
+
+  ChROM_DomainPartition m_partition;
+  int m_rank;
+  ChSystem *m_system;
+  VehicleFactory m_factory;
+  InputFilter m_input_filter;
+  double m_halo_width = 50.0;
+
+  std::vector<Link> m_links;
+  std::map<int, ChROM_TrafficVehicle> m_vehicles;
+  std::map<int, ChROM_Ghost> m_ghosts;
+
+  // scratch buffers, reused from step to step
+  std::vector<uint8_t> m_state;
+  std::vector<float> m_frame;
+  std::vector<int> m_halo_domains;
+  std::vector<double> m_lead_distance;
+  std::vector<double> m_lead_speed;
+
+  uint64_t m_num_in = 0;
+  uint64_t m_num_out = 0;
+  uint64_t m_num_missing = 0;
+  bool m_warned_link = false;
+
+  // load balancing
+  int m_balance_period = 0;
+  double m_balance_tolerance = 0.2;
+  std::function<double()> m_cost_clock;
+  int m_step = 0;
+  double m_cost_sum = 0.0;
+  double m_load = 0.0;
+  uint64_t m_num_rebalances = 0;
+};
+
+} // namespace hil
+} // namespace chrono
+
+#endif
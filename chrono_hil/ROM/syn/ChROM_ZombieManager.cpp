@@ -0,0 +1,147 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// Jason Zhou
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Authors: Jason Zhou
+// =============================================================================
+//
+// Client side of the ROM area-of-interest filter. Spawns, updates and
+// despawns 8DOF zombies according to the frames built by
+// ChROM_InterestFilter. Despawned zombies are hidden and pooled for reuse.
+//
+// =============================================================================
+#include "ChROM_ZombieManager.h"
+
+#include <iostream>
+
+namespace chrono {
+namespace hil {
+
+ChROM_ZombieManager::ChROM_ZombieManager(
+    ChSystem *sys, std::function<std::string(int)> json_lookup, float z_plane,
+    bool vis) {
+  m_sys = sys;
+  m_json_lookup = json_lookup;
+  m_z_plane = z_plane;
+  m_vis = vis;
+}
+
+void ChROM_ZombieManager::Spawn(int id) {
+  if (m_active.count(id))
+    return;
+
+  std::string rom_json = m_json_lookup(id);
+  auto &pool = m_pool[rom_json];
+
+  std::shared_ptr<Ch_8DOF_zombie> zombie;
+  if (!pool.empty()) {
+    zombie = pool.back();
+    pool.pop_back();
+    zombie->SetVisible(true);
+    zombie->GetSnapshotBuffer().Clear();
+  } else {
+    zombie = chrono_types::make_shared<Ch_8DOF_zombie>(rom_json, m_z_plane,
+                                                       m_vis);
+    zombie->Initialize(m_sys);
+    zombie->GetSnapshotBuffer().SetPlayoutDelay(m_playout_delay);
+    m_num_created++;
+  }
+
+  m_active[id] = zombie;
+}
+
+void ChROM_ZombieManager::Despawn(int id) {
+  auto it = m_active.find(id);
+  if (it == m_active.end())
+    return;
+
+  it->second->SetVisible(false);
+  m_pool[m_json_lookup(id)].push_back(it->second);
+  m_active.erase(it);
+}
+
+void ChROM_ZombieManager::Apply(const std::vector<float> &frame,
+                                int state_len) {
+  ApplyFrame(frame, state_len, false, 0.0);
+}
+
+void ChROM_ZombieManager::ApplyTimed(const std::vector<float> &frame,
+                                     double time, int state_len) {
+  ApplyFrame(frame, state_len, true, time);
+}
+
+void ChROM_ZombieManager::ApplyFrame(const std::vector<float> &frame,
+                                     int state_len, bool timed, double time) {
+  if (frame.size() < 3) {
+    std::cout << "ROM zombie manager: malformed frame" << std::endl;
+    return;
+  }
+
+  int n_spawn = frame[0];
+  int n_despawn = frame[1];
+  int n_update = frame[2];
+
+  if (frame.size() !=
+      3 + n_spawn + n_despawn + n_update * (state_len + 1)) {
+    std::cout << "ROM zombie manager: malformed frame" << std::endl;
+    return;
+  }
+
+  int idx = 3;
+  for (int i = 0; i < n_spawn; i++)
+    Spawn(frame[idx++]);
+  for (int i = 0; i < n_despawn; i++)
+    Despawn(frame[idx++]);
+
+  for (int i = 0; i < n_update; i++) {
+    int id = frame[idx];
+    const float *s = &frame[idx + 1];
+    idx += state_len + 1;
+
+    auto it = m_active.find(id);
+    if (it == m_active.end())
+      continue;
+
+    if (timed) {
+      it->second->Update(time, ChVector<>(s[0], s[1], s[2]),
+                         ChVector<>(s[3], s[4], s[5]), s[6], s[7], s[8], s[9],
+                         s[10]);
+    } else {
+      it->second->Update(ChVector<>(s[0], s[1], s[2]),
+                         ChVector<>(s[3], s[4], s[5]), s[6], s[7], s[8], s[9],
+                         s[10]);
+    }
+  }
+}
+
+void ChROM_ZombieManager::Advance(double time) {
+  for (auto &active : m_active)
+    active.second->Advance(time);
+}
+
+void ChROM_ZombieManager::SetPlayoutDelay(double delay) {
+  m_playout_delay = delay;
+  for (auto &active : m_active)
+    active.second->GetSnapshotBuffer().SetPlayoutDelay(delay);
+  for (auto &pool : m_pool) {
+    for (auto &zombie : pool.second)
+      zombie->GetSnapshotBuffer().SetPlayoutDelay(delay);
+  }
+}
+
+std::shared_ptr<Ch_8DOF_zombie> ChROM_ZombieManager::GetZombie(int id) {
+  auto it = m_active.find(id);
+  if (it == m_active.end())
+    return nullptr;
+  return it->second;
+}
+
+} // namespace hil
+} // namespace chrono
@@ -0,0 +1,87 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// Jason Zhou
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Authors: Jason Zhou
+// =============================================================================
+//
+// Client side of the ROM area-of-interest filter. Spawns, updates and
+// despawns 8DOF zombies according to the frames built by
+// ChROM_InterestFilter. Despawned zombies are hidden and pooled for reuse.
+//
+// =============================================================================
+#ifndef CH_ROM_ZOMBIE_MANAGER_H
+#define CH_ROM_ZOMBIE_MANAGER_H
+
+#include "../../ChApiHil.h"
+#include "Ch_8DOF_zombie.h"
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace chrono {
+namespace hil {
+
+class CH_HIL_API ChROM_ZombieManager {
+public:
+  /// Create a zombie manager. json_lookup returns the ROM json file of the
+  /// ROM with the given id, zombies with the same json file share a pool.
+  ChROM_ZombieManager(ChSystem *sys,
+                      std::function<std::string(int)> json_lookup,
+                      float z_plane, bool vis = false);
+
+  /// Apply a frame received from the distributor (see ChROM_InterestFilter).
+  /// state_len is the number of floats describing one ROM.
+  void Apply(const std::vector<float> &frame, int state_len = 11);
+
+  /// Apply a frame received at the given time. Updates are queued in the
+  /// jitter buffer of each zombie, which is posed by Advance.
+  void ApplyTimed(const std::vector<float> &frame, double time,
+                  int state_len = 11);
+
+  /// Pose all active zombies at the given time, see Ch_8DOF_zombie::Advance
+  void Advance(double time);
+
+  /// Playout delay of the jitter buffer of all zombies [s]
+  void SetPlayoutDelay(double delay);
+
+  /// Get the zombie of an active ROM, nullptr if the ROM is not of interest
+  std::shared_ptr<Ch_8DOF_zombie> GetZombie(int id);
+
+  /// Number of zombies currently spawned
+  int GetNumActive() { return m_active.size(); }
+
+  /// Number of zombies created so far, active and pooled
+  int GetNumCreated() { return m_num_created; }
+
+private:
+  void Spawn(int id);
+  void Despawn(int id);
+  void ApplyFrame(const std::vector<float> &frame, int state_len, bool timed,
+                  double time);
+
+  ChSystem *m_sys;
+  std::function<std::string(int)> m_json_lookup;
+  float m_z_plane;
+  bool m_vis;
+  int m_num_created = 0;
+  double m_playout_delay = 0.05;
+
+  std::map<int, std::shared_ptr<Ch_8DOF_zombie>> m_active;
+  std::map<std::string, std::vector<std::shared_ptr<Ch_8DOF_zombie>>> m_pool;
+};
+
+} // namespace hil
+} // namespace chrono
+
+#endif
@@ -74,6 +74,40 @@ Ch_8DOF_zombie::Ch_8DOF_zombie(std::string rom_json, float z_plane, bool vis) {
 void Ch_8DOF_zombie::Update(ChVector<> pos, ChVector<> rot, float steering,
                             float tire_rot_0, float tire_rot_1,
                             float tire_rot_2, float tire_rot_3) {
+  float tire_rot[4] = {tire_rot_0, tire_rot_1, tire_rot_2, tire_rot_3};
+  SetPose(pos, rot, steering, tire_rot);
+}
+
+void Ch_8DOF_zombie::Update(double time, ChVector<> pos, ChVector<> rot,
+                            float steering, float tire_rot_0, float tire_rot_1,
+                            float tire_rot_2, float tire_rot_3) {
+  chrono::hil::ChROM_Snapshot snap;
+  snap.pos = pos;
+  snap.rot = rot;
+  snap.steering = steering;
+  snap.tire_rot[0] = tire_rot_0;
+  snap.tire_rot[1] = tire_rot_1;
+  snap.tire_rot[2] = tire_rot_2;
+  snap.tire_rot[3] = tire_rot_3;
+  snapshots.Push(time, snap);
+}
+
+void Ch_8DOF_zombie::Advance(double time) {
+  chrono::hil::ChROM_Snapshot snap;
+  if (!snapshots.Sample(time, snap))
+    return;
+
+  float tire_rot[4];
+  for (int i = 0; i < 4; i++)
+    tire_rot[i] = snap.tire_rot[i];
+  SetPose(snap.pos, snap.rot, snap.steering, tire_rot);
+}
+
+void Ch_8DOF_zombie::SetPose(ChVector<> pos, ChVector<> rot, float steering,
+                             const float tire_rot[4]) {
+  rom_pos = pos;
+  rom_rot = Q_from_Euler123(rot);
+
   if (enable_vis) {
     chassis_body->SetPos(pos);
 
@@ -81,10 +115,8 @@ void Ch_8DOF_zombie::Update(ChVector<> pos, ChVector<> rot, float steering,
 
     ChFrame<> chassis_body_fr = ChFrame<>(pos, Q_from_Euler123(rot));
 
-    tire_rotation[0] = tire_rot_0;
-    tire_rotation[1] = tire_rot_1;
-    tire_rotation[2] = tire_rot_2;
-    tire_rotation[3] = tire_rot_3;
+    for (int i = 0; i < 4; i++)
+      tire_rotation[i] = tire_rot[i];
 
     ChFrame<> X_LF =
         chassis_body_fr * ChFrame<>(wheels_offset_pos[0], wheels_offset_rot[0]);
@@ -210,6 +242,21 @@ void Ch_8DOF_zombie::Initialize(ChSystem *sys) {
   }
 }
 
+void Ch_8DOF_zombie::SetVisible(bool visible) {
+  is_visible = visible;
+
+  if (!enable_vis)
+    return;
+
+  for (auto &shape : chassis_body->GetVisualModel()->GetShapes())
+    shape.first->SetVisible(visible);
+
+  for (int i = 0; i < 4; i++) {
+    for (auto &shape : wheels_body[i]->GetVisualModel()->GetShapes())
+      shape.first->SetVisible(visible);
+  }
+}
+
 ChVector<> Ch_8DOF_zombie::GetPos() { return rom_pos; }
 
 ChQuaternion<> Ch_8DOF_zombie::GetRot() { return rom_rot; }
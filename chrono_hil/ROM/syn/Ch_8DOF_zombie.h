@@ -19,6 +19,7 @@
 #define CH_EIGHT_ROM_ZOMBIE_H
 
 #include "../../ChApiHil.h"
+#include "ChROM_SnapshotBuffer.h"
 #include "chrono/core/ChQuaternion.h"
 #include "chrono/core/ChVector.h"
 #include "chrono/physics/ChBodyAuxRef.h"
@@ -40,10 +41,29 @@ public:
   void Update(ChVector<> pos, ChVector<> rot, float steering, float tire_rot_0,
               float tire_rot_1, float tire_rot_2, float tire_rot_3);
 
+  /// Queue the state of the ROM at the given time. The zombie is posed by
+  /// Advance, with the playout delay of the snapshot buffer.
+  void Update(double time, ChVector<> pos, ChVector<> rot, float steering,
+              float tire_rot_0, float tire_rot_1, float tire_rot_2,
+              float tire_rot_3);
+
+  /// Pose the zombie at the given time from the queued states, interpolated
+  /// or dead-reckoned. Does nothing if no state was queued yet.
+  void Advance(double time);
+
+  /// Jitter buffer of the states queued by Update, e.g. to set its delay
+  chrono::hil::ChROM_SnapshotBuffer &GetSnapshotBuffer() { return snapshots; }
+
   void SetPos(ChVector<> pos);
 
   void SetRot(float roll, float yaw);
 
+  /// Show or hide the zombie, used to park pooled zombies which are currently
+  /// not of interest to this node
+  void SetVisible(bool visible);
+
+  bool IsVisible() { return is_visible; }
+
   ChVector<> GetPos();
 
   ChQuaternion<> GetRot();
@@ -51,8 +71,12 @@ public:
   std::shared_ptr<ChBodyAuxRef> GetChassisBody();
 
 private:
+  void SetPose(ChVector<> pos, ChVector<> rot, float steering,
+               const float tire_rot[4]);
+
   float rom_z_plane;
   bool enable_vis;
+  bool is_visible = true;
 
   std::string chassis_mesh;
   std::string wheel_mesh;
@@ -68,6 +92,8 @@ private:
 
   float tire_rotation[4];
   float max_steer_angle;
+
+  chrono::hil::ChROM_SnapshotBuffer snapshots;
 };
 
 #endif
@@ -0,0 +1,222 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// Jason Zhou
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Authors: Jason Zhou
+// =============================================================================
+//
+// SynChrono agent for 8DOF ROM vehicles
+//
+// =============================================================================
+#include "SynRomVehicleAgent.h"
+
+#include "chrono_synchrono/communication/dds/idl/SynDDSMessage.h"
+#include "chrono_synchrono/communication/dds/idl/SynDDSMessagePubSubTypes.h"
+
+#include <algorithm>
+#include <iterator>
+
+using namespace chrono::synchrono;
+
+namespace chrono {
+namespace hil {
+
+SynRomVehicleAgent::SynRomVehicleAgent(
+    std::shared_ptr<SynDDSCommunicator> communicator, ChSystem *system)
+    : m_communicator(communicator), m_system(system) {}
+
+SynRomVehicleAgent::~SynRomVehicleAgent() {
+  // stop the listener before the message it fills goes away
+  m_subscriber.reset();
+  delete static_cast<SynDDSMessage *>(m_incoming);
+}
+
+void SynRomVehicleAgent::AddVehicle(int id,
+                                    std::shared_ptr<Ch_8DOF_vehicle> rom) {
+  m_local.push_back(std::make_pair(id, rom));
+}
+
+void SynRomVehicleAgent::SetZombieManager(ChROM_ZombieManager *zombie_manager,
+                                          bool timed) {
+  m_zombie_manager = zombie_manager;
+  m_timed = timed;
+}
+
+void SynRomVehicleAgent::AddState(int id, Ch_8DOF_vehicle &rom) {
+  m_out_batch.states.emplace_back();
+  ChROM_State &s = m_out_batch.states.back();
+  s.id = id;
+  s.pos = rom.GetPos();
+  s.rot = rom.GetRot().Q_to_Euler123();
+  s.steering = rom.GetDriverInputs().m_steering;
+  for (int w = 0; w < 4; w++)
+    s.tire_rot[w] = rom.GetTireRotation(w);
+}
+
+void SynRomVehicleAgent::CreateEndpoints() {
+  // one topic shared by all nodes, each node skips its own batches
+  auto topic = m_communicator->CreateTopic(
+      "rom", new SynDDSMessagePubSubType(), "/syn/");
+  m_publisher = m_communicator->CreatePublisher(topic);
+
+  // asynchronous and not managed by the communicator: batches are taken by
+  // the listener thread and never hold up the heartbeat
+  m_incoming = new SynDDSMessage();
+  m_subscriber = m_communicator->CreateSubscriber(
+      topic, [this](void *message) { OnBatch(message); }, m_incoming, false,
+      false);
+}
+
+void SynRomVehicleAgent::OnBatch(void *message) {
+  auto *dds_message = static_cast<SynDDSMessage *>(message);
+  const std::vector<uint8_t> &data = dds_message->data();
+
+  ChROM_StateBatch batch;
+  if (!batch.Decode(data.data(), data.size()) ||
+      batch.source == m_agent_key.GetNodeID())
+    return;
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto it = m_remote.find(batch.source);
+  if (it != m_remote.end() && it->second.time > batch.time)
+    return; // older than the batch shown
+  int source = batch.source;
+  m_remote[source] = std::move(batch);
+  m_changed.insert(source);
+  m_num_received++;
+  m_bytes_received += data.size();
+}
+
+void SynRomVehicleAgent::Update() {
+  if (!m_publisher)
+    CreateEndpoints();
+
+  // publish the ROMs of this node
+  size_t n_domain = m_domain ? m_domain->GetVehicles().size() : 0;
+  if (!m_local.empty() || n_domain > 0) {
+    m_out_batch.time = m_system->GetChTime();
+    m_out_batch.source = m_agent_key.GetNodeID();
+    m_out_batch.states.clear();
+    for (auto &local : m_local)
+      AddState(local.first, *local.second);
+    if (m_domain) {
+      for (auto &entry : m_domain->GetVehicles())
+        AddState(entry.first, *entry.second.rom);
+    }
+    m_out_batch.Encode(m_out_buffer);
+
+    SynDDSMessage message;
+    message.rank(m_agent_key.GetNodeID());
+    message.data(m_out_buffer);
+    m_publisher->Publish(&message);
+    m_num_sent++;
+    m_bytes_sent += m_out_buffer.size();
+  }
+
+  if (!m_zombie_manager)
+    return;
+
+  // merge the newest batch of each node into zombie manager frames,
+  // [n_spawn, n_despawn, n_update, spawn ids, despawn ids,
+  //  (id, pos, rot, steering, tire_rot[4]) * n_update]
+  // one per batch time when timed, the spawns and despawns in the first
+  struct Newest {
+    double time;
+    int source;
+    const ChROM_State *state;
+  };
+  std::set<int> current;
+  std::map<int, Newest> newest;
+  std::map<double, std::vector<const ChROM_State *>> updates;
+  double time = 0.0;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_changed.empty())
+      return;
+
+    // a ROM in two batches, while it migrates, takes the newer state
+    for (auto &remote : m_remote) {
+      time = std::max(time, remote.second.time);
+      for (const ChROM_State &s : remote.second.states) {
+        auto it = newest.find(s.id);
+        if (it == newest.end() || it->second.time < remote.second.time)
+          newest[s.id] = {remote.second.time, remote.first, &s};
+      }
+    }
+
+    // only the states of new batches are queued again, and new ROMs
+    for (auto &entry : newest) {
+      current.insert(entry.first);
+      m_last_seen[entry.first] = entry.second.time;
+      if (m_changed.count(entry.second.source) || !m_shown.count(entry.first))
+        updates[m_timed ? entry.second.time : 0.0].push_back(
+            entry.second.state);
+    }
+    m_changed.clear();
+
+    // ROMs missing for less than the grace stay shown, without update
+    for (int id : m_shown) {
+      if (current.count(id))
+        continue;
+      if (time - m_last_seen[id] < m_despawn_grace)
+        current.insert(id);
+      else
+        m_last_seen.erase(id);
+    }
+
+    std::vector<int> spawn, despawn;
+    std::set_difference(current.begin(), current.end(), m_shown.begin(),
+                        m_shown.end(), std::back_inserter(spawn));
+    std::set_difference(m_shown.begin(), m_shown.end(), current.begin(),
+                        current.end(), std::back_inserter(despawn));
+
+    m_frames.resize(std::max<size_t>(updates.size(), 1));
+    auto group = updates.begin();
+    for (size_t f = 0; f < m_frames.size(); f++) {
+      std::vector<float> &frame = m_frames[f].second;
+      size_t n_update = group == updates.end() ? 0 : group->second.size();
+      m_frames[f].first = group == updates.end() ? time : group->first;
+      frame.clear();
+      frame.push_back(f == 0 ? spawn.size() : 0);
+      frame.push_back(f == 0 ? despawn.size() : 0);
+      frame.push_back(n_update);
+      if (f == 0) {
+        frame.insert(frame.end(), spawn.begin(), spawn.end());
+        frame.insert(frame.end(), despawn.begin(), despawn.end());
+      }
+      if (group == updates.end())
+        continue;
+      for (const ChROM_State *s : group->second) {
+        frame.push_back(s->id);
+        frame.push_back(s->pos.x());
+        frame.push_back(s->pos.y());
+        frame.push_back(s->pos.z());
+        frame.push_back(s->rot.x());
+        frame.push_back(s->rot.y());
+        frame.push_back(s->rot.z());
+        frame.push_back(s->steering);
+        for (int w = 0; w < 4; w++)
+          frame.push_back(s->tire_rot[w]);
+      }
+      ++group;
+    }
+  }
+  m_shown.swap(current);
+
+  for (auto &frame : m_frames) {
+    if (m_timed)
+      m_zombie_manager->ApplyTimed(frame.second, frame.first);
+    else
+      m_zombie_manager->Apply(frame.second);
+  }
+}
+
+} // namespace hil
+} // namespace chrono
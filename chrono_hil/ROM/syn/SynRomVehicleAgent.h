@@ -0,0 +1,162 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// Jason Zhou
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Authors: Jason Zhou
+// =============================================================================
+//
+// SynChrono agent for 8DOF ROM vehicles. Every node adds one such agent to
+// its SynChronoManager. On each heartbeat the agent publishes the ROMs
+// simulated on its node as one ChROM_StateBatch on the "rom" DDS topic, and
+// shows the ROMs published by the other nodes through a ChROM_ZombieManager.
+//
+// The SynChrono message factory only knows its built-in flatbuffer types, so
+// ROM batches travel on their own topic of the SynDDSCommunicator rather than
+// in the SynChronoManager message list. They still follow the heartbeat and
+// never block: a node shows the newest batch received from each peer.
+//
+// A node running a ChROM_TrafficDomain publishes the ROMs its domain owns at
+// each heartbeat (SetTrafficDomain). A ROM migrating between two domains
+// then leaves the batch of one node before it shows up in the batch of the
+// other; with a despawn grace its zombie stays in place meanwhile instead of
+// being removed and spawned again. If a ROM is in the batches of two nodes,
+// the newer batch wins.
+//
+// =============================================================================
+#ifndef CH_SYN_ROM_VEHICLE_AGENT_H
+#define CH_SYN_ROM_VEHICLE_AGENT_H
+
+#include "../../ChApiHil.h"
+#include "../veh/Ch_8DOF_vehicle.h"
+#include "ChROM_StateBatch.h"
+#include "ChROM_TrafficDomain.h"
+#include "ChROM_ZombieManager.h"
+
+#include "chrono_synchrono/agent/SynAgent.h"
+#include "chrono_synchrono/communication/dds/SynDDSCommunicator.h"
+#include "chrono_synchrono/communication/dds/SynDDSPublisher.h"
+#include "chrono_synchrono/communication/dds/SynDDSSubscriber.h"
+
+#include <atomic>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace chrono {
+namespace hil {
+
+class CH_HIL_API SynRomVehicleAgent : public synchrono::SynAgent {
+public:
+  /// Create the ROM agent of this node. system provides the time stamp of
+  /// the published states.
+  SynRomVehicleAgent(
+      std::shared_ptr<synchrono::SynDDSCommunicator> communicator,
+      ChSystem *system);
+
+  ~SynRomVehicleAgent();
+
+  /// Publish the state of a ROM simulated on this node, id is the global id
+  /// of the ROM (unique across nodes, below 65536)
+  void AddVehicle(int id, std::shared_ptr<Ch_8DOF_vehicle> rom);
+
+  /// Also publish the ROMs owned by domain at the time of each heartbeat,
+  /// which change as ROMs migrate
+  void SetTrafficDomain(ChROM_TrafficDomain *domain) { m_domain = domain; }
+
+  /// Keep showing a ROM missing from the batches for up to grace seconds of
+  /// simulation time, e.g. while it migrates between two nodes
+  void SetDespawnGrace(double grace) { m_despawn_grace = grace; }
+
+  /// Show the ROMs of the other nodes with zombie_manager. With timed set,
+  /// states are queued with the time stamp of their batch
+  /// (ChROM_ZombieManager::ApplyTimed) and the caller advances the zombie
+  /// manager every step.
+  void SetZombieManager(ChROM_ZombieManager *zombie_manager,
+                        bool timed = false);
+
+  // ------------------------------------------------------------------------
+  // SynAgent interface
+
+  /// ROM agents are not zombified by SynChrono, each node has its own agent
+  virtual void InitializeZombie(ChSystem *system) override {}
+  virtual void
+  SynchronizeZombie(std::shared_ptr<synchrono::SynMessage> message) override {}
+
+  /// Publish the ROMs of this node and show the newest ROMs of the others,
+  /// called by SynChronoManager on each heartbeat
+  virtual void Update() override;
+
+  /// ROM batches use their own topic, see Update
+  virtual void GatherMessages(synchrono::SynMessageList &messages) override {}
+  virtual void
+  GatherDescriptionMessages(synchrono::SynMessageList &messages) override {}
+
+  virtual void SetKey(synchrono::AgentKey agent_key) override {
+    m_agent_key = agent_key;
+  }
+
+  // ------------------------------------------------------------------------
+
+  uint64_t GetNumBatchesSent() const { return m_num_sent; }
+  uint64_t GetNumBatchesReceived() const { return m_num_received; }
+  uint64_t GetBytesSent() const { return m_bytes_sent; }
+  uint64_t GetBytesReceived() const { return m_bytes_received; }
+
+  /// Number of ROMs of other nodes currently shown
+  int GetNumShown() const { return static_cast<int>(m_shown.size()); }
+
+private:
+  void CreateEndpoints();
+
+  /// Append the state of rom to the outgoing batch
+  void AddState(int id, Ch_8DOF_vehicle &rom);
+
+  /// Called by the DDS listener thread
+  void OnBatch(void *message);
+
+  std::shared_ptr<synchrono::SynDDSCommunicator> m_communicator;
+  std::shared_ptr<synchrono::SynDDSPublisher> m_publisher;
+  std::shared_ptr<synchrono::SynDDSSubscriber> m_subscriber;
+  void *m_incoming = nullptr; // SynDDSMessage filled in by the subscriber
+  ChSystem *m_system;
+
+  std::vector<std::pair<int, std::shared_ptr<Ch_8DOF_vehicle>>> m_local;
+  ChROM_TrafficDomain *m_domain = nullptr;
+  ChROM_StateBatch m_out_batch;
+  std::vector<uint8_t> m_out_buffer;
+
+  ChROM_ZombieManager *m_zombie_manager = nullptr;
+  bool m_timed = false;
+
+  // newest batch of each other node, filled by the listener thread
+  std::mutex m_mutex;
+  std::map<int, ChROM_StateBatch> m_remote;
+  std::set<int> m_changed; // nodes with a new batch since the last Update
+
+  std::set<int> m_shown;
+  std::map<int, double> m_last_seen; // batch time a shown ROM was last in
+  double m_despawn_grace = 0.0;
+  // zombie manager frames of an Update, with the batch time of their states
+  std::vector<std::pair<double, std::vector<float>>> m_frames;
+
+  uint64_t m_num_sent = 0;
+  uint64_t m_bytes_sent = 0;
+  // written by the listener thread
+  std::atomic<uint64_t> m_num_received{0};
+  std::atomic<uint64_t> m_bytes_received{0};
+};
+
+} // namespace hil
+} // namespace chrono
+
+#endif
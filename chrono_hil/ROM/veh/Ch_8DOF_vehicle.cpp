@@ -448,4 +448,40 @@ float Ch_8DOF_vehicle::GetTireRotation(int idx) {
   return prev_tire_rotation[idx];
 }
 
-DriverInputs Ch_8DOF_vehicle::GetDriverInputs() { return m_inputs; }
\ No newline at end of file
+DriverInputs Ch_8DOF_vehicle::GetDriverInputs() { return m_inputs; }
+
+void Ch_8DOF_vehicle::GetState(Ch_8DOF_state &state) {
+  state.veh = veh1_st;
+  state.tires[0] = tirelf_st;
+  state.tires[1] = tirerf_st;
+  state.tires[2] = tirelr_st;
+  state.tires[3] = tirerr_st;
+  state.inputs = m_inputs;
+  for (int i = 0; i < 4; i++)
+    state.tire_rotation[i] = prev_tire_rotation[i];
+}
+
+void Ch_8DOF_vehicle::SetState(const Ch_8DOF_state &state) {
+  veh1_st = state.veh;
+  tirelf_st = state.tires[0];
+  tirerf_st = state.tires[1];
+  tirelr_st = state.tires[2];
+  tirerr_st = state.tires[3];
+  m_inputs = state.inputs;
+  for (int i = 0; i < 4; i++)
+    prev_tire_rotation[i] = state.tire_rotation[i];
+
+  // the path follower looks ahead from the chassis body
+  if (enable_vis && chassis_body) {
+    chassis_body->SetPos(this->GetPos());
+    chassis_body->SetRot(this->GetRot());
+  }
+}
+
+void Ch_8DOF_vehicle::RemoveFromSystem(ChSystem *sys) {
+  if (!enable_vis || !chassis_body)
+    return;
+  sys->RemoveBody(chassis_body);
+  for (int i = 0; i < 4; i++)
+    sys->RemoveBody(wheels_body[i]);
+}
@@ -32,6 +32,15 @@ using namespace chrono;
 using namespace chrono::vehicle;
 using namespace chrono::geometry;
 
+/// Complete dynamic state of an 8DOF ROM. Parameters are not included, they
+/// come from the ROM json file.
+struct Ch_8DOF_state {
+  VehicleState veh;
+  TMeasyState tires[4]; ///< LF, RF, LR, RR
+  DriverInputs inputs;  ///< last driver inputs
+  float tire_rotation[4];
+};
+
 // Class definition for the 8DOF Reduced-Order Vehicle Model (ROM).
 class CH_HIL_API Ch_8DOF_vehicle {
 
@@ -90,6 +99,17 @@ public:
   /// Return the current engine speed
   double GetMotorSpeed() { return veh1_st.m_motor_speed; }
 
+  /// Copy the complete dynamic state of the 8DOF ROM, used to hand the ROM
+  /// over to another process
+  void GetState(Ch_8DOF_state &state);
+
+  /// Restore a state obtained with GetState on a ROM built from the same
+  /// json file. The chassis body follows, the wheels on the next Advance.
+  void SetState(const Ch_8DOF_state &state);
+
+  /// Remove the visualization bodies added by Initialize from sys
+  void RemoveFromSystem(ChSystem *sys);
+
 private:
   bool enable_vis; ///< Whether visualization is enabled. Note that if
                    ///< enable_vis is set to false, no communication will happen
@@ -0,0 +1,129 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// Jason Zhou
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Authors: Jason Zhou
+// =============================================================================
+//
+// Rate-limited, event-driven bridge between an SDL joystick and a simulator
+//
+// =============================================================================
+
+#include "ChJoystickBridge.h"
+#include "../timer/ChLatencyMonitor.h"
+
+#include <algorithm>
+#include <cmath>
+#include <poll.h>
+
+namespace chrono {
+namespace hil {
+
+ChJoystickBridge::ChJoystickBridge(ChSDLInterface *sdl,
+                                   const std::string &ip_out, int port_out,
+                                   int port_in, int in_len)
+    : m_sdl(sdl), m_out(ip_out, port_out), m_in(port_in, in_len) {}
+
+void ChJoystickBridge::SetButtonCallback(int button,
+                                         std::function<void()> callback) {
+  if (!m_buttons.count(button))
+    m_sdl->AddCallbackButtons(button);
+  m_buttons[button] = callback;
+}
+
+bool ChJoystickBridge::Sample() {
+  // pumps the SDL events, which also reads the joystick
+  if (m_sdl->Synchronize() == 1)
+    return false;
+
+  m_axes[0] = m_sdl->GetThrottle();
+  m_axes[1] = m_sdl->GetSteering();
+  m_axes[2] = m_sdl->GetBraking();
+  if (m_deadband >= 0.0) {
+    for (int i = 0; i < 3; i++) {
+      if (std::abs(m_axes[i] - m_sent_axes[i]) > m_deadband)
+        m_send_requested = true;
+    }
+  }
+
+  m_sdl->GetButtonPresses(m_presses);
+  for (int button : m_presses) {
+    auto it = m_buttons.find(button);
+    if (it != m_buttons.end() && it->second)
+      it->second();
+  }
+  return true;
+}
+
+void ChJoystickBridge::Send() {
+  m_frame.assign(m_axes, m_axes + 3);
+  if (m_fill)
+    m_fill(m_frame);
+  for (float value : m_frame)
+    m_out.AddData(value);
+  m_out.Synchronize();
+  std::copy(m_axes, m_axes + 3, m_sent_axes);
+  m_send_requested = false;
+}
+
+bool ChJoystickBridge::Spin() {
+  double now = ChLatencyMonitor::Now();
+  if (m_next_send == 0.0) {
+    m_next_send = now;
+    m_next_sample = now;
+  }
+
+  // sleep until a datagram arrives or the next deadline, rounded up to the
+  // millisecond resolution of poll
+  double wake = std::min(m_next_send, m_next_sample);
+  int timeout = std::max(0, static_cast<int>(std::ceil((wake - now) * 1e3)));
+  struct pollfd pfd;
+  pfd.fd = m_in.GetNativeHandle();
+  pfd.events = POLLIN;
+  pfd.revents = 0;
+  if (poll(&pfd, 1, timeout) > 0 && (pfd.revents & POLLIN)) {
+    while (m_in.Available() > 0) {
+      m_in.Synchronize();
+      m_num_received++;
+      if (m_receive)
+        m_receive(m_in.GetRecvData());
+    }
+  }
+
+  now = ChLatencyMonitor::Now();
+  if (now >= m_next_sample) {
+    if (!Sample())
+      return false;
+    m_next_sample += m_sample_period;
+    if (m_next_sample < now)
+      m_next_sample = now + m_sample_period;
+  }
+
+  // periodic frames keep their schedule, event frames come in between
+  if (now >= m_next_send) {
+    Send();
+    m_num_periodic++;
+    m_next_send += m_send_period;
+    if (m_next_send < now)
+      m_next_send = now + m_send_period;
+  } else if (m_send_requested) {
+    Send();
+    m_num_events++;
+  }
+  return true;
+}
+
+void ChJoystickBridge::Run() {
+  while (Spin()) {
+  }
+}
+
+} // namespace hil
+} // namespace chrono
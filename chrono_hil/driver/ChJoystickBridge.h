@@ -0,0 +1,126 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// Jason Zhou
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Authors: Jason Zhou
+// =============================================================================
+//
+// Bridge between an SDL joystick and a simulator over UDP, e.g. the NADS
+// motion simulator. Input frames (throttle, steering, braking, then the
+// channels added by the application) are sent at a fixed rate, and at once
+// when an axis moves by more than a deadband since the last frame sent.
+// Frames from the peer are handed to a callback as they arrive.
+//
+// The bridge sleeps in poll() on the receive socket between deadlines, so
+// it does not busy a core. SDL only reads the joystick when its events are
+// pumped and offers no descriptor to wait on, so the inputs are sampled on
+// a period of their own (1 ms by default), which bounds the reaction time
+// of the event sends. Button presses come from the SDL event queue and are
+// handed to per-button callbacks once per press.
+//
+// =============================================================================
+
+#ifndef CH_JOYSTICK_BRIDGE_H
+#define CH_JOYSTICK_BRIDGE_H
+
+#include <functional>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../ChApiHil.h"
+#include "../network/udp/ChBoostInStreamer.h"
+#include "../network/udp/ChBoostOutStreamer.h"
+#include "ChSDLInterface.h"
+
+namespace chrono {
+namespace hil {
+
+class CH_HIL_API ChJoystickBridge {
+public:
+  /// Appends the application channels to an input frame
+  typedef std::function<void(std::vector<float> &frame)> FrameFiller;
+
+  /// Called with each frame received from the peer
+  typedef std::function<void(const std::vector<float> &frame)> Receiver;
+
+  /// Bridge the joystick of sdl (initialized) to ip_out:port_out, and
+  /// receive frames of in_len floats on port_in
+  ChJoystickBridge(ChSDLInterface *sdl, const std::string &ip_out,
+                   int port_out, int port_in, int in_len);
+
+  /// Frames per second sent without input change (100 by default)
+  void SetSendRate(double rate) { m_send_period = 1.0 / rate; }
+
+  /// Axis change which sends a frame at once, in the scaled units of the
+  /// axes (0.01 by default); a negative deadband disables event sends
+  void SetDeadband(double deadband) { m_deadband = deadband; }
+
+  /// Period of the joystick reads [s]
+  void SetSamplePeriod(double period) { m_sample_period = period; }
+
+  /// Call callback on each press of button
+  void SetButtonCallback(int button, std::function<void()> callback);
+
+  void SetFrameFiller(FrameFiller fill) { m_fill = fill; }
+
+  void SetReceiver(Receiver receive) { m_receive = receive; }
+
+  /// Send a frame at the next wake up, e.g. after a button changed a
+  /// channel of the application
+  void RequestSend() { m_send_requested = true; }
+
+  /// Wait for the next datagram or deadline and handle it. Returns false
+  /// once SDL got a quit request.
+  bool Spin();
+
+  /// Spin until SDL gets a quit request
+  void Run();
+
+  uint64_t GetNumPeriodicSends() const { return m_num_periodic; }
+  uint64_t GetNumEventSends() const { return m_num_events; }
+  uint64_t GetNumReceived() const { return m_num_received; }
+
+private:
+  /// Read the joystick, returns false on a quit request
+  bool Sample();
+
+  void Send();
+
+  ChSDLInterface *m_sdl;
+  ChBoostOutStreamer m_out;
+  ChBoostInStreamer m_in;
+
+  double m_send_period = 0.01;
+  double m_sample_period = 0.001;
+  double m_deadband = 0.01;
+  FrameFiller m_fill;
+  Receiver m_receive;
+  std::map<int, std::function<void()>> m_buttons;
+
+  double m_next_send = 0.0;
+  double m_next_sample = 0.0;
+  bool m_send_requested = false;
+
+  float m_axes[3] = {0.f, 0.f, 0.f};      // throttle, steering, braking
+  float m_sent_axes[3] = {0.f, 0.f, 0.f}; // in the last frame sent
+  std::vector<float> m_frame;
+  std::vector<int> m_presses;
+
+  uint64_t m_num_periodic = 0;
+  uint64_t m_num_events = 0;
+  uint64_t m_num_received = 0;
+};
+
+} // namespace hil
+} // namespace chrono
+
+#endif
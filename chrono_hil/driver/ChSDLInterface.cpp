@@ -20,8 +20,11 @@
 // =============================================================================
 
 #include "ChSDLInterface.h"
+#include "../timer/ChLatencyMonitor.h"
 #include "chrono_vehicle/utils/ChUtilsJSON.h"
 
+#include <algorithm>
+
 namespace chrono {
 namespace hil {
 
@@ -97,6 +100,7 @@ void ChSDLInterface::SetJoystickConfigFile(std::string config_filename) {
 float ChSDLInterface::GetThrottle() {
   // NOTE: SDL_QuitRequested() has to be called to make program run properly
   SDL_JoystickUpdate();
+  m_input_time = ChLatencyMonitor::Now();
   float sdl_raw = SDL_JoystickGetAxis(m_joystick, m_throttle_axis.axis);
   return (sdl_raw - m_throttle_axis.max) *
              (m_throttle_axis.scaled_max - m_throttle_axis.scaled_min) /
@@ -107,6 +111,7 @@ float ChSDLInterface::GetThrottle() {
 float ChSDLInterface::GetSteering() {
   // NOTE: SDL_QuitRequested() has to be called to make program run properly
   SDL_JoystickUpdate();
+  m_input_time = ChLatencyMonitor::Now();
   float sdl_raw = SDL_JoystickGetAxis(m_joystick, m_steering_axis.axis);
   return (sdl_raw - m_steering_axis.max) *
              (m_steering_axis.scaled_max - m_steering_axis.scaled_min) /
@@ -117,6 +122,7 @@ float ChSDLInterface::GetSteering() {
 float ChSDLInterface::GetBraking() {
   // NOTE: SDL_QuitRequested() has to be called to make program run properly
   SDL_JoystickUpdate();
+  m_input_time = ChLatencyMonitor::Now();
   float sdl_raw = SDL_JoystickGetAxis(m_joystick, m_braking_axis.axis);
   return (sdl_raw - m_braking_axis.max) *
              (m_braking_axis.scaled_max - m_braking_axis.scaled_min) /
@@ -139,6 +145,29 @@ void ChSDLInterface::GetButtonStatus(std::vector<int> &ref_idx,
   ref_val = m_active_buttons_val;
 }
 
+void ChSDLInterface::GetButtonPresses(std::vector<int> &buttons) {
+  buttons.clear();
+  SDL_PumpEvents();
+  // the axes are read from the joystick state, their events only fill the
+  // queue
+  SDL_FlushEvent(SDL_JOYAXISMOTION);
+
+  // only button events are taken, SDL_QUIT stays for Synchronize
+  SDL_Event events[16];
+  int n;
+  while ((n = SDL_PeepEvents(events, 16, SDL_GETEVENT, SDL_JOYBUTTONDOWN,
+                             SDL_JOYBUTTONUP)) > 0) {
+    for (int i = 0; i < n; i++) {
+      if (events[i].type != SDL_JOYBUTTONDOWN)
+        continue;
+      int button = events[i].jbutton.button;
+      if (std::find(m_active_buttons_idx.begin(), m_active_buttons_idx.end(),
+                    button) != m_active_buttons_idx.end())
+        buttons.push_back(button);
+    }
+  }
+}
+
 int ChSDLInterface::Synchronize() {
   if (SDL_QuitRequested()) {
     return 1;
@@ -61,6 +61,11 @@ public:
 
   void GetButtonStatus(std::vector<int> &ref_idx, std::vector<int> &ref_val);
 
+  /// Callback buttons pressed since the last call, in order. Presses are
+  /// taken from the SDL event queue, so a press shorter than the polling
+  /// period is not missed and a held button counts once.
+  void GetButtonPresses(std::vector<int> &buttons);
+
   float GetThrottle();
 
   float GetBraking();
@@ -69,6 +74,10 @@ public:
 
   int Synchronize(); // Synchronize function to detect exit signal
 
+  /// Time of the last joystick read, in the time base of
+  /// ChLatencyMonitor::Now [s]
+  double GetInputTime() const { return m_input_time; }
+
 private:
   SDL_Joystick *m_joystick;
 
@@ -78,6 +87,8 @@ private:
 
   std::vector<int> m_active_buttons_idx;
   std::vector<int> m_active_buttons_val;
+
+  double m_input_time = 0.0;
 };
 
 } // namespace hil
@@ -0,0 +1,109 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Authors: Jason Zhou
+// =============================================================================
+//
+// Per-thread bump allocator for the scratch data of a frame
+//
+// =============================================================================
+
+#include "ChFrameArena.h"
+
+#include <algorithm>
+#include <iostream>
+#include <new>
+
+namespace chrono {
+namespace hil {
+
+ChFrameArena::ChFrameArena(size_t size)
+    : m_block(static_cast<char *>(::operator new(size))), m_size(size) {
+  // room for the overflows of a frame without growing
+  m_heap.reserve(16);
+}
+
+ChFrameArena::~ChFrameArena() {
+  // not Reset, which may grow the block and report the frame
+  for (auto &allocation : m_heap)
+    ::operator delete(allocation.first, std::align_val_t(allocation.second));
+  ::operator delete(m_block);
+}
+
+void *ChFrameArena::do_allocate(size_t bytes, size_t alignment) {
+  m_stats.allocations++;
+  m_stats.bytes += bytes;
+
+  uintptr_t base = reinterpret_cast<uintptr_t>(m_block);
+  uintptr_t start =
+      (base + m_used + alignment - 1) & ~(uintptr_t)(alignment - 1);
+  if (start + bytes <= base + m_size) {
+    m_used = start + bytes - base;
+    return reinterpret_cast<void *>(start);
+  }
+
+  // past the block, from the heap until the next Reset grows the block
+  m_stats.heap_allocations++;
+  void *p = ::operator new(bytes, std::align_val_t(alignment));
+  m_heap.emplace_back(p, alignment);
+  m_heap_bytes += bytes + alignment;
+  return p;
+}
+
+void ChFrameArena::Reset() {
+  size_t needed = m_used + m_heap_bytes;
+  for (auto &allocation : m_heap)
+    ::operator delete(allocation.first, std::align_val_t(allocation.second));
+  m_heap.clear();
+  m_heap_bytes = 0;
+  m_used = 0;
+
+  bool grown = needed > m_size;
+  if (grown) {
+    size_t size = m_size;
+    while (size < needed)
+      size *= 2;
+    ::operator delete(m_block);
+    m_block = static_cast<char *>(::operator new(size));
+    m_size = size;
+    m_num_heap_frames++;
+  }
+
+  m_frame_stats = m_stats;
+  m_stats = ChArenaStats();
+  m_num_frames++;
+  if (!m_debug)
+    return;
+
+  if (grown) {
+    std::cout << m_name << ": frame " << m_num_frames << " took "
+              << m_frame_stats.heap_allocations
+              << " allocations from the heap, block grown to " << m_size
+              << " bytes" << std::endl;
+  }
+  m_max_stats.allocations =
+      std::max(m_max_stats.allocations, m_frame_stats.allocations);
+  m_max_stats.bytes = std::max(m_max_stats.bytes, m_frame_stats.bytes);
+  if (m_num_frames % HIL_ARENA_REPORT_FRAMES == 0) {
+    std::cout << m_name << ": at most " << m_max_stats.allocations
+              << " allocations and " << m_max_stats.bytes
+              << " bytes per frame over the last " << HIL_ARENA_REPORT_FRAMES
+              << " frames" << std::endl;
+    m_max_stats = ChArenaStats();
+  }
+}
+
+ChFrameArena &ChFrameArena::GetThreadArena() {
+  thread_local ChFrameArena arena;
+  return arena;
+}
+
+} // namespace hil
+} // namespace chrono
@@ -0,0 +1,129 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Authors: Jason Zhou
+// =============================================================================
+//
+// Frame arena: a monotonic bump allocator for the scratch data of one frame
+// of a loop (payload vectors, formatted strings, sensor buffer copies),
+// released all at once by Reset at the end of the frame. Each thread has
+// its own arena (GetThreadArena), so allocating never takes a lock.
+//
+// The arena is a std::pmr::memory_resource: hot loop code opts in by
+// giving its containers the arena, without changing how it uses them:
+//
+//   ChFrameVector<float> payload(&ChFrameArena::GetThreadArena());
+//   ChFrameString line(&ChFrameArena::GetThreadArena());
+//
+// Such containers must not outlive the frame. A frame which needs more than
+// the block of the arena takes the rest from the heap; the next Reset then
+// grows the block to fit, so a loop with a steady frame stops calling
+// malloc after its first frames.
+//
+// Each frame counts its allocations and bytes. In debug mode, the frames
+// which went to the heap are reported, and the largest frame every
+// HIL_ARENA_REPORT_FRAMES frames.
+//
+// =============================================================================
+
+#ifndef CH_FRAME_ARENA_H
+#define CH_FRAME_ARENA_H
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "../ChApiHil.h"
+
+namespace chrono {
+namespace hil {
+
+#define HIL_ARENA_BLOCK (64 * 1024)  // initial block [bytes]
+#define HIL_ARENA_REPORT_FRAMES 1000 // frames between debug reports
+
+/// Allocations of one frame
+struct ChArenaStats {
+  uint64_t allocations = 0;
+  uint64_t bytes = 0;
+  uint64_t heap_allocations = 0; // past the end of the block
+};
+
+/// Containers allocating from a frame arena
+template <typename T> using ChFrameVector = std::pmr::vector<T>;
+typedef std::pmr::string ChFrameString;
+
+class CH_HIL_API ChFrameArena : public std::pmr::memory_resource {
+public:
+  /// Arena with a first block of size [bytes]
+  ChFrameArena(size_t size = HIL_ARENA_BLOCK);
+  ~ChFrameArena();
+
+  ChFrameArena(const ChFrameArena &) = delete;
+  ChFrameArena &operator=(const ChFrameArena &) = delete;
+
+  /// End the frame: release all its allocations, grow the block if the
+  /// frame did not fit
+  void Reset();
+
+  /// Report the heap allocations and the largest frames, under name
+  void SetDebug(bool debug, const std::string &name = "frame arena") {
+    m_debug = debug;
+    m_name = name;
+  }
+
+  /// Allocations of the frame so far, and of the last frame reset
+  const ChArenaStats &GetStats() const { return m_stats; }
+  const ChArenaStats &GetFrameStats() const { return m_frame_stats; }
+
+  /// Size of the block [bytes]
+  size_t GetSize() const { return m_size; }
+
+  /// Frames reset so far, and those which went to the heap
+  uint64_t GetNumFrames() const { return m_num_frames; }
+  uint64_t GetNumHeapFrames() const { return m_num_heap_frames; }
+
+  /// Arena of the calling thread
+  static ChFrameArena &GetThreadArena();
+
+private:
+  void *do_allocate(size_t bytes, size_t alignment) override;
+
+  /// Released by Reset
+  void do_deallocate(void *, size_t, size_t) override {}
+
+  bool do_is_equal(const std::pmr::memory_resource &other) const
+      noexcept override {
+    return this == &other;
+  }
+
+  char *m_block;
+  size_t m_size;
+  size_t m_used = 0;
+  // allocations of the frame past the block, with their alignment
+  std::vector<std::pair<void *, size_t>> m_heap;
+  size_t m_heap_bytes = 0;
+
+  ChArenaStats m_stats;
+  ChArenaStats m_frame_stats;
+  uint64_t m_num_frames = 0;
+  uint64_t m_num_heap_frames = 0;
+
+  bool m_debug = false;
+  std::string m_name = "frame arena";
+  ChArenaStats m_max_stats; // largest frame since the last report
+};
+
+} // namespace hil
+} // namespace chrono
+
+#endif
@@ -0,0 +1,159 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// Jason Zhou
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Authors: Jason Zhou
+// =============================================================================
+//
+// Bounded-staleness coupling of two simulations over a ChHilTransport
+//
+// =============================================================================
+#include "ChHilCoupler.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+namespace chrono {
+namespace hil {
+
+static float ToWord(uint32_t value) {
+  float word;
+  std::memcpy(&word, &value, sizeof(word));
+  return word;
+}
+
+static uint32_t FromWord(float word) {
+  uint32_t value;
+  std::memcpy(&value, &word, sizeof(value));
+  return value;
+}
+
+ChHilCoupler::ChHilCoupler(std::shared_ptr<ChHilTransport> link, int max_lag)
+    : m_link(link), m_max_lag(max_lag) {}
+
+bool ChHilCoupler::Connect(int id) {
+  m_link->Initialize();
+
+  std::vector<float> hello = {ToWord(HIL_COUPLER_HELLO),
+                              ToWord(HIL_COUPLER_VERSION), ToWord(id),
+                              ToWord(m_max_lag)};
+  if (!m_link->SendFrame(hello))
+    return false;
+
+  // the HELLO of the peer is the first frame it sends
+  if (!m_link->PollFrame(m_frame) || m_frame.size() != 4 ||
+      FromWord(m_frame[0]) != HIL_COUPLER_HELLO) {
+    std::cout << "Coupler: the peer did not send a HELLO" << std::endl;
+    return false;
+  }
+  if (FromWord(m_frame[1]) != HIL_COUPLER_VERSION) {
+    std::cout << "Coupler: the peer uses version " << FromWord(m_frame[1])
+              << ", expected " << HIL_COUPLER_VERSION << std::endl;
+    return false;
+  }
+  m_peer_id = static_cast<int>(FromWord(m_frame[2]));
+  return true;
+}
+
+void ChHilCoupler::Process(const std::vector<float> &frame) {
+  if (frame.empty())
+    return;
+  uint32_t type = FromWord(frame[0]);
+
+  if (type == HIL_COUPLER_ACK && frame.size() == 2) {
+    m_peer_ack = std::max(m_peer_ack, FromWord(frame[1]));
+    return;
+  }
+  if (type != HIL_COUPLER_DATA || frame.size() < HIL_COUPLER_HEADER_LEN)
+    return;
+
+  uint32_t seq = FromWord(frame[1]);
+  m_peer_ack = std::max(m_peer_ack, FromWord(frame[2]));
+  if (seq <= m_recv_seq)
+    return; // duplicate or out of order
+
+  m_stats.frames_received++;
+  if (m_pending)
+    m_stats.frames_superseded++;
+  m_recv_seq = seq;
+  std::memcpy(&m_newest_time, &frame[3], sizeof(double));
+  m_newest.assign(frame.begin() + HIL_COUPLER_HEADER_LEN, frame.end());
+  m_pending = true;
+}
+
+void ChHilCoupler::Drain() {
+  while (m_link->PollFrame(m_frame, false))
+    Process(m_frame);
+}
+
+bool ChHilCoupler::SendAck() {
+  m_acked = m_recv_seq;
+  std::vector<float> ack = {ToWord(HIL_COUPLER_ACK), ToWord(m_recv_seq)};
+  return m_link->SendFrame(ack);
+}
+
+bool ChHilCoupler::Send(const std::vector<float> &payload, double time) {
+  Drain();
+
+  if (m_max_lag >= 0 && static_cast<int>(m_seq - m_peer_ack) > m_max_lag) {
+    auto t_0 = std::chrono::steady_clock::now();
+    m_stats.waits++;
+    while (static_cast<int>(m_seq - m_peer_ack) > m_max_lag) {
+      // the peer may be blocked on us as well
+      if (m_recv_seq != m_acked)
+        SendAck();
+      if (!m_link->PollFrame(m_frame))
+        break;
+      Process(m_frame);
+    }
+    m_stats.wait_time += std::chrono::duration<double>(
+                             std::chrono::steady_clock::now() - t_0)
+                             .count();
+  }
+
+  m_seq++;
+  m_frame.resize(HIL_COUPLER_HEADER_LEN + payload.size());
+  m_frame[0] = ToWord(HIL_COUPLER_DATA);
+  m_frame[1] = ToWord(m_seq);
+  m_frame[2] = ToWord(m_recv_seq);
+  std::memcpy(&m_frame[3], &time, sizeof(double));
+  std::copy(payload.begin(), payload.end(),
+            m_frame.begin() + HIL_COUPLER_HEADER_LEN);
+  m_acked = m_recv_seq;
+
+  m_stats.lag = static_cast<int>(m_seq - m_peer_ack);
+  m_stats.max_lag = std::max(m_stats.max_lag, m_stats.lag);
+  if (!m_link->SendFrame(m_frame))
+    return false;
+  m_stats.frames_sent++;
+  return true;
+}
+
+bool ChHilCoupler::Receive(std::vector<float> &payload, double time) {
+  Drain();
+  m_stats.lag = static_cast<int>(m_seq - m_peer_ack);
+  if (!m_pending)
+    return false;
+
+  payload.swap(m_newest);
+  m_pending = false;
+  m_peer_time = m_newest_time;
+
+  m_stats.frames_consumed++;
+  m_stats.age = time - m_peer_time;
+  m_stats.max_age = std::max(m_stats.max_age, m_stats.age);
+  m_stats.sum_age += m_stats.age;
+  return true;
+}
+
+} // namespace hil
+} // namespace chrono
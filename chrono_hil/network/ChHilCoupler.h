@@ -0,0 +1,131 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// Jason Zhou
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Authors: Jason Zhou
+// =============================================================================
+//
+// Bounded-staleness coupling of two simulations over a ChHilTransport. Each
+// side steps at its own rate, sends its state when it has one, and consumes
+// the newest state of the peer, if any arrived. A side only blocks when it
+// gets more than max_lag frames ahead of what the peer has picked up, so a
+// hiccup on one side stalls the other by at most max_lag frames.
+//
+// Every frame carries the number of the newest peer frame picked up by the
+// sender, which is how a side knows how far behind the peer is. A blocked
+// side keeps picking up and acknowledging the frames of the peer, so two
+// sides blocked on each other always move on. The link starts with a HELLO
+// exchange, so neither side needs to wait for the other before connecting.
+//
+// Frame layout, 32-bit words (integers stored bit for bit in the floats):
+//   HELLO: type, version, id, max_lag
+//   DATA:  type, seq, ack, time (float64, 2 words), payload...
+//   ACK:   type, ack
+//
+// =============================================================================
+#ifndef CH_HIL_COUPLER_H
+#define CH_HIL_COUPLER_H
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "../ChApiHil.h"
+#include "ChHilTransport.h"
+
+namespace chrono {
+namespace hil {
+
+#define HIL_COUPLER_HELLO 0x48434C01 // "HCL" 1
+#define HIL_COUPLER_DATA 0x48434C02  // "HCL" 2
+#define HIL_COUPLER_ACK 0x48434C03   // "HCL" 3
+#define HIL_COUPLER_VERSION 1
+#define HIL_COUPLER_HEADER_LEN 5
+
+/// Staleness metrics of a coupled link
+struct ChHilCouplerStats {
+  uint64_t frames_sent = 0;
+  uint64_t frames_received = 0;
+  uint64_t frames_consumed = 0;   ///< frames handed out by Receive
+  uint64_t frames_superseded = 0; ///< frames replaced by a newer one unread
+  int lag = 0; ///< frames sent and not yet picked up by the peer
+  int max_lag = 0;
+  double age = 0.0;     ///< simulation time of this side minus the one of
+                        ///< the last consumed peer frame, negative when the
+                        ///< peer is ahead [s]
+  double max_age = 0.0; ///< largest age seen by Receive [s]
+  double sum_age = 0.0; ///< for the mean age
+  uint64_t waits = 0;   ///< times Send blocked on a lagging peer
+  double wait_time = 0.0; ///< wall time spent blocked [s]
+
+  double GetMeanAge() const {
+    return frames_consumed ? sum_age / frames_consumed : 0.0;
+  }
+};
+
+class CH_HIL_API ChHilCoupler {
+public:
+  /// Couple over link. max_lag < 0 never blocks, 0 is lockstep.
+  ChHilCoupler(std::shared_ptr<ChHilTransport> link, int max_lag = 10);
+
+  /// Bring the link up and exchange HELLO frames, id identifies this side to
+  /// the peer. Returns false if the peer does not speak this protocol.
+  bool Connect(int id);
+
+  /// Id sent by the peer in its HELLO
+  int GetPeerId() const { return m_peer_id; }
+
+  void SetMaxLag(int max_lag) { m_max_lag = max_lag; }
+  int GetMaxLag() const { return m_max_lag; }
+
+  /// Send the state of this side at simulation time. Blocks first while the
+  /// peer has not picked up more than max_lag of our frames.
+  bool Send(const std::vector<float> &payload, double time);
+
+  /// Take the newest peer frame arrived since the last call, never blocks.
+  /// Returns false if there is none, payload is then left untouched. time
+  /// is the simulation time of this side, used for the age metrics.
+  bool Receive(std::vector<float> &payload, double time);
+
+  /// Simulation time of the last consumed peer frame
+  double GetPeerTime() const { return m_peer_time; }
+
+  const ChHilCouplerStats &GetStats() const { return m_stats; }
+
+private:
+  /// Handle one incoming frame
+  void Process(const std::vector<float> &frame);
+
+  /// Pick up all frames already arrived
+  void Drain();
+
+  bool SendAck();
+
+  std::shared_ptr<ChHilTransport> m_link;
+  int m_max_lag;
+  int m_peer_id = -1;
+
+  uint32_t m_seq = 0;      // last frame sent
+  uint32_t m_peer_ack = 0; // last of our frames picked up by the peer
+  uint32_t m_recv_seq = 0; // newest peer frame picked up
+  uint32_t m_acked = 0;    // newest peer frame acknowledged
+
+  bool m_pending = false; // a received frame waits for Receive
+  std::vector<float> m_newest;
+  double m_newest_time = 0.0;
+  double m_peer_time = 0.0;
+
+  std::vector<float> m_frame;
+  ChHilCouplerStats m_stats;
+};
+
+} // namespace hil
+} // namespace chrono
+#endif
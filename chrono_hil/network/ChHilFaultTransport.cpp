@@ -0,0 +1,120 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Authors: Jason Zhou
+// =============================================================================
+//
+// Transport wrapper degrading the received frames
+//
+// =============================================================================
+
+#include "ChHilFaultTransport.h"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+namespace chrono {
+namespace hil {
+
+// longest sleep of a blocking poll before looking for new arrivals
+#define HIL_FAULT_POLL_SLICE 0.0005
+
+ChHilFaultTransport::ChHilFaultTransport(std::shared_ptr<ChHilTransport> inner,
+                                         double delay, double jitter,
+                                         unsigned int seed)
+    : m_inner(inner), m_delay(delay), m_jitter(jitter), m_rng(seed),
+      m_uniform(0.0, 1.0) {
+  m_clock = []() {
+    return std::chrono::duration<double>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+  };
+}
+
+bool ChHilFaultTransport::DoSend(const std::vector<float> &frame) {
+  return m_inner->SendFrame(frame);
+}
+
+void ChHilFaultTransport::Hold() {
+  // draws only for the faults enabled, so that a given delay and jitter
+  // keep their sequence whatever else is set
+  if (m_loss > 0.0 && m_uniform(m_rng) < m_loss) {
+    m_num_dropped++;
+    return;
+  }
+  double now = m_clock();
+  if (m_duplicate > 0.0 && m_uniform(m_rng) < m_duplicate) {
+    m_copy = m_incoming;
+    Queue(now, m_copy);
+    m_num_duplicated++;
+  }
+  Queue(now, m_incoming);
+}
+
+void ChHilFaultTransport::Queue(double now, std::vector<float> &data) {
+  double start = now;
+  if (m_bandwidth > 0.0) {
+    m_link_free = std::max(m_link_free, now) +
+                  data.size() * sizeof(float) / m_bandwidth;
+    start = m_link_free;
+  }
+
+  HeldFrame held;
+  if (m_reorder > 0.0 && m_uniform(m_rng) < m_reorder) {
+    held.release = start;
+    if (!m_held.empty() && m_held.back().release > held.release)
+      m_num_reordered++;
+  } else {
+    held.release = start + m_delay + m_jitter * m_uniform(m_rng);
+    // jitter alone does not reorder the frames
+    held.release = std::max(held.release, m_last_release);
+    m_last_release = held.release;
+  }
+  held.data.swap(data);
+
+  auto it = std::upper_bound(
+      m_held.begin(), m_held.end(), held.release,
+      [](double t, const HeldFrame &f) { return t < f.release; });
+  m_held.insert(it, std::move(held));
+}
+
+void ChHilFaultTransport::Pull() {
+  while (m_inner->PollFrame(m_incoming, false))
+    Hold();
+}
+
+bool ChHilFaultTransport::DoPoll(std::vector<float> &frame, bool blocking) {
+  while (true) {
+    Pull();
+    double now = m_clock();
+    if (!m_held.empty() && m_held.front().release <= now) {
+      frame.swap(m_held.front().data);
+      m_held.pop_front();
+      return true;
+    }
+    if (!blocking)
+      return false;
+
+    if (m_held.empty()) {
+      // nothing in flight, wait on the inner transport
+      if (!m_inner->PollFrame(m_incoming, true))
+        return false;
+      Hold();
+    } else {
+      double wait =
+          std::min(HIL_FAULT_POLL_SLICE, m_held.front().release - now);
+      std::this_thread::sleep_for(std::chrono::duration<double>(wait));
+    }
+  }
+}
+
+} // namespace hil
+} // namespace chrono
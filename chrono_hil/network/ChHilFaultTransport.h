@@ -0,0 +1,125 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Authors: Jason Zhou
+// =============================================================================
+//
+// Transport wrapper which degrades the frames received on another
+// transport, to test HIL links against a bad network on loopback. Each frame
+// may be dropped or duplicated, and is held for a fixed delay plus a random
+// jitter, in arrival order unless it is picked for reordering: such a frame
+// skips the delay and overtakes the frames held. A bandwidth cap queues the
+// frames behind each other, each taking its size over the bandwidth.
+//
+// All random draws come from one generator seeded at construction. With a
+// clock driven by the test (SetClock, see ChHilNetHarness) a run is exactly
+// repeatable. Frames are only seen when the wrapper is polled, so the delay
+// counts from the first poll after the arrival. Created with the
+// delay=<ms>&jitter=<ms>&loss=<%>&dup=<%>&reorder=<%>&rate=<kbit/s>&seed=<n>
+// URI parameters, see ChHilTransport::Create.
+//
+// =============================================================================
+#ifndef CH_HIL_FAULT_TRANSPORT_H
+#define CH_HIL_FAULT_TRANSPORT_H
+
+#include <deque>
+#include <functional>
+#include <random>
+
+#include "ChHilTransport.h"
+
+namespace chrono {
+namespace hil {
+
+class CH_HIL_API ChHilFaultTransport : public ChHilTransport {
+public:
+  /// Time [s], any epoch
+  typedef std::function<double()> Clock;
+
+  /// Delay the frames received on inner by delay plus a uniform random
+  /// jitter in [0, jitter] [s]
+  ChHilFaultTransport(std::shared_ptr<ChHilTransport> inner, double delay,
+                      double jitter = 0.0, unsigned int seed = 1);
+
+  virtual void Initialize() override { m_inner->Initialize(); }
+
+  /// Drop each frame received with probability loss
+  void SetLoss(double loss) { m_loss = loss; }
+
+  /// Deliver each frame received twice with probability duplicate, the copy
+  /// with its own jitter
+  void SetDuplication(double duplicate) { m_duplicate = duplicate; }
+
+  /// Deliver each frame with probability reorder without the delay, ahead
+  /// of the frames held
+  void SetReordering(double reorder) { m_reorder = reorder; }
+
+  /// Cap the received traffic to bandwidth [bytes/s], 0 for no cap
+  void SetBandwidth(double bandwidth) { m_bandwidth = bandwidth; }
+
+  /// Replace the steady clock, e.g. with the virtual time of a test. A
+  /// blocking poll then waits for another thread to move the clock.
+  void SetClock(Clock clock) { m_clock = clock; }
+
+  /// Frames received and still held
+  size_t GetNumHeld() const { return m_held.size(); }
+
+  uint64_t GetNumDropped() const { return m_num_dropped; }
+  uint64_t GetNumDuplicated() const { return m_num_duplicated; }
+
+  /// Frames delivered ahead of an earlier frame
+  uint64_t GetNumReordered() const { return m_num_reordered; }
+
+  std::shared_ptr<ChHilTransport> GetInner() const { return m_inner; }
+
+protected:
+  virtual bool DoSend(const std::vector<float> &frame) override;
+  virtual bool DoPoll(std::vector<float> &frame, bool blocking) override;
+
+private:
+  struct HeldFrame {
+    double release;
+    std::vector<float> data;
+  };
+
+  /// Queue the frame in m_incoming with its release time, or drop it
+  void Hold();
+
+  /// Queue one copy of the frame received at time now
+  void Queue(double now, std::vector<float> &data);
+
+  /// Take the frames arrived on the inner transport
+  void Pull();
+
+  std::shared_ptr<ChHilTransport> m_inner;
+  double m_delay;
+  double m_jitter;
+  double m_loss = 0.0;
+  double m_duplicate = 0.0;
+  double m_reorder = 0.0;
+  double m_bandwidth = 0.0;
+  Clock m_clock;
+  std::mt19937 m_rng;
+  std::uniform_real_distribution<double> m_uniform;
+
+  std::deque<HeldFrame> m_held; // sorted by release time
+  std::vector<float> m_incoming;
+  std::vector<float> m_copy;
+  double m_last_release = 0.0; // of the last frame delivered in order
+  double m_link_free = 0.0;    // end of the last frame on the capped link
+
+  uint64_t m_num_dropped = 0;
+  uint64_t m_num_duplicated = 0;
+  uint64_t m_num_reordered = 0;
+};
+
+} // namespace hil
+} // namespace chrono
+#endif
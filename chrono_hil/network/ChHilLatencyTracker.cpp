@@ -0,0 +1,154 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Authors: Jason Zhou
+// =============================================================================
+//
+// Round trip, clock offset and one-way delay of a link
+//
+// =============================================================================
+
+#include "ChHilLatencyTracker.h"
+
+#include <chrono>
+#include <cstring>
+
+namespace chrono {
+namespace hil {
+
+static void PutInt64(std::vector<float> &frame, int64_t value) {
+  float words[2];
+  std::memcpy(words, &value, sizeof(value));
+  frame.push_back(words[0]);
+  frame.push_back(words[1]);
+}
+
+static int64_t GetInt64(const float *words) {
+  int64_t value;
+  std::memcpy(&value, words, sizeof(value));
+  return value;
+}
+
+static float ToWord(uint32_t value) {
+  float word;
+  std::memcpy(&word, &value, sizeof(word));
+  return word;
+}
+
+static uint32_t FromWord(float word) {
+  uint32_t value;
+  std::memcpy(&value, &word, sizeof(value));
+  return value;
+}
+
+ChHilLatencyTracker::ChHilLatencyTracker(
+    std::shared_ptr<ChLatencyMonitor> monitor, const std::string &link)
+    : m_monitor(monitor), m_link(link), m_rtt_name(link + ".rtt"),
+      m_one_way_name(link + ".one_way") {
+  m_clock = []() {
+    return static_cast<int64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch())
+            .count());
+  };
+}
+
+void ChHilLatencyTracker::SetSessionClock(
+    std::shared_ptr<ChSessionClock> session) {
+  m_session = session;
+  ChSessionClock *clock = session.get();
+  m_clock = [clock]() { return clock->GetLocalNs(); };
+}
+
+void ChHilLatencyTracker::Stamp(const std::vector<float> &frame,
+                                std::vector<float> &out) {
+  out.reserve(frame.size() + HIL_LATENCY_TRAILER_LEN);
+  out.assign(frame.begin(), frame.end());
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  int64_t now = m_clock();
+  PutInt64(out, now);
+  PutInt64(out, m_echo_pending ? m_peer_send : 0);
+  PutInt64(out, m_echo_pending ? now - m_peer_recv : -1);
+  out.push_back(ToWord(HIL_LATENCY_MAGIC));
+  // each peer frame is echoed once
+  m_echo_pending = false;
+}
+
+bool ChHilLatencyTracker::Strip(std::vector<float> &frame) {
+  if (frame.size() < HIL_LATENCY_TRAILER_LEN ||
+      FromWord(frame.back()) != HIL_LATENCY_MAGIC) {
+    m_num_unstamped++;
+    return false;
+  }
+
+  const float *trailer = frame.data() + frame.size() - HIL_LATENCY_TRAILER_LEN;
+  int64_t sent = GetInt64(trailer);
+  int64_t echo = GetInt64(trailer + 2);
+  int64_t hold = GetInt64(trailer + 4);
+  frame.resize(frame.size() - HIL_LATENCY_TRAILER_LEN);
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  int64_t now = m_clock();
+  m_peer_send = sent;
+  m_peer_recv = now;
+  m_echo_pending = true;
+
+  if (hold >= 0) {
+    // t1 = echo and t4 = now on our clock, t2 = sent - hold and t3 = sent
+    // on the peer clock
+    Sample sample;
+    sample.rtt = (now - echo) - hold;
+    sample.offset = ((sent - hold - echo) + (sent - now)) / 2;
+    if (m_window.size() < HIL_LATENCY_WINDOW)
+      m_window.push_back(sample);
+    else
+      m_window[m_next_sample] = sample;
+    m_next_sample = (m_next_sample + 1) % HIL_LATENCY_WINDOW;
+    if (m_session)
+      m_session->AddSample(now, sample.offset, sample.rtt);
+    if (m_monitor)
+      m_monitor->Record(m_rtt_name, sample.rtt * 1e-9);
+  }
+
+  const Sample *best = GetBest();
+  if (best && m_monitor)
+    m_monitor->Record(m_one_way_name, (now - (sent - best->offset)) * 1e-9);
+  return true;
+}
+
+const ChHilLatencyTracker::Sample *ChHilLatencyTracker::GetBest() const {
+  const Sample *best = nullptr;
+  for (const Sample &s : m_window) {
+    if (!best || s.rtt < best->rtt)
+      best = &s;
+  }
+  return best;
+}
+
+double ChHilLatencyTracker::GetOffset() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  const Sample *best = GetBest();
+  return best ? best->offset * 1e-9 : 0.0;
+}
+
+bool ChHilLatencyTracker::HasOffset() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return !m_window.empty();
+}
+
+double ChHilLatencyTracker::GetMinRTT() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  const Sample *best = GetBest();
+  return best ? best->rtt * 1e-9 : 0.0;
+}
+
+} // namespace hil
+} // namespace chrono
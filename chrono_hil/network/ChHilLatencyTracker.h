@@ -0,0 +1,123 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Authors: Jason Zhou
+// =============================================================================
+//
+// Latency measurement on one link. Attached to a transport with
+// ChHilTransport::SetLatencyTracker, on both ends of the link: each frame
+// sent gets a time stamp trailer, which the receiving end removes before the
+// frame is handed out.
+//
+// The trailer echoes the send time of the last frame received from the peer
+// and how long it was held, as in NTP. Each echo gives one round trip time
+// (without the hold time) and one estimate of the offset between the clocks
+// of the two ends. The offset kept is the one of the fastest round trip of
+// the last HIL_LATENCY_WINDOW echoes, which is the least disturbed by
+// queuing. The one-way delay of a frame is its arrival time minus its send
+// time moved to the local clock; its error is half the asymmetry of the
+// fastest round trip.
+//
+// Round trips and one-way delays are recorded in the ChLatencyMonitor given
+// at construction, as "<link>.rtt" and "<link>.one_way". The offset samples
+// can also drive a ChSessionClock, see SetSessionClock.
+//
+// Trailer, 32-bit words (integers stored bit for bit in the floats):
+//   send time (int64 ns, 2 words), echoed peer send time (2 words),
+//   hold time (int64 ns, 2 words, negative if nothing is echoed), magic
+//
+// =============================================================================
+#ifndef CH_HIL_LATENCY_TRACKER_H
+#define CH_HIL_LATENCY_TRACKER_H
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "../ChApiHil.h"
+#include "../timer/ChLatencyMonitor.h"
+#include "../timer/ChSessionClock.h"
+
+namespace chrono {
+namespace hil {
+
+#define HIL_LATENCY_MAGIC 0x7FA54C54 // NaN pattern "LT"
+#define HIL_LATENCY_TRAILER_LEN 7
+#define HIL_LATENCY_WINDOW 32
+
+class CH_HIL_API ChHilLatencyTracker {
+public:
+  /// Clock of this end [ns], monotonic, any epoch
+  typedef std::function<int64_t()> Clock;
+
+  /// Track the link named link, recording into monitor (may be nullptr
+  /// when the tracker only drives a session clock)
+  ChHilLatencyTracker(std::shared_ptr<ChLatencyMonitor> monitor,
+                      const std::string &link);
+
+  /// Replace the steady clock, e.g. to simulate a peer with another epoch
+  void SetClock(Clock clock) { m_clock = clock; }
+
+  /// Stamp the frames with the local clock of session. On the master this
+  /// gives the peers its session time; on the other processes every round
+  /// trip is passed to session as an offset sample. Replaces SetClock.
+  void SetSessionClock(std::shared_ptr<ChSessionClock> session);
+
+  /// Copy frame to out and append the trailer
+  void Stamp(const std::vector<float> &frame, std::vector<float> &out);
+
+  /// Remove the trailer of a received frame and record its delays. Returns
+  /// false, leaving the frame untouched, if it carries no trailer.
+  bool Strip(std::vector<float> &frame);
+
+  /// Offset of the peer clock relative to ours [s], valid once HasOffset
+  double GetOffset() const;
+  bool HasOffset() const;
+
+  /// Fastest round trip of the current window [s]
+  double GetMinRTT() const;
+
+  /// Frames received without a trailer
+  uint64_t GetNumUnstamped() const { return m_num_unstamped; }
+
+  const std::string &GetLink() const { return m_link; }
+
+private:
+  struct Sample {
+    int64_t rtt = 0;
+    int64_t offset = 0;
+  };
+
+  /// Sample of the fastest round trip in the window
+  const Sample *GetBest() const;
+
+  std::shared_ptr<ChLatencyMonitor> m_monitor;
+  std::string m_link;
+  std::string m_rtt_name;
+  std::string m_one_way_name;
+  Clock m_clock;
+  std::shared_ptr<ChSessionClock> m_session;
+
+  mutable std::mutex m_mutex;
+  bool m_echo_pending = false;
+  int64_t m_peer_send = 0; // send time of the last peer frame, peer clock
+  int64_t m_peer_recv = 0; // its arrival time, our clock
+
+  std::vector<Sample> m_window;
+  size_t m_next_sample = 0;
+  uint64_t m_num_unstamped = 0;
+};
+
+} // namespace hil
+} // namespace chrono
+#endif
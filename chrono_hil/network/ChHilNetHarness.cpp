@@ -0,0 +1,167 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Authors: Jason Zhou
+// =============================================================================
+//
+// Harness running a network scenario with several endpoints
+//
+// =============================================================================
+
+#include "ChHilNetHarness.h"
+#include "ChHilFaultTransport.h"
+
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+#ifndef _WIN32
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace chrono {
+namespace hil {
+
+ChHilNetHarness::ChHilNetHarness(double step) : m_step(step) {}
+
+void ChHilNetHarness::AddEndpoint(const std::string &name,
+                                  std::shared_ptr<ChHilNetEndpoint> endpoint) {
+  Endpoint e;
+  e.name = name;
+  e.endpoint = endpoint;
+  m_endpoints.push_back(e);
+}
+
+std::shared_ptr<ChHilTransport>
+ChHilNetHarness::Open(const std::string &uri) {
+  auto transport = ChHilTransport::Create(uri);
+  if (!transport)
+    return nullptr;
+
+  auto faults = std::dynamic_pointer_cast<ChHilFaultTransport>(transport);
+  if (faults)
+    faults->SetClock([this]() { return GetTime(); });
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  Opened opened;
+  opened.uri = uri;
+  opened.transport = transport;
+  m_opened.push_back(opened);
+  return transport;
+}
+
+double ChHilNetHarness::GetTime() const {
+  if (m_virtual)
+    return m_time;
+  return ChLatencyMonitor::Now() - m_start;
+}
+
+bool ChHilNetHarness::RunLockstep(int num_steps) {
+  m_virtual = true;
+  m_time = 0.0;
+
+  // loopback transports wait for their peer in Initialize
+  std::vector<std::thread> threads;
+  for (Endpoint &e : m_endpoints)
+    threads.emplace_back([this, &e]() { e.endpoint->Initialize(*this); });
+  for (auto &thread : threads)
+    thread.join();
+
+  for (int step = 0; step < num_steps; step++) {
+    for (Endpoint &e : m_endpoints)
+      e.endpoint->Advance(m_time);
+    m_time += m_step;
+  }
+  m_duration = num_steps * m_step;
+
+  bool ok = true;
+  for (Endpoint &e : m_endpoints) {
+    bool passed = e.endpoint->Check();
+    std::cout << e.name << ": " << (passed ? "PASSED" : "FAILED")
+              << std::endl;
+    ok = ok && passed;
+  }
+  return ok;
+}
+
+bool ChHilNetHarness::RunChild(Endpoint &e, int num_steps) {
+  e.endpoint->Initialize(*this);
+
+  // paced from the end of the initialization of this endpoint
+  auto t_0 = std::chrono::steady_clock::now();
+  double first = GetTime();
+  for (int step = 0; step < num_steps; step++) {
+    e.endpoint->Advance(GetTime());
+    std::this_thread::sleep_until(
+        t_0 + std::chrono::duration<double>((step + 1) * m_step));
+  }
+  m_duration = GetTime() - first;
+
+  bool passed = e.endpoint->Check();
+  Report();
+  std::cout << e.name << ": " << (passed ? "PASSED" : "FAILED") << std::endl;
+  return passed;
+}
+
+bool ChHilNetHarness::RunForked(int num_steps) {
+#ifdef _WIN32
+  std::cout << "Forked scenarios are not supported on Windows" << std::endl;
+  return false;
+#else
+  m_virtual = false;
+  // one epoch for all children, the steady clock is shared by the processes
+  m_start = ChLatencyMonitor::Now();
+
+  std::cout.flush();
+  std::vector<pid_t> children;
+  for (Endpoint &e : m_endpoints) {
+    pid_t pid = fork();
+    if (pid == 0) {
+      bool passed = RunChild(e, num_steps);
+      std::cout.flush();
+      _exit(passed ? 0 : 1);
+    }
+    if (pid < 0)
+      std::cout << "Failed to fork endpoint " << e.name << std::endl;
+    children.push_back(pid);
+  }
+
+  bool ok = true;
+  for (pid_t pid : children) {
+    int status = 0;
+    if (pid < 0 || waitpid(pid, &status, 0) != pid || !WIFEXITED(status) ||
+        WEXITSTATUS(status) != 0)
+      ok = false;
+  }
+  return ok;
+#endif
+}
+
+void ChHilNetHarness::Report() const {
+  for (const Opened &opened : m_opened) {
+    const ChHilTransportStats &stats = opened.transport->GetStats();
+    double rate = m_duration > 0.0 ? stats.bytes_received / m_duration : 0.0;
+    std::cout << opened.uri << ": " << stats.frames_sent << " frames sent, "
+              << stats.frames_received << " received, " << 1e-3 * rate
+              << " kB/s received" << std::endl;
+  }
+  for (const std::string &name : m_monitor.GetNames()) {
+    ChLatencyHistogram histogram = m_monitor.GetHistogram(name);
+    std::cout << name << ": " << histogram.GetCount() << " samples, mean "
+              << 1e3 * histogram.GetMean() << " ms, p50 "
+              << 1e3 * histogram.GetPercentile(50.0) << " ms, p99 "
+              << 1e3 * histogram.GetPercentile(99.0) << " ms, max "
+              << 1e3 * histogram.GetMax() << " ms" << std::endl;
+  }
+}
+
+} // namespace hil
+} // namespace chrono
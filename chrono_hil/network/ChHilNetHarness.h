@@ -0,0 +1,124 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Authors: Jason Zhou
+// =============================================================================
+//
+// Harness running a network scenario with several endpoints from one
+// executable, for tests of the transports and of the HIL protocols on top of
+// them. Each endpoint opens its transports through the harness, is advanced
+// once per step, and checks what was delivered to it at the end.
+//
+// In lockstep, all endpoints run in this process on a virtual clock: they
+// advance in the order they were added, then the clock moves one step. The
+// fault wrappers (ChHilFaultTransport) of the transports opened follow that
+// clock, so a scenario over loopback transports with seeded faults gives the
+// same deliveries on every run, independent of the load of the machine.
+//
+// Forked, each endpoint runs in a child process in real time, paced at the
+// step, and must use transports reaching across processes (tcp, udp, shm).
+// Faults then follow the steady clock.
+//
+// =============================================================================
+#ifndef CH_HIL_NET_HARNESS_H
+#define CH_HIL_NET_HARNESS_H
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "../ChApiHil.h"
+#include "../timer/ChLatencyMonitor.h"
+#include "ChHilTransport.h"
+
+namespace chrono {
+namespace hil {
+
+class ChHilNetHarness;
+
+/// One participant of a scenario
+class CH_HIL_API ChHilNetEndpoint {
+public:
+  virtual ~ChHilNetEndpoint() {}
+
+  /// Open the transports of the endpoint with ChHilNetHarness::Open and
+  /// initialize them. The endpoints are initialized concurrently.
+  virtual void Initialize(ChHilNetHarness &harness) = 0;
+
+  /// One step, time is the scenario time [s]
+  virtual void Advance(double time) = 0;
+
+  /// Check the state delivered to the endpoint at the end of the run
+  virtual bool Check() { return true; }
+};
+
+class CH_HIL_API ChHilNetHarness {
+public:
+  /// Scenario advancing by step [s]
+  ChHilNetHarness(double step);
+
+  void AddEndpoint(const std::string &name,
+                   std::shared_ptr<ChHilNetEndpoint> endpoint);
+
+  /// Create a transport from uri (ChHilTransport::Create) whose faults
+  /// follow the scenario clock. Its traffic is part of the report.
+  std::shared_ptr<ChHilTransport> Open(const std::string &uri);
+
+  /// Scenario time [s]
+  double GetTime() const;
+
+  double GetStep() const { return m_step; }
+
+  /// Histograms filled by the endpoints, e.g. with the delivery delay of
+  /// their frames in scenario time
+  ChLatencyMonitor &GetMonitor() { return m_monitor; }
+
+  /// Run num_steps steps of all endpoints in lockstep in this process.
+  /// Returns true if all endpoints pass their check.
+  bool RunLockstep(int num_steps);
+
+  /// Run num_steps steps with each endpoint in its own process. Each child
+  /// prints its report; returns true if all of them pass their check.
+  bool RunForked(int num_steps);
+
+  /// Print the traffic of the transports opened in this process, with the
+  /// throughput over the last run, and the histograms of the monitor
+  void Report() const;
+
+private:
+  struct Endpoint {
+    std::string name;
+    std::shared_ptr<ChHilNetEndpoint> endpoint;
+  };
+
+  struct Opened {
+    std::string uri;
+    std::shared_ptr<ChHilTransport> transport;
+  };
+
+  /// Run endpoint on the real clock, in a child process
+  bool RunChild(Endpoint &endpoint, int num_steps);
+
+  double m_step;
+  std::vector<Endpoint> m_endpoints;
+  bool m_virtual = true;
+  double m_time = 0.0;     // scenario time in lockstep
+  double m_start = 0.0;    // steady time of the start of a forked run
+  double m_duration = 0.0; // scenario time spanned by the last run
+
+  std::mutex m_mutex; // endpoints open their transports concurrently
+  std::vector<Opened> m_opened;
+  ChLatencyMonitor m_monitor;
+};
+
+} // namespace hil
+} // namespace chrono
+#endif
@@ -0,0 +1,162 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Authors: Jason Zhou
+// =============================================================================
+// Binary log of the frames sent and received by the HIL transports
+// =============================================================================
+
+#include "ChHilRecorder.h"
+
+#include <iostream>
+#include <map>
+
+namespace chrono {
+namespace hil {
+
+// records are buffered, the file is written when the buffer is full
+#define HIL_LOG_FILE_BUFFER (1 << 20)
+
+#pragma pack(push, 1)
+struct ChHilLogFileHeader {
+  uint32_t magic;
+  uint32_t version;
+  int64_t start_time;
+};
+
+struct ChHilLogRecordHeader {
+  int64_t time_ns;
+  uint16_t peer;
+  uint8_t direction;
+  uint8_t reserved;
+  uint32_t len;
+};
+#pragma pack(pop)
+
+ChHilRecorder::ChHilRecorder(const std::string &path) {
+  m_file = std::fopen(path.c_str(), "wb");
+  if (!m_file) {
+    std::cout << "Failed to create HIL log " << path << std::endl;
+    return;
+  }
+  m_file_buffer.resize(HIL_LOG_FILE_BUFFER);
+  std::setvbuf(m_file, m_file_buffer.data(), _IOFBF, m_file_buffer.size());
+
+  m_start = std::chrono::steady_clock::now();
+  ChHilLogFileHeader header;
+  header.magic = HIL_LOG_MAGIC;
+  header.version = HIL_LOG_VERSION;
+  header.start_time = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                          std::chrono::system_clock::now().time_since_epoch())
+                          .count();
+  std::fwrite(&header, sizeof(header), 1, m_file);
+}
+
+ChHilRecorder::~ChHilRecorder() {
+  if (m_file)
+    std::fclose(m_file);
+}
+
+void ChHilRecorder::Record(int peer, ChHilLogDirection direction,
+                           const std::vector<float> &frame) {
+  if (!m_file)
+    return;
+
+  ChHilLogRecordHeader header;
+  header.peer = static_cast<uint16_t>(peer);
+  header.direction = static_cast<uint8_t>(direction);
+  header.reserved = 0;
+  header.len = static_cast<uint32_t>(frame.size());
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (m_clock)
+    header.time_ns = m_clock();
+  else
+    header.time_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                         std::chrono::steady_clock::now() - m_start)
+                         .count();
+  std::fwrite(&header, sizeof(header), 1, m_file);
+  if (!frame.empty())
+    std::fwrite(frame.data(), sizeof(float), frame.size(), m_file);
+  m_num_records++;
+}
+
+void ChHilRecorder::SetClock(std::function<int64_t()> clock) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_clock = clock;
+}
+
+void ChHilRecorder::Flush() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (m_file)
+    std::fflush(m_file);
+}
+
+std::shared_ptr<ChHilRecorder>
+ChHilRecorder::Shared(const std::string &path) {
+  static std::mutex registry_mutex;
+  static std::map<std::string, std::weak_ptr<ChHilRecorder>> registry;
+
+  std::lock_guard<std::mutex> lock(registry_mutex);
+  auto recorder = registry[path].lock();
+  if (!recorder) {
+    recorder = std::make_shared<ChHilRecorder>(path);
+    registry[path] = recorder;
+  }
+  return recorder;
+}
+
+ChHilLogReader::~ChHilLogReader() {
+  if (m_file)
+    std::fclose(m_file);
+}
+
+bool ChHilLogReader::Open(const std::string &path) {
+  if (m_file)
+    std::fclose(m_file);
+
+  m_file = std::fopen(path.c_str(), "rb");
+  if (!m_file) {
+    std::cout << "Failed to open HIL log " << path << std::endl;
+    return false;
+  }
+
+  ChHilLogFileHeader header;
+  if (std::fread(&header, sizeof(header), 1, m_file) != 1 ||
+      header.magic != HIL_LOG_MAGIC || header.version != HIL_LOG_VERSION) {
+    std::cout << path << " is not a HIL log" << std::endl;
+    std::fclose(m_file);
+    m_file = nullptr;
+    return false;
+  }
+  m_start_time = header.start_time;
+  return true;
+}
+
+bool ChHilLogReader::Next(ChHilLogRecord &record) {
+  if (!m_file)
+    return false;
+
+  ChHilLogRecordHeader header;
+  if (std::fread(&header, sizeof(header), 1, m_file) != 1)
+    return false;
+
+  record.time_ns = header.time_ns;
+  record.peer = header.peer;
+  record.direction = static_cast<ChHilLogDirection>(header.direction);
+  record.data.resize(header.len);
+  if (header.len > 0 && std::fread(record.data.data(), sizeof(float),
+                                   header.len, m_file) != header.len)
+    return false;
+  return true;
+}
+
+} // namespace hil
+} // namespace chrono
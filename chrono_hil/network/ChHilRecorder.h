@@ -0,0 +1,116 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Authors: Jason Zhou
+// =============================================================================
+// Binary log of the frames sent and received by the HIL transports of one
+// process. A recorder is attached to a transport with SetRecorder, or with
+// the record=<file> URI parameter, see ChHilTransport::Create.
+//
+// File layout, little endian:
+//   header: uint32 magic "HILG", uint32 version, int64 wall clock of the
+//           start of the recording [ns since epoch]
+//   record: int64 time [ns since the start, monotonic, unless a clock is
+//           set with SetClock], uint16 peer,
+//           uint8 direction, uint8 reserved, uint32 n, float data[n]
+// =============================================================================
+#ifndef CH_HIL_RECORDER_H
+#define CH_HIL_RECORDER_H
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "../ChApiHil.h"
+
+namespace chrono {
+namespace hil {
+
+#define HIL_LOG_MAGIC 0x474C4948 // "HILG"
+#define HIL_LOG_VERSION 1
+
+/// Direction of a logged frame, seen from the recording process
+enum ChHilLogDirection { HIL_LOG_SENT = 0, HIL_LOG_RECEIVED = 1 };
+
+/// One logged frame
+struct ChHilLogRecord {
+  int64_t time_ns = 0; ///< time since the start of the recording, or of
+                       ///< the clock given with ChHilRecorder::SetClock
+  int peer = 0;        ///< peer id given when the recorder was attached
+  ChHilLogDirection direction = HIL_LOG_SENT;
+  std::vector<float> data;
+};
+
+class CH_HIL_API ChHilRecorder {
+public:
+  /// Create the log file, an existing file is overwritten
+  ChHilRecorder(const std::string &path);
+
+  ~ChHilRecorder();
+
+  bool IsOpen() const { return m_file != nullptr; }
+
+  /// Append one frame, thread safe
+  void Record(int peer, ChHilLogDirection direction,
+              const std::vector<float> &frame);
+
+  /// Write the buffered records to the file
+  void Flush();
+
+  uint64_t GetNumRecords() const { return m_num_records; }
+
+  /// Time stamp the following records with clock [ns] instead of the time
+  /// since the start of the recording, e.g. with the session time of a
+  /// ChSessionClock so that the logs of several nodes line up
+  void SetClock(std::function<int64_t()> clock);
+
+  /// Recorder of the given file shared by all transports of the process,
+  /// created on first use
+  static std::shared_ptr<ChHilRecorder> Shared(const std::string &path);
+
+private:
+  FILE *m_file = nullptr;
+  std::vector<char> m_file_buffer;
+  std::mutex m_mutex;
+  std::chrono::steady_clock::time_point m_start;
+  std::function<int64_t()> m_clock;
+  uint64_t m_num_records = 0;
+};
+
+class CH_HIL_API ChHilLogReader {
+public:
+  ChHilLogReader() {}
+
+  ~ChHilLogReader();
+
+  /// Open a log written by ChHilRecorder, returns false if the file cannot
+  /// be read or is not a HIL log
+  bool Open(const std::string &path);
+
+  /// Read the next record, returns false at the end of the log. A record
+  /// truncated by a crash of the recording process ends the log.
+  bool Next(ChHilLogRecord &record);
+
+  /// Wall clock of the start of the recording [ns since epoch]
+  int64_t GetStartTime() const { return m_start_time; }
+
+private:
+  FILE *m_file = nullptr;
+  int64_t m_start_time = 0;
+};
+
+} // namespace hil
+} // namespace chrono
+#endif
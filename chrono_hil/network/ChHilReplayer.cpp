@@ -0,0 +1,122 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Authors: Jason Zhou
+// =============================================================================
+// Plays a recorded HIL log back into one node, standing in for one peer
+// =============================================================================
+
+#include "ChHilReplayer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+namespace chrono {
+namespace hil {
+
+ChHilReplayer::ChHilReplayer(std::shared_ptr<ChHilTransport> link, int peer)
+    : m_link(link), m_peer(peer) {}
+
+bool ChHilReplayer::Load(const std::string &path) {
+  ChHilLogReader reader;
+  if (!reader.Open(path))
+    return false;
+
+  m_records.clear();
+  m_num_to_play = 0;
+  ChHilLogRecord record;
+  while (reader.Next(record)) {
+    if (record.peer != m_peer)
+      continue;
+    if (record.direction == HIL_LOG_RECEIVED)
+      m_num_to_play++;
+    m_records.push_back(record);
+  }
+  return true;
+}
+
+bool ChHilReplayer::Run() {
+  m_link->Initialize();
+
+  using clock = std::chrono::steady_clock;
+  clock::time_point t_start = clock::now();
+  clock::time_point t_played = t_start;
+  int64_t t_played_recorded = 0;
+  bool awaiting_response = false;
+
+  // the schedule starts with the first frame of the peer
+  int64_t t_first = m_records.empty() ? 0 : m_records.front().time_ns;
+
+  std::vector<float> frame;
+  for (const ChHilLogRecord &record : m_records) {
+    if (record.direction == HIL_LOG_RECEIVED) {
+      // frame the node received from the peer: play it on schedule
+      if (m_speed > 0.0) {
+        clock::time_point t_due =
+            t_start + std::chrono::nanoseconds(static_cast<int64_t>(
+                          (record.time_ns - t_first) / m_speed));
+        std::this_thread::sleep_until(t_due);
+        m_max_lag = std::max(
+            m_max_lag,
+            std::chrono::duration<double>(clock::now() - t_due).count());
+      }
+
+      if (!m_link->SendFrame(record.data)) {
+        std::cout << "Replay of peer " << m_peer << " stopped: send failed"
+                  << std::endl;
+        return false;
+      }
+      m_num_played++;
+      t_played = clock::now();
+      t_played_recorded = record.time_ns;
+      awaiting_response = true;
+
+      // without causality, drain what the node sent in the meantime
+      while (!m_causal && m_link->PollFrame(frame, false))
+        m_num_received++;
+    } else if (m_causal) {
+      // frame the node sent to the peer: wait for it before going on
+      if (!m_link->PollFrame(frame)) {
+        std::cout << "Replay of peer " << m_peer << " stopped: receive failed"
+                  << std::endl;
+        return false;
+      }
+      m_num_received++;
+      if (frame != record.data)
+        m_num_mismatched++;
+
+      if (awaiting_response) {
+        double response =
+            std::chrono::duration<double>(clock::now() - t_played).count();
+        double recorded = 1e-9 * (record.time_ns - t_played_recorded);
+        m_num_responses++;
+        m_sum_response += response;
+        m_max_response = std::max(m_max_response, response);
+        m_sum_recorded_response += recorded;
+        m_max_recorded_response = std::max(m_max_recorded_response, recorded);
+        awaiting_response = false;
+      }
+    }
+  }
+  return true;
+}
+
+double ChHilReplayer::GetMeanResponse() const {
+  return m_num_responses ? m_sum_response / m_num_responses : 0.0;
+}
+
+double ChHilReplayer::GetMeanRecordedResponse() const {
+  return m_num_responses ? m_sum_recorded_response / m_num_responses : 0.0;
+}
+
+} // namespace hil
+} // namespace chrono
@@ -0,0 +1,92 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Authors: Jason Zhou
+// =============================================================================
+// Plays a log written by ChHilRecorder back into the node which recorded it.
+// The replayer stands in for one peer of the node: it sends the frames the
+// node received from that peer, on the recorded schedule, and takes the
+// frames the node sends, checking them against the recording.
+// =============================================================================
+#ifndef CH_HIL_REPLAYER_H
+#define CH_HIL_REPLAYER_H
+
+#include "ChHilTransport.h"
+
+namespace chrono {
+namespace hil {
+
+class CH_HIL_API ChHilReplayer {
+public:
+  /// Stand in for the given peer of the recorded node over link, typically
+  /// the server end of the transport the node connects to
+  ChHilReplayer(std::shared_ptr<ChHilTransport> link, int peer = 0);
+
+  /// Load the records of the peer, returns false if the log cannot be read
+  bool Load(const std::string &path);
+
+  /// 1 plays at the recorded pace, 2 twice as fast, 0 as fast as possible
+  void SetSpeed(double speed) { m_speed = speed; }
+
+  /// When causal (the default), a frame is only played once the node sent
+  /// all the frames which it had sent before receiving it. Disable on lossy
+  /// links, where the node is not guaranteed to send every frame.
+  void SetCausal(bool causal) { m_causal = causal; }
+
+  /// Initialize the link and play the log back, returns false if the link
+  /// failed before the end of the log
+  bool Run();
+
+  /// Number of frames loaded for the peer, to send and to expect
+  size_t GetNumFramesToPlay() const { return m_num_to_play; }
+  size_t GetNumFramesExpected() const {
+    return m_records.size() - m_num_to_play;
+  }
+
+  uint64_t GetNumPlayed() const { return m_num_played; }
+  uint64_t GetNumReceived() const { return m_num_received; }
+
+  /// Number of frames from the node which differ from the recording
+  uint64_t GetNumMismatched() const { return m_num_mismatched; }
+
+  /// Latest a frame was played after its scheduled time [s]
+  double GetMaxLag() const { return m_max_lag; }
+
+  /// Time the node took to answer a played frame [s], in the replay and in
+  /// the recording
+  double GetMeanResponse() const;
+  double GetMaxResponse() const { return m_max_response; }
+  double GetMeanRecordedResponse() const;
+  double GetMaxRecordedResponse() const { return m_max_recorded_response; }
+
+private:
+  std::shared_ptr<ChHilTransport> m_link;
+  int m_peer;
+  double m_speed = 1.0;
+  bool m_causal = true;
+
+  std::vector<ChHilLogRecord> m_records;
+  size_t m_num_to_play = 0;
+
+  uint64_t m_num_played = 0;
+  uint64_t m_num_received = 0;
+  uint64_t m_num_mismatched = 0;
+  double m_max_lag = 0.0;
+
+  uint64_t m_num_responses = 0;
+  double m_sum_response = 0.0;
+  double m_max_response = 0.0;
+  double m_sum_recorded_response = 0.0;
+  double m_max_recorded_response = 0.0;
+};
+
+} // namespace hil
+} // namespace chrono
+#endif
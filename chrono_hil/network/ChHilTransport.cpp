@@ -0,0 +1,176 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Authors: Jason Zhou
+// =============================================================================
+// Common interface of the frame transports, and the URI factory
+// =============================================================================
+
+#include "ChHilTransport.h"
+#include "ChHilFaultTransport.h"
+#include "ChLoopbackTransport.h"
+#include "tcp/ChTCPTransport.h"
+#include "udp/ChUDPTransport.h"
+
+#ifndef _WIN32
+#include "shm/ChSHMTransport.h"
+#endif
+
+#include <iostream>
+#include <map>
+
+namespace chrono {
+namespace hil {
+
+bool ChHilTransport::SendFrame(const std::vector<float> &frame) {
+  const std::vector<float> *wire = &frame;
+  if (m_latency) {
+    m_latency->Stamp(frame, m_stamped);
+    wire = &m_stamped;
+  }
+  if (!DoSend(*wire)) {
+    m_stats.send_errors++;
+    return false;
+  }
+  m_stats.frames_sent++;
+  m_stats.bytes_sent += wire->size() * sizeof(float);
+  if (m_recorder)
+    m_recorder->Record(m_peer, HIL_LOG_SENT, frame);
+  return true;
+}
+
+bool ChHilTransport::PollFrame(std::vector<float> &frame, bool blocking) {
+  if (!DoPoll(frame, blocking)) {
+    if (!blocking)
+      m_stats.empty_polls++;
+    return false;
+  }
+  m_stats.frames_received++;
+  m_stats.bytes_received += frame.size() * sizeof(float);
+  if (m_latency)
+    m_latency->Strip(frame);
+  if (m_recorder)
+    m_recorder->Record(m_peer, HIL_LOG_RECEIVED, frame);
+  return true;
+}
+
+// split "host:port", the host may be empty
+static bool ParseHostPort(const std::string &str, std::string &host,
+                          int &port) {
+  size_t colon = str.rfind(':');
+  try {
+    if (colon == std::string::npos) {
+      host = "";
+      port = std::stoi(str);
+    } else {
+      host = str.substr(0, colon);
+      port = std::stoi(str.substr(colon + 1));
+    }
+  } catch (std::exception &) {
+    return false;
+  }
+  return true;
+}
+
+// transport of the given scheme, nullptr if the address is not valid
+static std::shared_ptr<ChHilTransport>
+CreateTransport(const std::string &scheme, const std::string &rest,
+                std::map<std::string, std::string> &query) {
+  std::string host;
+  int port = 0;
+  if (scheme == "tcp-server" && ParseHostPort(rest, host, port)) {
+    return std::make_shared<ChTCPTransport>(port);
+  } else if (scheme == "tcp" && ParseHostPort(rest, host, port) &&
+             !host.empty()) {
+    return std::make_shared<ChTCPTransport>(host, port);
+  } else if (scheme == "udp" &&
+             (rest.empty() || ParseHostPort(rest, host, port))) {
+    int listen = query.count("listen") ? std::stoi(query["listen"]) : 0;
+    int len = query.count("len") ? std::stoi(query["len"]) : 0;
+    if ((port > 0 || listen > 0) && (listen <= 0 || len > 0))
+      return std::make_shared<ChUDPTransport>(host, port, listen, len);
+#ifndef _WIN32
+  } else if (scheme == "shm-server" && !rest.empty()) {
+    return std::make_shared<ChSHMTransport>(rest, true);
+  } else if (scheme == "shm" && !rest.empty()) {
+    return std::make_shared<ChSHMTransport>(rest, false);
+#endif
+  } else if (scheme == "loopback-server" && !rest.empty()) {
+    return std::make_shared<ChLoopbackTransport>(rest, true);
+  } else if (scheme == "loopback" && !rest.empty()) {
+    return std::make_shared<ChLoopbackTransport>(rest, false);
+  }
+  return nullptr;
+}
+
+std::shared_ptr<ChHilTransport>
+ChHilTransport::Create(const std::string &uri) {
+  size_t sep = uri.find("://");
+  if (sep == std::string::npos) {
+    std::cout << "Invalid transport URI " << uri << std::endl;
+    return nullptr;
+  }
+  std::string scheme = uri.substr(0, sep);
+  std::string rest = uri.substr(sep + 3);
+
+  // query parameters, "key=value" pairs separated by '&'
+  std::map<std::string, std::string> query;
+  size_t qmark = rest.find('?');
+  if (qmark != std::string::npos) {
+    std::string params = rest.substr(qmark + 1);
+    rest = rest.substr(0, qmark);
+    size_t start = 0;
+    while (start < params.size()) {
+      size_t end = params.find('&', start);
+      if (end == std::string::npos)
+        end = params.size();
+      std::string param = params.substr(start, end - start);
+      size_t eq = param.find('=');
+      if (eq != std::string::npos)
+        query[param.substr(0, eq)] = param.substr(eq + 1);
+      start = end + 1;
+    }
+  }
+
+  std::shared_ptr<ChHilTransport> transport;
+  try {
+    transport = CreateTransport(scheme, rest, query);
+    if (transport && (query.count("delay") || query.count("jitter") ||
+                      query.count("loss") || query.count("dup") ||
+                      query.count("reorder") || query.count("rate"))) {
+      auto number = [&query](const char *key) {
+        return query.count(key) ? std::stod(query[key]) : 0.0;
+      };
+      unsigned int seed = query.count("seed") ? std::stoul(query["seed"]) : 1;
+      auto faults = std::make_shared<ChHilFaultTransport>(
+          transport, 1e-3 * number("delay"), 1e-3 * number("jitter"), seed);
+      faults->SetLoss(1e-2 * number("loss"));
+      faults->SetDuplication(1e-2 * number("dup"));
+      faults->SetReordering(1e-2 * number("reorder"));
+      faults->SetBandwidth(1e3 / 8 * number("rate"));
+      transport = faults;
+    }
+    if (transport && query.count("record")) {
+      int peer = query.count("peer") ? std::stoi(query["peer"]) : 0;
+      transport->SetRecorder(ChHilRecorder::Shared(query["record"]), peer);
+    }
+  } catch (std::exception &e) {
+    std::cout << "Failed to create transport " << uri << ": " << e.what()
+              << std::endl;
+    return nullptr;
+  }
+
+  if (!transport)
+    std::cout << "Invalid transport URI " << uri << std::endl;
+  return transport;
+}
+
+} // namespace hil
+} // namespace chrono
@@ -0,0 +1,115 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Authors: Jason Zhou
+// =============================================================================
+// Common interface of the frame transports (TCP, UDP, shared memory and
+// in-process loopback). A frame is a vector of floats; transports keep frame
+// boundaries. Transports are created from a URI, see ChHilTransport::Create.
+// =============================================================================
+#ifndef CH_HIL_TRANSPORT_H
+#define CH_HIL_TRANSPORT_H
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "../ChApiHil.h"
+#include "ChHilLatencyTracker.h"
+#include "ChHilRecorder.h"
+
+namespace chrono {
+namespace hil {
+
+/// Traffic counters, maintained by ChHilTransport for all transports
+struct ChHilTransportStats {
+  uint64_t frames_sent = 0;
+  uint64_t frames_received = 0;
+  uint64_t bytes_sent = 0;
+  uint64_t bytes_received = 0;
+  uint64_t send_errors = 0;
+  uint64_t empty_polls = 0; ///< non-blocking polls which found no frame
+};
+
+class CH_HIL_API ChHilTransport {
+public:
+  virtual ~ChHilTransport() {}
+
+  /// Connect to, or accept, the peer. Blocks until the link is up.
+  virtual void Initialize() = 0;
+
+  /// Send one frame, returns false on error
+  bool SendFrame(const std::vector<float> &frame);
+
+  /// Receive one frame. If blocking is false and no frame is pending,
+  /// returns false right away.
+  bool PollFrame(std::vector<float> &frame, bool blocking = true);
+
+  const ChHilTransportStats &GetStats() const { return m_stats; }
+
+  void ResetStats() { m_stats = ChHilTransportStats(); }
+
+  /// Log every frame sent and received on this transport, tagged with the
+  /// given peer id. Pass nullptr to stop recording.
+  void SetRecorder(std::shared_ptr<ChHilRecorder> recorder, int peer = 0) {
+    m_recorder = recorder;
+    m_peer = peer;
+  }
+
+  /// Stamp every frame sent with its time and measure the delays of the
+  /// frames received, see ChHilLatencyTracker. Both ends of the link need a
+  /// tracker. Frames grow by HIL_LATENCY_TRAILER_LEN floats on the wire,
+  /// which fixed-length receivers (the len of udp://) must account for. Pass
+  /// nullptr to stop tracking.
+  void SetLatencyTracker(std::shared_ptr<ChHilLatencyTracker> tracker) {
+    m_latency = tracker;
+  }
+
+  std::shared_ptr<ChHilLatencyTracker> GetLatencyTracker() const {
+    return m_latency;
+  }
+
+  /// Create a transport from a URI, nullptr if the URI is not valid:
+  ///   tcp-server://:port            accept one TCP client
+  ///   tcp://host:port               connect to a TCP server
+  ///   udp://host:port?listen=p&len=n
+  ///                                 send datagrams to host:port, receive
+  ///                                 datagrams of n floats on port p; either
+  ///                                 side may be omitted
+  ///   shm-server://name             shared-memory segment owner
+  ///   shm://name                    shared-memory client
+  ///   loopback-server://name        in-process channel, accepting end
+  ///   loopback://name               in-process channel, connecting end
+  /// All schemes accept record=<file>&peer=<id>, which logs the traffic to
+  /// file (shared with the other transports recording to the same file),
+  /// and delay=<ms>&jitter=<ms>&loss=<%>&dup=<%>&reorder=<%>&rate=<kbit/s>
+  /// &seed=<n>, which degrade the received frames to emulate a bad network
+  /// (see ChHilFaultTransport).
+  static std::shared_ptr<ChHilTransport> Create(const std::string &uri);
+
+protected:
+  /// Transport-specific send, called by SendFrame
+  virtual bool DoSend(const std::vector<float> &frame) = 0;
+
+  /// Transport-specific receive, called by PollFrame
+  virtual bool DoPoll(std::vector<float> &frame, bool blocking) = 0;
+
+private:
+  ChHilTransportStats m_stats;
+  std::shared_ptr<ChHilRecorder> m_recorder;
+  int m_peer = 0;
+  std::shared_ptr<ChHilLatencyTracker> m_latency;
+  std::vector<float> m_stamped;
+};
+
+} // namespace hil
+} // namespace chrono
+#endif
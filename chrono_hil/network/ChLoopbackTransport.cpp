@@ -0,0 +1,103 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Authors: Jason Zhou
+// =============================================================================
+// In-process transport, see ChLoopbackTransport.h
+// =============================================================================
+
+#include "ChLoopbackTransport.h"
+
+#include <condition_variable>
+#include <deque>
+#include <iostream>
+#include <map>
+#include <mutex>
+
+namespace chrono {
+namespace hil {
+
+struct ChLoopbackChannel {
+  std::mutex mutex;
+  std::condition_variable cv;
+  std::deque<std::vector<float>> queue[2]; // frames to be read by each side
+  bool attached[2] = {false, false};
+  bool claimed[2] = {false, false};
+};
+
+// channels by name, kept alive by the transports using them
+static std::mutex registry_mutex;
+static std::map<std::string, std::weak_ptr<ChLoopbackChannel>> registry;
+
+ChLoopbackTransport::ChLoopbackTransport(std::string name, bool server) {
+  m_name = name;
+  m_side = server ? 0 : 1;
+
+  std::lock_guard<std::mutex> lock(registry_mutex);
+  m_channel = registry[name].lock();
+  if (!m_channel) {
+    m_channel = std::make_shared<ChLoopbackChannel>();
+    registry[name] = m_channel;
+  }
+
+  std::lock_guard<std::mutex> channel_lock(m_channel->mutex);
+  if (m_channel->claimed[m_side]) {
+    std::cout << "Loopback channel " << name << " already has a "
+              << (server ? "server" : "client") << std::endl;
+  }
+  m_channel->claimed[m_side] = true;
+}
+
+ChLoopbackTransport::~ChLoopbackTransport() {
+  {
+    std::lock_guard<std::mutex> lock(m_channel->mutex);
+    m_channel->attached[m_side] = false;
+    m_channel->claimed[m_side] = false;
+  }
+  m_channel->cv.notify_all();
+
+  std::lock_guard<std::mutex> lock(registry_mutex);
+  m_channel.reset();
+  auto it = registry.find(m_name);
+  if (it != registry.end() && it->second.expired())
+    registry.erase(it);
+}
+
+void ChLoopbackTransport::Initialize() {
+  std::unique_lock<std::mutex> lock(m_channel->mutex);
+  m_channel->attached[m_side] = true;
+  m_channel->cv.notify_all();
+  m_channel->cv.wait(lock, [&]() { return m_channel->attached[1 - m_side]; });
+}
+
+bool ChLoopbackTransport::DoSend(const std::vector<float> &frame) {
+  {
+    std::lock_guard<std::mutex> lock(m_channel->mutex);
+    m_channel->queue[1 - m_side].push_back(frame);
+  }
+  m_channel->cv.notify_all();
+  return true;
+}
+
+bool ChLoopbackTransport::DoPoll(std::vector<float> &frame, bool blocking) {
+  std::unique_lock<std::mutex> lock(m_channel->mutex);
+  auto &queue = m_channel->queue[m_side];
+  if (blocking)
+    m_channel->cv.wait(lock, [&]() { return !queue.empty(); });
+  if (queue.empty())
+    return false;
+
+  frame.swap(queue.front());
+  queue.pop_front();
+  return true;
+}
+
+} // namespace hil
+} // namespace chrono
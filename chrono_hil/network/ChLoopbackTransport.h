@@ -0,0 +1,51 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Authors: Jason Zhou
+// =============================================================================
+// In-process transport. Both ends of a named channel live in the same
+// process, typically in different threads, and exchange frames through two
+// queues. Used to run distributed examples in one process, and to measure
+// the protocol cost without the kernel networking stack.
+// =============================================================================
+#ifndef CH_LOOPBACK_TRANSPORT_H
+#define CH_LOOPBACK_TRANSPORT_H
+
+#include "ChHilTransport.h"
+
+namespace chrono {
+namespace hil {
+
+struct ChLoopbackChannel;
+
+class CH_HIL_API ChLoopbackTransport : public ChHilTransport {
+public:
+  /// Create one end of the channel name. The server end plays the role of
+  /// the accepting side, each channel connects one server and one client.
+  ChLoopbackTransport(std::string name, bool server);
+
+  ~ChLoopbackTransport();
+
+  /// Wait for the other end of the channel to be initialized
+  virtual void Initialize() override;
+
+protected:
+  virtual bool DoSend(const std::vector<float> &frame) override;
+  virtual bool DoPoll(std::vector<float> &frame, bool blocking) override;
+
+private:
+  std::shared_ptr<ChLoopbackChannel> m_channel;
+  std::string m_name;
+  int m_side; // 0 for the server end, 1 for the client end
+};
+
+} // namespace hil
+} // namespace chrono
+#endif
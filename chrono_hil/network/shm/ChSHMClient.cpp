@@ -0,0 +1,199 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Authors: Jason Zhou
+// =============================================================================
+// Shared-memory counterpart of ChTCPClient for processes on the same host.
+// =============================================================================
+
+#include "ChSHMClient.h"
+#include "ChSHMRing.h"
+
+#include <fcntl.h>
+#include <iostream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace chrono {
+namespace hil {
+
+ChSHMClient::ChSHMClient(std::string name, int data_len) {
+  m_name = SHMName(name);
+  m_len = data_len;
+  m_recv_stream_data.clear();
+}
+
+ChSHMClient::~ChSHMClient() { Detach(); }
+
+void ChSHMClient::Initialize() {
+  if (Attach())
+    return;
+
+  std::cout << "Waiting for SHM server on " << m_name << std::endl;
+  while (!Attach())
+    usleep(10000);
+}
+
+bool ChSHMClient::Attach() {
+  int fd = shm_open(m_name.c_str(), O_RDWR, 0);
+  if (fd < 0)
+    return false;
+
+  struct stat st;
+  if (fstat(fd, &st) != 0 || st.st_size < (off_t)sizeof(ChSHMHeader)) {
+    close(fd);
+    return false;
+  }
+  void *ptr =
+      mmap(nullptr, st.st_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (ptr == MAP_FAILED)
+    return false;
+
+  ChSHMHeader *hdr = static_cast<ChSHMHeader *>(ptr);
+  if (hdr->magic.load(std::memory_order_acquire) != SHM_MAGIC ||
+      hdr->version != SHM_VERSION ||
+      !SHMProcessAlive(hdr->server_pid.load(std::memory_order_acquire)) ||
+      (size_t)st.st_size < SHMSegmentSize(hdr->slot_capacity)) {
+    munmap(ptr, st.st_size);
+    return false;
+  }
+
+  // claim a free slot, or the slot of a client that died
+  for (int c = 0; c < SHM_MAX_CLIENTS; c++) {
+    ChSHMClientSlot &cs = hdr->clients[c];
+    int32_t pid = cs.pid.load(std::memory_order_acquire);
+    if (pid < 0 || (pid > 0 && SHMProcessAlive(pid)))
+      continue;
+    if (!cs.pid.compare_exchange_strong(pid, -1))
+      continue;
+
+    cs.up_tail.store(0, std::memory_order_relaxed);
+    cs.up_head.store(0, std::memory_order_relaxed);
+    cs.down_tail.store(hdr->down_head.load(std::memory_order_acquire),
+                       std::memory_order_relaxed);
+    cs.pid.store(getpid(), std::memory_order_release);
+    SHMSignal(hdr->down_space);
+
+    m_hdr = hdr;
+    m_size = st.st_size;
+    m_idx = c;
+    return true;
+  }
+
+  std::cout << "No free client slot on SHM segment " << m_name << std::endl;
+  munmap(ptr, st.st_size);
+  return false;
+}
+
+void ChSHMClient::Detach() {
+  if (!m_hdr)
+    return;
+
+  // release the slot, the server may be waiting on it
+  m_hdr->clients[m_idx].pid.store(0, std::memory_order_release);
+  SHMSignal(m_hdr->down_space);
+
+  munmap(m_hdr, m_size);
+  m_hdr = nullptr;
+  m_idx = -1;
+}
+
+void ChSHMClient::CheckServer() {
+  if (SHMProcessAlive(m_hdr->server_pid.load(std::memory_order_acquire)))
+    return;
+
+  std::cout << "Lost SHM server on " << m_name << ", reconnecting"
+            << std::endl;
+  Detach();
+  while (!Attach())
+    usleep(10000);
+  m_num_reconnects++;
+}
+
+bool ChSHMClient::HasFrame() {
+  if (!m_hdr)
+    return false;
+  return m_hdr->down_head.load(std::memory_order_acquire) >
+         m_hdr->clients[m_idx].down_tail.load(std::memory_order_relaxed);
+}
+
+int ChSHMClient::Write(const std::vector<float> &write_data) {
+  return WriteFrame(write_data);
+}
+
+int ChSHMClient::Read() {
+  int ret = ReadFrame();
+  if (ret == 0)
+    m_recv_stream_data.resize(m_len);
+  return ret;
+}
+
+int ChSHMClient::WriteFrame(const std::vector<float> &write_data) {
+  if (!m_hdr)
+    return -1;
+  if (write_data.size() > m_hdr->slot_capacity) {
+    std::cout << "SHM frame of " << write_data.size()
+              << " floats exceeds the maximum of " << m_hdr->slot_capacity
+              << std::endl;
+    return -1;
+  }
+
+  while (true) {
+    ChSHMClientSlot &cs = m_hdr->clients[m_idx];
+    uint64_t head = cs.up_head.load(std::memory_order_relaxed);
+    auto has_space = [&]() {
+      return head - cs.up_tail.load(std::memory_order_acquire) <
+             SHM_NUM_SLOTS;
+    };
+    if (!SHMWait(cs.up_space, has_space)) {
+      CheckServer();
+      continue;
+    }
+
+    SHMWriteSlot(SHMSlot(m_hdr, 1 + m_idx, head), head, write_data.data(),
+                 write_data.size());
+    cs.up_head.store(head + 1, std::memory_order_release);
+    SHMSignal(cs.up_data);
+    return 1;
+  }
+}
+
+int ChSHMClient::ReadFrame() {
+  if (!m_hdr)
+    return -1;
+
+  while (true) {
+    ChSHMClientSlot &cs = m_hdr->clients[m_idx];
+    uint64_t tail = cs.down_tail.load(std::memory_order_relaxed);
+    auto ready = [&]() {
+      return m_hdr->down_head.load(std::memory_order_acquire) > tail;
+    };
+    if (!SHMWait(m_hdr->down_data, ready)) {
+      CheckServer();
+      continue;
+    }
+
+    if (!SHMReadSlot(SHMSlot(m_hdr, 0, tail), tail, m_recv_stream_data,
+                     m_hdr->slot_capacity)) {
+      // overtaken while attaching, resume from the newest frame
+      uint64_t head = m_hdr->down_head.load(std::memory_order_acquire);
+      cs.down_tail.store(head - 1, std::memory_order_release);
+      continue;
+    }
+
+    cs.down_tail.store(tail + 1, std::memory_order_release);
+    SHMSignal(m_hdr->down_space);
+    return 0;
+  }
+}
+
+} // namespace hil
+} // namespace chrono
@@ -0,0 +1,80 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Authors: Jason Zhou
+// =============================================================================
+// Shared-memory counterpart of ChTCPClient for processes on the same host.
+// If the server goes away, the client re-attaches to the next server that
+// creates the segment and carries on.
+// =============================================================================
+#ifndef CH_SHM_CLIENT_H
+#define CH_SHM_CLIENT_H
+
+#include <string>
+#include <vector>
+
+#include "../../ChApiHil.h"
+
+namespace chrono {
+namespace hil {
+
+struct ChSHMHeader;
+
+class CH_HIL_API ChSHMClient {
+public:
+  /// Create a client of the shared-memory segment name, data_len is the
+  /// length of the frames read with Read()
+  ChSHMClient(std::string name, int data_len);
+
+  ~ChSHMClient();
+
+  /// Attach to the segment, waits for the server to create it
+  void Initialize();
+
+  /// Write a frame to the server, blocks while the ring is full
+  int Write(const std::vector<float> &write_data);
+
+  /// Read a frame of data_len floats
+  int Read();
+
+  /// Write a variable-length frame
+  int WriteFrame(const std::vector<float> &write_data);
+
+  /// Read a variable-length frame
+  int ReadFrame();
+
+  const std::vector<float> &GetRecvData() const { return m_recv_stream_data; }
+
+  /// Whether a frame from the server is pending
+  bool HasFrame();
+
+  /// Number of times the client re-attached after losing the server
+  int GetNumReconnects() { return m_num_reconnects; }
+
+private:
+  /// Try to map the segment and claim a client slot
+  bool Attach();
+  void Detach();
+
+  /// Called when a wait timed out, re-attaches if the server is gone
+  void CheckServer();
+
+  ChSHMHeader *m_hdr = nullptr;
+  size_t m_size = 0;
+  int m_idx = -1; // client slot
+  std::string m_name;
+  std::vector<float> m_recv_stream_data;
+  int m_len; // fixed receive data length
+  int m_num_reconnects = 0;
+};
+
+} // namespace hil
+} // namespace chrono
+#endif
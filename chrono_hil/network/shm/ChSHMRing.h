@@ -0,0 +1,214 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// Jason Zhou
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Authors: Jason Zhou
+// =============================================================================
+// Memory layout and helpers of the shared-memory ring used by ChSHMServer and
+// ChSHMClient. Not meant to be included by user code.
+//
+// Segment layout:
+//   ChSHMHeader
+//   downstream ring, SHM_NUM_SLOTS slots (server -> all clients)
+//   upstream rings, SHM_MAX_CLIENTS x SHM_NUM_SLOTS slots (client -> server)
+//
+// Rings are bounded, writers wait for the slowest live reader. Every slot
+// is also a seqlock: the writer of frame k sets the slot sequence to
+// 2k+1, copies the frame, and releases it by setting the sequence to 2k+2.
+// =============================================================================
+
+#ifndef CH_SHM_RING_H
+#define CH_SHM_RING_H
+
+#include <atomic>
+#include <cerrno>
+#include <climits>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#include <signal.h>
+#include <sys/types.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#endif
+
+namespace chrono {
+namespace hil {
+
+#define SHM_MAGIC 0x4C494853 // "SHIL"
+#define SHM_VERSION 1
+#define SHM_NUM_SLOTS 16
+#define SHM_MAX_CLIENTS 4
+#define SHM_CACHE_LINE 64
+
+/// Number of polls before falling back to a futex wait, keeps the common case
+/// of a peer answering within microseconds off the syscall path
+#define SHM_SPIN_COUNT 4000
+
+/// Timeout of a single futex wait, after which the peer liveness is checked
+#define SHM_WAIT_TIMEOUT_MS 100
+
+/// Futex word with a waiter count, so that a signal only costs a syscall
+/// when somebody is actually sleeping on it
+struct ChSHMEvent {
+  std::atomic<uint32_t> seq;
+  std::atomic<uint32_t> waiters;
+};
+
+/// Per-client bookkeeping, fields written by different processes live on
+/// different cache lines
+struct ChSHMClientSlot {
+  /// owner process, 0 if the slot is free and -1 while it is being claimed
+  alignas(SHM_CACHE_LINE) std::atomic<int32_t> pid;
+  std::atomic<uint64_t> down_tail; ///< downstream frames consumed
+  std::atomic<uint64_t> up_head;   ///< upstream frames written
+  ChSHMEvent up_data;              ///< signaled by the client on write
+  alignas(SHM_CACHE_LINE) std::atomic<uint64_t> up_tail; ///< frames consumed
+  ChSHMEvent up_space; ///< signaled by the server on read
+};
+
+struct ChSHMHeader {
+  std::atomic<uint32_t> magic; ///< set last, once the segment is initialized
+  uint32_t version;
+  std::atomic<int32_t> server_pid; ///< 0 once the server shut down
+  uint32_t slot_capacity;          ///< max number of floats per frame
+  alignas(SHM_CACHE_LINE) std::atomic<uint64_t> down_head; ///< frames written
+  ChSHMEvent down_data;  ///< signaled by the server on write
+  ChSHMEvent down_space; ///< signaled by the clients on read
+  ChSHMClientSlot clients[SHM_MAX_CLIENTS];
+};
+
+struct ChSHMSlotHeader {
+  std::atomic<uint64_t> seq;
+  uint32_t len;
+  uint32_t pad;
+};
+
+inline size_t SHMAlign(size_t size) {
+  return (size + SHM_CACHE_LINE - 1) / SHM_CACHE_LINE * SHM_CACHE_LINE;
+}
+
+inline size_t SHMSlotSize(uint32_t capacity) {
+  return SHMAlign(sizeof(ChSHMSlotHeader) + capacity * sizeof(float));
+}
+
+inline size_t SHMSegmentSize(uint32_t capacity) {
+  return SHMAlign(sizeof(ChSHMHeader)) +
+         (1 + SHM_MAX_CLIENTS) * SHM_NUM_SLOTS * SHMSlotSize(capacity);
+}
+
+/// Slot of frame k in ring r, ring 0 is downstream and ring 1 + c is the
+/// upstream ring of client c
+inline ChSHMSlotHeader *SHMSlot(ChSHMHeader *hdr, int ring, uint64_t k) {
+  char *base = reinterpret_cast<char *>(hdr) + SHMAlign(sizeof(ChSHMHeader));
+  return reinterpret_cast<ChSHMSlotHeader *>(
+      base + (ring * SHM_NUM_SLOTS + k % SHM_NUM_SLOTS) *
+                 SHMSlotSize(hdr->slot_capacity));
+}
+
+inline float *SHMSlotData(ChSHMSlotHeader *slot) {
+  return reinterpret_cast<float *>(slot + 1);
+}
+
+/// Publish frame number k into a slot
+inline void SHMWriteSlot(ChSHMSlotHeader *slot, uint64_t k, const float *data,
+                         uint32_t len) {
+  slot->seq.store(2 * k + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  slot->len = len;
+  std::memcpy(SHMSlotData(slot), data, len * sizeof(float));
+  slot->seq.store(2 * k + 2, std::memory_order_release);
+}
+
+/// Read frame number k from a slot into data, which is resized to the frame
+/// length. Returns false if the slot does not hold frame k (anymore).
+inline bool SHMReadSlot(ChSHMSlotHeader *slot, uint64_t k,
+                        std::vector<float> &data, uint32_t capacity) {
+  uint64_t s1 = slot->seq.load(std::memory_order_acquire);
+  if (s1 != 2 * k + 2)
+    return false;
+  uint32_t len = slot->len;
+  if (len > capacity)
+    return false;
+  data.resize(len);
+  std::memcpy(data.data(), SHMSlotData(slot), len * sizeof(float));
+  std::atomic_thread_fence(std::memory_order_acquire);
+  return slot->seq.load(std::memory_order_relaxed) == s1;
+}
+
+inline void SHMCpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#endif
+}
+
+/// Wait until ready() holds, spinning first and then sleeping on the event.
+/// Returns false if the wait timed out, so that the caller can check whether
+/// its peer is still alive.
+template <class Ready> bool SHMWait(ChSHMEvent &ev, Ready ready) {
+  // spinning only pays off if the peer runs on another core
+  static const int spin_count =
+      sysconf(_SC_NPROCESSORS_ONLN) > 1 ? SHM_SPIN_COUNT : 0;
+  for (int i = 0; i < spin_count; i++) {
+    if (ready())
+      return true;
+    SHMCpuRelax();
+  }
+
+  uint32_t seq = ev.seq.load(std::memory_order_seq_cst);
+  ev.waiters.fetch_add(1, std::memory_order_seq_cst);
+  if (!ready()) {
+#ifdef __linux__
+    timespec ts;
+    ts.tv_sec = SHM_WAIT_TIMEOUT_MS / 1000;
+    ts.tv_nsec = (SHM_WAIT_TIMEOUT_MS % 1000) * 1000000L;
+    // shared (non-private) futex, the word lives in a shared mapping
+    syscall(SYS_futex, reinterpret_cast<uint32_t *>(&ev.seq), FUTEX_WAIT, seq,
+            &ts, nullptr, 0);
+#else
+    usleep(100);
+#endif
+  }
+  ev.waiters.fetch_sub(1, std::memory_order_seq_cst);
+  return ready();
+}
+
+/// Wake all the waiters of an event
+inline void SHMSignal(ChSHMEvent &ev) {
+  ev.seq.fetch_add(1, std::memory_order_seq_cst);
+  if (ev.waiters.load(std::memory_order_seq_cst) == 0)
+    return;
+#ifdef __linux__
+  syscall(SYS_futex, reinterpret_cast<uint32_t *>(&ev.seq), FUTEX_WAKE,
+          INT_MAX, nullptr, nullptr, 0);
+#endif
+}
+
+/// Whether a process is still alive
+inline bool SHMProcessAlive(int32_t pid) {
+  return pid > 0 && (kill(pid, 0) == 0 || errno != ESRCH);
+}
+
+/// Normalize a segment name to the POSIX form "/name"
+inline std::string SHMName(const std::string &name) {
+  return name.size() && name[0] == '/' ? name : "/" + name;
+}
+
+} // namespace hil
+} // namespace chrono
+
+#endif
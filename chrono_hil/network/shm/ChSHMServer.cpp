@@ -0,0 +1,212 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Authors: Jason Zhou
+// =============================================================================
+// Shared-memory counterpart of ChTCPServer for processes on the same host.
+// =============================================================================
+
+#include "ChSHMServer.h"
+#include "ChSHMRing.h"
+
+#include <fcntl.h>
+#include <iostream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace chrono {
+namespace hil {
+
+ChSHMServer::ChSHMServer(std::string name, int data_len, int max_frame_len) {
+  m_name = SHMName(name);
+  m_len = data_len;
+  m_max_frame_len = max_frame_len;
+  m_recv_stream_data.clear();
+}
+
+ChSHMServer::~ChSHMServer() {
+  if (!m_hdr)
+    return;
+
+  // wake up the clients, they will notice the server is gone
+  m_hdr->server_pid.store(0, std::memory_order_release);
+  SHMSignal(m_hdr->down_data);
+  for (int c = 0; c < SHM_MAX_CLIENTS; c++)
+    SHMSignal(m_hdr->clients[c].up_space);
+
+  munmap(m_hdr, m_size);
+  shm_unlink(m_name.c_str());
+}
+
+void ChSHMServer::Initialize(int num_clients) {
+  m_size = SHMSegmentSize(m_max_frame_len);
+
+  // a segment left behind by a server that crashed is removed, a segment
+  // owned by a live server is not
+  int fd = shm_open(m_name.c_str(), O_RDWR, 0);
+  if (fd >= 0) {
+    struct stat st;
+    if (fstat(fd, &st) == 0 && st.st_size >= (off_t)sizeof(ChSHMHeader)) {
+      void *ptr = mmap(nullptr, sizeof(ChSHMHeader), PROT_READ, MAP_SHARED,
+                       fd, 0);
+      if (ptr != MAP_FAILED) {
+        ChSHMHeader *old = static_cast<ChSHMHeader *>(ptr);
+        int32_t pid = old->server_pid.load(std::memory_order_acquire);
+        bool owned = old->magic.load(std::memory_order_acquire) == SHM_MAGIC &&
+                     pid != getpid() && SHMProcessAlive(pid);
+        munmap(ptr, sizeof(ChSHMHeader));
+        if (owned) {
+          std::cout << "SHM segment " << m_name
+                    << " is owned by another server (pid " << pid << ")"
+                    << std::endl;
+          close(fd);
+          return;
+        }
+      }
+    }
+    close(fd);
+    shm_unlink(m_name.c_str());
+  }
+
+  fd = shm_open(m_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0666);
+  if (fd < 0) {
+    std::cout << "Failed to create SHM segment " << m_name << std::endl;
+    return;
+  }
+  if (ftruncate(fd, m_size) != 0) {
+    std::cout << "Failed to size SHM segment " << m_name << std::endl;
+    close(fd);
+    shm_unlink(m_name.c_str());
+    return;
+  }
+  void *ptr = mmap(nullptr, m_size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  close(fd);
+  if (ptr == MAP_FAILED) {
+    std::cout << "Failed to map SHM segment " << m_name << std::endl;
+    shm_unlink(m_name.c_str());
+    return;
+  }
+
+  // the segment is zero-filled, which is the initial state of all counters
+  m_hdr = static_cast<ChSHMHeader *>(ptr);
+  m_hdr->version = SHM_VERSION;
+  m_hdr->slot_capacity = m_max_frame_len;
+  m_hdr->server_pid.store(getpid(), std::memory_order_relaxed);
+  m_hdr->magic.store(SHM_MAGIC, std::memory_order_release);
+
+  std::cout << "SHM server waiting for " << num_clients << " client(s) on "
+            << m_name << std::endl;
+
+  auto attached = [&]() {
+    int n = 0;
+    for (int c = 0; c < SHM_MAX_CLIENTS; c++)
+      n += m_hdr->clients[c].pid.load(std::memory_order_acquire) > 0;
+    return n >= num_clients;
+  };
+  while (!SHMWait(m_hdr->down_space, attached))
+    ReapClients();
+}
+
+int ChSHMServer::ReapClients() {
+  int num_alive = 0;
+  for (int c = 0; c < SHM_MAX_CLIENTS; c++) {
+    int32_t pid = m_hdr->clients[c].pid.load(std::memory_order_acquire);
+    if (pid <= 0)
+      continue;
+    if (SHMProcessAlive(pid)) {
+      num_alive++;
+    } else if (m_hdr->clients[c].pid.compare_exchange_strong(pid, 0)) {
+      std::cout << "SHM client " << c << " (pid " << pid
+                << ") disconnected from " << m_name << std::endl;
+    }
+  }
+  return num_alive;
+}
+
+int ChSHMServer::GetNumClients() { return m_hdr ? ReapClients() : 0; }
+
+bool ChSHMServer::HasFrame(int client) {
+  if (!m_hdr || client < 0 || client >= SHM_MAX_CLIENTS)
+    return false;
+  ChSHMClientSlot &cs = m_hdr->clients[client];
+  return cs.up_head.load(std::memory_order_acquire) >
+         cs.up_tail.load(std::memory_order_relaxed);
+}
+
+int ChSHMServer::Write(const std::vector<float> &write_data) {
+  return WriteFrame(write_data);
+}
+
+int ChSHMServer::Read(int client) {
+  int ret = ReadFrame(client);
+  if (ret == 0)
+    m_recv_stream_data.resize(m_len);
+  return ret;
+}
+
+int ChSHMServer::WriteFrame(const std::vector<float> &write_data) {
+  if (!m_hdr)
+    return -1;
+  if (write_data.size() > (size_t)m_max_frame_len) {
+    std::cout << "SHM frame of " << write_data.size()
+              << " floats exceeds the maximum of " << m_max_frame_len
+              << std::endl;
+    return -1;
+  }
+
+  // wait for the slowest attached client to free the slot
+  uint64_t head = m_hdr->down_head.load(std::memory_order_relaxed);
+  auto has_space = [&]() {
+    for (int c = 0; c < SHM_MAX_CLIENTS; c++) {
+      ChSHMClientSlot &cs = m_hdr->clients[c];
+      if (cs.pid.load(std::memory_order_acquire) > 0 &&
+          head - cs.down_tail.load(std::memory_order_acquire) >=
+              SHM_NUM_SLOTS)
+        return false;
+    }
+    return true;
+  };
+  while (!SHMWait(m_hdr->down_space, has_space))
+    ReapClients();
+
+  SHMWriteSlot(SHMSlot(m_hdr, 0, head), head, write_data.data(),
+               write_data.size());
+  m_hdr->down_head.store(head + 1, std::memory_order_release);
+  SHMSignal(m_hdr->down_data);
+  return 0;
+}
+
+int ChSHMServer::ReadFrame(int client) {
+  if (!m_hdr || client < 0 || client >= SHM_MAX_CLIENTS)
+    return -1;
+
+  ChSHMClientSlot &cs = m_hdr->clients[client];
+  while (true) {
+    // re-read every time, the slot is reset when a client re-attaches
+    uint64_t tail = cs.up_tail.load(std::memory_order_relaxed);
+    auto ready = [&]() {
+      return cs.up_head.load(std::memory_order_acquire) > tail;
+    };
+    if (!SHMWait(cs.up_data, ready)) {
+      ReapClients();
+      continue;
+    }
+
+    if (SHMReadSlot(SHMSlot(m_hdr, 1 + client, tail), tail,
+                    m_recv_stream_data, m_max_frame_len)) {
+      cs.up_tail.store(tail + 1, std::memory_order_release);
+      SHMSignal(cs.up_space);
+      return 0;
+    }
+  }
+}
+
+} // namespace hil
+} // namespace chrono
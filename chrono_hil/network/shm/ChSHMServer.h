@@ -0,0 +1,77 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Authors: Jason Zhou
+// =============================================================================
+// Shared-memory counterpart of ChTCPServer for processes on the same host.
+// Frames written by the server are seen by every attached client, each client
+// has its own ring back to the server. Clients that crash are detected and
+// their slot is handed to the next client that attaches.
+// =============================================================================
+#ifndef CH_SHM_SERVER_H
+#define CH_SHM_SERVER_H
+
+#include <string>
+#include <vector>
+
+#include "../../ChApiHil.h"
+
+namespace chrono {
+namespace hil {
+
+struct ChSHMHeader;
+
+class CH_HIL_API ChSHMServer {
+public:
+  /// Create a server on the shared-memory segment name. data_len is the
+  /// length of the frames read with Read(), max_frame_len bounds the length
+  /// of any frame exchanged in both directions.
+  ChSHMServer(std::string name, int data_len, int max_frame_len = 16384);
+
+  ~ChSHMServer();
+
+  /// Create the segment and wait for num_clients clients to attach
+  void Initialize(int num_clients = 1);
+
+  /// Write a frame to all attached clients, blocks while the ring is full
+  int Write(const std::vector<float> &write_data);
+
+  /// Read a frame of data_len floats from a client
+  int Read(int client = 0);
+
+  /// Write a variable-length frame
+  int WriteFrame(const std::vector<float> &write_data);
+
+  /// Read a variable-length frame from a client
+  int ReadFrame(int client = 0);
+
+  const std::vector<float> &GetRecvData() const { return m_recv_stream_data; }
+
+  /// Whether a frame from the client is pending
+  bool HasFrame(int client = 0);
+
+  /// Number of clients currently attached
+  int GetNumClients();
+
+private:
+  /// Free the slots of clients that died, returns the number of live clients
+  int ReapClients();
+
+  ChSHMHeader *m_hdr = nullptr;
+  size_t m_size = 0;
+  std::string m_name;
+  std::vector<float> m_recv_stream_data;
+  int m_len;           // fixed receive data length
+  int m_max_frame_len; // slot capacity in floats
+};
+
+} // namespace hil
+} // namespace chrono
+#endif
@@ -0,0 +1,59 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Authors: Jason Zhou
+// =============================================================================
+// ChHilTransport adapter of ChSHMServer and ChSHMClient
+// =============================================================================
+
+#include "ChSHMTransport.h"
+
+namespace chrono {
+namespace hil {
+
+ChSHMTransport::ChSHMTransport(std::string name, bool server) {
+  if (server)
+    m_server = std::make_shared<ChSHMServer>(name, 0);
+  else
+    m_client = std::make_shared<ChSHMClient>(name, 0);
+}
+
+void ChSHMTransport::Initialize() {
+  if (m_server)
+    m_server->Initialize();
+  else
+    m_client->Initialize();
+}
+
+bool ChSHMTransport::DoSend(const std::vector<float> &frame) {
+  if (m_server)
+    return m_server->WriteFrame(frame) >= 0;
+  return m_client->WriteFrame(frame) >= 0;
+}
+
+bool ChSHMTransport::DoPoll(std::vector<float> &frame, bool blocking) {
+  if (m_server) {
+    if (!blocking && !m_server->HasFrame())
+      return false;
+    if (m_server->ReadFrame() != 0)
+      return false;
+    frame = m_server->GetRecvData();
+  } else {
+    if (!blocking && !m_client->HasFrame())
+      return false;
+    if (m_client->ReadFrame() != 0)
+      return false;
+    frame = m_client->GetRecvData();
+  }
+  return true;
+}
+
+} // namespace hil
+} // namespace chrono
@@ -0,0 +1,43 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Authors: Jason Zhou
+// =============================================================================
+// ChHilTransport adapter of ChSHMServer and ChSHMClient
+// =============================================================================
+#ifndef CH_SHM_TRANSPORT_H
+#define CH_SHM_TRANSPORT_H
+
+#include "../ChHilTransport.h"
+#include "ChSHMClient.h"
+#include "ChSHMServer.h"
+
+namespace chrono {
+namespace hil {
+
+class CH_HIL_API ChSHMTransport : public ChHilTransport {
+public:
+  /// Owner (server) or client end of the shared-memory segment name
+  ChSHMTransport(std::string name, bool server);
+
+  virtual void Initialize() override;
+
+protected:
+  virtual bool DoSend(const std::vector<float> &frame) override;
+  virtual bool DoPoll(std::vector<float> &frame, bool blocking) override;
+
+private:
+  std::shared_ptr<ChSHMServer> m_server;
+  std::shared_ptr<ChSHMClient> m_client;
+};
+
+} // namespace hil
+} // namespace chrono
+#endif
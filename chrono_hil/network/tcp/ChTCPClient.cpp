@@ -16,6 +16,7 @@
 #include "ChTCPClient.h"
 
 #include <algorithm>
+#include <array>
 #include <climits>
 #include <fstream>
 #include <iostream>
@@ -25,9 +26,11 @@
 namespace chrono {
 namespace hil {
 
-ChTCPClient::ChTCPClient(std::string ip_addr, int port_in, int data_len) {
+ChTCPClient::ChTCPClient(std::string ip_addr, int port_in, int data_len,
+                         int max_frame_len) {
   m_port = port_in;
   m_len = data_len;
+  m_max_frame_len = max_frame_len;
   m_addr = ip_addr;
   m_recv_stream_data.clear();
 }
@@ -42,7 +45,7 @@ void ChTCPClient::Initialize() {
   m_socket->connect(*m_tcpendpt);
 }
 
-int ChTCPClient::Write(std::vector<float> write_data) {
+int ChTCPClient::Write(const std::vector<float> &write_data) {
   boost::asio::write(*m_socket,
                      boost::asio::buffer(write_data.data(),
                                          sizeof(float) * write_data.size()));
@@ -64,5 +67,42 @@ int ChTCPClient::Read() {
   return 0;
 };
 
+int ChTCPClient::WriteFrame(const std::vector<float> &write_data) {
+  uint32_t frame_len = write_data.size();
+  // gathered from the stack, no allocation per frame
+  std::array<boost::asio::const_buffer, 2> buffers = {
+      boost::asio::buffer(&frame_len, sizeof(uint32_t)),
+      boost::asio::buffer(write_data.data(),
+                          sizeof(float) * write_data.size())};
+  boost::asio::write(*m_socket, buffers);
+  return 1;
+}
+
+int ChTCPClient::ReadFrame() {
+  uint32_t frame_len = 0;
+  boost::asio::read(*m_socket,
+                    boost::asio::buffer(&frame_len, sizeof(uint32_t)));
+
+  // a corrupt or hostile length, the stream cannot be resynchronized
+  if (frame_len > static_cast<uint32_t>(m_max_frame_len)) {
+    std::cout << "TCP: frame of " << frame_len
+              << " floats exceeds the limit of " << m_max_frame_len
+              << ", closing the connection" << std::endl;
+    m_recv_stream_data.clear();
+    boost::system::error_code ec;
+    m_socket->close(ec);
+    return -1;
+  }
+
+  m_recv_stream_data.resize(frame_len);
+  if (frame_len > 0) {
+    boost::asio::read(*m_socket,
+                      boost::asio::buffer(m_recv_stream_data.data(),
+                                          frame_len * sizeof(float)));
+  }
+
+  return 0;
+}
+
 } // namespace hil
 } // namespace chrono
\ No newline at end of file
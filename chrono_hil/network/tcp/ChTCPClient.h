@@ -36,17 +36,32 @@ namespace hil {
 // target speed specified in target_speed
 class CH_HIL_API ChTCPClient {
 public:
-  ChTCPClient(std::string ip_addr, int port_in, int data_len); // create
+  /// Create a client of ip_addr:port_in. data_len is the length of the frames
+  /// read with Read(), max_frame_len bounds the length of the frames read
+  /// with ReadFrame.
+  ChTCPClient(std::string ip_addr, int port_in, int data_len,
+              int max_frame_len = 16384);
 
   ~ChTCPClient();
 
   void Initialize(); // create socket and send signal to acceptor
 
-  int Write(std::vector<float> write_data);
+  int Write(const std::vector<float> &write_data);
 
   int Read();
 
-  std::vector<float> GetRecvData() { return m_recv_stream_data; }
+  /// Write a variable-length frame, prefixed with its float count
+  int WriteFrame(const std::vector<float> &write_data);
+
+  /// Read a variable-length frame written by WriteFrame on the peer. A frame
+  /// longer than max_frame_len is a protocol error: the connection is closed
+  /// and -1 returned.
+  int ReadFrame();
+
+  const std::vector<float> &GetRecvData() const { return m_recv_stream_data; }
+
+  /// Number of bytes received and not read yet
+  size_t Available() { return m_socket->available(); }
 
 private:
   std::shared_ptr<boost::asio::io_service> m_io_service;
@@ -55,6 +70,7 @@ private:
   std::vector<float> m_recv_stream_data;
   int m_port; // fixed port connection
   int m_len;  // fixed receive data length
+  int m_max_frame_len; // longest frame read by ReadFrame, in floats
   std::string m_addr;
 };
 
@@ -0,0 +1,91 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Authors: Jason Zhou
+// =============================================================================
+// ChHilTransport adapter of ChTCPServer and ChTCPClient
+// =============================================================================
+
+#include "ChTCPTransport.h"
+
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+namespace chrono {
+namespace hil {
+
+ChTCPTransport::ChTCPTransport(int port) {
+  m_server = std::make_shared<ChTCPServer>(port, 0);
+}
+
+ChTCPTransport::ChTCPTransport(std::string ip_addr, int port) {
+  m_client = std::make_shared<ChTCPClient>(ip_addr, port, 0);
+}
+
+void ChTCPTransport::Initialize() {
+  if (m_server) {
+    m_server->Initialize();
+    return;
+  }
+
+  // like the other transports, wait for the server to come up
+  bool waiting = false;
+  while (true) {
+    try {
+      m_client->Initialize();
+      return;
+    } catch (std::exception &e) {
+      if (!waiting)
+        std::cout << "Waiting for TCP server: " << e.what() << std::endl;
+      waiting = true;
+      std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+  }
+}
+
+bool ChTCPTransport::DoSend(const std::vector<float> &frame) {
+  try {
+    if (m_server)
+      m_server->WriteFrame(frame);
+    else
+      m_client->WriteFrame(frame);
+  } catch (std::exception &e) {
+    std::cout << "TCP transport send failed: " << e.what() << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool ChTCPTransport::DoPoll(std::vector<float> &frame, bool blocking) {
+  try {
+    // a frame starts with its length, wait for that before blocking on it
+    size_t available = m_server ? m_server->Available() : m_client->Available();
+    if (!blocking && available < sizeof(uint32_t))
+      return false;
+
+    if (m_server) {
+      if (m_server->ReadFrame() != 0)
+        return false;
+      frame = m_server->GetRecvData();
+    } else {
+      if (m_client->ReadFrame() != 0)
+        return false;
+      frame = m_client->GetRecvData();
+    }
+  } catch (std::exception &e) {
+    std::cout << "TCP transport receive failed: " << e.what() << std::endl;
+    return false;
+  }
+  return true;
+}
+
+} // namespace hil
+} // namespace chrono
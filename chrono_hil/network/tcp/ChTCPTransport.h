@@ -0,0 +1,47 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Authors: Jason Zhou
+// =============================================================================
+// ChHilTransport adapter of ChTCPServer and ChTCPClient. Frames are sent with
+// WriteFrame/ReadFrame, so that frame boundaries survive the byte stream.
+// =============================================================================
+#ifndef CH_TCP_TRANSPORT_H
+#define CH_TCP_TRANSPORT_H
+
+#include "../ChHilTransport.h"
+#include "ChTCPClient.h"
+#include "ChTCPServer.h"
+
+namespace chrono {
+namespace hil {
+
+class CH_HIL_API ChTCPTransport : public ChHilTransport {
+public:
+  /// Server end, accepts one client on port
+  ChTCPTransport(int port);
+
+  /// Client end, connects to ip_addr:port
+  ChTCPTransport(std::string ip_addr, int port);
+
+  virtual void Initialize() override;
+
+protected:
+  virtual bool DoSend(const std::vector<float> &frame) override;
+  virtual bool DoPoll(std::vector<float> &frame, bool blocking) override;
+
+private:
+  std::shared_ptr<ChTCPServer> m_server;
+  std::shared_ptr<ChTCPClient> m_client;
+};
+
+} // namespace hil
+} // namespace chrono
+#endif
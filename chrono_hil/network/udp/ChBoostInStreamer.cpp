@@ -18,7 +18,10 @@
 #include "ChBoostInStreamer.h"
 
 #include <algorithm>
+#include <array>
+#include <cerrno>
 #include <climits>
+#include <cstring>
 #include <fstream>
 #include <iostream>
 #include <sstream>
@@ -39,23 +42,214 @@ ChBoostInStreamer::ChBoostInStreamer(int port_in, int data_len) {
                                                             *m_udpendpt);
 }
 
+ChBoostInStreamer::ChBoostInStreamer(std::string group_addr, int port_in,
+                                     int data_len, std::string interface_addr) {
+  m_port = port_in;
+  m_len = data_len;
+  m_group_addr = group_addr;
+  m_interface_addr = interface_addr;
+  m_recv_stream_data.clear();
+
+  m_io_context = std::make_shared<boost::asio::io_context>();
+  m_udpendpt =
+      std::make_shared<boost::asio::ip::udp::endpoint>(udp::v4(), m_port);
+  m_socket = std::make_shared<boost::asio::ip::udp::socket>(*m_io_context);
+  m_socket->open(udp::v4());
+  m_socket->set_option(boost::asio::ip::udp::socket::reuse_address(true));
+  m_socket->bind(*m_udpendpt);
+  JoinGroup();
+}
+
 ChBoostInStreamer::~ChBoostInStreamer() {}
 
+void ChBoostInStreamer::JoinGroup() {
+  if (m_interface_addr.empty()) {
+    m_socket->set_option(boost::asio::ip::multicast::join_group(
+        address::from_string(m_group_addr)));
+  } else {
+    m_socket->set_option(boost::asio::ip::multicast::join_group(
+        address::from_string(m_group_addr).to_v4(),
+        address::from_string(m_interface_addr).to_v4()));
+  }
+}
+
+void ChBoostInStreamer::Interrupt() {
+  std::lock_guard<std::mutex> lock(m_interrupt_mutex);
+  m_interrupted = true;
+  // a shut down socket wakes up its receivers on Linux; the error (not
+  // connected) is expected on a UDP socket
+  boost::system::error_code err;
+  m_socket->shutdown(boost::asio::socket_base::shutdown_receive, err);
+}
+
+bool ChBoostInStreamer::Reopen() {
+  if (!m_interrupted)
+    return false;
+  std::lock_guard<std::mutex> lock(m_interrupt_mutex);
+  m_interrupted = false;
+  boost::system::error_code err;
+  m_socket->close(err);
+  m_socket->open(udp::v4());
+  if (!m_group_addr.empty())
+    m_socket->set_option(boost::asio::ip::udp::socket::reuse_address(true));
+  m_socket->bind(udp::endpoint(udp::v4(), m_port));
+  if (!m_group_addr.empty())
+    JoinGroup();
+  std::cout << "UDP receiver on port " << m_port << " interrupted, reopened"
+            << std::endl;
+  return true;
+}
+
+size_t ChBoostInStreamer::Available() {
+  Reopen();
+  return m_socket->available();
+}
+
 int ChBoostInStreamer::Synchronize() {
   float udp_float_arr[m_len];
+  uint32_t seq = 0;
 
   m_recv_stream_data.clear();
 
-  if (m_socket->receive_from(
-          boost::asio::buffer(&udp_float_arr, sizeof(float) * m_len),
-          *m_udpendpt)) {
-    for (int i = 0; i < m_len; i++) {
-      m_recv_stream_data.push_back(udp_float_arr[i]);
+  while (true) {
+    // an empty sequence buffer without sequence numbers
+    std::array<boost::asio::mutable_buffer, 2> buffers = {
+        boost::asio::buffer(&seq, m_use_seq ? sizeof(uint32_t) : 0),
+        boost::asio::buffer(&udp_float_arr, sizeof(float) * m_len)};
+
+    size_t received = m_socket->receive_from(buffers, *m_udpendpt);
+    if (Reopen())
+      return -1;
+    if (!received) {
+      return 0;
+    }
+
+    if (!m_use_seq) {
+      break;
     }
+
+    if (AcceptSequence(seq)) {
+      break;
+    }
+
+    // late or duplicated datagram, wait for the next one
+  }
+
+  m_num_received++;
+  for (int i = 0; i < m_len; i++) {
+    m_recv_stream_data.push_back(udp_float_arr[i]);
   }
 
   return 0;
 }
 
+bool ChBoostInStreamer::AcceptSequence(uint32_t seq) {
+  // signed distance to the expected sequence number, robust to wrap-around
+  int32_t diff = (int32_t)(seq - m_next_seq);
+  if (m_first_seq || diff >= 0) {
+    if (!m_first_seq) {
+      m_num_lost += diff;
+    }
+    m_first_seq = false;
+    m_next_seq = seq + 1;
+    return true;
+  }
+
+  m_num_dropped++;
+  return false;
+}
+
+void ChBoostInStreamer::ReserveBatch(int max_frames) {
+  if (m_batch_seqs.size() >= static_cast<size_t>(max_frames))
+    return;
+
+  m_batch_buf.resize(max_frames * m_len);
+  m_batch_seqs.resize(max_frames);
+
+#ifdef __linux__
+  m_msgs.resize(max_frames);
+  m_iovs.resize(max_frames * 2); // sequence number and data
+#endif
+}
+
+int ChBoostInStreamer::SynchronizeBatch(int max_frames) {
+  ReserveBatch(max_frames);
+  m_batch_count = 0;
+
+#ifdef __linux__
+  int iov_per_msg = m_use_seq ? 2 : 1;
+  for (int i = 0; i < max_frames; i++) {
+    struct iovec *iov = &m_iovs[i * 2];
+    if (m_use_seq) {
+      iov->iov_base = &m_batch_seqs[i];
+      iov->iov_len = sizeof(uint32_t);
+      iov++;
+    }
+    iov->iov_base = &m_batch_buf[i * m_len];
+    iov->iov_len = sizeof(float) * m_len;
+
+    std::memset(&m_msgs[i], 0, sizeof(struct mmsghdr));
+    m_msgs[i].msg_hdr.msg_iov = &m_iovs[i * 2];
+    m_msgs[i].msg_hdr.msg_iovlen = iov_per_msg;
+  }
+
+  int ret;
+  do {
+    ret = recvmmsg(m_socket->native_handle(), m_msgs.data(), max_frames,
+                   MSG_WAITFORONE, nullptr);
+  } while (ret < 0 && errno == EINTR);
+
+  if (Reopen())
+    return -1;
+  if (ret <= 0) {
+    return 0;
+  }
+
+  // drop late datagrams and compact the accepted ones
+  for (int i = 0; i < ret; i++) {
+    if (m_use_seq && !AcceptSequence(m_batch_seqs[i]))
+      continue;
+    if (m_batch_count != i) {
+      std::memcpy(&m_batch_buf[m_batch_count * m_len], &m_batch_buf[i * m_len],
+                  sizeof(float) * m_len);
+    }
+    m_batch_count++;
+  }
+#else
+  while (m_batch_count < max_frames) {
+    // block for the first datagram only
+    if (m_batch_count > 0 && m_socket->available() == 0)
+      break;
+
+    uint32_t seq = 0;
+    std::array<boost::asio::mutable_buffer, 2> buffers = {
+        boost::asio::buffer(&seq, m_use_seq ? sizeof(uint32_t) : 0),
+        boost::asio::buffer(&m_batch_buf[m_batch_count * m_len],
+                            sizeof(float) * m_len)};
+    size_t received = m_socket->receive_from(buffers, *m_udpendpt);
+    if (Reopen()) {
+      m_batch_count = 0;
+      return -1;
+    }
+    if (!received)
+      break;
+
+    if (m_use_seq && !AcceptSequence(seq))
+      continue;
+    m_batch_count++;
+  }
+#endif
+
+  m_num_received += m_batch_count;
+
+  // the newest datagram is also available through GetRecvData
+  if (m_batch_count > 0) {
+    const float *last = GetBatchFrame(m_batch_count - 1);
+    m_recv_stream_data.assign(last, last + m_len);
+  }
+
+  return m_batch_count;
+}
+
 } // namespace hil
 } // namespace chrono
\ No newline at end of file
@@ -16,6 +16,8 @@
 #ifndef CH_BOOST_INTERFACE_H
 #define CH_BOOST_INTERFACE_H
 
+#include <atomic>
+#include <mutex>
 #include <string>
 
 #include "../../ChApiHil.h"
@@ -23,6 +25,10 @@
 #include <boost/asio.hpp>
 #include <boost/bind.hpp>
 
+#ifdef __linux__
+#include <sys/socket.h>
+#endif
+
 using boost::asio::ip::address;
 using boost::asio::ip::udp;
 
@@ -36,13 +42,62 @@ class CH_HIL_API ChBoostInStreamer {
 public:
   ChBoostInStreamer(int port_in, int data_len);
 
+  /// Receive datagrams sent to a multicast group. The port may be shared with
+  /// other receivers on the same host. interface_addr selects the local
+  /// interface the group is joined on (any interface if empty).
+  ChBoostInStreamer(std::string group_addr, int port_in, int data_len,
+                    std::string interface_addr = "");
+
   ~ChBoostInStreamer();
 
   void Initialize();
 
+  /// Receive one datagram, blocking until it arrives. Returns -1, with no
+  /// data, if the receive was interrupted.
   int Synchronize();
 
-  std::vector<float> GetRecvData() { return m_recv_stream_data; }
+  /// Wake up a receive blocked in another thread (on Linux), or make the
+  /// next one return at once, without data. The receiving thread then
+  /// reopens the socket, dropping the datagrams queued in it. Thread safe,
+  /// e.g. the reset action of a ChWatchdog.
+  void Interrupt();
+
+  const std::vector<float> &GetRecvData() const { return m_recv_stream_data; }
+
+  /// Number of bytes received and not read yet; an interrupted socket is
+  /// reopened first, as by the receives, so that it can be polled
+  size_t Available();
+
+  /// Socket handle, to wait for datagrams with poll or select
+  udp::socket::native_handle_type GetNativeHandle() {
+    return m_socket->native_handle();
+  }
+
+  /// Receive up to max_frames datagrams. Blocks until at least one datagram
+  /// is available, then also takes the datagrams already queued in the
+  /// socket. On Linux this is a single recvmmsg call into pre-allocated
+  /// buffers; elsewhere, one receive_from per datagram. Returns the number of
+  /// datagrams received, -1 if the receive was interrupted.
+  int SynchronizeBatch(int max_frames);
+
+  /// Number of datagrams received by the last SynchronizeBatch call
+  int GetBatchFrameCount() { return m_batch_count; }
+
+  /// Data of the i-th datagram received by the last SynchronizeBatch call
+  const float *GetBatchFrame(int i) { return &m_batch_buf[i * m_len]; }
+
+  /// Expect a 32-bit sequence number in front of every datagram, see
+  /// ChBoostOutStreamer::EnableSequenceNumbers
+  void EnableSequenceNumbers(bool enable) { m_use_seq = enable; }
+
+  /// Number of datagrams accepted so far
+  uint64_t GetNumReceived() { return m_num_received; }
+
+  /// Number of datagrams detected as lost (gaps in the sequence numbers)
+  uint64_t GetNumLost() { return m_num_lost; }
+
+  /// Number of late or duplicated datagrams, which were dropped
+  uint64_t GetNumDropped() { return m_num_dropped; }
 
 private:
   std::shared_ptr<boost::asio::io_context> m_io_context;
@@ -51,6 +106,36 @@ private:
   std::vector<float> m_recv_stream_data;
   int m_port;
   int m_len;
+
+  bool m_use_seq = false;
+  bool m_first_seq = true;
+  uint32_t m_next_seq = 0;
+  uint64_t m_num_received = 0;
+  uint64_t m_num_lost = 0;
+  uint64_t m_num_dropped = 0;
+
+  bool AcceptSequence(uint32_t seq);
+
+  // multicast group joined, empty for unicast
+  std::string m_group_addr;
+  std::string m_interface_addr;
+  void JoinGroup();
+
+  // set by Interrupt, the receiving thread reopens the socket; the mutex
+  // keeps Interrupt off a socket being reopened
+  std::atomic<bool> m_interrupted{false};
+  std::mutex m_interrupt_mutex;
+  bool Reopen();
+
+  // pre-allocated batch receive buffers
+  void ReserveBatch(int max_frames);
+  int m_batch_count = 0;
+  std::vector<float> m_batch_buf;
+  std::vector<uint32_t> m_batch_seqs;
+#ifdef __linux__
+  std::vector<struct mmsghdr> m_msgs;
+  std::vector<struct iovec> m_iovs;
+#endif
 };
 
 } // namespace hil
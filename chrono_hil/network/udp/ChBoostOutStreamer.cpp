@@ -17,7 +17,10 @@
 #include "ChBoostOutStreamer.h"
 
 #include <algorithm>
+#include <array>
+#include <cerrno>
 #include <climits>
+#include <cstring>
 #include <fstream>
 #include <iostream>
 #include <sstream>
@@ -34,6 +37,11 @@ ChBoostOutStreamer::ChBoostOutStreamer(std::string end_ip_addr, int port) {
   m_remote_endpoint = std::make_shared<boost::asio::ip::udp::endpoint>(
       address::from_string(m_end_ip_addr), m_port);
   m_socket->open(udp::v4());
+
+  // a single hop by default, multicast traffic stays on the local network
+  if (IsMulticast()) {
+    SetMulticast(1);
+  }
 }
 
 void ChBoostOutStreamer::AddData(float data_in) {
@@ -44,23 +52,120 @@ void ChBoostOutStreamer::AddVehicleStruct(ChronoVehicleInfo info) {
   m_stream_vehicle_data.push_back(info);
 }
 
+void ChBoostOutStreamer::SetMulticast(int ttl, std::string interface_addr,
+                                      bool loopback) {
+  if (!IsMulticast()) {
+    std::cout << "ChBoostOutStreamer: " << m_end_ip_addr
+              << " is not a multicast group" << std::endl;
+    return;
+  }
+
+  m_socket->set_option(boost::asio::ip::multicast::hops(ttl));
+  m_socket->set_option(boost::asio::ip::multicast::enable_loopback(loopback));
+  if (!interface_addr.empty()) {
+    m_socket->set_option(boost::asio::ip::multicast::outbound_interface(
+        address::from_string(interface_addr).to_v4()));
+  }
+}
+
 void ChBoostOutStreamer::Synchronize() {
-  if (m_stream_vehicle_data.size() != 0) {
-    boost::system::error_code err;
-    auto sent = m_socket->send_to(
+  // an empty sequence buffer without sequence numbers, so that sending
+  // does not allocate
+  std::array<boost::asio::const_buffer, 2> buffers = {
+      boost::asio::buffer(&m_seq, m_use_seq ? sizeof(uint32_t) : 0),
+      boost::asio::const_buffer()};
+
+  bool send_vehicle_data = m_stream_vehicle_data.size() != 0;
+  if (send_vehicle_data) {
+    buffers[1] =
         boost::asio::buffer(m_stream_vehicle_data.data(),
-                            sizeof(long long) * m_stream_vehicle_data.size()),
-        *m_remote_endpoint, 0, err);
+                            sizeof(long long) * m_stream_vehicle_data.size());
+  } else {
+    buffers[1] = boost::asio::buffer(m_stream_data.data(),
+                                     sizeof(float) * m_stream_data.size());
+  }
+
+  boost::system::error_code err;
+  auto sent = m_socket->send_to(buffers, *m_remote_endpoint, 0, err);
+  m_seq++;
+
+  if (send_vehicle_data) {
     m_stream_vehicle_data.clear();
   } else {
-    boost::system::error_code err;
-    auto sent = m_socket->send_to(
-        boost::asio::buffer(m_stream_data.data(),
-                            sizeof(float) * m_stream_data.size()),
-        *m_remote_endpoint, 0, err);
     m_stream_data.clear();
   }
 }
 
+void ChBoostOutStreamer::QueueFrame() {
+  m_batch_offsets.push_back(m_batch_data.size());
+  m_batch_seqs.push_back(m_seq++);
+  m_batch_data.insert(m_batch_data.end(), m_stream_data.begin(),
+                      m_stream_data.end());
+  m_stream_data.clear();
+}
+
+int ChBoostOutStreamer::SynchronizeBatch() {
+  int num_frames = m_batch_offsets.size();
+  m_batch_offsets.push_back(m_batch_data.size()); // end of the last frame
+
+#ifdef __linux__
+  int iov_per_msg = m_use_seq ? 2 : 1;
+  m_msgs.resize(std::max(m_batch_size, 1));
+  m_iovs.resize(m_msgs.size() * iov_per_msg);
+
+  int sent = 0;
+  while (sent < num_frames) {
+    int n = std::min((int)m_msgs.size(), num_frames - sent);
+    for (int i = 0; i < n; i++) {
+      int f = sent + i;
+      struct iovec *iov = &m_iovs[i * iov_per_msg];
+      if (m_use_seq) {
+        iov->iov_base = &m_batch_seqs[f];
+        iov->iov_len = sizeof(uint32_t);
+        iov++;
+      }
+      iov->iov_base = m_batch_data.data() + m_batch_offsets[f];
+      iov->iov_len =
+          sizeof(float) * (m_batch_offsets[f + 1] - m_batch_offsets[f]);
+
+      struct msghdr &hdr = m_msgs[i].msg_hdr;
+      std::memset(&hdr, 0, sizeof(hdr));
+      hdr.msg_name = m_remote_endpoint->data();
+      hdr.msg_namelen = m_remote_endpoint->size();
+      hdr.msg_iov = &m_iovs[i * iov_per_msg];
+      hdr.msg_iovlen = iov_per_msg;
+    }
+
+    int ret = sendmmsg(m_socket->native_handle(), m_msgs.data(), n, 0);
+    if (ret <= 0) {
+      if (ret < 0 && errno == EINTR)
+        continue;
+      break; // datagrams which could not be sent are dropped, as with send_to
+    }
+    sent += ret;
+  }
+#else
+  int sent = 0;
+  for (int f = 0; f < num_frames; f++) {
+    std::array<boost::asio::const_buffer, 2> buffers = {
+        boost::asio::buffer(&m_batch_seqs[f],
+                            m_use_seq ? sizeof(uint32_t) : 0),
+        boost::asio::buffer(m_batch_data.data() + m_batch_offsets[f],
+                            sizeof(float) * (m_batch_offsets[f + 1] -
+                                             m_batch_offsets[f]))};
+
+    boost::system::error_code err;
+    m_socket->send_to(buffers, *m_remote_endpoint, 0, err);
+    if (!err)
+      sent++;
+  }
+#endif
+
+  m_batch_data.clear();
+  m_batch_offsets.clear();
+  m_batch_seqs.clear();
+  return sent;
+}
+
 } // namespace hil
 } // namespace chrono
\ No newline at end of file
@@ -23,6 +23,10 @@
 #include <boost/asio.hpp>
 #include <boost/bind.hpp>
 
+#ifdef __linux__
+#include <sys/socket.h>
+#endif
+
 using boost::asio::ip::address;
 using boost::asio::ip::udp;
 
@@ -44,6 +48,8 @@ struct ChronoVehicleInfo {
 class CH_HIL_API ChBoostOutStreamer {
 public:
   /// Construct an interactive driver.
+  /// If end_ip_addr is a multicast group address, every datagram is sent once
+  /// to the group, and all receivers which joined the group get a copy.
   ChBoostOutStreamer(std::string end_ip_addr, int port);
 
   ~ChBoostOutStreamer() { m_socket->close(); };
@@ -54,6 +60,33 @@ public:
 
   void Synchronize();
 
+  /// Set the multicast time-to-live (number of router hops) and the local
+  /// interface datagrams are sent from. Only valid for a multicast group.
+  void SetMulticast(int ttl, std::string interface_addr = "",
+                    bool loopback = true);
+
+  /// Prefix every datagram with a 32-bit sequence number, which allows
+  /// receivers to detect lost and reordered datagrams. Must match the setting
+  /// of the receiving ChBoostInStreamer.
+  void EnableSequenceNumbers(bool enable) { m_use_seq = enable; }
+
+  /// Queue the data added so far as one datagram, to be sent together with
+  /// other queued datagrams by SynchronizeBatch
+  void QueueFrame();
+
+  /// Send all queued datagrams. On Linux, up to GetBatchSize() datagrams are
+  /// handed to the kernel per sendmmsg call; elsewhere, this falls back to
+  /// one send_to per datagram. Returns the number of datagrams sent.
+  int SynchronizeBatch();
+
+  /// Set the maximum number of datagrams sent per syscall
+  void SetBatchSize(int batch_size) { m_batch_size = batch_size; }
+
+  int GetBatchSize() { return m_batch_size; }
+
+  /// Whether the destination is a multicast group
+  bool IsMulticast() { return m_remote_endpoint->address().is_multicast(); }
+
 private:
   std::shared_ptr<boost::asio::io_service> m_io_service;
   std::shared_ptr<boost::asio::ip::udp::socket> m_socket;
@@ -62,6 +95,20 @@ private:
   std::vector<ChronoVehicleInfo> m_stream_vehicle_data;
   std::string m_end_ip_addr;
   int m_port;
+
+  bool m_use_seq = false;
+  uint32_t m_seq = 0;
+
+  // queued datagrams, stored back to back, reused from batch to batch
+  int m_batch_size = 64;
+  std::vector<float> m_batch_data;
+  std::vector<size_t> m_batch_offsets;
+  std::vector<uint32_t> m_batch_seqs;
+
+#ifdef __linux__
+  std::vector<struct mmsghdr> m_msgs;
+  std::vector<struct iovec> m_iovs;
+#endif
 };
 
 } // namespace hil
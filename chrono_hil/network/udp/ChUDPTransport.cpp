@@ -0,0 +1,65 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Authors: Jason Zhou
+// =============================================================================
+// ChHilTransport adapter of ChBoostOutStreamer and ChBoostInStreamer
+// =============================================================================
+
+#include "ChUDPTransport.h"
+
+#include <iostream>
+
+namespace chrono {
+namespace hil {
+
+ChUDPTransport::ChUDPTransport(std::string ip_out, int port_out, int port_in,
+                               int data_len) {
+  if (port_out > 0)
+    m_out = std::make_shared<ChBoostOutStreamer>(ip_out, port_out);
+  if (port_in > 0)
+    m_in = std::make_shared<ChBoostInStreamer>(port_in, data_len);
+}
+
+bool ChUDPTransport::DoSend(const std::vector<float> &frame) {
+  if (!m_out) {
+    std::cout << "UDP transport has no destination" << std::endl;
+    return false;
+  }
+
+  try {
+    for (float value : frame)
+      m_out->AddData(value);
+    m_out->Synchronize();
+  } catch (std::exception &e) {
+    std::cout << "UDP transport send failed: " << e.what() << std::endl;
+    return false;
+  }
+  return true;
+}
+
+bool ChUDPTransport::DoPoll(std::vector<float> &frame, bool blocking) {
+  if (!m_in)
+    return false;
+
+  try {
+    if (!blocking && m_in->Available() == 0)
+      return false;
+    m_in->Synchronize();
+  } catch (std::exception &e) {
+    std::cout << "UDP transport receive failed: " << e.what() << std::endl;
+    return false;
+  }
+  frame = m_in->GetRecvData();
+  return true;
+}
+
+} // namespace hil
+} // namespace chrono
@@ -0,0 +1,46 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Authors: Jason Zhou
+// =============================================================================
+// ChHilTransport adapter of ChBoostOutStreamer and ChBoostInStreamer. One
+// frame is one datagram; delivery is not guaranteed.
+// =============================================================================
+#ifndef CH_UDP_TRANSPORT_H
+#define CH_UDP_TRANSPORT_H
+
+#include "../ChHilTransport.h"
+#include "ChBoostInStreamer.h"
+#include "ChBoostOutStreamer.h"
+
+namespace chrono {
+namespace hil {
+
+class CH_HIL_API ChUDPTransport : public ChHilTransport {
+public:
+  /// Send datagrams to ip_out:port_out and receive datagrams of data_len
+  /// floats on port_in. Either direction is disabled with a port <= 0.
+  ChUDPTransport(std::string ip_out, int port_out, int port_in, int data_len);
+
+  /// Nothing to do, UDP is connectionless
+  virtual void Initialize() override {}
+
+protected:
+  virtual bool DoSend(const std::vector<float> &frame) override;
+  virtual bool DoPoll(std::vector<float> &frame, bool blocking) override;
+
+private:
+  std::shared_ptr<ChBoostOutStreamer> m_out;
+  std::shared_ptr<ChBoostInStreamer> m_in;
+};
+
+} // namespace hil
+} // namespace chrono
+#endif
@@ -0,0 +1,26 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Authors: Jason Zhou
+// =============================================================================
+//
+// Cache line size the lock-free primitives pad their shared state to, so
+// that the indices written by different threads never share a line
+//
+// =============================================================================
+
+#ifndef CH_CACHE_LINE_H
+#define CH_CACHE_LINE_H
+
+// x86-64 and most ARM cores; 128 on Apple silicon, where 64 only costs
+// some false sharing
+#define HIL_CACHE_LINE 64
+
+#endif
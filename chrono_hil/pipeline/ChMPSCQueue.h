@@ -0,0 +1,104 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Authors: Jason Zhou
+// =============================================================================
+//
+// Bounded queue from any number of producer threads to one consumer, e.g.
+// events of the input, network and sensor threads to the real-time loop.
+// Nothing is allocated after construction and nothing ever blocks.
+//
+// Each cell carries a sequence number telling whether it is free for the
+// producer of a given position or holds the item of the consumer's
+// position. Producers claim a position with a compare-and-swap on the tail
+// (lock-free: a producer only retries when another one got the position);
+// the consumer is wait-free. A producer preempted between its claim and
+// its write holds back the items behind it until it resumes: TryPop then
+// returns false, as for an empty queue.
+//
+// =============================================================================
+
+#ifndef CH_MPSC_QUEUE_H
+#define CH_MPSC_QUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+
+#include "ChCacheLine.h"
+
+namespace chrono {
+namespace hil {
+
+template <typename T, size_t N> class ChMPSCQueue {
+  static_assert(N > 0 && (N & (N - 1)) == 0,
+                "the capacity must be a power of two");
+
+public:
+  ChMPSCQueue() {
+    for (size_t i = 0; i < N; i++)
+      m_cells[i].sequence.store(i, std::memory_order_relaxed);
+  }
+
+  /// Append value, returns false if the queue is full; any thread
+  bool TryPush(const T &value) {
+    size_t pos = m_tail.load(std::memory_order_relaxed);
+    while (true) {
+      Cell &cell = m_cells[pos & (N - 1)];
+      size_t sequence = cell.sequence.load(std::memory_order_acquire);
+      intptr_t diff = (intptr_t)sequence - (intptr_t)pos;
+      if (diff == 0) {
+        // free for this position, claim it
+        if (m_tail.compare_exchange_weak(pos, pos + 1,
+                                         std::memory_order_relaxed)) {
+          cell.value = value;
+          cell.sequence.store(pos + 1, std::memory_order_release);
+          return true;
+        }
+      } else if (diff < 0) {
+        // still holds the item of the previous lap
+        return false;
+      } else {
+        pos = m_tail.load(std::memory_order_relaxed);
+      }
+    }
+  }
+
+  /// Take the oldest item into value, returns false if the queue is empty;
+  /// consumer only
+  bool TryPop(T &value) {
+    Cell &cell = m_cells[m_head & (N - 1)];
+    if (cell.sequence.load(std::memory_order_acquire) != m_head + 1)
+      return false;
+    value = std::move(cell.value);
+    // free for the producer of the next lap
+    cell.sequence.store(m_head + N, std::memory_order_release);
+    m_head++;
+    return true;
+  }
+
+  static constexpr size_t Capacity() { return N; }
+
+private:
+  struct alignas(HIL_CACHE_LINE) Cell {
+    std::atomic<size_t> sequence;
+    T value;
+  };
+
+  alignas(HIL_CACHE_LINE) std::atomic<size_t> m_tail{0};
+  alignas(HIL_CACHE_LINE) size_t m_head = 0;
+  Cell m_cells[N];
+};
+
+} // namespace hil
+} // namespace chrono
+
+#endif
@@ -0,0 +1,74 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Authors: Jason Zhou
+// =============================================================================
+//
+// Render system copy of the visible bodies of a physics system
+//
+// =============================================================================
+
+#include "ChRenderMirror.h"
+
+namespace chrono {
+namespace hil {
+
+ChRenderMirror::ChRenderMirror(ChRenderPipeline &pipeline,
+                               ChSystem *render_sys)
+    : m_pipeline(pipeline), m_render_sys(render_sys) {}
+
+std::shared_ptr<ChBody>
+ChRenderMirror::AddBody(std::shared_ptr<ChBody> body) {
+  auto it = m_by_body.find(body.get());
+  if (it != m_by_body.end())
+    return it->second;
+
+  // a plain body at the visual model frame of the source, so that the
+  // shared shapes land where they do on a ChBodyAuxRef too
+  auto mirror = chrono_types::make_shared<ChBody>();
+  mirror->SetBodyFixed(true);
+  mirror->SetCollide(false);
+  const ChFrame<> &frame = body->GetVisualModelFrame();
+  mirror->SetPos(frame.GetPos());
+  mirror->SetRot(frame.GetRot());
+  if (body->GetVisualModel())
+    mirror->AddVisualModel(body->GetVisualModel());
+  m_render_sys->AddBody(mirror);
+
+  int index = m_pipeline.AddBody(body);
+  m_mirrors.push_back(std::make_pair(index, mirror));
+  m_by_body[body.get()] = mirror;
+  return mirror;
+}
+
+void ChRenderMirror::AddSystem(ChSystem *sys) {
+  for (auto &body : sys->Get_bodylist()) {
+    if (body->GetVisualModel())
+      AddBody(body);
+  }
+}
+
+std::shared_ptr<ChBody>
+ChRenderMirror::GetMirror(std::shared_ptr<ChBody> body) const {
+  auto it = m_by_body.find(body.get());
+  return it != m_by_body.end() ? it->second : nullptr;
+}
+
+void ChRenderMirror::Apply(const ChPoseSnapshot &snapshot) {
+  for (auto &entry : m_mirrors) {
+    const ChBodyPose &pose = snapshot.poses[entry.first];
+    entry.second->SetPos(pose.pos);
+    entry.second->SetRot(pose.rot);
+  }
+  m_render_sys->SetChTime(snapshot.time);
+}
+
+} // namespace hil
+} // namespace chrono
@@ -0,0 +1,70 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Authors: Jason Zhou
+// =============================================================================
+//
+// Copy of the visible bodies of a physics system in a render system, posed
+// from the snapshots of a ChRenderPipeline. Each body with a visual model
+// gets a fixed mirror body sharing that visual model, so the render thread
+// can run Irrlicht or a ChSensorManager on the render system while the
+// physics thread steps its own. Sensors are attached to the mirror bodies
+// (GetMirror).
+//
+// The bodies are mirrored once; bodies added to the physics system later,
+// e.g. zombies of late nodes, are mirrored with AddBody before Start.
+//
+// =============================================================================
+
+#ifndef CH_RENDER_MIRROR_H
+#define CH_RENDER_MIRROR_H
+
+#include <map>
+#include <memory>
+#include <vector>
+
+#include "../ChApiHil.h"
+#include "ChRenderPipeline.h"
+#include "chrono/physics/ChBody.h"
+#include "chrono/physics/ChSystem.h"
+
+namespace chrono {
+namespace hil {
+
+class CH_HIL_API ChRenderMirror {
+public:
+  /// Mirror into render_sys the bodies published by pipeline
+  ChRenderMirror(ChRenderPipeline &pipeline, ChSystem *render_sys);
+
+  /// Publish the pose of body and mirror it, returns the mirror body
+  std::shared_ptr<ChBody> AddBody(std::shared_ptr<ChBody> body);
+
+  /// Mirror all the bodies of sys which have a visual model
+  void AddSystem(ChSystem *sys);
+
+  /// Mirror of body, null if body is not mirrored
+  std::shared_ptr<ChBody> GetMirror(std::shared_ptr<ChBody> body) const;
+
+  /// Pose the mirror bodies and set the time of the render system; call
+  /// on the render thread, as the first consumer of the pipeline
+  void Apply(const ChPoseSnapshot &snapshot);
+
+private:
+  ChRenderPipeline &m_pipeline;
+  ChSystem *m_render_sys;
+
+  std::vector<std::pair<int, std::shared_ptr<ChBody>>> m_mirrors;
+  std::map<ChBody *, std::shared_ptr<ChBody>> m_by_body;
+};
+
+} // namespace hil
+} // namespace chrono
+
+#endif
@@ -0,0 +1,111 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Authors: Jason Zhou
+// =============================================================================
+//
+// Pose snapshots handed from the physics thread to a render thread
+//
+// =============================================================================
+
+#include "ChRenderPipeline.h"
+#include "../timer/ChRealtimePacer.h"
+
+namespace chrono {
+namespace hil {
+
+ChRenderPipeline::~ChRenderPipeline() { Stop(); }
+
+int ChRenderPipeline::AddSource(Source source) {
+  m_sources.push_back(source);
+  return static_cast<int>(m_sources.size()) - 1;
+}
+
+void ChRenderPipeline::Start() {
+  if (m_thread.joinable())
+    return;
+  m_stop = false;
+  m_ready = false;
+  m_thread = std::thread(&ChRenderPipeline::RenderLoop, this);
+
+  std::unique_lock<std::mutex> lock(m_mutex);
+  m_cv.wait(lock, [&] { return m_ready; });
+}
+
+void ChRenderPipeline::Stop() {
+  if (!m_thread.joinable())
+    return;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+  m_cv.notify_one();
+  m_thread.join();
+}
+
+void ChRenderPipeline::Publish(double time) {
+  ChPoseSnapshot &snapshot = m_buffer.GetWriteBuffer();
+  snapshot.frame = m_frame;
+  snapshot.time = time;
+  snapshot.poses.resize(m_sources.size());
+  for (size_t i = 0; i < m_sources.size(); i++)
+    snapshot.poses[i] = m_sources[i]();
+  snapshot.wall = ChRealtimePacer::Now();
+  m_buffer.Publish();
+  m_frame++;
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_published = m_frame;
+  }
+  m_cv.notify_one();
+}
+
+void ChRenderPipeline::RenderLoop() {
+  if (m_init)
+    m_init();
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_ready = true;
+  }
+  m_cv.notify_one();
+
+  uint64_t seen = 0;
+  uint64_t next = 0; // frame expected next
+  while (true) {
+    {
+      std::unique_lock<std::mutex> lock(m_mutex);
+      m_cv.wait(lock, [&] { return m_published != seen || m_stop; });
+      if (m_stop)
+        break;
+      seen = m_published;
+    }
+    if (!m_buffer.Update())
+      continue;
+
+    const ChPoseSnapshot &snapshot = m_buffer.GetReadBuffer();
+    m_skipped += snapshot.frame - next;
+    next = snapshot.frame + 1;
+
+    double start = ChRealtimePacer::Now();
+    for (auto &consumer : m_consumers)
+      consumer(snapshot);
+    double end = ChRealtimePacer::Now();
+    m_cost.Record(end - start);
+    m_latency.Record(end - snapshot.wall);
+    m_consumed++;
+  }
+
+  if (m_exit)
+    m_exit();
+}
+
+} // namespace hil
+} // namespace chrono
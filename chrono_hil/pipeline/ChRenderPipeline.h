@@ -0,0 +1,149 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Authors: Jason Zhou
+// =============================================================================
+//
+// Pipeline between the physics and the rendering of a simulation. After
+// each step, the physics thread publishes a snapshot of the poses of the
+// bodies it was given (chassis, wheels, ROM and zombie bodies) into a
+// triple buffer, and goes on with the next step. A render thread takes the
+// latest snapshot and hands it to the consumers (e.g. Irrlicht rendering,
+// ChSensorManager::Update), one frame behind the physics. A slow render
+// frame no longer delays the dynamics: the consumers skip the snapshots
+// published while they were busy.
+//
+// A snapshot is never written while a consumer reads it, and holds the
+// poses of one single step. The consumers must not touch the bodies of
+// the physics system; ChRenderMirror keeps copies of them, posed from the
+// snapshots, in a system owned by the render thread.
+//
+// =============================================================================
+
+#ifndef CH_RENDER_PIPELINE_H
+#define CH_RENDER_PIPELINE_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "../ChApiHil.h"
+#include "../timer/ChLatencyHistogram.h"
+#include "ChTripleBuffer.h"
+#include "chrono/core/ChQuaternion.h"
+#include "chrono/core/ChVector.h"
+
+namespace chrono {
+namespace hil {
+
+/// Pose of a body in the absolute frame
+struct ChBodyPose {
+  ChVector<> pos;
+  ChQuaternion<> rot;
+};
+
+/// Poses of the bodies of the pipeline after one physics step
+struct ChPoseSnapshot {
+  uint64_t frame = 0; // index of the step
+  double time = 0.0;  // simulated time [s]
+  double wall = 0.0;  // monotonic time of the publication [s]
+  std::vector<ChBodyPose> poses;
+};
+
+class CH_HIL_API ChRenderPipeline {
+public:
+  typedef std::function<ChBodyPose()> Source;
+  typedef std::function<void(const ChPoseSnapshot &snapshot)> Consumer;
+
+  ChRenderPipeline() {}
+  ~ChRenderPipeline();
+
+  /// Add a pose to the snapshots, read on the physics thread by Publish.
+  /// Returns its index in ChPoseSnapshot::poses.
+  int AddSource(Source source);
+
+  /// Add the pose of the visual model of body (the frame its visual shapes
+  /// are placed in), e.g. a ChBody or a ChBodyAuxRef
+  template <typename Body> int AddBody(std::shared_ptr<Body> body) {
+    return AddSource([body]() {
+      auto frame = body->GetVisualModelFrame();
+      return ChBodyPose{frame.GetPos(), frame.GetRot()};
+    });
+  }
+
+  /// Called on the render thread before the first snapshot, e.g. to create
+  /// the window and the GL context the consumers render to. Start waits for
+  /// it, so it may read the physics system, which does not step meanwhile.
+  void SetInit(std::function<void()> init) { m_init = init; }
+
+  /// Called on the render thread once stopped, e.g. to release the window
+  /// and the sensor manager created by the init
+  void SetExit(std::function<void()> exit) { m_exit = exit; }
+
+  /// Called on the render thread with each snapshot taken, in the order
+  /// they were added
+  void AddConsumer(Consumer consumer) { m_consumers.push_back(consumer); }
+
+  /// Start the render thread and wait for its init; add the sources and
+  /// consumers before
+  void Start();
+
+  /// Stop the render thread after the snapshot it is consuming
+  void Stop();
+
+  /// Publish the poses of the sources at simulated time time [s]. Call on
+  /// the physics thread after each step; never waits for the consumers.
+  void Publish(double time);
+
+  uint64_t GetNumPublished() const { return m_frame; }
+
+  /// Snapshots consumed and skipped by the render thread, final once
+  /// stopped
+  uint64_t GetNumConsumed() const { return m_consumed; }
+  uint64_t GetNumSkipped() const { return m_skipped; }
+
+  /// Wall time from the publication of a snapshot to the end of its
+  /// consumption, and time spent in the consumers per snapshot
+  const ChLatencyHistogram &GetLatency() const { return m_latency; }
+  const ChLatencyHistogram &GetCost() const { return m_cost; }
+
+private:
+  void RenderLoop();
+
+  std::vector<Source> m_sources;
+  std::vector<Consumer> m_consumers;
+  std::function<void()> m_init;
+  std::function<void()> m_exit;
+
+  ChTripleBuffer<ChPoseSnapshot> m_buffer;
+  uint64_t m_frame = 0;
+
+  std::thread m_thread;
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  uint64_t m_published = 0; // guarded by m_mutex, wakes the render thread
+  bool m_stop = false;
+  bool m_ready = false; // init over, guarded by m_mutex
+
+  // written by the render thread
+  uint64_t m_consumed = 0;
+  uint64_t m_skipped = 0;
+  ChLatencyHistogram m_latency;
+  ChLatencyHistogram m_cost;
+};
+
+} // namespace hil
+} // namespace chrono
+
+#endif
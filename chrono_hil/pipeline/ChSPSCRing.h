@@ -0,0 +1,94 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Authors: Jason Zhou
+// =============================================================================
+//
+// Bounded wait-free ring between one producer and one consumer thread, e.g.
+// log records from the real-time loop to a writer thread. TryPush and
+// TryPop never wait: they fail on a full or an empty ring.
+//
+// The producer owns the tail and the consumer the head, each on its own
+// cache line. Each side keeps a copy of the index of the other, and only
+// reloads it when the ring looks full or empty, so the two cores rarely
+// touch the same line.
+//
+// The items live in the ring: for large items or capacities, allocate the
+// ring on the heap.
+//
+// =============================================================================
+
+#ifndef CH_SPSC_RING_H
+#define CH_SPSC_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+
+#include "ChCacheLine.h"
+
+namespace chrono {
+namespace hil {
+
+template <typename T, size_t N> class ChSPSCRing {
+  static_assert(N > 0 && (N & (N - 1)) == 0,
+                "the capacity must be a power of two");
+
+public:
+  /// Append value, returns false if the ring is full; producer only
+  bool TryPush(const T &value) {
+    size_t tail = m_tail.load(std::memory_order_relaxed);
+    if (tail - m_head_cache == N) {
+      m_head_cache = m_head.load(std::memory_order_acquire);
+      if (tail - m_head_cache == N)
+        return false;
+    }
+    m_items[tail & (N - 1)] = value;
+    m_tail.store(tail + 1, std::memory_order_release);
+    return true;
+  }
+
+  /// Take the oldest item into value, returns false if the ring is empty;
+  /// consumer only
+  bool TryPop(T &value) {
+    size_t head = m_head.load(std::memory_order_relaxed);
+    if (head == m_tail_cache) {
+      m_tail_cache = m_tail.load(std::memory_order_acquire);
+      if (head == m_tail_cache)
+        return false;
+    }
+    value = std::move(m_items[head & (N - 1)]);
+    m_head.store(head + 1, std::memory_order_release);
+    return true;
+  }
+
+  /// Items in the ring; approximate while the other thread runs
+  size_t Size() const {
+    // the head first, it never passes a later tail
+    size_t head = m_head.load(std::memory_order_acquire);
+    return m_tail.load(std::memory_order_acquire) - head;
+  }
+
+  static constexpr size_t Capacity() { return N; }
+
+private:
+  alignas(HIL_CACHE_LINE) std::atomic<size_t> m_tail{0};
+  size_t m_head_cache = 0; // head as last seen by the producer
+
+  alignas(HIL_CACHE_LINE) std::atomic<size_t> m_head{0};
+  size_t m_tail_cache = 0; // tail as last seen by the consumer
+
+  alignas(HIL_CACHE_LINE) T m_items[N];
+};
+
+} // namespace hil
+} // namespace chrono
+
+#endif
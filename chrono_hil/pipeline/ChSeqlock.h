@@ -0,0 +1,102 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Authors: Jason Zhou
+// =============================================================================
+//
+// Sequence lock over a plain state (e.g. the chassis state or the driver
+// inputs) written by one thread and read by any number of threads. The
+// writer never waits; a reader which overlapped a write retries, and only
+// ever returns a state of one single write.
+//
+// The sequence is odd during a write. The state is held in atomic words
+// written with release and read with acquire ordering (plain moves on
+// x86), so that a read racing with a write is well defined, and clean
+// under ThreadSanitizer, which does not model fences.
+//
+// =============================================================================
+
+#ifndef CH_SEQLOCK_H
+#define CH_SEQLOCK_H
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <thread>
+#include <type_traits>
+
+#include "ChCacheLine.h"
+
+namespace chrono {
+namespace hil {
+
+template <typename T> class ChSeqlock {
+  static_assert(std::is_trivially_copyable<T>::value,
+                "the state must be trivially copyable");
+
+public:
+  ChSeqlock() {
+    for (size_t i = 0; i < WORDS; i++)
+      m_words[i].store(0, std::memory_order_relaxed);
+  }
+
+  /// Write the state; writer thread only
+  void Store(const T &value) {
+    uint64_t words[WORDS] = {};
+    std::memcpy(words, &value, sizeof(T));
+
+    uint64_t sequence = m_sequence.load(std::memory_order_relaxed);
+    m_sequence.store(sequence + 1, std::memory_order_relaxed);
+    // a reader seeing any new word sees the odd sequence
+    for (size_t i = 0; i < WORDS; i++)
+      m_words[i].store(words[i], std::memory_order_release);
+    m_sequence.store(sequence + 2, std::memory_order_release);
+  }
+
+  /// Read the state into value, returns false if a write overlapped
+  bool TryLoad(T &value) const {
+    uint64_t sequence = m_sequence.load(std::memory_order_acquire);
+    if (sequence & 1)
+      return false;
+    uint64_t words[WORDS];
+    // the sequence is read again after all the words
+    for (size_t i = 0; i < WORDS; i++)
+      words[i] = m_words[i].load(std::memory_order_acquire);
+    if (m_sequence.load(std::memory_order_relaxed) != sequence)
+      return false;
+    std::memcpy(&value, words, sizeof(T));
+    return true;
+  }
+
+  /// Read the state, retrying until no write overlaps; a zero state
+  /// before the first write
+  T Load() const {
+    T value;
+    while (!TryLoad(value))
+      std::this_thread::yield();
+    return value;
+  }
+
+  /// Writes so far
+  uint64_t GetVersion() const {
+    return m_sequence.load(std::memory_order_acquire) / 2;
+  }
+
+private:
+  static const size_t WORDS = (sizeof(T) + 7) / 8;
+
+  alignas(HIL_CACHE_LINE) std::atomic<uint64_t> m_sequence{0};
+  std::atomic<uint64_t> m_words[WORDS];
+};
+
+} // namespace hil
+} // namespace chrono
+
+#endif
@@ -0,0 +1,76 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Authors: Jason Zhou
+// =============================================================================
+//
+// Lock-free triple buffer between one writer and one reader thread. The
+// writer fills its buffer and publishes it, the reader takes the latest
+// published buffer; neither ever waits for the other. A reader slower than
+// the writer skips the buffers published in between.
+//
+// The three buffers rotate between the writer, the reader and the middle
+// slot. One atomic holds the index of the middle buffer and a flag telling
+// whether it was published since the reader last took it. The buffers and
+// the indices of each side sit on cache lines of their own.
+//
+// =============================================================================
+
+#ifndef CH_TRIPLE_BUFFER_H
+#define CH_TRIPLE_BUFFER_H
+
+#include <atomic>
+
+#include "ChCacheLine.h"
+
+namespace chrono {
+namespace hil {
+
+template <typename T> class ChTripleBuffer {
+public:
+  /// Buffer of the writer, to fill before Publish
+  T &GetWriteBuffer() { return m_buffers[m_write].value; }
+
+  /// Hand the write buffer over to the reader, and take a free one
+  void Publish() {
+    m_write = m_middle.exchange(m_write | FRESH, std::memory_order_acq_rel) &
+              INDEX;
+  }
+
+  /// Take the latest published buffer, returns false if none was published
+  /// since the last call
+  bool Update() {
+    if (!(m_middle.load(std::memory_order_acquire) & FRESH))
+      return false;
+    m_read = m_middle.exchange(m_read, std::memory_order_acq_rel) & INDEX;
+    return true;
+  }
+
+  /// Buffer of the reader, as of the last Update
+  const T &GetReadBuffer() const { return m_buffers[m_read].value; }
+
+private:
+  static const int INDEX = 3;
+  static const int FRESH = 4;
+
+  struct alignas(HIL_CACHE_LINE) Buffer {
+    T value;
+  };
+
+  Buffer m_buffers[3];
+  alignas(HIL_CACHE_LINE) int m_write = 0;
+  alignas(HIL_CACHE_LINE) int m_read = 1;
+  alignas(HIL_CACHE_LINE) std::atomic<int> m_middle{2};
+};
+
+} // namespace hil
+} // namespace chrono
+
+#endif
@@ -0,0 +1,140 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Authors: Jason Zhou
+// =============================================================================
+//
+// Degrades and restores the optional work of a loop to keep its frames in
+// real time
+//
+// =============================================================================
+
+#include "ChFrameGovernor.h"
+#include "ChTaskScheduler.h"
+
+#include <algorithm>
+#include <iomanip>
+#include <iostream>
+
+namespace chrono {
+namespace hil {
+
+int ChFrameGovernor::AddKnob(const std::string &name, int levels,
+                             Setter setter, int priority) {
+  Knob knob;
+  knob.name = name;
+  knob.levels = std::max(1, levels);
+  knob.setter = setter;
+  knob.priority = priority;
+  m_knobs.push_back(knob);
+  return static_cast<int>(m_knobs.size()) - 1;
+}
+
+int ChFrameGovernor::AddTaskKnob(ChTaskScheduler &scheduler, int task,
+                                 int levels, int priority) {
+  double period = scheduler.GetPeriod(task);
+  return AddKnob(
+      scheduler.GetName(task), levels,
+      [&scheduler, task, period](int level) {
+        scheduler.SetPeriod(task, period * (1 << level));
+      },
+      priority);
+}
+
+bool ChFrameGovernor::Update(double busy, double time) {
+  m_frames++;
+  m_busy += busy;
+  if (busy > m_step)
+    m_overruns++;
+  if (m_frames < m_window)
+    return false;
+
+  double load = m_busy / (m_frames * m_step);
+  double overruns = (double)m_overruns / m_frames;
+  m_frames = 0;
+  m_busy = 0.0;
+  m_overruns = 0;
+  m_since_restore++;
+
+  if (load > m_degrade || overruns > HIL_GOVERNOR_OVERRUN_SHARE) {
+    m_good = 0;
+    // lowest priority first, in the order of registration
+    int knob = -1;
+    for (int i = 0; i < GetNumKnobs(); i++) {
+      if (m_knobs[i].level < m_knobs[i].levels - 1 &&
+          (knob < 0 || m_knobs[i].priority < m_knobs[knob].priority))
+        knob = i;
+    }
+    if (knob < 0)
+      return false;
+
+    // the last restore did not hold, wait longer before the next one
+    if (m_restored >= 0 && m_since_restore <= 1)
+      m_backoff = std::min(2 * m_backoff, HIL_GOVERNOR_MAX_BACKOFF);
+    m_restored = -1;
+    Change(knob, 1, time, load, overruns);
+    return true;
+  }
+
+  if (load >= m_restore) {
+    m_good = 0;
+    return false;
+  }
+
+  if (++m_good < m_restore_windows * m_backoff)
+    return false;
+  m_good = 0;
+
+  // highest priority first
+  int knob = -1;
+  for (int i = 0; i < GetNumKnobs(); i++) {
+    if (m_knobs[i].level > 0 &&
+        (knob < 0 || m_knobs[i].priority > m_knobs[knob].priority))
+      knob = i;
+  }
+  if (knob < 0) {
+    m_backoff = 1;
+    return false;
+  }
+  m_restored = knob;
+  m_since_restore = 0;
+  Change(knob, -1, time, load, overruns);
+  return true;
+}
+
+void ChFrameGovernor::Change(int knob, int change, double time, double load,
+                             double overruns) {
+  Knob &entry = m_knobs[knob];
+  entry.level += change;
+  entry.setter(entry.level);
+
+  ChGovernorDecision decision;
+  decision.time = time;
+  decision.knob = knob;
+  decision.level = entry.level;
+  decision.load = load;
+  decision.overruns = overruns;
+  m_decisions.push_back(decision);
+
+  if (m_print) {
+    std::ios::fmtflags flags = std::cout.flags();
+    std::streamsize precision = std::cout.precision();
+    std::cout << std::fixed << std::setprecision(2) << "Governor: " << time
+              << " s, load " << load << ", " << std::setprecision(0)
+              << 100 * overruns << "% overruns: " << entry.name
+              << (change > 0 ? " degraded" : " restored") << " to level "
+              << entry.level << "/" << entry.levels - 1 << std::endl;
+    std::cout.flags(flags);
+    std::cout.precision(precision);
+  }
+}
+
+} // namespace hil
+} // namespace chrono
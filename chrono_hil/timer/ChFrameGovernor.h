@@ -0,0 +1,148 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Authors: Jason Zhou
+// =============================================================================
+//
+// Frame time governor of a HIL main loop. The optional work of the loop
+// (render rate, lidar rate, zombie updates, background ROM fidelity, log
+// frequency) is registered as knobs with a number of levels, level 0 being
+// full quality, and a priority. The governor is fed the busy time of each
+// frame and, over windows of frames, its load against the step:
+//   - a window over the degrade load, or with too many overruns, lowers the
+//     knob of lowest priority which can still go down by one level
+//   - restore windows in a row under the restore load raise the knob of
+//     highest priority which is degraded by one level
+// The gap between the two loads and the windows in a row are the
+// hysteresis; a knob degraded again right after its restore doubles the
+// windows needed before the next restore. Every decision is logged.
+//
+// With ChTaskScheduler::SetGovernor, the scheduler feeds the governor, and
+// a task knob doubles the period of its task at each level.
+//
+// =============================================================================
+
+#ifndef CH_FRAME_GOVERNOR_H
+#define CH_FRAME_GOVERNOR_H
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "../ChApiHil.h"
+
+namespace chrono {
+namespace hil {
+
+class ChTaskScheduler;
+
+#define HIL_GOVERNOR_WINDOW 50         // frames of a decision window
+#define HIL_GOVERNOR_DEGRADE 0.9       // load which degrades
+#define HIL_GOVERNOR_RESTORE 0.6       // load which restores
+#define HIL_GOVERNOR_RESTORE_WINDOWS 4 // good windows in a row to restore
+#define HIL_GOVERNOR_OVERRUN_SHARE 0.1 // share of frames over the step
+#define HIL_GOVERNOR_MAX_BACKOFF 16    // cap of the restore windows factor
+
+/// One change of level of a knob
+struct ChGovernorDecision {
+  double time; // simulated time [s]
+  int knob;
+  int level;       // new level
+  double load;     // mean load of the window which decided
+  double overruns; // share of the frames of the window over the step
+};
+
+class CH_HIL_API ChFrameGovernor {
+public:
+  /// Applies a level of a knob, 0 being full quality
+  typedef std::function<void(int level)> Setter;
+
+  /// Govern frames of step [s]
+  ChFrameGovernor(double step) : m_step(step) {}
+
+  /// Register optional work with levels levels, degraded by increasing
+  /// priority. Returns the index of the knob.
+  int AddKnob(const std::string &name, int levels, Setter setter,
+              int priority = 0);
+
+  /// Register the rate of task of scheduler: each level doubles its
+  /// period
+  int AddTaskKnob(ChTaskScheduler &scheduler, int task, int levels,
+                  int priority = 0);
+
+  /// Loads, busy time over the step, which degrade and restore
+  void SetThresholds(double degrade, double restore) {
+    m_degrade = degrade;
+    m_restore = restore;
+  }
+
+  /// Frames of a decision window, and good windows in a row which restore
+  void SetWindow(int frames,
+                 int restore_windows = HIL_GOVERNOR_RESTORE_WINDOWS) {
+    m_window = frames;
+    m_restore_windows = restore_windows;
+  }
+
+  /// Print the decisions as they are taken (default)
+  void SetPrint(bool print) { m_print = print; }
+
+  void SetStep(double step) { m_step = step; }
+
+  /// Account for a frame of busy time busy [s] at simulated time time [s];
+  /// returns true if a knob changed level
+  bool Update(double busy, double time);
+
+  int GetNumKnobs() const { return static_cast<int>(m_knobs.size()); }
+  const std::string &GetName(int knob) const { return m_knobs[knob].name; }
+  int GetLevel(int knob) const { return m_knobs[knob].level; }
+
+  /// All the decisions since the start
+  const std::vector<ChGovernorDecision> &GetDecisions() const {
+    return m_decisions;
+  }
+
+private:
+  struct Knob {
+    std::string name;
+    int levels;
+    Setter setter;
+    int priority;
+    int level = 0;
+  };
+
+  /// Move knob by change levels, after a window of load and overruns
+  void Change(int knob, int change, double time, double load,
+              double overruns);
+
+  double m_step;
+  double m_degrade = HIL_GOVERNOR_DEGRADE;
+  double m_restore = HIL_GOVERNOR_RESTORE;
+  int m_window = HIL_GOVERNOR_WINDOW;
+  int m_restore_windows = HIL_GOVERNOR_RESTORE_WINDOWS;
+  bool m_print = true;
+
+  std::vector<Knob> m_knobs;
+  std::vector<ChGovernorDecision> m_decisions;
+
+  // current window
+  int m_frames = 0;
+  double m_busy = 0.0;
+  int m_overruns = 0;
+
+  int m_good = 0;          // good windows in a row
+  int m_backoff = 1;       // factor of the restore windows
+  int m_restored = -1;     // knob restored last
+  int m_since_restore = 0; // windows since that restore
+};
+
+} // namespace hil
+} // namespace chrono
+
+#endif
@@ -0,0 +1,127 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Authors: Jason Zhou
+// =============================================================================
+//
+// Latency histogram with log-linear buckets
+//
+// Bucket index of a value v: values below 2^SUB_BITS have their own bucket.
+// Above, with b = (highest set bit of v) - (SUB_BITS - 1), v falls in bucket
+// b * HALF + (v >> b), where v >> b is in [HALF, 2 HALF).
+//
+// =============================================================================
+
+#include "ChLatencyHistogram.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace chrono {
+namespace hil {
+
+static const int HALF = 1 << (HIL_HISTOGRAM_SUB_BITS - 1);
+static const uint64_t MAX_VALUE = (uint64_t(1) << HIL_HISTOGRAM_MAX_BITS) - 1;
+
+ChLatencyHistogram::ChLatencyHistogram()
+    : m_counts((HIL_HISTOGRAM_MAX_BITS - HIL_HISTOGRAM_SUB_BITS + 2) * HALF,
+               0) {}
+
+int ChLatencyHistogram::GetIndex(uint64_t ns) {
+  if (ns < uint64_t(2 * HALF))
+    return static_cast<int>(ns);
+  int msb = 0;
+  for (uint64_t v = ns; v > 1; v >>= 1)
+    msb++;
+  int b = msb - (HIL_HISTOGRAM_SUB_BITS - 1);
+  return b * HALF + static_cast<int>(ns >> b);
+}
+
+uint64_t ChLatencyHistogram::GetHighest(int index) {
+  if (index < 2 * HALF)
+    return index;
+  int b = index / HALF - 1;
+  uint64_t sub = index - b * HALF;
+  return ((sub + 1) << b) - 1;
+}
+
+void ChLatencyHistogram::Record(double seconds) {
+  RecordNs(static_cast<int64_t>(std::llround(seconds * 1e9)));
+}
+
+void ChLatencyHistogram::RecordNs(int64_t ns) {
+  uint64_t value;
+  if (ns < 0) {
+    value = 0;
+    m_clamped++;
+  } else if (uint64_t(ns) > MAX_VALUE) {
+    value = MAX_VALUE;
+    m_clamped++;
+  } else {
+    value = ns;
+  }
+
+  m_counts[GetIndex(value)]++;
+  m_min = m_count ? std::min(m_min, value) : value;
+  m_max = m_count ? std::max(m_max, value) : value;
+  m_sum += static_cast<double>(value);
+  m_count++;
+}
+
+void ChLatencyHistogram::Merge(const ChLatencyHistogram &other) {
+  if (!other.m_count)
+    return;
+  for (size_t i = 0; i < m_counts.size(); i++)
+    m_counts[i] += other.m_counts[i];
+  m_min = m_count ? std::min(m_min, other.m_min) : other.m_min;
+  m_max = m_count ? std::max(m_max, other.m_max) : other.m_max;
+  m_sum += other.m_sum;
+  m_count += other.m_count;
+  m_clamped += other.m_clamped;
+}
+
+void ChLatencyHistogram::Reset() {
+  std::fill(m_counts.begin(), m_counts.end(), 0);
+  m_count = 0;
+  m_clamped = 0;
+  m_min = 0;
+  m_max = 0;
+  m_sum = 0.0;
+}
+
+double ChLatencyHistogram::GetMin() const { return m_min * 1e-9; }
+
+double ChLatencyHistogram::GetMax() const { return m_max * 1e-9; }
+
+double ChLatencyHistogram::GetMean() const {
+  return m_count ? m_sum / m_count * 1e-9 : 0.0;
+}
+
+double ChLatencyHistogram::GetPercentile(double percent) const {
+  if (!m_count)
+    return 0.0;
+  percent = std::max(0.0, std::min(100.0, percent));
+  uint64_t rank = static_cast<uint64_t>(std::ceil(percent / 100.0 * m_count));
+  rank = std::max<uint64_t>(rank, 1);
+
+  uint64_t seen = 0;
+  for (size_t i = 0; i < m_counts.size(); i++) {
+    seen += m_counts[i];
+    if (seen >= rank) {
+      // the bucket bound may lie outside the recorded range
+      uint64_t value = std::min(GetHighest(static_cast<int>(i)), m_max);
+      return std::max(value, m_min) * 1e-9;
+    }
+  }
+  return GetMax();
+}
+
+} // namespace hil
+} // namespace chrono
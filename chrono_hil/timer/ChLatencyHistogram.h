@@ -0,0 +1,83 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Authors: Jason Zhou
+// =============================================================================
+//
+// Latency histogram with log-linear buckets, in the manner of HdrHistogram.
+// Values are recorded in nanoseconds. Each power of two is split into 128
+// buckets, so a value is known to within 0.8% from 1 ns up to about 68 s
+// (larger values are clamped), with a fixed 31 kB of counters and a constant
+// recording cost. Tail percentiles stay exact enough to see short spikes.
+//
+// =============================================================================
+
+#ifndef CH_LATENCY_HISTOGRAM_H
+#define CH_LATENCY_HISTOGRAM_H
+
+#include <cstdint>
+#include <vector>
+
+#include "../ChApiHil.h"
+
+namespace chrono {
+namespace hil {
+
+#define HIL_HISTOGRAM_SUB_BITS 8 // 2^8 values in the first bucket
+#define HIL_HISTOGRAM_MAX_BITS 36 // largest value 2^36 ns, about 68 s
+
+class CH_HIL_API ChLatencyHistogram {
+public:
+  ChLatencyHistogram();
+
+  /// Record one latency [s], negative values are recorded as 0
+  void Record(double seconds);
+
+  /// Record one latency [ns]
+  void RecordNs(int64_t ns);
+
+  /// Add the counts of other to this histogram
+  void Merge(const ChLatencyHistogram &other);
+
+  void Reset();
+
+  uint64_t GetCount() const { return m_count; }
+
+  /// Values recorded below 0 or above the range, clamped
+  uint64_t GetNumClamped() const { return m_clamped; }
+
+  /// Smallest, largest and mean recorded value [s], 0 when empty
+  double GetMin() const;
+  double GetMax() const;
+  double GetMean() const;
+
+  /// Value below which the given percentage (0 to 100) of the recorded
+  /// values fall [s], 0 when empty
+  double GetPercentile(double percent) const;
+
+private:
+  /// Bucket holding value ns
+  static int GetIndex(uint64_t ns);
+
+  /// Largest value of bucket index, which is the value reported for it
+  static uint64_t GetHighest(int index);
+
+  std::vector<uint64_t> m_counts;
+  uint64_t m_count = 0;
+  uint64_t m_clamped = 0;
+  uint64_t m_min = 0;
+  uint64_t m_max = 0;
+  double m_sum = 0.0; // [ns]
+};
+
+} // namespace hil
+} // namespace chrono
+
+#endif
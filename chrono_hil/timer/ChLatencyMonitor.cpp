@@ -0,0 +1,143 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Authors: Jason Zhou
+// =============================================================================
+//
+// Named latency histograms with CSV and JSON export
+//
+// =============================================================================
+
+#include "ChLatencyMonitor.h"
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+
+namespace chrono {
+namespace hil {
+
+ChLatencyMonitor::ChLatencyMonitor() : m_start(Now()) {}
+
+double ChLatencyMonitor::Now() {
+  return std::chrono::duration<double>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+void ChLatencyMonitor::Record(const std::string &name, double seconds) {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  m_histograms[name].Record(seconds);
+}
+
+ChLatencyHistogram
+ChLatencyMonitor::GetHistogram(const std::string &name) const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  auto it = m_histograms.find(name);
+  return it != m_histograms.end() ? it->second : ChLatencyHistogram();
+}
+
+std::vector<std::string> ChLatencyMonitor::GetNames() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  std::vector<std::string> names;
+  for (auto &h : m_histograms)
+    names.push_back(h.first);
+  return names;
+}
+
+void ChLatencyMonitor::Reset() {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  for (auto &h : m_histograms)
+    h.second.Reset();
+}
+
+bool ChLatencyMonitor::ExportCSV(const std::string &path) const {
+  bool is_new = !std::ifstream(path).good();
+  std::ofstream out(path, std::ios::app);
+  if (!out) {
+    std::cout << "Failed to write latency file " << path << std::endl;
+    return false;
+  }
+  if (is_new)
+    out << "time,name,count,min_us,mean_us,p50_us,p90_us,p99_us,p999_us,"
+           "max_us,clamped\n";
+
+  double time = GetElapsed();
+  std::lock_guard<std::mutex> lock(m_mutex);
+  for (auto &entry : m_histograms) {
+    const ChLatencyHistogram &h = entry.second;
+    out << time << "," << entry.first << "," << h.GetCount() << ","
+        << h.GetMin() * 1e6 << "," << h.GetMean() * 1e6 << ","
+        << h.GetPercentile(50.0) * 1e6 << "," << h.GetPercentile(90.0) * 1e6
+        << "," << h.GetPercentile(99.0) * 1e6 << ","
+        << h.GetPercentile(99.9) * 1e6 << "," << h.GetMax() * 1e6 << ","
+        << h.GetNumClamped() << "\n";
+  }
+  return true;
+}
+
+bool ChLatencyMonitor::ExportJSON(const std::string &path) const {
+  std::ofstream out(path);
+  if (!out) {
+    std::cout << "Failed to write latency file " << path << std::endl;
+    return false;
+  }
+
+  out << "{\"time\": " << GetElapsed() << ", \"histograms\": {";
+  std::lock_guard<std::mutex> lock(m_mutex);
+  bool first = true;
+  for (auto &entry : m_histograms) {
+    const ChLatencyHistogram &h = entry.second;
+    out << (first ? "\n" : ",\n") << "  \"" << entry.first << "\": {"
+        << "\"count\": " << h.GetCount() << ", \"min_us\": " << h.GetMin() * 1e6
+        << ", \"mean_us\": " << h.GetMean() * 1e6
+        << ", \"p50_us\": " << h.GetPercentile(50.0) * 1e6
+        << ", \"p90_us\": " << h.GetPercentile(90.0) * 1e6
+        << ", \"p99_us\": " << h.GetPercentile(99.0) * 1e6
+        << ", \"p999_us\": " << h.GetPercentile(99.9) * 1e6
+        << ", \"max_us\": " << h.GetMax() * 1e6
+        << ", \"clamped\": " << h.GetNumClamped() << "}";
+    first = false;
+  }
+  out << "\n}}\n";
+  return true;
+}
+
+void ChLatencyMonitor::SetExport(const std::string &path, double period,
+                                 bool reset) {
+  m_export_path = path;
+  m_export_period = period;
+  m_export_reset = reset;
+  m_next_export = GetElapsed() + period;
+}
+
+void ChLatencyMonitor::Update() {
+  if (m_export_path.empty() || GetElapsed() < m_next_export)
+    return;
+
+  const std::string json = ".json";
+  bool is_json = m_export_path.size() >= json.size() &&
+                 m_export_path.compare(m_export_path.size() - json.size(),
+                                       json.size(), json) == 0;
+  if (is_json)
+    ExportJSON(m_export_path);
+  else
+    ExportCSV(m_export_path);
+
+  if (m_export_reset)
+    Reset();
+  m_next_export += m_export_period;
+  // skip the periods missed during a long stall
+  if (m_next_export < GetElapsed())
+    m_next_export = GetElapsed() + m_export_period;
+}
+
+} // namespace hil
+} // namespace chrono
@@ -0,0 +1,96 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Authors: Jason Zhou
+// =============================================================================
+//
+// Named latency histograms of one process: one per link (round trip and
+// one-way delay, filled by ChHilLatencyTracker) and one per pipeline stage
+// (filled by the application, e.g. from joystick read to motion base send).
+// The histograms can be written to CSV or JSON, once or periodically.
+//
+// CSV export appends one row per histogram and period:
+//   time,name,count,min_us,mean_us,p50_us,p90_us,p99_us,p999_us,max_us,clamped
+// JSON export overwrites the file with the latest snapshot:
+//   {"time": t, "histograms": {"name": {"count": n, "min_us": ...}, ...}}
+//
+// =============================================================================
+
+#ifndef CH_LATENCY_MONITOR_H
+#define CH_LATENCY_MONITOR_H
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "../ChApiHil.h"
+#include "ChLatencyHistogram.h"
+
+namespace chrono {
+namespace hil {
+
+class CH_HIL_API ChLatencyMonitor {
+public:
+  ChLatencyMonitor();
+
+  /// Record one latency [s] in the histogram name, created on first use.
+  /// Thread safe.
+  void Record(const std::string &name, double seconds);
+
+  /// Record the time elapsed since start, a time stamp taken with Now()
+  void RecordSince(const std::string &name, double start) {
+    Record(name, Now() - start);
+  }
+
+  /// Copy of the histogram name, empty if nothing was recorded in it
+  ChLatencyHistogram GetHistogram(const std::string &name) const;
+
+  std::vector<std::string> GetNames() const;
+
+  /// Clear all histograms
+  void Reset();
+
+  /// Append the current histograms to a CSV file, with a header line if the
+  /// file is new. Returns false if the file cannot be written.
+  bool ExportCSV(const std::string &path) const;
+
+  /// Write the current histograms to a JSON file
+  bool ExportJSON(const std::string &path) const;
+
+  /// Export to path every period seconds of wall time, as JSON if path ends
+  /// with ".json" and as CSV otherwise. With reset set, the histograms are
+  /// cleared after each export, so every row covers one period.
+  void SetExport(const std::string &path, double period, bool reset = true);
+
+  /// Export if the period is over, call once per simulation step
+  void Update();
+
+  /// Monotonic time stamp [s], the time base of RecordSince
+  static double Now();
+
+private:
+  /// Wall time since the creation of the monitor [s]
+  double GetElapsed() const { return Now() - m_start; }
+
+  mutable std::mutex m_mutex;
+  std::map<std::string, ChLatencyHistogram> m_histograms;
+
+  double m_start;
+  std::string m_export_path;
+  double m_export_period = 0.0;
+  bool m_export_reset = true;
+  double m_next_export = 0.0;
+};
+
+} // namespace hil
+} // namespace chrono
+
+#endif
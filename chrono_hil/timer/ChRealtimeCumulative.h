@@ -18,9 +18,11 @@
 #ifndef CHREALTIMECUM_H
 #define CHREALTIMECUM_H
 
+#include <functional>
 #include <limits>
 
 #include "../ChApiHil.h"
+#include "ChRealtimePacer.h"
 #include "chrono/core/ChTimer.h"
 
 namespace chrono {
@@ -37,17 +39,34 @@ public:
   /// (preferably as the last call in the loop), passing it the integration step
   /// size used at this step. If the time elapsed over the last step (i.e., from
   /// the last call to Spin) is small than the integration step size, this
-  /// function will spin in place until real time catches up with the simulation
-  /// time, thus providing soft real-time capabilities.
+  /// function will wait until real time catches up with the simulation
+  /// time, thus providing soft real-time capabilities. The wait sleeps, and
+  /// only spins for the last HIL_PACER_SPIN_MARGIN (see ChRealtimePacer).
   void Spin(double sim_time) {
-    while (GetTimeSecondsIntermediate() < sim_time) {
+    if (m_clock) {
+      ChRealtimePacer::WaitUntil([this]() { return m_clock() - m_start; },
+                                 sim_time);
+      return;
     }
+    ChRealtimePacer::WaitUntil(
+        [this]() { return GetTimeSecondsIntermediate(); }, sim_time);
   }
 
   void Reset() {
     reset();
     start();
+    if (m_clock)
+      m_start = m_clock();
   }
+
+  /// Pace against clock [s] instead of the local timer, e.g. the session
+  /// time of a ChSessionClock, so that nodes following the same session
+  /// step at the same rate. Takes effect from the next Reset.
+  void SetClock(std::function<double()> clock) { m_clock = clock; }
+
+private:
+  std::function<double()> m_clock;
+  double m_start = 0.0;
 };
 
 } // end namespace hil
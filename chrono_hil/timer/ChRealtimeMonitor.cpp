@@ -0,0 +1,251 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Authors: Jason Zhou
+// =============================================================================
+//
+// Deadline, jitter and phase time monitor of a real-time loop
+//
+// =============================================================================
+
+#include "ChRealtimeMonitor.h"
+
+#include <chrono>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+namespace chrono {
+namespace hil {
+
+std::string ChRealtimeSummary::ToString() const {
+  std::ostringstream out;
+  out << std::fixed << std::setprecision(3) << "t " << sim_time << " RTF "
+      << rtf << " (" << rtf_total << ") frame p50/p99/max "
+      << 1e3 * frame_times.GetPercentile(50.0) << "/"
+      << 1e3 * frame_times.GetPercentile(99.0) << "/"
+      << 1e3 * frame_times.GetMax() << " ms jitter p99 "
+      << 1e3 * jitter.GetPercentile(99.0) << " ms misses " << misses << "/"
+      << frames << " (" << misses_total << ")";
+
+  double total = frame_times.GetMean() * frame_times.GetCount();
+  for (size_t i = 0; i < phase_times.size(); i++) {
+    const ChLatencyHistogram &h = phase_times[i];
+    if (h.GetCount() == 0 || total <= 0.0)
+      continue;
+    out << " " << phase_names[i] << " "
+        << std::setprecision(0)
+        << 100.0 * h.GetMean() * h.GetCount() / total << "%"
+        << std::setprecision(3);
+  }
+  return out.str();
+}
+
+ChRealtimeMonitor::ChRealtimeMonitor(double step)
+    : m_step(step), m_deadline(step) {
+  m_phases.resize(1);
+  m_phases[0].name = "other";
+  Reset();
+}
+
+ChRealtimeMonitor::~ChRealtimeMonitor() {
+  if (m_thread.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_stop = true;
+    }
+    m_cv.notify_one();
+    m_thread.join();
+  }
+}
+
+double ChRealtimeMonitor::Now() {
+  return std::chrono::duration<double>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+int ChRealtimeMonitor::AddPhase(const std::string &name) {
+  m_phases.emplace_back();
+  m_phases.back().name = name;
+  return static_cast<int>(m_phases.size()) - 1;
+}
+
+void ChRealtimeMonitor::Reset(double sim_time) {
+  m_start = Now();
+  m_frame_start = m_start;
+  m_phase_start = m_start;
+  m_phase = 0;
+  m_last_frame = -1.0;
+  m_num_frames = 0;
+  m_num_misses = 0;
+  m_sim_start = sim_time;
+  m_sim_time = sim_time;
+  m_frame_times.Reset();
+  m_jitter.Reset();
+  m_misses.clear();
+  for (auto &phase : m_phases) {
+    phase.time = 0.0;
+    phase.total.Reset();
+    phase.period.Reset();
+  }
+
+  m_period_frames.Reset();
+  m_period_jitter.Reset();
+  m_period_misses = 0;
+  m_period_wall = m_start;
+  m_period_sim = sim_time;
+  m_next_publish = m_start + m_publish_period;
+}
+
+void ChRealtimeMonitor::BeginPhase(int phase) {
+  double now = Now();
+  m_phases[m_phase].time += now - m_phase_start;
+  m_phase_start = now;
+  m_phase = phase;
+}
+
+void ChRealtimeMonitor::EndFrame(double sim_time) {
+  double now = Now();
+  m_phases[m_phase].time += now - m_phase_start;
+  m_phase_start = now;
+  m_phase = 0;
+
+  double frame = now - m_frame_start;
+  m_frame_start = now;
+  m_num_frames++;
+  m_sim_time = sim_time;
+  m_frame_times.Record(frame);
+  m_period_frames.Record(frame);
+  if (m_last_frame >= 0.0) {
+    double jitter = std::abs(frame - m_last_frame);
+    m_jitter.Record(jitter);
+    m_period_jitter.Record(jitter);
+  }
+  m_last_frame = frame;
+
+  int longest = 0;
+  for (size_t i = 0; i < m_phases.size(); i++) {
+    Phase &phase = m_phases[i];
+    if (static_cast<int>(i) != m_wait_phase &&
+        phase.time > m_phases[longest].time)
+      longest = static_cast<int>(i);
+    // phases a frame skips are not recorded, their time is not an event
+    if (phase.time > 0.0 || i == 0) {
+      phase.total.Record(phase.time);
+      phase.period.Record(phase.time);
+    }
+  }
+
+  double busy = frame;
+  if (m_wait_phase >= 0)
+    busy -= m_phases[m_wait_phase].time;
+  if (busy > m_deadline) {
+    m_num_misses++;
+    m_period_misses++;
+    ChRealtimeMiss miss;
+    miss.frame = m_num_frames - 1;
+    miss.sim_time = sim_time;
+    miss.frame_time = frame;
+    miss.busy_time = busy;
+    miss.phase = longest;
+    for (auto &phase : m_phases)
+      miss.phase_times.push_back(phase.time);
+    m_misses.push_back(std::move(miss));
+    if (m_misses.size() > HIL_RT_MISS_LOG)
+      m_misses.pop_front();
+  }
+
+  for (auto &phase : m_phases)
+    phase.time = 0.0;
+
+  if (m_publish && now >= m_next_publish)
+    Publish(sim_time);
+}
+
+double ChRealtimeMonitor::GetRTF() const {
+  double sim = m_sim_time - m_sim_start;
+  return sim > 0.0 ? (m_frame_start - m_start) / sim : 0.0;
+}
+
+void ChRealtimeMonitor::SetPublisher(
+    double period, std::function<void(const ChRealtimeSummary &)> publish) {
+  m_publish_period = period;
+  m_next_publish = Now() + period;
+  m_publish = publish;
+  if (!m_thread.joinable())
+    m_thread = std::thread(&ChRealtimeMonitor::PublishLoop, this);
+}
+
+void ChRealtimeMonitor::SetPrint(double period) {
+  SetPublisher(period, [](const ChRealtimeSummary &summary) {
+    std::cout << summary.ToString() << std::endl;
+  });
+}
+
+void ChRealtimeMonitor::Publish(double sim_time) {
+  // never wait for the publisher, try again at the next frame
+  std::unique_lock<std::mutex> lock(m_mutex, std::try_to_lock);
+  if (!lock.owns_lock() || m_pending)
+    return;
+
+  double now = m_frame_start;
+  ChRealtimeSummary &s = m_summary;
+  s.wall_time = now - m_start;
+  s.sim_time = sim_time;
+  double sim = sim_time - m_period_sim;
+  s.rtf = sim > 0.0 ? (now - m_period_wall) / sim : 0.0;
+  s.rtf_total = GetRTF();
+  s.frames = m_period_frames.GetCount();
+  s.misses = m_period_misses;
+  s.misses_total = m_num_misses;
+  s.frame_times = m_period_frames;
+  s.jitter = m_period_jitter;
+  s.phase_names.resize(m_phases.size());
+  s.phase_times.resize(m_phases.size());
+  for (size_t i = 0; i < m_phases.size(); i++) {
+    s.phase_names[i] = m_phases[i].name;
+    s.phase_times[i] = m_phases[i].period;
+    m_phases[i].period.Reset();
+  }
+  m_pending = true;
+  lock.unlock();
+  m_cv.notify_one();
+
+  m_period_frames.Reset();
+  m_period_jitter.Reset();
+  m_period_misses = 0;
+  m_period_wall = now;
+  m_period_sim = sim_time;
+  m_next_publish += m_publish_period;
+  // skip the periods missed during a long stall
+  if (m_next_publish < now)
+    m_next_publish = now + m_publish_period;
+}
+
+void ChRealtimeMonitor::PublishLoop() {
+  ChRealtimeSummary summary;
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while (true) {
+    m_cv.wait(lock, [this] { return m_pending || m_stop; });
+    if (m_stop)
+      return;
+    summary = m_summary;
+    m_pending = false;
+    auto publish = m_publish;
+    lock.unlock();
+    publish(summary);
+    lock.lock();
+  }
+}
+
+} // namespace hil
+} // namespace chrono
@@ -0,0 +1,201 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Authors: Jason Zhou
+// =============================================================================
+//
+// Deadline and jitter monitor of a real-time loop. The loop marks the start
+// of its phases (dynamics, sync, render, I/O, ...) with BeginPhase and the
+// end of each frame with EndFrame. The monitor keeps histograms of the wall
+// time of the frames, of their jitter (change of the frame time from one
+// frame to the next) and of the time of each phase, counts the frames
+// longer than the deadline and logs the last HIL_RT_MISS_LOG of them with
+// the time of each of their phases, so a stutter can be traced to a phase.
+// In a paced loop, the phase waiting for the next frame (e.g. in
+// ChRealtimePacer::Wait) is declared with SetWaitPhase: its time does not
+// count against the deadline, so a late wake up shows as jitter and the
+// misses are the frames whose work did not fit in the deadline.
+//
+// The real-time factor is the wall time over the simulated time, as in
+// Chrono: below 1 the loop runs faster than real time.
+//
+// A summary of every publish period is handed to a callback on a thread of
+// the monitor. The loop only copies the histograms of the period, and skips
+// a publish while the previous one is still being handled, so a slow
+// callback (console, file, network) never stalls the loop.
+//
+// =============================================================================
+
+#ifndef CH_REALTIME_MONITOR_H
+#define CH_REALTIME_MONITOR_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../ChApiHil.h"
+#include "ChLatencyHistogram.h"
+
+namespace chrono {
+namespace hil {
+
+#define HIL_RT_MISS_LOG 64 // deadline misses kept with their phase times
+
+/// Frame which ran past its deadline
+struct ChRealtimeMiss {
+  uint64_t frame;
+  double sim_time;                 // simulated time at the end [s]
+  double frame_time;               // wall time of the frame [s]
+  double busy_time;                // frame time minus the wait phase [s]
+  int phase;                       // longest phase of the frame
+  std::vector<double> phase_times; // wall time of each phase [s]
+};
+
+/// Statistics of one publish period, wall times in seconds
+struct ChRealtimeSummary {
+  double wall_time;    // since the start of the monitor
+  double sim_time;     // at the end of the period
+  double rtf;          // real-time factor over the period
+  double rtf_total;    // real-time factor since the start
+  uint64_t frames;     // frames of the period
+  uint64_t misses;     // deadline misses of the period
+  uint64_t misses_total;
+  ChLatencyHistogram frame_times;
+  ChLatencyHistogram jitter;
+  std::vector<std::string> phase_names;
+  std::vector<ChLatencyHistogram> phase_times;
+
+  /// One line: RTF, frame time and jitter percentiles, misses, and the
+  /// share of the frame time of each phase
+  std::string ToString() const;
+};
+
+class CH_HIL_API ChRealtimeMonitor {
+public:
+  /// Monitor a loop advancing the simulation by step [s] per frame, with a
+  /// deadline of one step
+  ChRealtimeMonitor(double step);
+  ~ChRealtimeMonitor();
+
+  double GetStep() const { return m_step; }
+
+  /// Wall time allowed per frame [s]
+  void SetDeadline(double deadline) { m_deadline = deadline; }
+  double GetDeadline() const { return m_deadline; }
+
+  /// Add a phase, returns its index for BeginPhase. Phase 0 is "other",
+  /// the time of a frame before its first BeginPhase.
+  int AddPhase(const std::string &name);
+
+  /// Phase waiting for the deadline, left out of the time of the frame
+  /// checked against the deadline
+  void SetWaitPhase(int phase) { m_wait_phase = phase; }
+
+  /// End the current phase of the frame and start phase
+  void BeginPhase(int phase);
+
+  /// End the frame at simulated time sim_time [s]
+  void EndFrame(double sim_time);
+
+  /// Hand a summary to publish every period [s] of wall time, on the
+  /// thread of the monitor. Set before the loop starts.
+  void SetPublisher(double period,
+                    std::function<void(const ChRealtimeSummary &)> publish);
+
+  /// Print the summary line of every period [s] to std::cout
+  void SetPrint(double period);
+
+  /// Start over at simulated time sim_time [s], e.g. after the first step
+  /// of the simulation
+  void Reset(double sim_time = 0.0);
+
+  uint64_t GetNumFrames() const { return m_num_frames; }
+  uint64_t GetNumMisses() const { return m_num_misses; }
+
+  /// Real-time factor since the start
+  double GetRTF() const;
+
+  /// Histograms since the start
+  const ChLatencyHistogram &GetFrameTimes() const { return m_frame_times; }
+  const ChLatencyHistogram &GetJitter() const { return m_jitter; }
+  const ChLatencyHistogram &GetPhaseTimes(int phase) const {
+    return m_phases[phase].total;
+  }
+
+  const std::string &GetPhaseName(int phase) const {
+    return m_phases[phase].name;
+  }
+  int GetNumPhases() const { return static_cast<int>(m_phases.size()); }
+
+  /// Last deadline misses, oldest first
+  const std::deque<ChRealtimeMiss> &GetMisses() const { return m_misses; }
+
+  /// Monotonic time [s]
+  static double Now();
+
+private:
+  struct Phase {
+    std::string name;
+    double time = 0.0; // in the current frame
+    ChLatencyHistogram total;
+    ChLatencyHistogram period;
+  };
+
+  /// Copy the statistics of the period for the publisher, unless it is
+  /// still busy with the previous ones
+  void Publish(double sim_time);
+
+  void PublishLoop();
+
+  double m_step;
+  double m_deadline;
+  std::vector<Phase> m_phases;
+  int m_phase = 0;
+  int m_wait_phase = -1;
+
+  double m_start;
+  double m_phase_start;
+  double m_frame_start;
+  double m_last_frame = -1.0;
+  uint64_t m_num_frames = 0;
+  uint64_t m_num_misses = 0;
+  double m_sim_start = 0.0;
+  double m_sim_time = 0.0;
+  ChLatencyHistogram m_frame_times;
+  ChLatencyHistogram m_jitter;
+  std::deque<ChRealtimeMiss> m_misses;
+
+  // statistics of the publish period
+  ChLatencyHistogram m_period_frames;
+  ChLatencyHistogram m_period_jitter;
+  uint64_t m_period_misses = 0;
+  double m_period_wall = 0.0;
+  double m_period_sim = 0.0;
+
+  double m_publish_period = 0.0;
+  double m_next_publish = 0.0;
+  std::function<void(const ChRealtimeSummary &)> m_publish;
+  std::thread m_thread;
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  ChRealtimeSummary m_summary; // handed to the publisher
+  bool m_pending = false;
+  bool m_stop = false;
+};
+
+} // namespace hil
+} // namespace chrono
+
+#endif
@@ -0,0 +1,112 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Authors: Jason Zhou
+// =============================================================================
+//
+// Fixed-rate pacer sleeping, then spinning, until each deadline
+//
+// =============================================================================
+
+#include "ChRealtimePacer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <thread>
+
+#ifdef __linux__
+#include <cerrno>
+#include <time.h>
+#endif
+
+namespace chrono {
+namespace hil {
+
+ChRealtimePacer::ChRealtimePacer(double period) : m_period(period) {
+  Reset();
+}
+
+void ChRealtimePacer::Reset() {
+  m_start = Now();
+  m_delay = 0.0;
+  m_num_frames = 0;
+  m_num_overruns = 0;
+  m_max_lateness = 0.0;
+  m_slack.Reset();
+  m_overruns.Reset();
+  m_wake_error.Reset();
+}
+
+double ChRealtimePacer::Now() {
+  return std::chrono::duration<double>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+double ChRealtimePacer::GetTime() const { return Now() - m_start - m_delay; }
+
+double ChRealtimePacer::Wait() {
+  // make up part of the time lost, before the deadline of this frame
+  if (m_policy == HIL_PACER_SLEW)
+    m_delay -= std::min(m_delay, m_slew * m_period);
+
+  m_num_frames++;
+  double deadline = m_start + m_num_frames * m_period + m_delay;
+  double lateness = Now() - deadline;
+  if (lateness <= 0.0) {
+    m_slack.Record(-lateness);
+    SleepUntil(deadline);
+    m_wake_error.Record(Now() - deadline);
+    return lateness;
+  }
+
+  m_num_overruns++;
+  m_overruns.Record(lateness);
+  m_max_lateness = std::max(m_max_lateness, lateness);
+  // the next frame starts now, on time again
+  if (m_policy != HIL_PACER_BURST)
+    m_delay += lateness;
+  return lateness;
+}
+
+void ChRealtimePacer::SleepUntil(double deadline) const {
+#ifdef __linux__
+  // steady_clock is CLOCK_MONOTONIC, sleep on an absolute time so that
+  // a wake up by a signal does not stretch the sleep
+  double wake = deadline - m_margin;
+  if (wake > Now()) {
+    struct timespec ts;
+    ts.tv_sec = static_cast<time_t>(wake);
+    ts.tv_nsec = static_cast<long>((wake - ts.tv_sec) * 1e9);
+    while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) ==
+           EINTR) {
+    }
+  }
+  while (Now() < deadline) {
+  }
+#else
+  WaitUntil(Now, deadline, m_margin);
+#endif
+}
+
+void ChRealtimePacer::WaitUntil(const std::function<double()> &now,
+                                double target, double margin) {
+  while (true) {
+    double left = target - now();
+    if (left <= margin)
+      break;
+    std::this_thread::sleep_for(std::chrono::duration<double>(left - margin));
+  }
+  while (now() < target) {
+  }
+}
+
+} // namespace hil
+} // namespace chrono
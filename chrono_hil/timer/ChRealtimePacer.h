@@ -0,0 +1,122 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Authors: Jason Zhou
+// =============================================================================
+//
+// Fixed-rate pacer for real-time loops. The loop calls Wait once per frame,
+// after its work: the pacer sleeps on the monotonic clock until a margin
+// before the end of the frame (clock_nanosleep with an absolute deadline on
+// Linux), then spins for the margin only. The wake up is as accurate as a
+// busy wait, for a small fraction of a core.
+//
+// A frame whose work runs past its deadline is an overrun. What happens to
+// the time lost depends on the catch-up policy:
+//   HIL_PACER_DROP   the time is given up, the schedule moves back by the
+//                    overrun and the loop runs late for good
+//   HIL_PACER_SLEW   the time is made up by shortening the next frames by
+//                    at most a fraction of the period each
+//   HIL_PACER_BURST  the schedule is kept, the next frames run without
+//                    waiting until the loop is back on time
+//
+// =============================================================================
+
+#ifndef CH_REALTIME_PACER_H
+#define CH_REALTIME_PACER_H
+
+#include <cstdint>
+#include <functional>
+
+#include "../ChApiHil.h"
+#include "ChLatencyHistogram.h"
+
+namespace chrono {
+namespace hil {
+
+// spin before a deadline, covers the wake up latency of a sleep [s]
+#define HIL_PACER_SPIN_MARGIN 100e-6
+
+enum ChRealtimeCatchUp { HIL_PACER_DROP, HIL_PACER_SLEW, HIL_PACER_BURST };
+
+class CH_HIL_API ChRealtimePacer {
+public:
+  /// Pace frames of period [s]
+  ChRealtimePacer(double period);
+
+  /// Start the first frame now
+  void Reset();
+
+  /// Time spun before each deadline [s]
+  void SetSpinMargin(double margin) { m_margin = margin; }
+
+  /// Catch-up policy after an overrun; with HIL_PACER_SLEW, each frame is
+  /// shortened by at most slew times the period
+  void SetCatchUp(ChRealtimeCatchUp policy, double slew = 0.1) {
+    m_policy = policy;
+    m_slew = slew;
+  }
+
+  /// End the current frame: wait for its deadline, or account for its
+  /// overrun. Returns the lateness of the frame [s], negative if it waited.
+  double Wait();
+
+  /// Time since Reset, on the schedule of the frames [s]
+  double GetTime() const;
+
+  /// Delay of the schedule behind the nominal one, left by overruns [s]
+  double GetDelay() const { return m_delay; }
+
+  uint64_t GetNumFrames() const { return m_num_frames; }
+  uint64_t GetNumOverruns() const { return m_num_overruns; }
+
+  /// Largest lateness of a frame at its deadline [s]
+  double GetMaxLateness() const { return m_max_lateness; }
+
+  /// Time left before the deadlines of the frames which waited
+  const ChLatencyHistogram &GetSlack() const { return m_slack; }
+
+  /// Lateness at the deadline of the frames which overran
+  const ChLatencyHistogram &GetOverruns() const { return m_overruns; }
+
+  /// Error of the wake up of the frames which waited, past the deadline
+  const ChLatencyHistogram &GetWakeError() const { return m_wake_error; }
+
+  /// Monotonic time [s]
+  static double Now();
+
+  /// Sleep then spin until now() reaches target, now being any clock
+  /// running at the rate of the monotonic clock [s]
+  static void WaitUntil(const std::function<double()> &now, double target,
+                        double margin = HIL_PACER_SPIN_MARGIN);
+
+private:
+  /// Sleep then spin until the monotonic time deadline
+  void SleepUntil(double deadline) const;
+
+  double m_period;
+  double m_margin = HIL_PACER_SPIN_MARGIN;
+  ChRealtimeCatchUp m_policy = HIL_PACER_SLEW;
+  double m_slew = 0.1;
+
+  double m_start = 0.0;
+  double m_delay = 0.0; // schedule shift accumulated by the overruns
+  uint64_t m_num_frames = 0;
+  uint64_t m_num_overruns = 0;
+  double m_max_lateness = 0.0;
+
+  ChLatencyHistogram m_slack;
+  ChLatencyHistogram m_overruns;
+  ChLatencyHistogram m_wake_error;
+};
+
+} // namespace hil
+} // namespace chrono
+
+#endif
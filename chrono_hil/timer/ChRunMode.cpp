@@ -0,0 +1,133 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Authors: Jason Zhou
+// =============================================================================
+//
+// Real-time, scaled and unthrottled run modes of a HIL main loop
+//
+// =============================================================================
+
+#include "ChRunMode.h"
+#include "ChRealtimePacer.h"
+#include "ChTaskScheduler.h"
+
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+
+namespace chrono {
+namespace hil {
+
+ChRunMode::ChRunMode(ChRunModeType type, double factor)
+    : m_type(type), m_factor(type == HIL_RUN_SCALED ? factor : 1.0) {}
+
+bool ChRunMode::Parse(const std::string &mode) {
+  if (mode == "realtime" || mode == "rt") {
+    m_type = HIL_RUN_REALTIME;
+    m_factor = 1.0;
+    return true;
+  }
+  if (mode == "fast" || mode == "batch") {
+    m_type = HIL_RUN_FAST;
+    m_factor = 1.0;
+    return true;
+  }
+
+  // a factor, with an optional x before or after it
+  std::string number = mode;
+  if (!number.empty() && (number.front() == 'x' || number.front() == 'X'))
+    number.erase(0, 1);
+  else if (!number.empty() && (number.back() == 'x' || number.back() == 'X'))
+    number.pop_back();
+  char *end = nullptr;
+  double factor = std::strtod(number.c_str(), &end);
+  if (number.empty() || *end != '\0' || !(factor > 0.0)) {
+    std::cout << "Run mode: cannot parse \"" << mode
+              << "\", expected realtime, fast or a factor such as x20"
+              << std::endl;
+    return false;
+  }
+  m_type = factor == 1.0 ? HIL_RUN_REALTIME : HIL_RUN_SCALED;
+  m_factor = factor;
+  return true;
+}
+
+double ChRunMode::GetFactor() const {
+  return m_type == HIL_RUN_FAST ? 0.0 : m_factor;
+}
+
+std::string ChRunMode::GetName() const {
+  if (m_type == HIL_RUN_REALTIME)
+    return "realtime";
+  if (m_type == HIL_RUN_FAST)
+    return "fast";
+  std::ostringstream name;
+  name << "x" << m_factor;
+  return name.str();
+}
+
+bool ChRunMode::IsHeadless() const {
+  return m_headless_set ? m_headless : m_type != HIL_RUN_REALTIME;
+}
+
+void ChRunMode::Apply(ChTaskScheduler &scheduler) const {
+  if (m_type == HIL_RUN_FAST) {
+    scheduler.SetRealtime(false);
+    return;
+  }
+  scheduler.SetTimeScale(m_factor);
+}
+
+void ChRunMode::Update(double time) {
+  double now = ChRealtimePacer::Now();
+  if (!m_started) {
+    m_sim_start = m_sim_print = time;
+    m_wall_start = m_wall_print = now;
+    m_started = true;
+  }
+  m_sim = time;
+  m_wall = now;
+
+  if (m_print <= 0.0 || m_wall - m_wall_print < m_print)
+    return;
+  std::ios::fmtflags flags = std::cout.flags();
+  std::streamsize precision = std::cout.precision();
+  std::cout << std::fixed << std::setprecision(1) << "Run mode: " << time
+            << " s, " << (m_sim - m_sim_print) / (m_wall - m_wall_print)
+            << " sim s per wall s (" << GetRate() << " overall)"
+            << std::endl;
+  std::cout.flags(flags);
+  std::cout.precision(precision);
+  m_sim_print = m_sim;
+  m_wall_print = m_wall;
+}
+
+double ChRunMode::GetRate() const {
+  double wall = m_wall - m_wall_start;
+  return wall > 0.0 ? (m_sim - m_sim_start) / wall : 0.0;
+}
+
+void ChRunMode::Report() const {
+  std::ios::fmtflags flags = std::cout.flags();
+  std::streamsize precision = std::cout.precision();
+  std::cout << std::fixed << std::setprecision(2) << "Run mode " << GetName()
+            << (IsHeadless() ? ", headless" : "")
+            << (IsInteractive() ? "" : ", inputs from " + m_input_file)
+            << ": " << m_sim - m_sim_start << " sim s in "
+            << m_wall - m_wall_start << " wall s, " << GetRate()
+            << " sim s per wall s" << std::endl;
+  std::cout.flags(flags);
+  std::cout.precision(precision);
+}
+
+} // namespace hil
+} // namespace chrono
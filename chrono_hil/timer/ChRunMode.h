@@ -0,0 +1,117 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Authors: Jason Zhou
+// =============================================================================
+//
+// Run mode of a HIL main loop, so that the same loop runs a scenario in the
+// simulator or as a batch job:
+//   HIL_RUN_REALTIME  frames paced on the wall clock
+//   HIL_RUN_SCALED    frames paced on the wall clock sped up (or slowed
+//                     down) by a factor
+//   HIL_RUN_FAST      frames not paced, as fast as the machine goes
+// The mode is parsed from a command line value ("realtime", "fast", "x20")
+// and applied to a ChTaskScheduler. It also tells the loop to run headless,
+// which is the default of all but real-time runs, and where the driver
+// inputs come from: a scripted or recorded input file replaces the
+// interactive inputs (simulator cab, joystick, keyboard).
+//
+// Fed the simulated time of each frame, the mode measures the achieved
+// rate, in simulated seconds per wall second, and prints it periodically.
+//
+// =============================================================================
+
+#ifndef CH_RUN_MODE_H
+#define CH_RUN_MODE_H
+
+#include <string>
+
+#include "../ChApiHil.h"
+
+namespace chrono {
+namespace hil {
+
+class ChTaskScheduler;
+
+#define HIL_RUN_PRINT 5.0 // wall time between rate prints [s]
+
+enum ChRunModeType { HIL_RUN_REALTIME, HIL_RUN_SCALED, HIL_RUN_FAST };
+
+class CH_HIL_API ChRunMode {
+public:
+  /// Mode of type, sped up by factor for HIL_RUN_SCALED
+  ChRunMode(ChRunModeType type = HIL_RUN_REALTIME, double factor = 1.0);
+
+  /// Set the mode from "realtime", "fast" or a factor ("x20", "20x",
+  /// "0.5"); returns false, leaving the mode, if mode does not parse
+  bool Parse(const std::string &mode);
+
+  ChRunModeType GetType() const { return m_type; }
+
+  /// Speed up over real time of the pacing, 0 if not paced
+  double GetFactor() const;
+
+  /// The frames wait for the wall clock
+  bool IsPaced() const { return m_type != HIL_RUN_FAST; }
+
+  /// Name of the mode, e.g. "x20"
+  std::string GetName() const;
+
+  /// Run without visualization; by default, all but real-time runs do
+  void SetHeadless(bool headless) {
+    m_headless = headless;
+    m_headless_set = true;
+  }
+  bool IsHeadless() const;
+
+  /// Scripted or recorded driver inputs, replacing the interactive ones
+  void SetInputFile(const std::string &file) { m_input_file = file; }
+  const std::string &GetInputFile() const { return m_input_file; }
+
+  /// The driver inputs are interactive (no input file)
+  bool IsInteractive() const { return m_input_file.empty(); }
+
+  /// Pace the frames of scheduler for the mode: real time scaled by the
+  /// factor, or not at all. Call after ChTaskScheduler::SetRealtime.
+  void Apply(ChTaskScheduler &scheduler) const;
+
+  /// Print the achieved rate every interval of wall time [s], 0 never
+  void SetPrint(double interval) { m_print = interval; }
+
+  /// Account for a frame at simulated time time [s]; call once per frame
+  void Update(double time);
+
+  /// Simulated seconds per wall second since the first frame
+  double GetRate() const;
+
+  /// Print the mode and the achieved rate
+  void Report() const;
+
+private:
+  ChRunModeType m_type;
+  double m_factor;
+  bool m_headless = false;
+  bool m_headless_set = false;
+  std::string m_input_file;
+  double m_print = HIL_RUN_PRINT;
+
+  bool m_started = false;
+  double m_sim_start = 0.0;
+  double m_wall_start = 0.0;
+  double m_sim = 0.0;
+  double m_wall = 0.0;
+  double m_sim_print = 0.0; // at the last print
+  double m_wall_print = 0.0;
+};
+
+} // namespace hil
+} // namespace chrono
+
+#endif
@@ -0,0 +1,170 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Authors: Jason Zhou
+// =============================================================================
+//
+// Session time shared by the nodes of a distributed run
+//
+// =============================================================================
+
+#include "ChSessionClock.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+namespace chrono {
+namespace hil {
+
+static int64_t SteadyNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+ChSessionClock::ChSessionClock(bool master) : m_master(master) {
+  if (master) {
+    // the session starts now
+    int64_t epoch = SteadyNs();
+    m_clock = [epoch]() { return SteadyNs() - epoch; };
+  } else {
+    m_clock = SteadyNs;
+  }
+}
+
+void ChSessionClock::AddSample(int64_t local_ns, int64_t offset_ns,
+                               int64_t rtt_ns) {
+  if (m_master)
+    return;
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  Sample sample;
+  sample.local = local_ns;
+  sample.offset = offset_ns;
+  sample.rtt = rtt_ns;
+
+  if (!m_has_period) {
+    m_period_best = sample;
+    m_period_start = local_ns;
+    m_has_period = true;
+  } else if (sample.rtt < m_period_best.rtt) {
+    m_period_best = sample;
+  }
+
+  if (m_window.empty()) {
+    // provisional estimate until the first period is over
+    m_ref = m_period_best.local;
+    m_offset = static_cast<double>(m_period_best.offset);
+    m_drift = 0.0;
+  }
+
+  if ((local_ns - m_period_start) * 1e-9 >= HIL_SESSION_SAMPLE_PERIOD) {
+    if (m_window.size() < HIL_SESSION_WINDOW)
+      m_window.push_back(m_period_best);
+    else
+      m_window[m_next_sample] = m_period_best;
+    m_next_sample = (m_next_sample + 1) % HIL_SESSION_WINDOW;
+    m_has_period = false;
+    Fit();
+  }
+}
+
+void ChSessionClock::Fit() {
+  // times relative to the newest sample, in seconds, offsets in ns
+  const Sample &newest =
+      m_window[(m_next_sample + m_window.size() - 1) % m_window.size()];
+  double min_x = 0.0, max_x = 0.0, sum_x = 0.0, sum_y = 0.0;
+  for (const Sample &s : m_window) {
+    double x = (s.local - newest.local) * 1e-9;
+    min_x = std::min(min_x, x);
+    max_x = std::max(max_x, x);
+    sum_x += x;
+    sum_y += static_cast<double>(s.offset - newest.offset);
+  }
+
+  if (max_x - min_x < HIL_SESSION_MIN_SPAN) {
+    // too short to see a drift, follow the newest sample
+    m_ref = newest.local;
+    m_offset = static_cast<double>(newest.offset);
+    m_drift = 0.0;
+    return;
+  }
+
+  double n = static_cast<double>(m_window.size());
+  double mean_x = sum_x / n, mean_y = sum_y / n;
+  double sxx = 0.0, sxy = 0.0;
+  for (const Sample &s : m_window) {
+    double dx = (s.local - newest.local) * 1e-9 - mean_x;
+    double dy = static_cast<double>(s.offset - newest.offset) - mean_y;
+    sxx += dx * dx;
+    sxy += dx * dy;
+  }
+  m_drift = sxy / sxx * 1e-9;
+  m_ref = newest.local + std::llround(mean_x * 1e9);
+  m_offset = newest.offset + mean_y;
+}
+
+double ChSessionClock::GetOffsetAt(int64_t t) const {
+  return m_offset + m_drift * static_cast<double>(t - m_ref);
+}
+
+bool ChSessionClock::IsSynchronized() const {
+  if (m_master)
+    return true;
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_has_period || !m_window.empty();
+}
+
+double ChSessionClock::GetOffset() const {
+  if (m_master)
+    return 0.0;
+  int64_t local = m_clock();
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return GetOffsetAt(local) * 1e-9;
+}
+
+double ChSessionClock::GetDrift() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_drift;
+}
+
+double ChSessionClock::GetUncertainty() const {
+  std::lock_guard<std::mutex> lock(m_mutex);
+  int64_t rtt = m_has_period ? m_period_best.rtt : INT64_MAX;
+  for (const Sample &s : m_window)
+    rtt = std::min(rtt, s.rtt);
+  if (rtt == INT64_MAX)
+    return 0.0;
+  return 0.5 * rtt * 1e-9;
+}
+
+int64_t ChSessionClock::GetSessionNs() const {
+  int64_t local = m_clock();
+  if (m_master)
+    return local;
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+  if (!m_has_period && m_window.empty()) {
+    // from zero, as the session time it will be replaced with, not from
+    // the epoch of the local clock (e.g. the boot)
+    if (m_first_local == INT64_MIN)
+      m_first_local = local;
+    return local - m_first_local;
+  }
+  int64_t session = local + std::llround(GetOffsetAt(local));
+  // a correction may hold the session time, it never steps it back
+  session = std::max(session, m_last_session);
+  m_last_session = session;
+  return session;
+}
+
+} // namespace hil
+} // namespace chrono
@@ -0,0 +1,122 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Authors: Jason Zhou
+// =============================================================================
+//
+// Session time shared by the nodes of a distributed run. One process (e.g.
+// the ROM distributor) is the master, its session time is the time since
+// the creation of its session clock. The other processes estimate the
+// offset and the drift of their own clock against it from time stamp
+// exchanges (ChHilLatencyTracker::SetSessionClock), and map their clock to
+// session time with it.
+//
+// Offset samples are noisy by up to half the round trip. Only the sample of
+// the fastest round trip of every HIL_SESSION_SAMPLE_PERIOD is kept, and a
+// line is fitted through the last HIL_SESSION_WINDOW kept samples: its
+// value is the offset and its slope the drift. Session time never goes
+// backwards on a correction. Until its first sample, a node reads its local
+// time since its first reading, not the raw time of its clock.
+//
+// =============================================================================
+
+#ifndef CH_SESSION_CLOCK_H
+#define CH_SESSION_CLOCK_H
+
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+#include "../ChApiHil.h"
+
+namespace chrono {
+namespace hil {
+
+#define HIL_SESSION_SAMPLE_PERIOD 0.1 // [s]
+#define HIL_SESSION_WINDOW 64
+#define HIL_SESSION_MIN_SPAN 1.0 // shortest window for a drift estimate [s]
+
+class CH_HIL_API ChSessionClock {
+public:
+  /// Local clock [ns], monotonic, any epoch
+  typedef std::function<int64_t()> Clock;
+
+  /// Create the clock of the master, or of a process following it
+  ChSessionClock(bool master);
+
+  /// Replace the steady clock, e.g. to simulate a skewed clock
+  void SetLocalClock(Clock clock) { m_clock = clock; }
+
+  /// Local clock [ns], the time base of the offset samples
+  int64_t GetLocalNs() const { return m_clock(); }
+
+  /// Add one measurement of the session time minus the local time, taken
+  /// at local time local_ns over a round trip of rtt_ns
+  void AddSample(int64_t local_ns, int64_t offset_ns, int64_t rtt_ns);
+
+  bool IsMaster() const { return m_master; }
+
+  /// True once a session time is known (always on the master)
+  bool IsSynchronized() const;
+
+  /// Session time minus local time, now [s]
+  double GetOffset() const;
+
+  /// Rate of the session clock relative to the local clock, minus 1
+  double GetDrift() const;
+
+  /// Half the fastest round trip of the window, which bounds the offset
+  /// error for symmetric links [s]
+  double GetUncertainty() const;
+
+  /// Session time [ns]; until synchronized, the local time since the first
+  /// call
+  int64_t GetSessionNs() const;
+
+  /// Session time [s]
+  double GetTime() const { return GetSessionNs() * 1e-9; }
+
+private:
+  struct Sample {
+    int64_t local = 0;
+    int64_t offset = 0;
+    int64_t rtt = 0;
+  };
+
+  /// Estimated offset at local time t [ns]
+  double GetOffsetAt(int64_t t) const;
+
+  /// Fit the line through the window
+  void Fit();
+
+  bool m_master;
+  Clock m_clock;
+
+  mutable std::mutex m_mutex;
+  bool m_has_period = false; // a sample is held for the current period
+  Sample m_period_best;
+  int64_t m_period_start = 0;
+  std::vector<Sample> m_window;
+  size_t m_next_sample = 0;
+
+  // offset(t) = m_offset + m_drift * (t - m_ref) [ns]
+  int64_t m_ref = 0;
+  double m_offset = 0.0;
+  double m_drift = 0.0;
+
+  mutable int64_t m_last_session = INT64_MIN;
+  mutable int64_t m_first_local = INT64_MIN; // first unsynchronized reading
+};
+
+} // namespace hil
+} // namespace chrono
+
+#endif
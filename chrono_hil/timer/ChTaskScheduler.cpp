@@ -0,0 +1,291 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Authors: Jason Zhou
+// =============================================================================
+//
+// Multirate task scheduler with staggered phases and real-time pacing
+//
+// =============================================================================
+
+#include "ChTaskScheduler.h"
+#include "../memory/ChFrameArena.h"
+#include "ChFrameGovernor.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+
+namespace chrono {
+namespace hil {
+
+ChTaskScheduler::ChTaskScheduler(double step) : m_step(step), m_pacer(step) {}
+
+ChTaskScheduler::~ChTaskScheduler() {
+  if (m_worker.joinable()) {
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_stop = true;
+    }
+    m_cv.notify_one();
+    m_worker.join();
+  }
+}
+
+int ChTaskScheduler::GetPeriodFrames(const TaskEntry &task) const {
+  return std::max(1, static_cast<int>(std::lround(task.period / m_step)));
+}
+
+int ChTaskScheduler::Stagger(int frames) const {
+  // load of each frame of the hyperperiod of the main thread tasks
+  int64_t hyper = frames;
+  for (const TaskEntry &task : m_tasks) {
+    if (task.thread == HIL_TASK_MAIN)
+      hyper = std::min<int64_t>(std::lcm(hyper, GetPeriodFrames(task)),
+                                HIL_TASK_MAX_HYPERPERIOD);
+  }
+  std::vector<double> load(hyper, 0.0);
+  for (const TaskEntry &task : m_tasks) {
+    if (task.thread != HIL_TASK_MAIN)
+      continue;
+    int n = GetPeriodFrames(task);
+    int offset = static_cast<int>(std::lround(task.phase / m_step)) % n;
+    for (int64_t f = offset; f < hyper; f += n)
+      load[f] += task.cost_hint;
+  }
+
+  int best = 0;
+  double best_peak = -1.0;
+  for (int offset = 0; offset < frames; offset++) {
+    double peak = 0.0;
+    for (int64_t f = offset; f < hyper; f += frames)
+      peak = std::max(peak, load[f]);
+    if (best_peak < 0.0 || peak < best_peak) {
+      best = offset;
+      best_peak = peak;
+    }
+  }
+  return best;
+}
+
+int ChTaskScheduler::AddTask(const std::string &name, double period,
+                             Task task, int priority, double phase,
+                             ChTaskThread thread) {
+  // staggered against the load of the tasks registered before
+  if (phase == HIL_TASK_AUTO_PHASE)
+    phase = Stagger(std::max(1, (int)std::lround(period / m_step))) * m_step;
+
+  m_tasks.emplace_back();
+  TaskEntry &added = m_tasks.back();
+  added.name = name;
+  added.period = period;
+  added.phase = phase;
+  added.priority = priority;
+  added.thread = thread;
+  added.task = task;
+  added.next = m_time + added.phase;
+  if (m_monitor && thread == HIL_TASK_MAIN)
+    added.monitor_phase = m_monitor->AddPhase(name);
+  if (thread == HIL_TASK_WORKER && !m_worker.joinable())
+    m_worker = std::thread(&ChTaskScheduler::WorkerLoop, this);
+
+  // stable, so tasks of equal priority run in the order of registration
+  m_order.push_back(&added);
+  std::stable_sort(m_order.begin(), m_order.end(),
+                   [](const TaskEntry *a, const TaskEntry *b) {
+                     return a->priority > b->priority;
+                   });
+  return static_cast<int>(m_tasks.size()) - 1;
+}
+
+void ChTaskScheduler::SetCostHint(int task, double cost) {
+  m_tasks[task].cost_hint = cost;
+}
+
+void ChTaskScheduler::SetAfterWait(int task, bool after_wait) {
+  m_tasks[task].after_wait = after_wait;
+}
+
+void ChTaskScheduler::SetPeriod(int task, double period) {
+  TaskEntry &entry = m_tasks[task];
+  entry.period = period;
+  if (m_started)
+    entry.next = std::min(entry.next, m_time + period);
+}
+
+void ChTaskScheduler::SetRealtime(bool realtime, ChRealtimeCatchUp policy) {
+  m_realtime = realtime;
+  m_policy = policy;
+  m_pacer.SetCatchUp(policy);
+}
+
+void ChTaskScheduler::SetMonitor(ChRealtimeMonitor *monitor) {
+  m_monitor = monitor;
+  for (TaskEntry &task : m_tasks) {
+    if (task.thread == HIL_TASK_MAIN)
+      task.monitor_phase = monitor->AddPhase(task.name);
+  }
+  m_wait_phase = monitor->AddPhase("wait");
+  monitor->SetWaitPhase(m_wait_phase);
+}
+
+void ChTaskScheduler::SetTimeScale(double scale) {
+  m_scale = scale;
+  SetStep(m_step);
+}
+
+void ChTaskScheduler::SetStep(double step) {
+  m_step = step;
+  // the frames last the step over the scale in wall time
+  m_pacer = ChRealtimePacer(step / m_scale);
+  m_pacer.SetCatchUp(m_policy);
+  if (m_governor)
+    m_governor->SetStep(step / m_scale);
+}
+
+void ChTaskScheduler::Step(double time) {
+  if (!m_started) {
+    // the phases count from the first frame
+    for (TaskEntry &task : m_tasks)
+      task.next = time + task.phase;
+    m_pacer.Reset();
+    m_start = ChRealtimePacer::Now();
+    m_frame_start = m_start;
+    m_started = true;
+  }
+  m_time = time;
+
+  RunDue(time, false);
+
+  if (m_governor)
+    m_governor->Update(ChRealtimePacer::Now() - m_frame_start, time);
+  // frees in the slack of the frame
+  if (m_arena)
+    m_arena->Reset();
+
+  if (m_realtime) {
+    if (m_monitor)
+      m_monitor->BeginPhase(m_wait_phase);
+    m_pacer.Wait();
+  }
+  m_frame_start = ChRealtimePacer::Now();
+  if (m_monitor)
+    m_monitor->EndFrame(time);
+
+  // part of the busy time of the next frame
+  RunDue(time, true);
+}
+
+void ChTaskScheduler::RunDue(double time, bool after_wait) {
+  double tolerance = 0.5 * m_step;
+  for (TaskEntry *task : m_order) {
+    if (task->after_wait != after_wait || time < task->next - tolerance)
+      continue;
+
+    if (m_budget > 0.0 && task->priority < 0 && !task->deferred &&
+        ChRealtimePacer::Now() - m_frame_start > m_budget) {
+      // stays due, runs first thing next frame
+      task->deferred = true;
+      task->stats.deferred++;
+      continue;
+    }
+    task->deferred = false;
+
+    if (task->period < m_step) {
+      task->next = time;
+    } else {
+      task->next += task->period;
+      // back on the phase after a step change or a deferral
+      while (task->next < time + tolerance)
+        task->next += task->period;
+    }
+    Run(*task, time);
+  }
+}
+
+void ChTaskScheduler::Run(TaskEntry &task, double time) {
+  if (task.thread == HIL_TASK_WORKER) {
+    if (task.busy) {
+      task.stats.skipped++;
+      return;
+    }
+    task.busy = true;
+    {
+      std::lock_guard<std::mutex> lock(m_mutex);
+      m_queue.emplace_back(&task, time);
+    }
+    m_cv.notify_one();
+    return;
+  }
+
+  if (m_monitor)
+    m_monitor->BeginPhase(task.monitor_phase);
+  double start = ChRealtimePacer::Now();
+  task.task(time);
+  task.stats.cost.Record(ChRealtimePacer::Now() - start);
+  task.stats.runs++;
+  if (m_monitor)
+    m_monitor->BeginPhase(0);
+}
+
+void ChTaskScheduler::WorkerLoop() {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while (true) {
+    m_cv.wait(lock, [this] { return !m_queue.empty() || m_stop; });
+    if (m_stop)
+      return;
+    TaskEntry *task = m_queue.front().first;
+    double time = m_queue.front().second;
+    m_queue.pop_front();
+    lock.unlock();
+
+    double start = ChRealtimePacer::Now();
+    task->task(time);
+    task->stats.cost.Record(ChRealtimePacer::Now() - start);
+    task->stats.runs++;
+    task->busy = false;
+    lock.lock();
+  }
+}
+
+void ChTaskScheduler::Report() const {
+  double wall = m_started ? ChRealtimePacer::Now() - m_start : 0.0;
+  std::ios::fmtflags flags = std::cout.flags();
+  std::streamsize precision = std::cout.precision();
+  std::cout << std::left << std::setw(16) << "task" << std::right
+            << std::setw(10) << "period ms" << std::setw(10) << "phase ms"
+            << std::setw(6) << "prio" << std::setw(8) << "thread"
+            << std::setw(9) << "runs" << std::setw(10) << "mean us"
+            << std::setw(10) << "p99 us" << std::setw(10) << "max us"
+            << std::setw(8) << "load %" << std::setw(9) << "deferred"
+            << std::setw(8) << "skipped" << std::endl;
+  for (const TaskEntry &task : m_tasks) {
+    const ChTaskStats &s = task.stats;
+    double total = s.cost.GetMean() * s.cost.GetCount();
+    std::cout << std::left << std::setw(16) << task.name << std::right
+              << std::fixed << std::setprecision(2) << std::setw(10)
+              << 1e3 * task.period << std::setw(10) << 1e3 * task.phase
+              << std::setw(6) << task.priority << std::setw(8)
+              << (task.thread == HIL_TASK_MAIN ? "main" : "worker")
+              << std::setw(9) << s.runs << std::setprecision(1)
+              << std::setw(10) << 1e6 * s.cost.GetMean() << std::setw(10)
+              << 1e6 * s.cost.GetPercentile(99.0) << std::setw(10)
+              << 1e6 * s.cost.GetMax() << std::setw(8)
+              << (wall > 0.0 ? 100.0 * total / wall : 0.0) << std::setw(9)
+              << s.deferred << std::setw(8) << s.skipped << std::endl;
+  }
+  std::cout.flags(flags);
+  std::cout.precision(precision);
+}
+
+} // namespace hil
+} // namespace chrono
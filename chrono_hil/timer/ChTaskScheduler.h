@@ -0,0 +1,225 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Authors: Jason Zhou
+// =============================================================================
+//
+// Multirate task scheduler of a HIL main loop. The tasks which used to run
+// every N steps (render, network sends, logging, HUD, sensor queries) are
+// registered with a period and a phase offset in simulated time, and the
+// loop calls Step once per frame. The schedule follows the simulated time,
+// not a step counter, so it holds when the step size changes.
+//
+// Tasks registered with HIL_TASK_AUTO_PHASE are staggered: each one gets
+// the offset whose frames carry the least load of the tasks already
+// registered (weighted by their cost hints), so tasks of the same rate
+// fall in different frames instead of piling up in one.
+//
+// Due tasks run by decreasing priority. With a budget set, once the frame
+// has used it (the busy time since the end of the previous wait, the
+// dynamics included), the due tasks of negative priority are deferred to
+// the next frame. Tasks with the HIL_TASK_WORKER hint run on a worker
+// thread of the scheduler, and are skipped while their previous run is
+// still going.
+//
+// With real time enabled, Step ends with a ChRealtimePacer wait for the
+// end of the frame, on a wall clock sped up by the time scale (see
+// ChRunMode). Tasks set to run after the wait (e.g. the receive of driver
+// inputs) run once it is over, so that what they sample is not held for
+// the wait before the dynamics use it. With a ChRealtimeMonitor set, each
+// main thread task is a phase of the monitor, and Step ends the frame of
+// the monitor.
+// With a ChFrameGovernor set, Step feeds it the busy time of each frame,
+// from the end of the previous wait to the start of this one.
+// With a ChFrameArena set, Step resets it before the wait, ending the
+// frame of the scratch data of the main thread tasks.
+//
+// =============================================================================
+
+#ifndef CH_TASK_SCHEDULER_H
+#define CH_TASK_SCHEDULER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../ChApiHil.h"
+#include "ChLatencyHistogram.h"
+#include "ChRealtimeMonitor.h"
+#include "ChRealtimePacer.h"
+
+namespace chrono {
+namespace hil {
+
+class ChFrameArena;
+class ChFrameGovernor;
+
+#define HIL_TASK_AUTO_PHASE -1.0
+#define HIL_TASK_MAX_HYPERPERIOD 100000 // frames searched to stagger tasks
+
+enum ChTaskThread {
+  HIL_TASK_MAIN,  // on the thread calling Step, in the frame it is due
+  HIL_TASK_WORKER // on the worker thread, without holding up the frame
+};
+
+/// Statistics of one task
+struct ChTaskStats {
+  uint64_t runs = 0;
+  uint64_t deferred = 0; // frames the task was put off by the budget
+  uint64_t skipped = 0;  // runs dropped while the worker was still busy
+  ChLatencyHistogram cost;
+};
+
+class CH_HIL_API ChTaskScheduler {
+public:
+  /// Task, called with the simulated time of the frame [s]
+  typedef std::function<void(double time)> Task;
+
+  /// Schedule frames of step [s] of simulated time
+  ChTaskScheduler(double step);
+  ~ChTaskScheduler();
+
+  /// Register task, run every period [s] of simulated time from phase [s],
+  /// or from a staggered phase with HIL_TASK_AUTO_PHASE. A period shorter
+  /// than the step runs the task every frame. Returns the index of the
+  /// task. Register the tasks before the first Step.
+  int AddTask(const std::string &name, double period, Task task,
+              int priority = 0, double phase = HIL_TASK_AUTO_PHASE,
+              ChTaskThread thread = HIL_TASK_MAIN);
+
+  /// Relative cost of a task, used to stagger the tasks registered after
+  /// it (1 by default)
+  void SetCostHint(int task, double cost);
+
+  /// Run a main thread task after the wait of its frame, right before the
+  /// dynamics which follow Step, instead of before the wait
+  void SetAfterWait(int task, bool after_wait = true);
+
+  /// Busy time per frame [s], from the end of the previous wait, after
+  /// which the tasks of negative priority are deferred; 0 (the default)
+  /// never defers
+  void SetBudget(double budget) { m_budget = budget; }
+
+  /// Wait for the end of each frame in Step, with policy after overruns
+  void SetRealtime(bool realtime, ChRealtimeCatchUp policy = HIL_PACER_SLEW);
+
+  /// Pace the frames to the step over scale, to run scale times faster
+  /// than real time (1 by default)
+  void SetTimeScale(double scale);
+  double GetTimeScale() const { return m_scale; }
+
+  /// Pacer of the frames, its statistics hold the overruns
+  ChRealtimePacer &GetPacer() { return m_pacer; }
+
+  /// Mark the tasks as phases of monitor and end its frames in Step
+  void SetMonitor(ChRealtimeMonitor *monitor);
+
+  /// Feed the busy time of each frame to governor in Step
+  void SetGovernor(ChFrameGovernor *governor) { m_governor = governor; }
+
+  /// Reset arena at the end of each frame in Step; the main thread tasks
+  /// allocate their scratch data from it
+  void SetArena(ChFrameArena *arena) { m_arena = arena; }
+
+  /// New step size [s]; the phases stay on simulated time, the pacer
+  /// starts over
+  void SetStep(double step);
+  double GetStep() const { return m_step; }
+
+  /// Run the tasks due at simulated time time [s], then wait for the end
+  /// of the frame in real time, then run the due tasks set to run after
+  /// the wait. Call once per frame, between the dynamics.
+  void Step(double time);
+
+  int GetNumTasks() const { return static_cast<int>(m_tasks.size()); }
+  const std::string &GetName(int task) const { return m_tasks[task].name; }
+
+  /// Period of task [s]; a new period applies from the next run, which
+  /// is moved forward if it comes later than one new period from now
+  double GetPeriod(int task) const { return m_tasks[task].period; }
+  void SetPeriod(int task, double period);
+
+  /// Phase of task, as assigned for HIL_TASK_AUTO_PHASE [s]
+  double GetPhase(int task) const { return m_tasks[task].phase; }
+
+  /// Statistics of task; those of a worker task are final once the
+  /// scheduler is destroyed or idle
+  const ChTaskStats &GetStats(int task) const { return m_tasks[task].stats; }
+
+  /// Print the period, phase, cost and share of the loop time of each task
+  void Report() const;
+
+private:
+  struct TaskEntry {
+    std::string name;
+    double period;
+    double phase;
+    int priority;
+    ChTaskThread thread;
+    Task task;
+    double cost_hint = 1.0;
+    double next = 0.0; // simulated time of the next run
+    int monitor_phase = -1;
+    bool after_wait = false;
+    bool deferred = false;         // put off in the previous frame
+    std::atomic<bool> busy{false}; // queued or running on the worker
+    ChTaskStats stats;
+  };
+
+  /// Frames of the period of task, at least one
+  int GetPeriodFrames(const TaskEntry &task) const;
+
+  /// Offset [frames] of a new task of period frames whose frames carry the
+  /// least load
+  int Stagger(int frames) const;
+
+  /// Run the due tasks of one side of the wait
+  void RunDue(double time, bool after_wait);
+
+  void Run(TaskEntry &task, double time);
+
+  void WorkerLoop();
+
+  double m_step;
+  double m_budget = 0.0;
+  bool m_realtime = false;
+  double m_scale = 1.0;
+  ChRealtimeCatchUp m_policy = HIL_PACER_SLEW;
+  ChRealtimePacer m_pacer;
+  ChRealtimeMonitor *m_monitor = nullptr;
+  int m_wait_phase = -1;
+  ChFrameGovernor *m_governor = nullptr;
+  ChFrameArena *m_arena = nullptr;
+  double m_frame_start = 0.0; // end of the wait of the previous frame
+  double m_start = 0.0; // wall time of the loop, for the load shares
+  bool m_started = false;
+
+  std::deque<TaskEntry> m_tasks;    // stable addresses for the worker
+  std::vector<TaskEntry *> m_order; // by decreasing priority
+  double m_time = 0.0;              // of the last frame
+
+  std::thread m_worker;
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  std::deque<std::pair<TaskEntry *, double>> m_queue;
+  bool m_stop = false;
+};
+
+} // namespace hil
+} // namespace chrono
+
+#endif
@@ -0,0 +1,302 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Authors: Jason Zhou
+// =============================================================================
+//
+// Thread affinity, scheduling class and memory locking per role
+//
+// =============================================================================
+
+#include "ChThreadPlacement.h"
+#include "chrono_vehicle/utils/ChUtilsJSON.h"
+
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+
+#ifdef __linux__
+#include <cerrno>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#endif
+
+namespace chrono {
+namespace hil {
+
+namespace {
+
+const char *PolicyName(ChThreadPolicy policy) {
+  switch (policy) {
+  case HIL_THREAD_FIFO:
+    return "fifo";
+  case HIL_THREAD_RR:
+    return "rr";
+  default:
+    return "other";
+  }
+}
+
+// cpulist string of cores, e.g. "0-2,5"
+std::string FormatCPUList(const std::vector<int> &cpus) {
+  std::ostringstream out;
+  for (size_t i = 0; i < cpus.size(); i++) {
+    size_t last = i;
+    while (last + 1 < cpus.size() && cpus[last + 1] == cpus[last] + 1)
+      last++;
+    out << (i > 0 ? "," : "") << cpus[i];
+    if (last > i)
+      out << "-" << cpus[last];
+    i = last;
+  }
+  return cpus.empty() ? "none" : out.str();
+}
+
+// report a field of the wrong type, the profile is refused
+bool ProfileError(const std::string &filename, const std::string &field,
+                  const std::string &expected) {
+  std::cout << "Thread placement: " << field << " must be " << expected
+            << " in profile " << filename << std::endl;
+  return false;
+}
+
+} // namespace
+
+bool ChThreadPlacement::Load(const std::string &filename) {
+  rapidjson::Document d;
+  chrono::vehicle::ReadFileJSON(filename, d);
+  if (!d.IsObject() || !d.HasMember("threads") || !d["threads"].IsObject()) {
+    std::cout << "Thread placement: no threads in profile " << filename
+              << std::endl;
+    return false;
+  }
+
+  if (d.HasMember("lock_memory")) {
+    if (!d["lock_memory"].IsBool())
+      return ProfileError(filename, "lock_memory", "true or false");
+    m_lock_memory = d["lock_memory"].GetBool();
+  }
+
+  const rapidjson::Value &threads = d["threads"];
+  for (auto it = threads.MemberBegin(); it != threads.MemberEnd(); ++it) {
+    std::string name = it->name.GetString();
+    const rapidjson::Value &value = it->value;
+    ChThreadRole role;
+
+    if (value.HasMember("cpus") && value["cpus"].IsArray()) {
+      const rapidjson::Value &cpus = value["cpus"];
+      for (rapidjson::SizeType i = 0; i < cpus.Size(); i++) {
+        if (!cpus[i].IsInt())
+          return ProfileError(filename, name + ": cpus", "a list of cores");
+        role.cpus.push_back(cpus[i].GetInt());
+      }
+    } else if (value.HasMember("cpus")) {
+      if (!value["cpus"].IsString())
+        return ProfileError(filename, name + ": cpus",
+                            "a list of cores, a cpulist or \"isolated\"");
+      std::string cpus = value["cpus"].GetString();
+      if (cpus == "isolated") {
+        role.cpus = GetIsolatedCPUs();
+        if (role.cpus.empty())
+          std::cout << "Thread placement: " << name
+                    << ": no isolated cores, keeping its cores" << std::endl;
+      } else {
+        role.cpus = ParseCPUList(cpus);
+      }
+    }
+
+    if (value.HasMember("policy")) {
+      if (!value["policy"].IsString())
+        return ProfileError(filename, name + ": policy",
+                            "\"fifo\", \"rr\" or \"other\"");
+      std::string policy = value["policy"].GetString();
+      if (policy == "fifo")
+        role.policy = HIL_THREAD_FIFO;
+      else if (policy == "rr")
+        role.policy = HIL_THREAD_RR;
+      else if (policy != "other")
+        std::cout << "Thread placement: " << name << ": unknown policy "
+                  << policy << ", using other" << std::endl;
+    }
+    if (value.HasMember("priority")) {
+      if (!value["priority"].IsInt())
+        return ProfileError(filename, name + ": priority", "an integer");
+      role.priority = value["priority"].GetInt();
+    }
+
+    m_roles[name] = role;
+  }
+  return true;
+}
+
+bool ChThreadPlacement::Apply(const std::string &name) {
+#ifdef __linux__
+  return Place(name, pthread_self());
+#else
+  return Place(name, std::thread::native_handle_type());
+#endif
+}
+
+bool ChThreadPlacement::Apply(const std::string &name, std::thread &thread) {
+  if (!thread.joinable()) {
+    std::cout << "Thread placement: " << name << ": no thread to place"
+              << std::endl;
+    return false;
+  }
+  return Place(name, thread.native_handle());
+}
+
+bool ChThreadPlacement::Place(const std::string &name,
+                              std::thread::native_handle_type handle) {
+  auto it = m_roles.find(name);
+  if (it == m_roles.end())
+    return true;
+  const ChThreadRole &role = it->second;
+
+#ifdef __linux__
+  bool ok = true;
+
+  if (!role.cpus.empty()) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    for (int cpu : role.cpus) {
+      if (cpu >= 0 && cpu < CPU_SETSIZE)
+        CPU_SET(cpu, &set);
+    }
+    int err = pthread_setaffinity_np(handle, sizeof(set), &set);
+    if (err != 0) {
+      std::cout << "Thread placement: " << name << ": cores "
+                << FormatCPUList(role.cpus) << " refused (" << strerror(err)
+                << (err == EINVAL ? ", none is online or allowed" : "")
+                << "), keeping its cores" << std::endl;
+      ok = false;
+    }
+  }
+
+  int policy = SCHED_OTHER;
+  if (role.policy == HIL_THREAD_FIFO)
+    policy = SCHED_FIFO;
+  else if (role.policy == HIL_THREAD_RR)
+    policy = SCHED_RR;
+  sched_param param;
+  param.sched_priority = role.policy == HIL_THREAD_OTHER ? 0 : role.priority;
+  int err = pthread_setschedparam(handle, policy, &param);
+  if (err != 0) {
+    std::cout << "Thread placement: " << name << ": policy "
+              << PolicyName(role.policy) << " " << role.priority
+              << " refused (" << strerror(err)
+              << (err == EPERM ? ", needs CAP_SYS_NICE or an rtprio limit"
+                               : "")
+              << (err == EINVAL ? ", priority out of 1 to 99" : "")
+              << "), keeping its policy" << std::endl;
+    ok = false;
+  }
+
+  if (ok) {
+    std::cout << "Thread placement: " << name << " on cores "
+              << (role.cpus.empty() ? "unchanged" : FormatCPUList(role.cpus))
+              << ", policy " << PolicyName(role.policy);
+    if (role.policy != HIL_THREAD_OTHER)
+      std::cout << " " << role.priority;
+    std::cout << std::endl;
+  }
+  return ok;
+#else
+  std::cout << "Thread placement: " << name
+            << ": only supported on Linux, left as it is" << std::endl;
+  return false;
+#endif
+}
+
+bool ChThreadPlacement::LockMemory() {
+  if (!m_lock_memory)
+    return true;
+#ifdef __linux__
+  if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+    int err = errno;
+    std::cout << "Thread placement: memory lock refused (" << strerror(err)
+              << (err == EPERM || err == ENOMEM
+                      ? ", needs CAP_IPC_LOCK or a larger memlock limit"
+                      : "")
+              << "), pages may be swapped out" << std::endl;
+    return false;
+  }
+  return true;
+#else
+  std::cout << "Thread placement: memory lock only supported on Linux"
+            << std::endl;
+  return false;
+#endif
+}
+
+ChThreadRole ChThreadPlacement::GetCurrent() {
+  ChThreadRole role;
+#ifdef __linux__
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  if (pthread_getaffinity_np(pthread_self(), sizeof(set), &set) == 0) {
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+      if (CPU_ISSET(cpu, &set))
+        role.cpus.push_back(cpu);
+    }
+  }
+
+  int policy;
+  sched_param param;
+  if (pthread_getschedparam(pthread_self(), &policy, &param) == 0) {
+    if (policy == SCHED_FIFO)
+      role.policy = HIL_THREAD_FIFO;
+    else if (policy == SCHED_RR)
+      role.policy = HIL_THREAD_RR;
+    role.priority = param.sched_priority;
+  }
+#endif
+  return role;
+}
+
+std::vector<int> ChThreadPlacement::ParseCPUList(const std::string &list) {
+  std::vector<int> cpus;
+  std::stringstream stream(list);
+  std::string range;
+  while (std::getline(stream, range, ',')) {
+    const char *begin = range.c_str();
+    char *end;
+    long first = std::strtol(begin, &end, 10);
+    if (end == begin || first < 0)
+      continue;
+    long last = first;
+    if (*end == '-') {
+      begin = end + 1;
+      last = std::strtol(begin, &end, 10);
+      if (end == begin || last < first)
+        continue;
+    }
+    for (long cpu = first; cpu <= last; cpu++)
+      cpus.push_back((int)cpu);
+  }
+
+  std::sort(cpus.begin(), cpus.end());
+  cpus.erase(std::unique(cpus.begin(), cpus.end()), cpus.end());
+  return cpus;
+}
+
+std::vector<int> ChThreadPlacement::GetIsolatedCPUs() {
+  std::ifstream file(HIL_THREAD_ISOLATED_FILE);
+  std::string list;
+  std::getline(file, list);
+  return ParseCPUList(list);
+}
+
+} // namespace hil
+} // namespace chrono
@@ -0,0 +1,117 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Authors: Jason Zhou
+// =============================================================================
+//
+// Placement of the threads of a HIL node: the cores each thread may run on
+// and its scheduling class, per role (physics, io, render...), so that the
+// physics loop can own a core isolated with isolcpus, away from the IRQ and
+// render threads. The roles come from a JSON runtime profile:
+//
+//   {
+//     "lock_memory": true,
+//     "threads": {
+//       "physics": { "cpus": [2], "policy": "fifo", "priority": 80 },
+//       "io":      { "cpus": "3",  "policy": "fifo", "priority": 70 },
+//       "render":  { "cpus": "0-1" }
+//     }
+//   }
+//
+// "cpus" is a list of cores, a Linux cpulist string ("0-1,4"), or
+// "isolated" for the cores isolated by the kernel; "policy" is "other"
+// (default), "fifo" or "rr", with a priority of 1 to 99. Each thread places
+// itself, or is placed, by role with Apply.
+//
+// Real-time classes and memory locking need CAP_SYS_NICE / CAP_IPC_LOCK or
+// the rtprio / memlock limits. Without them, Apply and LockMemory report
+// what was refused and why, and the thread goes on with its previous policy;
+// the other settings of the role are still applied. Placement is only
+// supported on Linux, elsewhere it is reported and ignored.
+//
+// =============================================================================
+
+#ifndef CH_THREAD_PLACEMENT_H
+#define CH_THREAD_PLACEMENT_H
+
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../ChApiHil.h"
+
+namespace chrono {
+namespace hil {
+
+// cores isolated from the scheduler by the kernel (isolcpus)
+#define HIL_THREAD_ISOLATED_FILE "/sys/devices/system/cpu/isolated"
+
+enum ChThreadPolicy { HIL_THREAD_OTHER, HIL_THREAD_FIFO, HIL_THREAD_RR };
+
+/// Placement of the threads of one role
+struct ChThreadRole {
+  std::vector<int> cpus; // cores the thread may run on, empty to keep them
+  ChThreadPolicy policy = HIL_THREAD_OTHER;
+  int priority = 0; // 1 to 99 with HIL_THREAD_FIFO and HIL_THREAD_RR
+};
+
+class CH_HIL_API ChThreadPlacement {
+public:
+  ChThreadPlacement() {}
+
+  /// Read the roles and the memory locking of a JSON runtime profile;
+  /// returns false if the file has no "threads" member or a field of the
+  /// wrong type
+  bool Load(const std::string &filename);
+
+  void SetRole(const std::string &name, const ChThreadRole &role) {
+    m_roles[name] = role;
+  }
+  bool HasRole(const std::string &name) const {
+    return m_roles.count(name) > 0;
+  }
+
+  /// Lock the pages of the process in memory in LockMemory
+  void SetLockMemory(bool lock) { m_lock_memory = lock; }
+  bool GetLockMemory() const { return m_lock_memory; }
+
+  /// Place the calling thread as role name. Returns false if a setting
+  /// was refused, after reporting it; a role without a profile entry is
+  /// left as it is.
+  bool Apply(const std::string &name);
+
+  /// Place thread as role name, e.g. a worker thread from its owner
+  bool Apply(const std::string &name, std::thread &thread);
+
+  /// Lock the current and future pages of the process in memory, so the
+  /// loops never take a page fault; does nothing if not enabled
+  bool LockMemory();
+
+  /// Placement of the calling thread
+  static ChThreadRole GetCurrent();
+
+  /// Cores of a Linux cpulist string, e.g. "0-2,5", sorted
+  static std::vector<int> ParseCPUList(const std::string &list);
+
+  /// Cores isolated by the kernel, empty if none
+  static std::vector<int> GetIsolatedCPUs();
+
+private:
+  bool Place(const std::string &name, std::thread::native_handle_type handle);
+
+  std::map<std::string, ChThreadRole> m_roles;
+  bool m_lock_memory = false;
+};
+
+} // namespace hil
+} // namespace chrono
+
+#endif
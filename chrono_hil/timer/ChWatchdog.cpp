@@ -0,0 +1,208 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Authors: Jason Zhou
+// =============================================================================
+//
+// Heartbeat watchdog with stall dumps and actions
+//
+// =============================================================================
+
+#include "ChWatchdog.h"
+#include "ChRealtimePacer.h"
+
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+#ifdef __linux__
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace chrono {
+namespace hil {
+
+ChWatchdog::ChWatchdog(double period) : m_period(period) {}
+
+ChWatchdog::~ChWatchdog() { Stop(); }
+
+int ChWatchdog::Watch(const std::string &name, double threshold,
+                      Action action) {
+  m_loops.emplace_back();
+  Loop &loop = m_loops.back();
+  loop.name = name;
+  loop.threshold = threshold;
+  loop.action = action;
+  return static_cast<int>(m_loops.size()) - 1;
+}
+
+void ChWatchdog::Beat(int loop) {
+  Loop &entry = m_loops[loop];
+  double now = ChRealtimePacer::Now();
+#ifdef __linux__
+  if (entry.tid.load(std::memory_order_relaxed) == 0)
+    entry.tid.store(syscall(SYS_gettid), std::memory_order_relaxed);
+#endif
+  // only the loop writes its beats
+  uint64_t beats = entry.beats.load(std::memory_order_relaxed);
+  double interval = now - entry.last_beat.load(std::memory_order_relaxed);
+  if (beats > 0 &&
+      interval > entry.max_interval.load(std::memory_order_relaxed))
+    entry.max_interval.store(interval, std::memory_order_relaxed);
+  entry.beats.store(beats + 1, std::memory_order_relaxed);
+  entry.last_beat.store(now, std::memory_order_release);
+}
+
+void ChWatchdog::Activity(int loop) {
+  m_loops[loop].activity.store(ChRealtimePacer::Now(),
+                               std::memory_order_relaxed);
+}
+
+void ChWatchdog::Start() {
+  if (m_thread.joinable())
+    return;
+  double now = ChRealtimePacer::Now();
+  for (Loop &loop : m_loops) {
+    loop.last_beat.store(now, std::memory_order_relaxed);
+    loop.stalled = false;
+  }
+  m_stop = false;
+  m_thread = std::thread(&ChWatchdog::Run, this);
+}
+
+void ChWatchdog::Stop() {
+  if (!m_thread.joinable())
+    return;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    m_stop = true;
+  }
+  m_cv.notify_one();
+  m_thread.join();
+}
+
+void ChWatchdog::Run() {
+  std::unique_lock<std::mutex> lock(m_mutex);
+  while (!m_stop) {
+    m_cv.wait_for(lock, std::chrono::duration<double>(m_period));
+    if (m_stop)
+      break;
+    // the actions run without the lock, Stop does not wait for them
+    lock.unlock();
+    double now = ChRealtimePacer::Now();
+    for (int i = 0; i < GetNumLoops(); i++)
+      Check(i, now);
+    lock.lock();
+  }
+}
+
+void ChWatchdog::Check(int loop, double now) {
+  Loop &entry = m_loops[loop];
+  double last = entry.last_beat.load(std::memory_order_acquire);
+
+  if (entry.stalled) {
+    // still no beat since the stall
+    if (last == entry.stalled_beat)
+      return;
+    double length = last - entry.stalled_beat;
+    if (length > entry.max_stall)
+      entry.max_stall = length;
+    entry.stalled = false;
+    if (m_print) {
+      std::ios::fmtflags flags = std::cout.flags();
+      std::streamsize precision = std::cout.precision();
+      std::cout << std::fixed << std::setprecision(1)
+                << "Watchdog: " << entry.name << " recovered after a "
+                << 1e3 * length << " ms stall" << std::endl;
+      std::cout.flags(flags);
+      std::cout.precision(precision);
+    }
+    return;
+  }
+
+  if (now - last <= entry.threshold)
+    return;
+  entry.stalled = true;
+  entry.stalled_beat = last;
+  entry.stalls++;
+
+  ChWatchdogStall stall = GetState(loop);
+  if (m_print) {
+    std::ios::fmtflags flags = std::cout.flags();
+    std::streamsize precision = std::cout.precision();
+    std::cout << std::fixed << std::setprecision(1) << "Watchdog: "
+              << stall.name << " stalled for " << 1e3 * stall.stalled
+              << " ms (threshold " << 1e3 * stall.threshold << " ms), "
+              << stall.beats << " beats, longest interval "
+              << 1e3 * stall.max_interval << " ms";
+    if (!stall.state.empty())
+      std::cout << ", state \"" << stall.state << "\"";
+    if (stall.activity >= 0.0)
+      std::cout << ", last activity " << 1e3 * stall.activity << " ms ago";
+    if (!stall.thread.empty())
+      std::cout << ", thread " << stall.thread;
+    std::cout << std::endl;
+    std::cout.flags(flags);
+    std::cout.precision(precision);
+  }
+  if (entry.action)
+    entry.action(stall);
+}
+
+ChWatchdogStall ChWatchdog::GetState(int loop) const {
+  const Loop &entry = m_loops[loop];
+  double now = ChRealtimePacer::Now();
+
+  ChWatchdogStall stall;
+  stall.loop = loop;
+  stall.name = entry.name;
+  stall.stalled = now - entry.last_beat.load(std::memory_order_acquire);
+  stall.threshold = entry.threshold;
+  stall.beats = entry.beats.load(std::memory_order_relaxed);
+  stall.max_interval = entry.max_interval.load(std::memory_order_relaxed);
+  const char *state = entry.state.load(std::memory_order_relaxed);
+  stall.state = state ? state : "";
+  double activity = entry.activity.load(std::memory_order_relaxed);
+  stall.activity = activity < 0.0 ? -1.0 : now - activity;
+  stall.thread = GetThreadState(entry.tid.load(std::memory_order_relaxed));
+  return stall;
+}
+
+std::string ChWatchdog::GetThreadState(long tid) {
+#ifdef __linux__
+  if (tid == 0)
+    return "";
+  std::string task = "/proc/self/task/" + std::to_string(tid);
+
+  // the state follows the command name, which may hold spaces
+  std::ifstream stat_file(task + "/stat");
+  std::string stat;
+  std::getline(stat_file, stat);
+  size_t end = stat.rfind(')');
+  if (end == std::string::npos || end + 2 >= stat.size())
+    return "";
+  std::string state(1, stat[end + 2]);
+
+  // kernel function the thread sleeps in, "0" when running
+  std::ifstream wchan_file(task + "/wchan");
+  std::string wchan;
+  std::getline(wchan_file, wchan);
+  if (!wchan.empty() && wchan != "0")
+    state += " in " + wchan;
+  return state;
+#else
+  return "";
+#endif
+}
+
+} // namespace hil
+} // namespace chrono
@@ -0,0 +1,158 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Authors: Jason Zhou
+// =============================================================================
+//
+// Watchdog of the loops and threads of a HIL process. Each watched loop
+// (main loop, network receive, sensor thread, ...) is registered with a
+// stall threshold and beats once per iteration. A thread of the watchdog
+// checks the beats every period; a loop which has not beaten for longer
+// than its threshold is stalled:
+//   - its state is dumped: time since the last beat, beats and longest
+//     interval between beats so far, what the loop said it was doing
+//     (SetState, e.g. "receive"), its last activity (Activity, e.g. the
+//     last datagram received) and, on Linux, the scheduler state and wait
+//     channel of its thread from /proc
+//   - its action runs, once per stall, on the watchdog thread: log only
+//     (no action), reset a connection (e.g. ChBoostInStreamer::Interrupt,
+//     which wakes up a blocked receive), or fail safe (e.g. zero the
+//     throttle sent to the motion platform)
+// A stalled loop which beats again is reported as recovered, with the
+// length of the stall.
+//
+// Beat, SetState and Activity are lock-free and may be called from any
+// thread; register the loops before Start. Actions must not block.
+//
+// =============================================================================
+
+#ifndef CH_WATCHDOG_H
+#define CH_WATCHDOG_H
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "../ChApiHil.h"
+
+namespace chrono {
+namespace hil {
+
+#define HIL_WATCHDOG_PERIOD 1e-3 // time between checks [s]
+
+/// State of a loop found stalled, handed to its action
+struct ChWatchdogStall {
+  int loop;
+  std::string name;
+  double stalled;      // time since the last beat [s]
+  double threshold;    // [s]
+  uint64_t beats;      // beats so far
+  double max_interval; // longest interval between two beats [s]
+  std::string state;   // as set by the loop, empty if never set
+  double activity;     // time since the last activity [s], -1 if none
+  std::string thread;  // scheduler state of the thread, empty if unknown
+};
+
+class CH_HIL_API ChWatchdog {
+public:
+  /// Runs on the watchdog thread when a loop stalls
+  typedef std::function<void(const ChWatchdogStall &stall)> Action;
+
+  /// Check the loops every period [s]
+  ChWatchdog(double period = HIL_WATCHDOG_PERIOD);
+  ~ChWatchdog();
+
+  /// Watch a loop which beats at least every threshold [s]; action (log
+  /// only if empty) runs when it stalls. Returns the index of the loop.
+  int Watch(const std::string &name, double threshold, Action action = {});
+
+  /// Heartbeat of loop, from the thread running it
+  void Beat(int loop);
+
+  /// What loop is doing, dumped if it stalls; state must be a string
+  /// literal, e.g. "receive"
+  void SetState(int loop, const char *state) {
+    m_loops[loop].state.store(state, std::memory_order_relaxed);
+  }
+
+  /// Mark the last activity of loop, e.g. a datagram received
+  void Activity(int loop);
+
+  /// Start and stop the watchdog thread; the loops are on time at Start
+  void Start();
+  void Stop();
+
+  /// Thread of the watchdog, to give it a real-time placement
+  std::thread &GetThread() { return m_thread; }
+
+  /// Print the stalls and recoveries (default)
+  void SetPrint(bool print) { m_print = print; }
+
+  int GetNumLoops() const { return static_cast<int>(m_loops.size()); }
+  const std::string &GetName(int loop) const { return m_loops[loop].name; }
+
+  /// Loop is stalled now
+  bool IsStalled(int loop) const { return m_loops[loop].stalled; }
+
+  /// Stalls of loop so far
+  uint64_t GetNumStalls(int loop) const { return m_loops[loop].stalls; }
+
+  /// Longest stall of loop which ended, from its last beat [s]
+  double GetMaxStall(int loop) const { return m_loops[loop].max_stall; }
+
+  /// Dump of loop as if it stalled now
+  ChWatchdogStall GetState(int loop) const;
+
+private:
+  struct Loop {
+    std::string name;
+    double threshold;
+    Action action;
+
+    // written by the loop
+    std::atomic<double> last_beat{0.0};
+    std::atomic<uint64_t> beats{0};
+    std::atomic<double> max_interval{0.0};
+    std::atomic<const char *> state{nullptr};
+    std::atomic<double> activity{-1.0};
+    std::atomic<long> tid{0};
+
+    // written by the watchdog thread
+    std::atomic<bool> stalled{false};
+    std::atomic<uint64_t> stalls{0};
+    std::atomic<double> max_stall{0.0};
+    double stalled_beat = 0.0; // last beat before the stall
+  };
+
+  void Run();
+  void Check(int loop, double now);
+
+  /// Scheduler state and wait channel of thread tid, from /proc
+  static std::string GetThreadState(long tid);
+
+  double m_period;
+  bool m_print = true;
+  std::deque<Loop> m_loops; // stable addresses
+
+  std::thread m_thread;
+  std::mutex m_mutex;
+  std::condition_variable m_cv;
+  bool m_stop = false;
+};
+
+} // namespace hil
+} // namespace chrono
+
+#endif
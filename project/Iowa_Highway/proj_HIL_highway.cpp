@@ -44,9 +44,12 @@
 
 #include "chrono_hil/driver/ChCSLDriver.h"
 #include "chrono_hil/driver/ChNSF_Drivers.h"
+#include "chrono_hil/pipeline/ChRenderMirror.h"
+#include "chrono_hil/pipeline/ChRenderPipeline.h"
 #include "chrono_hil/timer/ChRealtimeCumulative.h"
 #include "chrono_vehicle/wheeled_vehicle/vehicle/WheeledVehicle.h"
 
+#include "chrono/physics/ChSystemSMC.h"
 #include "chrono/utils/ChFilters.h"
 #include "chrono/utils/ChUtilsInputOutput.h"
 
@@ -287,6 +290,19 @@ irr::video::ITexture *texture_AUTO;
 irr::video::ITexture *texture_COLON;
 irr::video::ITexture *texture_NUMERICAL[10];
 
+// dashboard values, computed by DashUpdate and drawn by IrrDashDraw
+struct DashState {
+  int gear = 0;
+  double speed_mph = 0.0;
+  double engine_rpm = 0.0;
+  bool autonomous = false;
+  bool started = false; // the IG vehicle started driving
+  int end_h = 0;
+  int end_m = 0;
+  int end_s = 0;
+  int sec_remaining = 0;
+};
+
 // =============================================================================
 
 // button callback placeholder
@@ -304,14 +320,16 @@ void AddBuildings(ChSystem *chsystem);
 
 // load textures for dashboard
 void IrrDashLoadTextures(ChWheeledVehicleVisualSystemIrrlicht &app);
-// update irrlicht dashboard inside simulation loop
-void IrrDashUpdate(
-    double sim_time, int step_number,
-    std::chrono::time_point<std::chrono::high_resolution_clock> t0,
-    ChWheeledVehicleVisualSystemIrrlicht &app, ChWheeledVehicle &vehicle,
-    std::shared_ptr<chrono::vehicle::ChChassis> ego_chassis,
-    DriverMode driver_mode, float &IG_dist, ChVector<> &IG_prev_pos,
-    bool &IG_started_driving);
+// update the dashboard values inside simulation loop
+void DashUpdate(double sim_time, int step_number,
+                std::chrono::time_point<std::chrono::high_resolution_clock> t0,
+                ChWheeledVehicle &vehicle,
+                std::shared_ptr<chrono::vehicle::ChChassis> ego_chassis,
+                DriverMode driver_mode, float &IG_dist, ChVector<> &IG_prev_pos,
+                bool &IG_started_driving, DashState &dash);
+// draw the irrlicht dashboard
+void IrrDashDraw(ChWheeledVehicleVisualSystemIrrlicht &app,
+                 const DashState &dash);
 
 // helper function to update dummy vehicles
 void UpdateDummy(std::shared_ptr<ChBodyAuxRef> dummy_vehicle,
@@ -1036,49 +1054,12 @@ int main(int argc, char *argv[]) {
   // Create the driver system
   // ------------------------
 
-  // ChWheeledVehicleVisualSystemIrrlicht app(
-  //     &vehicle, L"  ", irr::core::dimension2d<irr::u32>(1360, 420));
-  ChWheeledVehicleVisualSystemIrrlicht app;
-  app.SetWindowTitle("proj_HIL_highway");
-  app.SetWindowSize(1360, 420);
-  app.Initialize();
-  app.AttachVehicle(&vehicle);
-  /*
-  SPEEDOMETER: we want to use the irrlicht app to display the speedometer, but
-  calling endscene would update the entire (massive) scenario. In order to do
-  so, we first have to clean app the Irrlichr app. Once we delete the node, we
-  remove all cached meshes and textures. The order is important, otherwise
-  meshes are re-cached!!
-  */
-  // irr::scene::ISceneNode *mnode = app.GetContainer();
-  // mnode->remove();
-  irr::scene::IMeshCache *cache =
-      app.GetDevice()->getSceneManager()->getMeshCache();
-  cache->clear();
-  app.GetVideoDriver()->removeAllTextures();
 #ifdef CHRONO_IRRKLANG
   GetLog() << "USING IRRKLANG"
            << "\n\n";
   ChCSLSoundEngine soundEng(&vehicle);
 #endif
 
-  // Create the interactive driver system
-  // ChCSLDriver driver(vehicle);
-  // driver = chrono_types::make_shared<ChCSLDriver>(vehicle);
-  auto IGdriver = chrono_types::make_shared<ChInteractiveDriverIRR>(app);
-  IGdriver->SetButtonCallback(r_1, &CustomButtonCallback);
-  IGdriver->SetButtonCallback(r_3, &DummyButtonCallback_r_3);
-
-  if (keyboard_control) {
-    IGdriver->SetInputMode(ChInteractiveDriverIRR::InputMode::KEYBOARD);
-  } else {
-    IGdriver->SetInputMode(ChInteractiveDriverIRR::InputMode::JOYSTICK);
-    std::cout << "joystick config: " << joystick_filename << std::endl;
-    IGdriver->SetJoystickConfigFile(joystick_filename);
-  }
-
-  IGdriver->Initialize();
-
   std::string steering_controller_file_IG =
       demo_data_path + "/Environments/Iowa/Driver/SteeringController_IG.json";
   std::string steering_controller_file_IG_nl =
@@ -1177,68 +1158,133 @@ int main(int argc, char *argv[]) {
   int render_frame = 0;
   double sim_time = 0;
 
-  // ---------------------------------------------
-  // Create a sensor manager and add a point light
-  // ---------------------------------------------
-  auto manager =
-      chrono_types::make_shared<ChSensorManager>(vehicle.GetSystem());
-  float intensity = 2.0;
-  manager->scene->AddPointLight({0, 0, 1e8}, {intensity, intensity, intensity},
-                                1e12);
-  manager->scene->SetAmbientLight({.1, .1, .1});
-  manager->scene->SetSceneEpsilon(1e-3);
-  manager->scene->EnableDynamicOrigin(true);
-  manager->scene->SetOriginOffsetThreshold(500.f);
-
-  // Set environment map
-  Background b;
-  b.mode = BackgroundMode::ENVIRONMENT_MAP;
-  b.env_tex = GetChronoDataFile("sensor/textures/sunflowers_4k.hdr");
-  manager->scene->SetBackground(b);
-  if (fog_enabled) {
-    manager->scene->SetFogScatteringFromDistance(fog_distance);
-    manager->scene->SetFogColor(fog_color);
+  // ------------------------------------------------------------------------
+  // The dashboard window and the wheel stay on the physics thread, polled at
+  // every step. The sensors run on a render thread one frame behind the
+  // dynamics, on a mirror of the bodies (the dummies and lead vehicles
+  // included) in their own system
+  // ------------------------------------------------------------------------
+  ChWheeledVehicleVisualSystemIrrlicht app;
+  app.SetWindowTitle("proj_HIL_highway");
+  app.SetWindowSize(1360, 420);
+  app.Initialize();
+  app.AttachVehicle(&vehicle);
+  /*
+  SPEEDOMETER: we want to use the irrlicht app to display the speedometer,
+  but calling endscene would update the entire (massive) scenario. In order
+  to do so, we first have to clean app the Irrlichr app. Once we delete the
+  node, we remove all cached meshes and textures. The order is important,
+  otherwise meshes are re-cached!!
+  */
+  // irr::scene::ISceneNode *mnode = app.GetContainer();
+  // mnode->remove();
+  irr::scene::IMeshCache *cache =
+      app.GetDevice()->getSceneManager()->getMeshCache();
+  cache->clear();
+  app.GetVideoDriver()->removeAllTextures();
+
+  // Create the interactive driver system
+  // ChCSLDriver driver(vehicle);
+  // driver = chrono_types::make_shared<ChCSLDriver>(vehicle);
+  auto IGdriver = chrono_types::make_shared<ChInteractiveDriverIRR>(app);
+  IGdriver->SetButtonCallback(r_1, &CustomButtonCallback);
+  IGdriver->SetButtonCallback(r_3, &DummyButtonCallback_r_3);
+
+  if (keyboard_control) {
+    IGdriver->SetInputMode(ChInteractiveDriverIRR::InputMode::KEYBOARD);
+  } else {
+    IGdriver->SetInputMode(ChInteractiveDriverIRR::InputMode::JOYSTICK);
+    std::cout << "joystick config: " << joystick_filename << std::endl;
+    IGdriver->SetJoystickConfigFile(joystick_filename);
   }
 
-  // ------------------------------------------------
-  // Create a camera and add it to the sensor manager
-  // ------------------------------------------------
-
-  auto cam = chrono_types::make_shared<ChCameraSensor>(
-      vehicle.GetChassisBody(), // body camera is attached to
-      10,                       // update rate in Hz
-      chrono::ChFrame<double>(
-          {0, 0, 3000}, Q_from_AngAxis(CH_C_PI_2, {0, 1, 0})), // offset pose
-      1920,                                                    // image width
-      1080,                                                    // image height
-      CH_C_PI_4,
-      super_samples); // fov, lag, exposure
-  cam->SetName("Camera Sensor");
-  if (sensor_vis)
-    // cam->PushFilter(chrono_types::make_shared<ChFilterVisualize>(1280, 720));
+  IGdriver->Initialize();
+
+  IrrDashLoadTextures(app);
+
+  ChSystemSMC render_system;
+  ChRenderPipeline pipeline;
+  ChRenderMirror mirror(pipeline, &render_system);
+  mirror.AddSystem(vehicle.GetSystem());
+  auto chassis_mirror = mirror.AddBody(vehicle.GetChassisBody());
+
+  std::shared_ptr<ChSensorManager> manager;
+
+  // the GL contexts of the sensors belong to the render thread
+  pipeline.SetInit([&]() {
+    // ---------------------------------------------
+    // Create a sensor manager and add a point light
+    // ---------------------------------------------
+    manager = chrono_types::make_shared<ChSensorManager>(&render_system);
+    float intensity = 2.0;
+    manager->scene->AddPointLight({0, 0, 1e8},
+                                  {intensity, intensity, intensity}, 1e12);
+    manager->scene->SetAmbientLight({.1, .1, .1});
+    manager->scene->SetSceneEpsilon(1e-3);
+    manager->scene->EnableDynamicOrigin(true);
+    manager->scene->SetOriginOffsetThreshold(500.f);
+
+    // Set environment map
+    Background b;
+    b.mode = BackgroundMode::ENVIRONMENT_MAP;
+    b.env_tex = GetChronoDataFile("sensor/textures/sunflowers_4k.hdr");
+    manager->scene->SetBackground(b);
+    if (fog_enabled) {
+      manager->scene->SetFogScatteringFromDistance(fog_distance);
+      manager->scene->SetFogColor(fog_color);
+    }
+
+    // ------------------------------------------------
+    // Create a camera and add it to the sensor manager
+    // ------------------------------------------------
+
+    auto cam = chrono_types::make_shared<ChCameraSensor>(
+        chassis_mirror, // body camera is attached to
+        10,             // update rate in Hz
+        chrono::ChFrame<double>({0, 0, 3000},
+                                Q_from_AngAxis(CH_C_PI_2, {0, 1, 0})), // pose
+        1920, // image width
+        1080, // image height
+        CH_C_PI_4,
+        super_samples); // fov, lag, exposure
+    cam->SetName("Camera Sensor");
+    if (sensor_vis)
+      // cam->PushFilter(
+      //     chrono_types::make_shared<ChFilterVisualize>(1280, 720));
+
+      // add sensor to the manager
+      if (cli.GetAsType<bool>("birdseye"))
+        manager->AddSensor(cam);
+
+    // -------------------------------------------------------
+    // Create a second camera and add it to the sensor manager
+    // -------------------------------------------------------
+    auto cam2 = chrono_types::make_shared<ChCameraSensor>(
+        chassis_mirror, // body camera is attached to
+        frame_rate,     // update rate in Hz
+        chrono::ChFrame<double>(driver_eye,
+                                driver_view_direction), // offset pose
+        image_width,                                    // image width
+        image_height,                                   // image height
+        cam_fov,
+        super_samples); // fov, lag, exposure
+    cam2->SetName("Camera Sensor");
+    if (sensor_vis)
+      cam2->PushFilter(chrono_types::make_shared<ChFilterVisualize>(
+          image_width, image_height, "Driver View", use_fullscreen));
 
     // add sensor to the manager
-    if (cli.GetAsType<bool>("birdseye"))
-      manager->AddSensor(cam);
-
-  // -------------------------------------------------------
-  // Create a second camera and add it to the sensor manager
-  // -------------------------------------------------------
-  auto cam2 = chrono_types::make_shared<ChCameraSensor>(
-      vehicle.GetChassisBody(), // body camera is attached to
-      frame_rate,               // update rate in Hz
-      chrono::ChFrame<double>(driver_eye, driver_view_direction), // offset pose
-      image_width,                                                // image width
-      image_height, // image height
-      cam_fov,
-      super_samples); // fov, lag, exposure
-  cam2->SetName("Camera Sensor");
-  if (sensor_vis)
-    cam2->PushFilter(chrono_types::make_shared<ChFilterVisualize>(
-        image_width, image_height, "Driver View", use_fullscreen));
-
-  // add sensor to the manager
-  manager->AddSensor(cam2);
+    manager->AddSensor(cam2);
+  });
+
+  pipeline.AddConsumer(
+      [&](const ChPoseSnapshot &snapshot) { mirror.Apply(snapshot); });
+  pipeline.AddConsumer([&](const ChPoseSnapshot &snapshot) {
+    if (render)
+      manager->Update();
+  });
+  pipeline.SetExit([&]() { manager.reset(); });
+  pipeline.Start();
 
   // ---------------
   // Simulate system
@@ -1255,10 +1301,10 @@ int main(int argc, char *argv[]) {
   auto t0 = high_resolution_clock::now();
   ChRealtimeCumulative realtime_timer;
 
-  IrrDashLoadTextures(app);
-
   vehicle.EnableRealtime(false);
 
+  DashState dash;
+
   while (app.GetDevice()->run()) {
     sim_time = vehicle.GetSystem()->GetChTime();
 
@@ -1311,7 +1357,6 @@ int main(int argc, char *argv[]) {
     terrain.Synchronize(sim_time);
     vehicle.Synchronize(sim_time, driver_inputs, terrain);
 
-    app.Synchronize(sim_time, driver_inputs);
 #ifdef CHRONO_IRRKLANG
     soundEng.Synchronize(sim_time);
 #endif
@@ -1326,8 +1371,6 @@ int main(int argc, char *argv[]) {
     terrain.Advance(step);
     vehicle.Advance(step);
 
-    app.Advance(step_size);
-
     auto t2 = high_resolution_clock::now();
     float wall_time = duration_cast<duration<double>>(t2 - t0).count();
 
@@ -1459,14 +1502,13 @@ int main(int argc, char *argv[]) {
     }
 
     if (step_number % 20 == 0) {
-      IrrDashUpdate(sim_time, step_number, t0, app, vehicle, ego_chassis,
-                    driver_mode, IG_dist, IG_prev_pos, IG_started_driving);
+      DashUpdate(sim_time, step_number, t0, vehicle, ego_chassis, driver_mode,
+                 IG_dist, IG_prev_pos, IG_started_driving, dash);
+      IrrDashDraw(app, dash);
     }
 
-    // Update the sensor manager
-    if (render) {
-      manager->Update();
-    }
+    // Hand the poses to the sensor manager
+    pipeline.Publish(vehicle.GetSystem()->GetChTime());
 
     if (step_number == 0) {
       if (enable_realtime) {
@@ -1498,20 +1540,20 @@ int main(int argc, char *argv[]) {
         buffer << ",";
         buffer << std::to_string(sim_time) + ",";
         buffer << std::to_string(wall_time) << ",";
-        ChDriver *currDriver;
+        DriverInputs currInputs;
         bool isManual;
         if (driver_mode == HUMAN) {
-          currDriver = IGdriver.get();
+          currInputs = driver_inputs;
           isManual = true;
         } else {
-          currDriver = PFdriver.get();
+          currInputs = PFdriver->GetInputs();
           isManual = false;
         }
 
         buffer << isManual << ",";
-        buffer << currDriver->GetSteering() << ",";
-        buffer << currDriver->GetThrottle() << ",";
-        buffer << currDriver->GetBraking() << ",";
+        buffer << currInputs.m_steering << ",";
+        buffer << currInputs.m_throttle << ",";
+        buffer << currInputs.m_braking << ",";
         buffer << ego_chassis->GetPos().x() << ",";
         buffer << ego_chassis->GetPos().y() << ",";
         buffer << ego_chassis->GetSpeed() * MS_TO_MPH << ",";
@@ -1595,6 +1637,7 @@ int main(int argc, char *argv[]) {
       }
     }
   }
+  pipeline.Stop();
 
   if (save_driver) {
     printf("Writing to output file...=%i", buffer.tellp());
@@ -2089,22 +2132,78 @@ void IrrDashLoadTextures(ChWheeledVehicleVisualSystemIrrlicht &app) {
       (demo_data_path + "/miscellaneous/numerical/9.png").c_str());
 }
 
-void IrrDashUpdate(
-    double sim_time, int step_number,
-    std::chrono::time_point<std::chrono::high_resolution_clock> t0,
-    ChWheeledVehicleVisualSystemIrrlicht &app, ChWheeledVehicle &vehicle,
-    std::shared_ptr<chrono::vehicle::ChChassis> ego_chassis,
-    DriverMode driver_mode, float &IG_dist, ChVector<> &IG_prev_pos,
-    bool &IG_started_driving) {
+void DashUpdate(double sim_time, int step_number,
+                std::chrono::time_point<std::chrono::high_resolution_clock> t0,
+                ChWheeledVehicle &vehicle,
+                std::shared_ptr<chrono::vehicle::ChChassis> ego_chassis,
+                DriverMode driver_mode, float &IG_dist, ChVector<> &IG_prev_pos,
+                bool &IG_started_driving, DashState &dash) {
+  dash.gear = vehicle.GetTransmission()->GetCurrentGear();
+  dash.speed_mph = vehicle.GetSpeed() * MS_TO_MPH;
+  dash.engine_rpm = vehicle.GetEngine()->GetMotorSpeed() * rads2rpm;
+  dash.autonomous = driver_mode == AUTONOMOUS;
+
+  if (vehicle.GetSpeed() >= 0.5 && IG_started_driving == false) {
+    start_sim_time = sim_time;
+    auto t1_temp = high_resolution_clock::now();
+    start_wall_time += duration_cast<duration<double>>(t1_temp - t0).count();
+
+    time_t curr_time = time(NULL);
+    struct tm *tmp = localtime(&curr_time);
+
+    dash.end_s = tmp->tm_sec;
+    dash.end_m = tmp->tm_min + meet_time;
+    dash.end_h = tmp->tm_hour;
+
+    if (dash.end_s >= 60) {
+      dash.end_s = dash.end_s - 60;
+      dash.end_m = dash.end_m + 1;
+    }
+    if (dash.end_m >= 60) {
+      dash.end_m = dash.end_m - 60;
+      dash.end_h = dash.end_h + 1;
+    }
+    if (dash.end_h >= 23) {
+      dash.end_h = dash.end_h % 24;
+    }
+
+    IG_started_driving = true;
+  }
+
+  dash.started = IG_started_driving;
+
+  // compute the ETA
+  if (step_number == 0) {
+    IG_prev_pos = ego_chassis->GetPos();
+  }
+
+  IG_dist = IG_dist + (ego_chassis->GetPos() - IG_prev_pos).Length();
+  IG_prev_pos = ego_chassis->GetPos();
+
+  if (step_number % 50 == 0) {
+    float remaining = eta_dist * MILE_TO_M - IG_dist;
+    float avg_speed = IG_speed_avg.Add(ego_chassis->GetSpeed());
+    dash.sec_remaining = remaining / avg_speed;
+  }
+
+  // panic algorithm
+  // if below 0, set to 0
+  // if above max, set to 0
+
+  if (dash.sec_remaining < 0 || dash.sec_remaining > 356518) {
+    dash.sec_remaining = 0;
+  }
+}
+
+void IrrDashDraw(ChWheeledVehicleVisualSystemIrrlicht &app,
+                 const DashState &dash) {
   app.GetDevice()->getVideoDriver()->beginScene();
   /// irrlicht::tools::drawSegment(app.GetVideoDriver(), v1, v2,
   /// video::SColor(255, 80, 0, 0), false);
   app.GetDevice()->getVideoDriver()->draw2DImage(
       texture_DASH, irr::core::position2d<irr::s32>(0, 0));
 
-  int curr_gear = vehicle.GetTransmission()->GetCurrentGear();
-
-  switch (curr_gear) {
+  switch (dash.gear) {
   case 1:
     app.GetDevice()->getVideoDriver()->draw2DImage(texture_GEAR1, gr_center);
     break;
@@ -2133,21 +2232,19 @@ void IrrDashUpdate(
     break;
   }
 
-  double speed_mph = vehicle.GetSpeed() * MS_TO_MPH;
-  double theta = ((265 / 130) * speed_mph) * (CH_C_PI / 180);
+  double theta = ((265 / 130) * dash.speed_mph) * (CH_C_PI / 180);
   app.GetDevice()->getVideoDriver()->draw2DLine(
       sm_center + irr::core::position2d<irr::s32>(-sm_needle * sin(theta),
                                                   sm_needle * cos(theta)),
       sm_center, irr::video::SColor(255, 255, 0, 0));
 
-  double engine_rpm = vehicle.GetEngine()->GetMotorSpeed() * rads2rpm;
-  double alpha = ((265.0 / 6500.0) * engine_rpm) * (CH_C_PI / 180);
+  double alpha = ((265.0 / 6500.0) * dash.engine_rpm) * (CH_C_PI / 180);
   app.GetDevice()->getVideoDriver()->draw2DLine(
       rpm_center + irr::core::position2d<irr::s32>(-sm_needle * sin(alpha),
                                                    sm_needle * cos(alpha)),
       rpm_center, irr::video::SColor(255, 255, 0, 0));
 
-  if (driver_mode == AUTONOMOUS) {
+  if (dash.autonomous) {
     app.GetDevice()->getVideoDriver()->draw2DImage(texture_AUTO, auto_center);
   }
 
@@ -2192,49 +2289,14 @@ void IrrDashUpdate(
     }
   }
 
-  static int end_s;
-  static int end_m;
-  static int end_h;
-
-  if (vehicle.GetSpeed() >= 0.5 && IG_started_driving == false) {
-    start_sim_time = sim_time;
-    auto t1_temp = high_resolution_clock::now();
-    start_wall_time += duration_cast<duration<double>>(t1_temp - t0).count();
-
-    time_t curr_time = time(NULL);
-    struct tm *tmp = localtime(&curr_time);
-
-    int temp_h = tmp->tm_hour;
-    int temp_m = tmp->tm_min;
-    int temp_s = tmp->tm_sec;
-
-    end_s = s;
-    end_m = m + meet_time;
-    end_h = h;
-
-    if (end_s >= 60) {
-      end_s = end_s - 60;
-      end_m = end_m + 1;
-    }
-    if (end_m >= 60) {
-      end_m = end_m - 60;
-      end_h = end_h + 1;
-    }
-    if (end_h >= 23) {
-      end_h = end_h % 24;
-    }
-
-    IG_started_driving = true;
-  }
-
-  if (IG_started_driving == true) {
+  if (dash.started) {
     std::vector<int> display_end_int;
-    display_end_int.push_back(end_h / 10);
-    display_end_int.push_back(end_h % 10);
-    display_end_int.push_back(end_m / 10);
-    display_end_int.push_back(end_m % 10);
-    display_end_int.push_back(end_s / 10);
-    display_end_int.push_back(end_s % 10);
+    display_end_int.push_back(dash.end_h / 10);
+    display_end_int.push_back(dash.end_h % 10);
+    display_end_int.push_back(dash.end_m / 10);
+    display_end_int.push_back(dash.end_m % 10);
+    display_end_int.push_back(dash.end_s / 10);
+    display_end_int.push_back(dash.end_s % 10);
 
     for (int i = 0; i < display_end_int.size() + 2; i++) {
       irr::core::position2d<irr::s32> offset(50, 0);
@@ -2262,34 +2324,10 @@ void IrrDashUpdate(
     }
   }
 
-  // compute and display ETA
-
-  static int sec_remaining = 0;
-
-  if (step_number == 0) {
-    IG_prev_pos = ego_chassis->GetPos();
-  }
-
-  IG_dist = IG_dist + (ego_chassis->GetPos() - IG_prev_pos).Length();
-  IG_prev_pos = ego_chassis->GetPos();
-
-  if (step_number % 50 == 0) {
-    float remaining = eta_dist * MILE_TO_M - IG_dist;
-    float avg_speed = IG_speed_avg.Add(ego_chassis->GetSpeed());
-    sec_remaining = remaining / avg_speed;
-  }
-
-  // panic algorithm
-  // if below 0, set to 0
-  // if above max, set to 0
-
-  if (sec_remaining < 0 || sec_remaining > 356518) {
-    sec_remaining = 0;
-  }
-
-  int eta_h = sec_remaining / 3600;
-  int eta_m = (sec_remaining % 3600) / 60;
-  int eta_s = sec_remaining % 60;
+  // display ETA
+  int eta_h = dash.sec_remaining / 3600;
+  int eta_m = (dash.sec_remaining % 3600) / 60;
+  int eta_s = dash.sec_remaining % 60;
 
   std::vector<int> display_eta_int;
   display_eta_int.push_back(eta_h / 10);
@@ -20,7 +20,11 @@
 
 #include "chrono_vehicle/driver/ChPathFollowerDriver.h"
 
-#include "chrono_hil/timer/ChRealtimeCumulative.h"
+#include "chrono_hil/timer/ChFrameGovernor.h"
+#include "chrono_hil/timer/ChRunMode.h"
+#include "chrono_hil/timer/ChTaskScheduler.h"
+#include "chrono_hil/timer/ChThreadPlacement.h"
+#include "chrono_hil/timer/ChWatchdog.h"
 
 #include "chrono_vehicle/ChConfigVehicle.h"
 #include "chrono_vehicle/ChVehicleModelData.h"
@@ -117,6 +121,20 @@ int main(int argc, char *argv[]) {
   std::cout << "id:" << node_id << std::endl;
   std::cout << "num:" << num_nodes << std::endl;
 
+  // cores and real-time class of the main loop, from the runtime profile
+  ChThreadPlacement placement;
+  const std::string rt_profile = cli.GetAsType<std::string>("rt_profile");
+  if (!rt_profile.empty())
+    placement.Load(rt_profile);
+
+  // real time in the simulator, or a faster headless batch run on
+  // scripted inputs
+  ChRunMode run_mode;
+  if (!run_mode.Parse(cli.GetAsType<std::string>("run_mode")))
+    return 1;
+  run_mode.SetInputFile(cli.GetAsType<std::string>("inputs"));
+  const double watchdog_threshold = 1e-3 * cli.GetAsType<int>("watchdog");
+
   // =============================================================================
 
   // -----------------------
@@ -230,22 +248,53 @@ int main(int argc, char *argv[]) {
   // ------------------------
   ChVector<> trackPoint(0.0, 0.0, 1.75);
   int render_step = 20;
-  auto vis = chrono_types::make_shared<ChWheeledVehicleVisualSystemIrrlicht>();
-  vis->SetWindowTitle("NADS");
-  vis->SetChaseCamera(trackPoint, 6.0, 0.5);
-  vis->Initialize();
-  vis->AddLightDirectional();
-  vis->AddSkyBox();
-  vis->AddLogo();
-  vis->AttachVehicle(&my_vehicle);
+  std::shared_ptr<ChWheeledVehicleVisualSystemIrrlicht> vis;
+  if (!run_mode.IsHeadless()) {
+    vis = chrono_types::make_shared<ChWheeledVehicleVisualSystemIrrlicht>();
+    vis->SetWindowTitle("NADS");
+    vis->SetChaseCamera(trackPoint, 6.0, 0.5);
+    vis->Initialize();
+    vis->AddLightDirectional();
+    vis->AddSkyBox();
+    vis->AddLogo();
+    vis->AttachVehicle(&my_vehicle);
+  }
 
   // ------------------------
   // Create the driver system
   // ------------------------
 
-  ChBoostInStreamer in_streamer(PORT_IN, 4);
+  // throttle, steering, braking and gear, from the simulator cab or from
+  // the input file
+  std::unique_ptr<ChBoostInStreamer> in_streamer;
+  std::unique_ptr<ChDataDriver> data_driver;
+  if (run_mode.IsInteractive()) {
+    in_streamer = chrono_types::make_unique<ChBoostInStreamer>(PORT_IN, 4);
+  } else {
+    data_driver = chrono_types::make_unique<ChDataDriver>(
+        my_vehicle, run_mode.GetInputFile());
+    data_driver->Initialize();
+  }
   std::vector<float> recv_data;
 
+  // stalls of the main loop are dumped; a cab which stops sending gets its
+  // receive interrupted, and the vehicle is braked to a stop until the cab
+  // is back
+  std::atomic<bool> input_lost(false);
+  ChWatchdog watchdog;
+  int main_watch = -1;
+  int input_watch = -1;
+  if (watchdog_threshold > 0.0) {
+    main_watch = watchdog.Watch("main loop", watchdog_threshold);
+    if (in_streamer) {
+      input_watch = watchdog.Watch("cab input", watchdog_threshold,
+                                   [&](const ChWatchdogStall &stall) {
+                                     input_lost = true;
+                                     in_streamer->Interrupt();
+                                   });
+    }
+  }
+
   // ---------------
   // Simulation loop
   // ---------------
@@ -257,11 +306,6 @@ int main(int argc, char *argv[]) {
 
   my_vehicle.EnableRealtime(false);
 
-  ChRealtimeCumulative realtime_timer;
-  std::chrono::high_resolution_clock::time_point start =
-      std::chrono::high_resolution_clock::now();
-  double last_time = 0;
-
   // create boost data streaming interface
   ChBoostOutStreamer boost_streamer(IP_OUT, PORT_OUT);
   ChBoostOutStreamer boost_traffic_streamer(IP_OUT_2, PORT_OUT_2);
@@ -292,12 +336,295 @@ int main(int argc, char *argv[]) {
   ChRunningAverage lr_wheel_vel(100);
   ChRunningAverage rr_wheel_vel(100);
 
+  // chassis state of the frame, streamed out by the tasks below
+  ChVector<> pos;
+  ChQuaternion<> rot;
+  DriverInputs driver_inputs;
+
+  // input, data streams and rendering run at their own rates, staggered
+  // over the frames so that they do not all land in the same one
+  ChTaskScheduler scheduler(step_size);
+  int input_task = scheduler.AddTask(
+      "input", 4 * step_size,
+      [&](double time) {
+        if (in_streamer) {
+          if (input_watch >= 0)
+            watchdog.SetState(input_watch, "receive");
+          // polled while the cab is lost, so that the loop goes on in real
+          // time on the fail safe until the first datagram is back
+          if ((!input_lost || in_streamer->Available() > 0) &&
+              in_streamer->Synchronize() == 0) {
+            recv_data = in_streamer->GetRecvData();
+            input_lost = false;
+          }
+          if (input_lost) {
+            // fail safe: no throttle, full brake, steering held; in park
+            // if the cab never sent anything
+            recv_data.resize(4, 0.0f);
+            recv_data[0] = 0.0f;
+            recv_data[2] = 1.0f;
+          }
+          if (input_watch >= 0) {
+            watchdog.SetState(input_watch, "idle");
+            // the stall of a lost cab lasts until it sends again
+            if (!input_lost) {
+              watchdog.Beat(input_watch);
+              watchdog.Activity(input_watch);
+            }
+          }
+        } else {
+          // in drive, as the cab reports it
+          data_driver->Synchronize(time);
+          const DriverInputs &inputs = data_driver->GetInputs();
+          recv_data = {(float)inputs.m_throttle, (float)inputs.m_steering,
+                       (float)inputs.m_braking, 1.0f};
+        }
+      },
+      2, 0.0);
+  // sampled once the frame is paced, right before the dynamics use it
+  scheduler.SetAfterWait(input_task);
+
+  scheduler.AddTask(
+      "stream", 4 * step_size,
+      [&](double time) {
+        // Time
+        boost_streamer.AddData((float)time); // 0 - time
+
+        // Chassis location
+        boost_streamer.AddData(pos.x() * M_2_FT);  // 1
+        boost_streamer.AddData(-pos.y() * M_2_FT); // 2
+        boost_streamer.AddData(-pos.z() * M_2_FT); // 3
+
+        // Eyepoint position
+        ChVector<> eyepoint_global =
+            my_vehicle.GetPointLocation(driver_eyepoint);
+
+        boost_streamer.AddData(-eyepoint_global.y() * M_2_FT); // 4
+        boost_streamer.AddData(eyepoint_global.x() * M_2_FT);  // 5
+        boost_streamer.AddData(eyepoint_global.z() * M_2_FT);  // 6
+
+        // Eyepoint orientation
+        auto eu_rot = Q_to_Euler123(rot);
+
+        boost_streamer.AddData(eu_rot.z() * RADS_2_DEG);  // 7 - yaw
+        boost_streamer.AddData(-eu_rot.y() * RADS_2_DEG); // 8 - pitch
+        boost_streamer.AddData(eu_rot.x() * RADS_2_DEG);  // 9 - roll
+
+        // Chassis angular velocity
+        auto ang_vel = my_vehicle.GetChassis()->GetBody()->GetWvel_loc();
+        auto ang_vel_x_filtered = ang_vel_x.Add(ang_vel.x());
+        auto ang_vel_y_filtered = ang_vel_y.Add(ang_vel.y());
+        auto ang_vel_z_filtered = ang_vel_z.Add(ang_vel.z());
+
+        boost_streamer.AddData(ang_vel_x_filtered * RADS_2_DEG);  // 10
+        boost_streamer.AddData(-ang_vel_y_filtered * RADS_2_DEG); // 11
+        boost_streamer.AddData(-ang_vel_z_filtered * RADS_2_DEG); // 12
+
+        // Chassis velocity
+        auto vel = my_vehicle.GetChassis()
+                       ->GetBody()
+                       ->GetFrame_REF_to_abs()
+                       .GetPos_dt();
+
+        boost_streamer.AddData(vel.x() * M_2_FT);  // 13
+        boost_streamer.AddData(-vel.y() * M_2_FT); // 14
+        boost_streamer.AddData(-vel.z() * M_2_FT); // 15
+
+        // Eyepoint velocity
+        ChVector<> eyepoint_velocity =
+            my_vehicle.GetPointVelocity(driver_eyepoint);
+        auto eyepoint_velocity_x_filtered =
+            eyepoint_vel_x.Add(-eyepoint_velocity.y());
+        auto eyepoint_velocity_y_filtered =
+            eyepoint_vel_y.Add(eyepoint_velocity.x());
+        auto eyepoint_velocity_z_filtered =
+            eyepoint_vel_z.Add(eyepoint_velocity.z());
+
+        boost_streamer.AddData(eyepoint_velocity_x_filtered * M_2_FT);  // 16
+        boost_streamer.AddData(-eyepoint_velocity_y_filtered * M_2_FT); // 17
+        boost_streamer.AddData(-eyepoint_velocity_z_filtered * M_2_FT); // 18
+
+        // Chassis local acceleration
+        auto acc_local = my_vehicle.GetPointAcceleration(
+            my_vehicle.GetChassis()->GetCOMFrame().GetPos());
+        auto acc_loc_x_filtered = acc_x.Add(acc_local.x());
+        auto acc_loc_y_filtered = acc_y.Add(-acc_local.y());
+        auto acc_loc_z_filtered = acc_z.Add(-acc_local.z());
+
+        boost_streamer.AddData(acc_loc_x_filtered * M_2_FT); // 19
+        boost_streamer.AddData(acc_loc_y_filtered * M_2_FT); // 20
+        boost_streamer.AddData(acc_loc_z_filtered * M_2_FT); // 21
+
+        // Eyepoint specific force
+        // rotation matrix A -> from local to global
+        auto A_REF_to_abs =
+            my_vehicle.GetChassis()->GetBody()->GetFrame_REF_to_abs().GetA();
+
+        // inverse rotation matrix invA -> from global to local
+        ChMatrix33<> inv_A_REF_to_abs = A_REF_to_abs.inverse();
+
+        // local gravity
+        auto local_g = inv_A_REF_to_abs * ChVector<>(0.0, 0.0, -9.81);
+
+        auto eye_acc_x_filtered =
+            eyepoint_acc_x.Add(acc_local.x() + local_g.x());
+        auto eye_acc_y_filtered =
+            eyepoint_acc_y.Add(-acc_local.y() + local_g.y());
+        auto eye_acc_z_filtered =
+            eyepoint_acc_z.Add(-acc_local.z() + local_g.z());
+
+        boost_streamer.AddData(eye_acc_x_filtered / G_2_MPSS); // 22
+        boost_streamer.AddData(eye_acc_y_filtered / G_2_MPSS); // 23
+        boost_streamer.AddData(eye_acc_z_filtered / G_2_MPSS); // 24
+
+        // wheel center locations
+        auto wheel_LF_state = my_vehicle.GetWheel(0, LEFT)->GetState();
+        auto wheel_RF_state = my_vehicle.GetWheel(0, RIGHT)->GetState();
+        auto wheel_LR_state = my_vehicle.GetWheel(1, LEFT)->GetState();
+        auto wheel_RR_state = my_vehicle.GetWheel(1, RIGHT)->GetState();
+
+        boost_streamer.AddData(
+            wheel_RF_state.pos.x()); // 25 - RF wheel center pos x - global
+        boost_streamer.AddData(
+            wheel_RF_state.pos.y()); // 26 - RF wheel center pos y - global
+        boost_streamer.AddData(
+            wheel_RF_state.pos.x()); // 27 - LF wheel center pos x - global
+        boost_streamer.AddData(
+            wheel_LF_state.pos.y()); // 28 - LF wheel center pos y - global
+        boost_streamer.AddData(
+            wheel_RR_state.pos.x()); // 29 - RR wheel center pos x - global
+        boost_streamer.AddData(
+            wheel_RR_state.pos.y()); // 30 - RR wheel center pos y - global
+        boost_streamer.AddData(
+            wheel_LR_state.pos.x()); // 31 - LR wheel center pos x - global
+        boost_streamer.AddData(
+            wheel_LR_state.pos.y()); // 32 - LR wheel center pos y - global
+
+        // wheel rotational velocity
+        auto lf_omega_filtered = lf_wheel_vel.Add(wheel_RF_state.omega);
+        auto rf_omega_filtered = rf_wheel_vel.Add(wheel_LF_state.omega);
+        auto lr_omega_filtered = lr_wheel_vel.Add(wheel_RR_state.omega);
+        auto rr_omega_filtered = rr_wheel_vel.Add(wheel_LR_state.omega);
+
+        boost_streamer.AddData(
+            lf_omega_filtered); // 33 - RF wheel rot vel - in rad/s
+        boost_streamer.AddData(
+            rf_omega_filtered); // 34 - LF wheel rot vel - in rad/s
+        boost_streamer.AddData(
+            lr_omega_filtered); // 35 - RR wheel rot vel - in rad/s
+        boost_streamer.AddData(
+            rr_omega_filtered); // 36 - LR wheel rot vel - in rad/s
+
+        boost_streamer.AddData(my_vehicle.GetTransmission()
+                                   ->GetCurrentGear()); // 37 - current gear
+
+        boost_streamer.AddData(
+            (float)(my_vehicle.GetSpeed() * MS_2_MPH)); // 38 - speed (m/s)
+
+        boost_streamer.AddData(my_vehicle.GetEngine()->GetMotorSpeed() *
+                               RADS_2_RPM); // 39 - current RPM
+
+        boost_streamer.AddData(
+            my_vehicle.GetEngine()
+                ->GetOutputMotorshaftTorque()); // 40 - Engine Torque - in N-m
+
+        // Send the data
+        boost_streamer.Synchronize();
+      },
+      1);
+
+  // the zombie and render rates are halved when the frames run out of time
+  ChFrameGovernor governor(step_size);
+
+  if (num_nodes > 1) {
+    scheduler.AddTask("traffic", 10 * step_size, [&](double time) {
+      int traf_id = 1;
+      for (std::map<int, std::shared_ptr<SynWheeledVehicleAgent>>::iterator
+               it = id_map.begin();
+           it != id_map.end(); ++it) {
+
+        ChronoVehicleInfo info;
+        info.vehicle_id = traf_id;
+        info.time_stamp = std::chrono::high_resolution_clock::now()
+                              .time_since_epoch()
+                              .count();
+
+        ChVector<double> chassis_pos = it->second->GetZombiePos();
+        ChVector<double> chassis_rot =
+            it->second->GetZombieRot().Q_to_Euler123();
+
+        // converting chassis
+        info.position[0] = chassis_pos.x() * M_2_FT;
+        info.position[1] = -chassis_pos.y() * M_2_FT;
+        info.position[2] = -chassis_pos.z() * M_2_FT;
+
+        info.orientation[0] = chassis_rot.x();
+        info.orientation[1] = -chassis_rot.y();
+        info.orientation[2] = -chassis_rot.z();
+
+        info.steering_angle =
+            driver_inputs.m_steering * double(30.0 / 180.0) * CH_C_PI * 2;
+        info.wheel_rotations[0] = 0.0;
+        info.wheel_rotations[1] = 0.0;
+        info.wheel_rotations[2] = 0.0;
+        info.wheel_rotations[3] = 0.0;
+
+        boost_traffic_streamer.AddVehicleStruct(info);
+        traf_id++;
+      }
+      boost_traffic_streamer.Synchronize();
+    });
+    governor.AddTaskKnob(scheduler, scheduler.GetNumTasks() - 1, 3, 0);
+  }
+
+  // rendering gives way to a frame already over budget
+  if (render == true && vis) {
+    scheduler.AddTask(
+        "render", render_step * step_size,
+        [&](double time) {
+          vis->BeginScene();
+          vis->Render();
+          vis->EndScene();
+          vis->Synchronize(time, driver_inputs);
+        },
+        -1);
+    governor.AddTaskKnob(scheduler, scheduler.GetNumTasks() - 1, 3, -1);
+  }
+  // a batch run keeps full quality, however long its frames take
+  if (run_mode.IsPaced())
+    scheduler.SetGovernor(&governor);
+
+  // paced as ChRealtimeCumulative did, catching up after a slow frame;
+  // scaled or not paced at all in a batch run
+  scheduler.SetRealtime(true, HIL_PACER_BURST);
+  run_mode.Apply(scheduler);
+
+  // deadlines of the paced frames only
+  double deadline =
+      run_mode.IsPaced() ? step_size / run_mode.GetFactor() : step_size;
+  // render is deferred once the dynamics and tasks of a frame took most
+  // of it
+  scheduler.SetBudget(0.8 * deadline);
+  ChRealtimeMonitor monitor(deadline);
+  if (run_mode.IsPaced()) {
+    scheduler.SetMonitor(&monitor);
+    monitor.SetPrint(0.5);
+  }
+
+  // the DDS and streamer threads started above keep the default placement
+  placement.LockMemory();
+  placement.Apply("physics");
+  if (watchdog_threshold > 0.0) {
+    watchdog.Start();
+    placement.Apply("watchdog", watchdog.GetThread());
+  }
+
   // simulation loop
-  while (vis->Run() && syn_manager.IsOk()) {
+  while ((!vis || vis->Run()) && syn_manager.IsOk()) {
     double time = my_vehicle.GetSystem()->GetChTime();
 
-    ChVector<> pos = my_vehicle.GetChassis()->GetPos();
-    ChQuaternion<> rot = my_vehicle.GetChassis()->GetRot();
+    pos = my_vehicle.GetChassis()->GetPos();
+    rot = my_vehicle.GetChassis()->GetRot();
 
     auto euler_rot = Q_to_Euler123(rot);
     euler_rot.x() = 0.0;
@@ -313,14 +640,14 @@ int main(int argc, char *argv[]) {
       break;
 #endif
 
-    // Get driver inputs
-    DriverInputs driver_inputs;
-
-    if (step_number % 4 == 0) {
-      in_streamer.Synchronize();
-      recv_data = in_streamer.GetRecvData();
-    }
+    // run the tasks due in this frame, wait for its end in real time, then
+    // take the cab inputs the dynamics below use
+    scheduler.Step(time);
+    run_mode.Update(time);
+    if (main_watch >= 0)
+      watchdog.Beat(main_watch);
 
+    // Get driver inputs
     driver_inputs.m_throttle = recv_data[0];
     driver_inputs.m_steering = recv_data[1];
     driver_inputs.m_braking = recv_data[2];
@@ -350,151 +677,6 @@ int main(int argc, char *argv[]) {
       gear_to_send = 0;
     }
 
-    // =======================
-    // data stream out section
-    // =======================
-    if (step_number % 4 == 0) {
-      // Time
-      boost_streamer.AddData((float)time); // 0 - time
-
-      // Chassis location
-      boost_streamer.AddData(pos.x() * M_2_FT);  // 1
-      boost_streamer.AddData(-pos.y() * M_2_FT); // 2
-      boost_streamer.AddData(-pos.z() * M_2_FT); // 3
-
-      // Eyepoint position
-      ChVector<> eyepoint_global = my_vehicle.GetPointLocation(driver_eyepoint);
-
-      boost_streamer.AddData(-eyepoint_global.y() * M_2_FT); // 4
-      boost_streamer.AddData(eyepoint_global.x() * M_2_FT);  // 5
-      boost_streamer.AddData(eyepoint_global.z() * M_2_FT);  // 6
-
-      // Eyepoint orientation
-      auto eu_rot = Q_to_Euler123(rot);
-
-      boost_streamer.AddData(eu_rot.z() * RADS_2_DEG);  // 7 - yaw
-      boost_streamer.AddData(-eu_rot.y() * RADS_2_DEG); // 8 - pitch
-      boost_streamer.AddData(eu_rot.x() * RADS_2_DEG);  // 9 - roll
-
-      // Chassis angular velocity
-      auto ang_vel = my_vehicle.GetChassis()->GetBody()->GetWvel_loc();
-      auto ang_vel_x_filtered = ang_vel_x.Add(ang_vel.x());
-      auto ang_vel_y_filtered = ang_vel_y.Add(ang_vel.y());
-      auto ang_vel_z_filtered = ang_vel_z.Add(ang_vel.z());
-
-      boost_streamer.AddData(ang_vel_x_filtered * RADS_2_DEG);  // 10
-      boost_streamer.AddData(-ang_vel_y_filtered * RADS_2_DEG); // 11
-      boost_streamer.AddData(-ang_vel_z_filtered * RADS_2_DEG); // 12
-
-      // Chassis velocity
-      auto vel =
-          my_vehicle.GetChassis()->GetBody()->GetFrame_REF_to_abs().GetPos_dt();
-
-      boost_streamer.AddData(vel.x() * M_2_FT);  // 13
-      boost_streamer.AddData(-vel.y() * M_2_FT); // 14
-      boost_streamer.AddData(-vel.z() * M_2_FT); // 15
-
-      // Eyepoint velocity
-      ChVector<> eyepoint_velocity =
-          my_vehicle.GetPointVelocity(driver_eyepoint);
-      auto eyepoint_velocity_x_filtered =
-          eyepoint_vel_x.Add(-eyepoint_velocity.y());
-      auto eyepoint_velocity_y_filtered =
-          eyepoint_vel_y.Add(eyepoint_velocity.x());
-      auto eyepoint_velocity_z_filtered =
-          eyepoint_vel_z.Add(eyepoint_velocity.z());
-
-      boost_streamer.AddData(eyepoint_velocity_x_filtered * M_2_FT);  // 16
-      boost_streamer.AddData(-eyepoint_velocity_y_filtered * M_2_FT); // 17
-      boost_streamer.AddData(-eyepoint_velocity_z_filtered * M_2_FT); // 18
-
-      // Chassis local acceleration
-      auto acc_local = my_vehicle.GetPointAcceleration(
-          my_vehicle.GetChassis()->GetCOMFrame().GetPos());
-      auto acc_loc_x_filtered = acc_x.Add(acc_local.x());
-      auto acc_loc_y_filtered = acc_y.Add(-acc_local.y());
-      auto acc_loc_z_filtered = acc_z.Add(-acc_local.z());
-
-      boost_streamer.AddData(acc_loc_x_filtered * M_2_FT); // 19
-      boost_streamer.AddData(acc_loc_y_filtered * M_2_FT); // 20
-      boost_streamer.AddData(acc_loc_z_filtered * M_2_FT); // 21
-
-      // Eyepoint specific force
-      // rotation matrix A -> from local to global
-      auto A_REF_to_abs =
-          my_vehicle.GetChassis()->GetBody()->GetFrame_REF_to_abs().GetA();
-
-      // inverse rotation matrix invA -> from global to local
-      ChMatrix33<> inv_A_REF_to_abs = A_REF_to_abs.inverse();
-
-      // local gravity
-      auto local_g = inv_A_REF_to_abs * ChVector<>(0.0, 0.0, -9.81);
-
-      auto eye_acc_x_filtered = eyepoint_acc_x.Add(acc_local.x() + local_g.x());
-      auto eye_acc_y_filtered =
-          eyepoint_acc_y.Add(-acc_local.y() + local_g.y());
-      auto eye_acc_z_filtered =
-          eyepoint_acc_z.Add(-acc_local.z() + local_g.z());
-
-      boost_streamer.AddData(eye_acc_x_filtered / G_2_MPSS); // 22
-      boost_streamer.AddData(eye_acc_y_filtered / G_2_MPSS); // 23
-      boost_streamer.AddData(eye_acc_z_filtered / G_2_MPSS); // 24
-
-      // wheel center locations
-      auto wheel_LF_state = my_vehicle.GetWheel(0, LEFT)->GetState();
-      auto wheel_RF_state = my_vehicle.GetWheel(0, RIGHT)->GetState();
-      auto wheel_LR_state = my_vehicle.GetWheel(1, LEFT)->GetState();
-      auto wheel_RR_state = my_vehicle.GetWheel(1, RIGHT)->GetState();
-
-      boost_streamer.AddData(
-          wheel_RF_state.pos.x()); // 25 - RF wheel center pos x - global
-      boost_streamer.AddData(
-          wheel_RF_state.pos.y()); // 26 - RF wheel center pos y - global
-      boost_streamer.AddData(
-          wheel_RF_state.pos.x()); // 27 - LF wheel center pos x - global
-      boost_streamer.AddData(
-          wheel_LF_state.pos.y()); // 28 - LF wheel center pos y - global
-      boost_streamer.AddData(
-          wheel_RR_state.pos.x()); // 29 - RR wheel center pos x - global
-      boost_streamer.AddData(
-          wheel_RR_state.pos.y()); // 30 - RR wheel center pos y - global
-      boost_streamer.AddData(
-          wheel_LR_state.pos.x()); // 31 - LR wheel center pos x - global
-      boost_streamer.AddData(
-          wheel_LR_state.pos.y()); // 32 - LR wheel center pos y - global
-
-      // wheel rotational velocity
-      auto lf_omega_filtered = lf_wheel_vel.Add(wheel_RF_state.omega);
-      auto rf_omega_filtered = rf_wheel_vel.Add(wheel_LF_state.omega);
-      auto lr_omega_filtered = lr_wheel_vel.Add(wheel_RR_state.omega);
-      auto rr_omega_filtered = rr_wheel_vel.Add(wheel_LR_state.omega);
-
-      boost_streamer.AddData(
-          lf_omega_filtered); // 33 - RF wheel rot vel - in rad/s
-      boost_streamer.AddData(
-          rf_omega_filtered); // 34 - LF wheel rot vel - in rad/s
-      boost_streamer.AddData(
-          lr_omega_filtered); // 35 - RR wheel rot vel - in rad/s
-      boost_streamer.AddData(
-          rr_omega_filtered); // 36 - LR wheel rot vel - in rad/s
-
-      boost_streamer.AddData(
-          my_vehicle.GetTransmission()->GetCurrentGear()); // 37 - current gear
-
-      boost_streamer.AddData(
-          (float)(my_vehicle.GetSpeed() * MS_2_MPH)); // 38 - speed (m/s)
-
-      boost_streamer.AddData(my_vehicle.GetEngine()->GetMotorSpeed() *
-                             RADS_2_RPM); // 39 - current RPM
-
-      boost_streamer.AddData(
-          my_vehicle.GetEngine()
-              ->GetOutputMotorshaftTorque()); // 40 - Engine Torque - in N-m
-
-      // Send the data
-      boost_streamer.Synchronize();
-    }
-
     if (step_number == 0) {
       zombie_map = syn_manager.GetZombies();
       std::cout << "zombie size: " << zombie_map.size() << std::endl;
@@ -510,51 +692,6 @@ int main(int argc, char *argv[]) {
       }
     }
 
-    // obtain map
-    if (num_nodes > 1) {
-      if (step_number % 10 == 0) {
-        int traf_id = 1;
-        for (std::map<int, std::shared_ptr<SynWheeledVehicleAgent>>::iterator
-                 it = id_map.begin();
-             it != id_map.end(); ++it) {
-
-          ChronoVehicleInfo info;
-          info.vehicle_id = traf_id;
-          info.time_stamp = std::chrono::high_resolution_clock::now()
-                                .time_since_epoch()
-                                .count();
-
-          ChVector<double> chassis_pos = it->second->GetZombiePos();
-          ChVector<double> chassis_rot =
-              it->second->GetZombieRot().Q_to_Euler123();
-
-          // converting chassis
-          info.position[0] = chassis_pos.x() * M_2_FT;
-          info.position[1] = -chassis_pos.y() * M_2_FT;
-          info.position[2] = -chassis_pos.z() * M_2_FT;
-
-          info.orientation[0] = chassis_rot.x();
-          info.orientation[1] = -chassis_rot.y();
-          info.orientation[2] = -chassis_rot.z();
-
-          info.steering_angle =
-              driver_inputs.m_steering * double(30.0 / 180.0) * CH_C_PI * 2;
-          info.wheel_rotations[0] = 0.0;
-          info.wheel_rotations[1] = 0.0;
-          info.wheel_rotations[2] = 0.0;
-          info.wheel_rotations[3] = 0.0;
-
-          boost_traffic_streamer.AddVehicleStruct(info);
-          traf_id++;
-        }
-        boost_traffic_streamer.Synchronize();
-      }
-    }
-
-    // =======================
-    // end data stream out section
-    // =======================
-
     // Update modules (process inputs from other modules)
     terrain.Synchronize(time);
     my_vehicle.Synchronize(time, driver_inputs, terrain);
@@ -563,39 +700,14 @@ int main(int argc, char *argv[]) {
     // Advance simulation for one timestep for all modules
     terrain.Advance(step_size);
     my_vehicle.Advance(step_size);
-    vis->Advance(step_size);
+    if (vis)
+      vis->Advance(step_size);
 
     // Increment frame number
     step_number++;
-
-    if (step_number == 0) {
-      realtime_timer.Reset();
-    }
-
-    if (step_number % 10 == 0) {
-      realtime_timer.Spin(time);
-    }
-
-    if (step_number % 500 == 0) {
-      std::chrono::high_resolution_clock::time_point end =
-          std::chrono::high_resolution_clock::now();
-      std::chrono::duration<double> wall_time =
-          std::chrono::duration_cast<std::chrono::duration<double>>(end -
-                                                                    start);
-
-      std::cout << "elapsed time = " << (wall_time.count()) / (time - last_time)
-                << ", t = " << time << "\n";
-      last_time = time;
-      start = std::chrono::high_resolution_clock::now();
-    }
-
-    if (render == true && step_number % render_step == 0) {
-      vis->BeginScene();
-      vis->Render();
-      vis->EndScene();
-      vis->Synchronize(time, driver_inputs);
-    }
   }
+  watchdog.Stop();
+  run_mode.Report();
   syn_manager.QuitSimulation();
   return 0;
 }
@@ -604,4 +716,17 @@ void AddCommandLineOptions(ChCLI &cli) {
   // DDS Specific
   cli.AddOption<int>("DDS", "d,node_id", "ID for this Node", "1");
   cli.AddOption<int>("DDS", "n,num_nodes", "Number of Nodes", "2");
+
+  cli.AddOption<std::string>(
+      "Realtime", "rt_profile",
+      "JSON thread placement profile, e.g. rt_profile.json", "");
+  cli.AddOption<std::string>(
+      "Realtime", "run_mode",
+      "realtime, fast, or a factor over real time such as x20", "realtime");
+  cli.AddOption<std::string>(
+      "Realtime", "inputs",
+      "Scripted driver inputs (ChDataDriver file) replacing the cab", "");
+  cli.AddOption<int>("Realtime", "watchdog",
+                     "Stall threshold of the watchdog [ms], 0 to disable",
+                     "50");
 }
\ No newline at end of file
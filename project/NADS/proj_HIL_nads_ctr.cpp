@@ -19,32 +19,20 @@
 
 #include "chrono_thirdparty/filesystem/path.h"
 
+#include "chrono_hil/driver/ChJoystickBridge.h"
 #include "chrono_hil/driver/ChSDLInterface.h"
 
-#include "chrono_hil/network/udp/ChBoostInStreamer.h"
-#include "chrono_hil/network/udp/ChBoostOutStreamer.h"
-
-#include <arpa/inet.h>
-#include <netinet/in.h>
-#include <stdlib.h>
-#include <string.h>
-#include <sys/socket.h>
-#include <sys/types.h>
-#include <unistd.h>
-
-#include <boost/array.hpp>
-#include <boost/asio.hpp>
-#include <boost/bind.hpp>
+#include <iostream>
 
 using namespace chrono;
 using namespace chrono::hil;
 
-using boost::asio::ip::address;
-using boost::asio::ip::udp;
-
 #define PORT_IN 1210
 #define PORT_OUT 1209
 #define IP_OUT "127.0.0.1"
+#define SEND_RATE 100.0 // input frames per second without input change
+#define DEADBAND 0.01   // axis change sending a frame at once
+#define GEAR_BUTTON 6
 
 int main(int argc, char *argv[]) {
   ChSDLInterface SDLDriver;
@@ -53,60 +41,31 @@ int main(int argc, char *argv[]) {
 
   SDLDriver.SetJoystickConfigFile(std::string(STRINGIFY(HIL_DATA_DIR)) +
                                   std::string("/joystick/controller_G29.json"));
-  SDLDriver.AddCallbackButtons(6);
   float gear =
       0.f; // 0.0 for park, 1.0 for forward, 2.0 for backward, 3.0 for neutral
 
-  std::vector<int> check_button_idx;
-  std::vector<int> check_button_val;
+  // out - throttle, steering, braking, gear; in - 19 floats
+  ChJoystickBridge bridge(&SDLDriver, IP_OUT, PORT_OUT, PORT_IN, 19);
+  bridge.SetSendRate(SEND_RATE);
+  bridge.SetDeadband(DEADBAND);
+  bridge.SetFrameFiller([&gear](std::vector<float> &frame) {
+    frame.push_back(gear); // out - 3 - gear
+  });
 
-  ChBoostOutStreamer out_streamer(IP_OUT, PORT_OUT);
-  ChBoostInStreamer in_streamer(PORT_IN, 19);
+  // one gear per press of the button
+  bridge.SetButtonCallback(GEAR_BUTTON, [&gear, &bridge]() {
+    gear = ((int)(gear + 1.0)) % 4;
+    bridge.RequestSend();
+  });
 
   std::vector<float> recv_data;
+  bridge.SetReceiver(
+      [&recv_data](const std::vector<float> &frame) { recv_data = frame; });
 
-  while (true) {
-    // data out
-    float throttle = SDLDriver.GetThrottle();
-    float steering = SDLDriver.GetSteering();
-    float braking = SDLDriver.GetBraking();
-
-    out_streamer.AddData(throttle); // out - 0 - throttle
-    out_streamer.AddData(steering); // out - 1 - steering
-    out_streamer.AddData(braking);  // out - 2 - braking
-
-    SDLDriver.GetButtonStatus(check_button_idx, check_button_val);
-    if (check_button_val[0] == 1) {
-      static auto last_invoked_1 =
-          std::chrono::system_clock::now().time_since_epoch();
-      auto current_invoke_1 =
-          std::chrono::system_clock::now().time_since_epoch();
-
-      if (std::chrono::duration_cast<std::chrono::seconds>(current_invoke_1 -
-                                                           last_invoked_1)
-              .count() >= 1.0) {
-        gear = ((int)(gear + 1.0)) % 4;
-
-        last_invoked_1 = current_invoke_1;
-      }
-    }
-    out_streamer.AddData(gear);
-
-    out_streamer.Synchronize();
-
-    // data in
-    in_streamer.Synchronize();
-
-    recv_data = in_streamer.GetRecvData();
-    // for (int i = 0; i < recv_data.size(); i++) {
-    //   std::cout << recv_data[i] << ",";
-    // }
-    // std::cout << std::endl;
-
-    if (SDLDriver.Synchronize() == 1) {
-      break;
-    }
-  }
+  bridge.Run();
 
+  std::cout << bridge.GetNumPeriodicSends() << " periodic and "
+            << bridge.GetNumEventSends() << " input change frames sent, "
+            << bridge.GetNumReceived() << " frames received" << std::endl;
   return 0;
 }
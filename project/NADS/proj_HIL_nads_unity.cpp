@@ -38,10 +38,12 @@
 
 #include "chrono_models/vehicle/sedan/Sedan.h"
 
+#include "chrono_thirdparty/cxxopts/ChCLI.h"
 #include "chrono_thirdparty/filesystem/path.h"
 
 #include "chrono_hil/driver/ChSDLInterface.h"
 #include "chrono_hil/network/udp/ChBoostOutStreamer.h"
+#include "chrono_hil/timer/ChLatencyMonitor.h"
 
 using namespace chrono;
 using namespace chrono::irrlicht;
@@ -77,7 +79,16 @@ double t_end = 1000;
 
 // =============================================================================
 
+void AddCommandLineOptions(ChCLI &cli);
 int main(int argc, char *argv[]) {
+  ChCLI cli(argv[0]);
+  AddCommandLineOptions(cli);
+  if (!cli.Parse(argc, argv, false, false))
+    return 0;
+
+  // latency of the driver loop, exported every second; empty to disable
+  const std::string latency_file = cli.GetAsType<std::string>("latency");
+
   GetLog() << "Copyright (c) 2017 projectchrono.org\nChrono version: "
            << CHRONO_VERSION << "\n\n";
 
@@ -224,6 +235,13 @@ int main(int argc, char *argv[]) {
   // create boost data streaming interface
   ChBoostOutStreamer boost_streamer(IP_OUT, PORT_OUT);
 
+  // joystick read to the first pose sent to Unity reflecting it, which is
+  // the pose after the next step
+  ChLatencyMonitor latency;
+  if (!latency_file.empty())
+    latency.SetExport(latency_file, 1.0);
+  double last_input_time = -1.0;
+
   // simulation loop
   while (true) {
     double time = my_vehicle.GetSystem()->GetChTime();
@@ -267,6 +285,10 @@ int main(int argc, char *argv[]) {
     boost_streamer.AddData(eu_rot.z()); // 6 - z
 
     boost_streamer.Synchronize();
+    if (last_input_time >= 0.0)
+      latency.RecordSince("input_to_unity", last_input_time);
+    last_input_time = SDLDriver.GetInputTime();
+    latency.Update();
     // std::cout << pos.x() << "," << pos.y() << "," << pos.z() << std::endl;
     //  =======================
     //  end data stream out section
@@ -311,3 +333,10 @@ int main(int argc, char *argv[]) {
 
   return 0;
 }
+
+void AddCommandLineOptions(ChCLI &cli) {
+  cli.AddOption<std::string>("Simulation", "latency",
+                             "Write the driver loop latencies to this CSV "
+                             "file, every second",
+                             "");
+}
@@ -0,0 +1,160 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// Jason Zhou
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Author: Jason Zhou
+// =============================================================================
+// Replays the network traffic recorded by one node (see the record=<file>
+// transport URI parameter) back into that node. The replayer stands in for
+// the recorded peers, each over its own transport, e.g. to replay the ROM
+// distributor link of a SynChrono node recorded with
+//   -t tcp://<ip>:1204?record=node1.hillog&peer=0
+// run
+//   proj_HIL_net_replay -l node1.hillog -p 0 -u tcp-server://:1204
+// and start the node against the replayer. Use -i to list the peers and
+// traffic found in a log.
+// =============================================================================
+
+#include <iostream>
+#include <map>
+#include <thread>
+
+#include "chrono_hil/network/ChHilReplayer.h"
+#include "chrono_hil/network/ChHilTransport.h"
+#include "chrono_thirdparty/cxxopts/ChCLI.h"
+
+using namespace chrono;
+using namespace chrono::hil;
+
+void AddCommandLineOptions(ChCLI &cli) {
+  cli.AddOption<std::string>("Replay", "l,log", "HIL log to replay", "");
+  cli.AddOption<std::vector<int>>("Replay", "p,peer", "Peers to stand in for",
+                                  "0");
+  cli.AddOption<std::vector<std::string>>(
+      "Replay", "u,uri", "Transport of each peer, the node connects to it",
+      "tcp-server://:1204");
+  cli.AddOption<double>("Replay", "s,speed",
+                        "Playback speed, 1 for the recorded pace, 0 for as "
+                        "fast as possible",
+                        "1.0");
+  cli.AddOption<bool>("Replay", "nocausal",
+                      "Do not wait for the frames the node sent in the "
+                      "recording, for lossy links",
+                      "false");
+  cli.AddOption<bool>("Replay", "i,info", "Print a summary of the log",
+                      "false");
+}
+
+// number of frames and bytes per peer and direction, and the duration
+int PrintInfo(const std::string &path) {
+  ChHilLogReader reader;
+  if (!reader.Open(path))
+    return 1;
+
+  struct Traffic {
+    uint64_t frames[2] = {0, 0};
+    uint64_t bytes[2] = {0, 0};
+    int64_t t_first = -1;
+    int64_t t_last = 0;
+  };
+  std::map<int, Traffic> peers;
+
+  ChHilLogRecord record;
+  while (reader.Next(record)) {
+    Traffic &traffic = peers[record.peer];
+    traffic.frames[record.direction]++;
+    traffic.bytes[record.direction] += record.data.size() * sizeof(float);
+    if (traffic.t_first < 0)
+      traffic.t_first = record.time_ns;
+    traffic.t_last = record.time_ns;
+  }
+
+  for (auto &peer : peers) {
+    const Traffic &traffic = peer.second;
+    std::cout << "peer " << peer.first << ": sent "
+              << traffic.frames[HIL_LOG_SENT] << " frames / "
+              << traffic.bytes[HIL_LOG_SENT] << " bytes, received "
+              << traffic.frames[HIL_LOG_RECEIVED] << " frames / "
+              << traffic.bytes[HIL_LOG_RECEIVED] << " bytes, over "
+              << 1e-9 * (traffic.t_last - traffic.t_first) << " s"
+              << std::endl;
+  }
+  return 0;
+}
+
+int main(int argc, char *argv[]) {
+  ChCLI cli(argv[0]);
+  AddCommandLineOptions(cli);
+  if (!cli.Parse(argc, argv, true))
+    return 0;
+
+  const std::string log = cli.GetAsType<std::string>("log");
+  const std::vector<int> peers = cli.GetAsType<std::vector<int>>("peer");
+  const std::vector<std::string> uris =
+      cli.GetAsType<std::vector<std::string>>("uri");
+  const double speed = cli.GetAsType<double>("speed");
+  const bool causal = !cli.GetAsType<bool>("nocausal");
+
+  if (log.empty()) {
+    std::cout << "No log given, see --help" << std::endl;
+    return 1;
+  }
+
+  if (cli.GetAsType<bool>("info"))
+    return PrintInfo(log);
+
+  if (peers.size() != uris.size()) {
+    std::cout << "One transport URI is needed per peer" << std::endl;
+    return 1;
+  }
+
+  std::vector<std::shared_ptr<ChHilReplayer>> replayers;
+  for (size_t i = 0; i < peers.size(); i++) {
+    auto link = ChHilTransport::Create(uris[i]);
+    if (!link)
+      return 1;
+    auto replayer = std::make_shared<ChHilReplayer>(link, peers[i]);
+    if (!replayer->Load(log))
+      return 1;
+    replayer->SetSpeed(speed);
+    replayer->SetCausal(causal);
+    std::cout << "peer " << peers[i] << " on " << uris[i] << ": "
+              << replayer->GetNumFramesToPlay() << " frames to play, "
+              << replayer->GetNumFramesExpected() << " expected" << std::endl;
+    replayers.push_back(replayer);
+  }
+
+  // one thread per peer, each initializes its link and plays its frames
+  std::vector<std::thread> threads;
+  std::vector<int> results(replayers.size());
+  for (size_t i = 0; i < replayers.size(); i++) {
+    threads.emplace_back(
+        [&, i]() { results[i] = replayers[i]->Run() ? 0 : 1; });
+  }
+  for (auto &thread : threads)
+    thread.join();
+
+  int ret = 0;
+  for (size_t i = 0; i < replayers.size(); i++) {
+    auto &replayer = replayers[i];
+    std::cout << "peer " << peers[i] << ": played "
+              << replayer->GetNumPlayed() << ", received "
+              << replayer->GetNumReceived() << ", mismatched "
+              << replayer->GetNumMismatched() << ", max lag "
+              << 1e3 * replayer->GetMaxLag() << " ms" << std::endl;
+    std::cout << "  node response [ms]: mean "
+              << 1e3 * replayer->GetMeanResponse() << " max "
+              << 1e3 * replayer->GetMaxResponse() << ", recorded mean "
+              << 1e3 * replayer->GetMeanRecordedResponse() << " max "
+              << 1e3 * replayer->GetMaxRecordedResponse() << std::endl;
+    ret |= results[i];
+  }
+  return ret;
+}
@@ -13,6 +13,8 @@
 #include "chrono/core/ChStream.h"
 #include "chrono/utils/ChFilters.h"
 #include "chrono/utils/ChUtilsInputOutput.h"
+#include <algorithm>
+#include <cstdio>
 #include <fstream>
 #include <iostream>
 #include <map>
@@ -51,6 +53,7 @@
 
 #include "chrono_hil/driver/ChIDM_Follower.h"
 #include "chrono_hil/driver/ChSDLInterface.h"
+#include "chrono_hil/memory/ChFrameArena.h"
 #include "chrono_hil/timer/ChRealtimeCumulative.h"
 
 #include "chrono_thirdparty/cxxopts/ChCLI.h"
@@ -165,6 +168,16 @@ void AddCommandLineOptions(ChCLI &cli) {
   cli.AddOption<std::vector<std::string>>(
       "DDS", "ip", "IP Addresses for initialPeersList", "127.0.0.1");
   cli.AddOption<int>("Simulation", "control", "to use slow-start control", "0");
+  cli.AddOption<bool>("Simulation", "arena_debug",
+                      "Report the per-frame allocations of the main loop",
+                      "false");
+}
+
+// value and a comma appended to a CSV line, formatted as by std::to_string
+void AppendCSV(ChFrameString &line, double value) {
+  char text[64];
+  int len = std::snprintf(text, sizeof(text), "%f,", value);
+  line.append(text, std::min(len, (int)sizeof(text) - 1));
 }
 
 void readvectors(std::vector<float> &throttle_ref,
@@ -263,6 +276,7 @@ int main(int argc, char *argv[]) {
       cli.GetAsType<std::vector<std::string>>("ip");
   render_scene = cli.GetAsType<int>("render");
   use_control = cli.GetAsType<int>("control");
+  const bool arena_debug = cli.GetAsType<bool>("arena_debug");
 
   // -----------------------
   // Create SynChronoManager
@@ -590,7 +604,6 @@ int main(int argc, char *argv[]) {
 
   std::string render_file_path = "./render.csv";
   std::ofstream render_filestream = std::ofstream(render_file_path);
-  std::stringstream render_buffer;
 
   std::string output_file_path = "./output.csv";
   std::ofstream output_filestream = std::ofstream(output_file_path);
@@ -685,6 +698,10 @@ int main(int argc, char *argv[]) {
 
   manager->Update();
 
+  // scratch data of the frame, released at its end
+  ChFrameArena &arena = ChFrameArena::GetThreadArena();
+  arena.SetDebug(arena_debug, "main arena");
+
   while (time <= sim_time && syn_manager.IsOk()) {
     time = my_vehicle.GetSystem()->GetChTime();
 
@@ -783,6 +800,8 @@ int main(int argc, char *argv[]) {
 
       // store rendering data
       if (render_scene == 4) {
+        // one line per frame, from the arena of the frame
+        ChFrameString render_line(&arena);
         for (int i = 0; i < num_nodes; i++) {
           if (i != node_id) {
             // body
@@ -790,12 +809,12 @@ int main(int argc, char *argv[]) {
             ChQuaternion<> temp_rot = id_map.at(i)->GetZombieRot();
             ChVector<> temp_rot_euler = temp_rot.Q_to_Euler123();
 
-            render_buffer << std::to_string(temp_pos.x()) + ",";
-            render_buffer << std::to_string(temp_pos.y()) + ",";
-            render_buffer << std::to_string(temp_pos.z()) + ",";
-            render_buffer << std::to_string(temp_rot_euler.x()) + ",";
-            render_buffer << std::to_string(temp_rot_euler.y()) + ",";
-            render_buffer << std::to_string(temp_rot_euler.z()) + ",";
+            AppendCSV(render_line, temp_pos.x());
+            AppendCSV(render_line, temp_pos.y());
+            AppendCSV(render_line, temp_pos.z());
+            AppendCSV(render_line, temp_rot_euler.x());
+            AppendCSV(render_line, temp_rot_euler.y());
+            AppendCSV(render_line, temp_rot_euler.z());
 
             // wheels
             for (int j = 0; j < 4; j++) {
@@ -804,12 +823,12 @@ int main(int argc, char *argv[]) {
                   id_map.at(i)->GetZombieWheelRot(j);
               ChVector<> temp_wheel_rot_euler = temp_wheel_rot.Q_to_Euler123();
 
-              render_buffer << std::to_string(temp_wheel_pos.x()) + ",";
-              render_buffer << std::to_string(temp_wheel_pos.y()) + ",";
-              render_buffer << std::to_string(temp_wheel_pos.z()) + ",";
-              render_buffer << std::to_string(temp_wheel_rot_euler.x()) + ",";
-              render_buffer << std::to_string(temp_wheel_rot_euler.y()) + ",";
-              render_buffer << std::to_string(temp_wheel_rot_euler.z()) + ",";
+              AppendCSV(render_line, temp_wheel_pos.x());
+              AppendCSV(render_line, temp_wheel_pos.y());
+              AppendCSV(render_line, temp_wheel_pos.z());
+              AppendCSV(render_line, temp_wheel_rot_euler.x());
+              AppendCSV(render_line, temp_wheel_rot_euler.y());
+              AppendCSV(render_line, temp_wheel_rot_euler.z());
             }
           } else {
             // ego body
@@ -817,12 +836,12 @@ int main(int argc, char *argv[]) {
             ChQuaternion<> temp_rot = my_vehicle.GetChassis()->GetRot();
             ChVector<> temp_rot_euler = temp_rot.Q_to_Euler123();
 
-            render_buffer << std::to_string(temp_pos.x()) + ",";
-            render_buffer << std::to_string(temp_pos.y()) + ",";
-            render_buffer << std::to_string(temp_pos.z()) + ",";
-            render_buffer << std::to_string(temp_rot_euler.x()) + ",";
-            render_buffer << std::to_string(temp_rot_euler.y()) + ",";
-            render_buffer << std::to_string(temp_rot_euler.z()) + ",";
+            AppendCSV(render_line, temp_pos.x());
+            AppendCSV(render_line, temp_pos.y());
+            AppendCSV(render_line, temp_pos.z());
+            AppendCSV(render_line, temp_rot_euler.x());
+            AppendCSV(render_line, temp_rot_euler.y());
+            AppendCSV(render_line, temp_rot_euler.z());
 
             // ego_wheels
             for (int j = 0; j < 4; j++) {
@@ -838,21 +857,20 @@ int main(int argc, char *argv[]) {
               ChQuaternion<> temp_wheel_rot = temp_wheel->GetState().rot;
               ChVector<> temp_wheel_rot_euler = temp_wheel_rot.Q_to_Euler123();
 
-              render_buffer << std::to_string(temp_wheel_pos.x()) + ",";
-              render_buffer << std::to_string(temp_wheel_pos.y()) + ",";
-              render_buffer << std::to_string(temp_wheel_pos.z()) + ",";
-              render_buffer << std::to_string(temp_wheel_rot_euler.x()) + ",";
-              render_buffer << std::to_string(temp_wheel_rot_euler.y()) + ",";
-              render_buffer << std::to_string(temp_wheel_rot_euler.z()) + ",";
+              AppendCSV(render_line, temp_wheel_pos.x());
+              AppendCSV(render_line, temp_wheel_pos.y());
+              AppendCSV(render_line, temp_wheel_pos.z());
+              AppendCSV(render_line, temp_wheel_rot_euler.x());
+              AppendCSV(render_line, temp_wheel_rot_euler.y());
+              AppendCSV(render_line, temp_wheel_rot_euler.z());
             }
           }
         }
 
-        render_buffer << std::endl;
+        render_line += '\n';
 
         SynLog() << ("Writing to render file...") << "\n";
-        render_filestream << render_buffer.rdbuf();
-        render_buffer.str("");
+        render_filestream.write(render_line.data(), render_line.size());
       }
     }
 
@@ -931,6 +949,7 @@ int main(int argc, char *argv[]) {
 
     // Increment frame number
     step_number++;
+    arena.Reset();
 
     if (!syn_manager.IsOk()) {
       syn_manager.QuitSimulation();
@@ -46,6 +46,7 @@
 #include "chrono_hil/ROM/driver/ChROM_PathFollowerDriver.h"
 #include "chrono_hil/ROM/veh/Ch_8DOF_vehicle.h"
 #include "chrono_hil/timer/ChRealtimeCumulative.h"
+#include "chrono_hil/timer/ChRealtimeMonitor.h"
 
 #include "chrono/core/ChBezierCurve.h"
 
@@ -292,11 +293,18 @@ int main(int argc, char *argv[]) {
     rom_dis_vec.push_back(0.0);
   }
 
+  ChRealtimeMonitor monitor(step_size);
+  int rom_phase = monitor.AddPhase("rom");
+  int record_phase = monitor.AddPhase("record");
+  int dynamics_phase = monitor.AddPhase("dynamics");
+  monitor.SetPrint(5.0);
+
   while (time < 900.0) {
 
     // get the controls for this time step
     // Driver inputs
 
+    monitor.BeginPhase(rom_phase);
     for (int i = 0; i < num_rom; i++) {
       // update idm
       int ld_idx = (i + 1) % num_rom;
@@ -331,6 +339,7 @@ int main(int argc, char *argv[]) {
       }
     }
 
+    monitor.BeginPhase(record_phase);
     if (step_number % 10 == 0) {
       for (int k = 0; k < num_rom; k++) {
         record_buffer << std::to_string(rom_dis_vec[k]) + ",";
@@ -350,8 +359,10 @@ int main(int argc, char *argv[]) {
     time += step_size;
     step_number += 1;
 
+    monitor.BeginPhase(dynamics_phase);
     sys.DoStepDynamics(step_size);
     // manager->Update();
+    monitor.EndFrame(time);
   }
   return 0;
 }
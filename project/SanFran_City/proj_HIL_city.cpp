@@ -59,6 +59,10 @@
 
 #include "chrono_hil/driver/ChLidarWaypointDriver.h"
 #include "chrono_hil/driver/ChSDLInterface.h"
+#include "chrono_hil/pipeline/ChRenderMirror.h"
+#include "chrono_hil/pipeline/ChRenderPipeline.h"
+
+#include "chrono/physics/ChSystemSMC.h"
 
 // =============================================================================
 
@@ -595,80 +599,104 @@ int main(int argc, char *argv[]) {
   std::shared_ptr<ChCameraSensor> camera;
   std::shared_ptr<ChSensorManager> manager;
 
+  // The sensors of the leader render a mirror of the bodies, the zombies of
+  // the other nodes included, in their own system, on a render thread one
+  // frame behind the dynamics
+  ChSystemSMC render_system;
+  ChRenderPipeline pipeline;
+  ChRenderMirror mirror(pipeline, &render_system);
+
   if (node_id == leader) {
-    // add a sensor manager
-    manager = chrono_types::make_shared<ChSensorManager>(vehicle.GetSystem());
-    // manager->SetRayRecursions(11);
-    Background b;
-    b.mode = BackgroundMode::ENVIRONMENT_MAP; // GRADIENT
-    b.color_zenith = {.5f, .6f, .7f};
-    b.color_horizon = {.9f, .8f, .7f};
-    b.env_tex = GetChronoDataFile("/Environments/sky_2_4k.hdr");
-    manager->scene->SetBackground(b);
-    float brightness = 1.5f;
-    manager->scene->AddPointLight({0, 0, 10000},
-                                  {brightness, brightness, brightness}, 100000);
-
-    const int image_width = resolution_x;
-    const int image_height = resolution_y;
-
-    // camera at driver's eye location for Audi
-    auto driver_cam = chrono_types::make_shared<ChCameraSensor>(
-        vehicle.GetChassisBody(), // body camera is attached to
-        25,                       // update rate in Hz
-        chrono::ChFrame<double>({0.54, .381, 1.04},
-                                Q_from_AngAxis(0, {0, 1, 0})), // offset pose
-        image_width,                                           // image width
-        image_height,                                          // image height
-        3.14 / 1.5,                                            // fov
-        supersample);
-
-    driver_cam->SetName("DriverCam");
-    driver_cam->PushFilter(chrono_types::make_shared<ChFilterVisualize>(
-        image_width, image_height, "Camera1", use_fullscreen));
-    if (save)
-      driver_cam->PushFilter(
-          chrono_types::make_shared<ChFilterSave>("DEMO_OUTPUT/driver_cam/"));
-    manager->AddSensor(driver_cam);
-
-    if (!no_sensing) {
-      lidar = chrono_types::make_shared<ChLidarSensor>(
-          vehicle.GetChassisBody(), // body lidar is attached to
-          20.f,                     // scanning rate in Hz
-          chrono::ChFrame<double>(lidar_pos,
+    // the zombies exist once the SynChronoManager is initialized
+    mirror.AddSystem(vehicle.GetSystem());
+    auto chassis_mirror = mirror.AddBody(vehicle.GetChassisBody());
+
+    // the sensors are created on the render thread, which owns their context
+    pipeline.SetInit([&, chassis_mirror]() {
+      // add a sensor manager
+      manager = chrono_types::make_shared<ChSensorManager>(&render_system);
+      // manager->SetRayRecursions(11);
+      Background b;
+      b.mode = BackgroundMode::ENVIRONMENT_MAP; // GRADIENT
+      b.color_zenith = {.5f, .6f, .7f};
+      b.color_horizon = {.9f, .8f, .7f};
+      b.env_tex = GetChronoDataFile("/Environments/sky_2_4k.hdr");
+      manager->scene->SetBackground(b);
+      float brightness = 1.5f;
+      manager->scene->AddPointLight(
+          {0, 0, 10000}, {brightness, brightness, brightness}, 100000);
+
+      const int image_width = resolution_x;
+      const int image_height = resolution_y;
+
+      // camera at driver's eye location for Audi
+      auto driver_cam = chrono_types::make_shared<ChCameraSensor>(
+          chassis_mirror, // body camera is attached to
+          25,             // update rate in Hz
+          chrono::ChFrame<double>({0.54, .381, 1.04},
                                   Q_from_AngAxis(0, {0, 1, 0})), // offset pose
-          900,           // number of horizontal samples
-          16,            // number of vertical channels
-          6.28318530718, // horizontal field of view
-          0.261799,
-          -0.261799,                        // vertical field of view
-          100.f,                            // max distance
-          LidarBeamShape::RECTANGULAR,      // beam shape
-          2,                                // sample radius
-          0.003,                            // vertical divergence angle
-          0.003,                            // horizontal divergence angle
-          LidarReturnMode::STRONGEST_RETURN // return mode for the lidar
-      );
-      lidar->SetName("Lidar Sensor 1");
-      lidar->SetLag(0.01);
-      lidar->SetCollectionWindow(.05);
-      // lidar->PushFilter(chrono_types::make_shared<ChFilterDIAccess>());
-      lidar->PushFilter(chrono_types::make_shared<ChFilterPCfromDepth>());
-      // lidar->PushFilter(chrono_types::make_shared<ChFilterLidarNoiseXYZI>(
-      //     0.01f, 0.001f, 0.001f, 0.01f));
-      lidar->PushFilter(chrono_types::make_shared<ChFilterXYZIAccess>());
-      lidar->PushFilter(chrono_types::make_shared<ChFilterVisualizePointCloud>(
-          640, 480, 2, "Lidar Point Cloud"));
-
+          image_width,                                           // image width
+          image_height,                                          // image height
+          3.14 / 1.5,                                            // fov
+          supersample);
+
+      driver_cam->SetName("DriverCam");
+      driver_cam->PushFilter(chrono_types::make_shared<ChFilterVisualize>(
+          image_width, image_height, "Camera1", use_fullscreen));
       if (save)
-        lidar->PushFilter(chrono_types::make_shared<ChFilterSavePtCloud>(
-            "DEMO_OUTPUT/lidar/"));
-      manager->AddSensor(lidar);
-      std::cout << "passed camera creation" << std::endl;
-    }
-  }
+        driver_cam->PushFilter(
+            chrono_types::make_shared<ChFilterSave>("DEMO_OUTPUT/driver_cam/"));
+      manager->AddSensor(driver_cam);
+
+      if (!no_sensing) {
+        lidar = chrono_types::make_shared<ChLidarSensor>(
+            chassis_mirror, // body lidar is attached to
+            20.f,           // scanning rate in Hz
+            chrono::ChFrame<double>(
+                lidar_pos, Q_from_AngAxis(0, {0, 1, 0})), // offset pose
+            900,           // number of horizontal samples
+            16,            // number of vertical channels
+            6.28318530718, // horizontal field of view
+            0.261799,
+            -0.261799,                        // vertical field of view
+            100.f,                            // max distance
+            LidarBeamShape::RECTANGULAR,      // beam shape
+            2,                                // sample radius
+            0.003,                            // vertical divergence angle
+            0.003,                            // horizontal divergence angle
+            LidarReturnMode::STRONGEST_RETURN // return mode for the lidar
+        );
+        lidar->SetName("Lidar Sensor 1");
+        lidar->SetLag(0.01);
+        lidar->SetCollectionWindow(.05);
+        // lidar->PushFilter(chrono_types::make_shared<ChFilterDIAccess>());
+        lidar->PushFilter(chrono_types::make_shared<ChFilterPCfromDepth>());
+        // lidar->PushFilter(chrono_types::make_shared<ChFilterLidarNoiseXYZI>(
+        //     0.01f, 0.001f, 0.001f, 0.01f));
+        lidar->PushFilter(chrono_types::make_shared<ChFilterXYZIAccess>());
+        lidar->PushFilter(
+            chrono_types::make_shared<ChFilterVisualizePointCloud>(
+                640, 480, 2, "Lidar Point Cloud"));
+
+        if (save)
+          lidar->PushFilter(chrono_types::make_shared<ChFilterSavePtCloud>(
+              "DEMO_OUTPUT/lidar/"));
+        manager->AddSensor(lidar);
+        std::cout << "passed camera creation" << std::endl;
+      }
 
-  manager->SetVerbose(false);
+      manager->SetVerbose(false);
+    });
+    pipeline.AddConsumer(
+        [&](const ChPoseSnapshot &snapshot) { mirror.Apply(snapshot); });
+    pipeline.AddConsumer(
+        [&](const ChPoseSnapshot &snapshot) { manager->Update(); });
+    pipeline.SetExit([&]() {
+      lidar.reset();
+      manager.reset();
+    });
+    pipeline.Start();
+  }
 
   // Create the vehicle Irrlicht interface
   std::string driver_file = "driver_inputs.txt";
@@ -762,7 +790,7 @@ int main(int argc, char *argv[]) {
     terrain.Advance(step_size);
 
     if (node_id == leader) {
-      manager->Update();
+      pipeline.Publish(vehicle.GetSystem()->GetChTime());
     }
 
     if (node_id == leader) {
@@ -786,6 +814,7 @@ int main(int argc, char *argv[]) {
       start = std::chrono::high_resolution_clock::now();
     }
   }
+  pipeline.Stop();
   if (node_id == leader && record_inputs) {
     driver_csv.write_to_file(driver_file);
   }
@@ -60,10 +60,13 @@
 #include "chrono_hil/driver/ChSDLInterface.h"
 #include "chrono_thirdparty/cxxopts/ChCLI.h"
 
+#include "chrono_hil/ROM/syn/ChROM_InterestFilter.h"
+#include "chrono_hil/ROM/syn/ChROM_ZombieManager.h"
 #include "chrono_hil/ROM/syn/Ch_8DOF_zombie.h"
 
-#include "chrono_hil/network/tcp/ChTCPClient.h"
-#include "chrono_hil/network/tcp/ChTCPServer.h"
+#include "chrono_hil/network/ChHilCoupler.h"
+#include "chrono_hil/network/ChHilTransport.h"
+#include "chrono_hil/timer/ChLatencyMonitor.h"
 
 // =============================================================================
 
@@ -216,6 +219,10 @@ int main(int argc, char *argv[]) {
       cli.GetAsType<std::vector<std::string>>("ip");
   const int record = cli.GetAsType<int>("record");
   const int output_state = cli.GetAsType<int>("output");
+  const double interest_radius = cli.GetAsType<double>("interest_radius");
+  const double playout_delay = cli.GetAsType<double>("playout_delay");
+  const int max_lag = cli.GetAsType<int>("max_lag");
+  const std::string latency_file = cli.GetAsType<std::string>("latency");
 
   std::string output_file_path =
       "./syn_output" + std::to_string(node_id) + ".csv";
@@ -374,25 +381,21 @@ int main(int argc, char *argv[]) {
   std::string audi_json =
       std::string(STRINGIFY(HIL_DATA_DIR)) + "/rom/audi/audi_rom.json";
 
-  std::vector<std::shared_ptr<Ch_8DOF_zombie>> zombie_vec;
-  for (int i = 0; i < num_rom; i++) {
-    std::string rom_json;
-    if (rom_data[i].type == 0) {
-      rom_json = hmmwv_json;
-    } else if (rom_data[i].type == 1) {
-      rom_json = sedan_json;
-    } else if (rom_data[i].type == 2) {
-      rom_json = patrol_json;
-    } else if (rom_data[i].type == 3) {
-      rom_json = audi_json;
+  // zombies are spawned as ROMs enter the interest region of this node
+  auto rom_json_lookup = [&](int id) {
+    if (rom_data[id].type == 0) {
+      return hmmwv_json;
+    } else if (rom_data[id].type == 1) {
+      return sedan_json;
+    } else if (rom_data[id].type == 2) {
+      return patrol_json;
     }
-
-    auto rom_zombie =
-        chrono_types::make_shared<Ch_8DOF_zombie>(rom_json, 0.0, true);
-    zombie_vec.push_back(rom_zombie);
-    rom_zombie->Initialize(my_vehicle.GetSystem());
-    std::cout << "zombie: " << i << std::endl;
-  }
+    return audi_json;
+  };
+  ChROM_ZombieManager zombie_manager(my_vehicle.GetSystem(), rom_json_lookup,
+                                     0.0, true);
+  // ROM states arrive every 20 steps, they are interpolated in between
+  zombie_manager.SetPlayoutDelay(playout_delay);
 
   // --------------
   // Create cam
@@ -598,25 +601,19 @@ int main(int argc, char *argv[]) {
                            "road", 20.0 * MPH_TO_MS, followerParam);
   idm_driver.Initialize();
 
-  // Create TCP Tunnel
-  ChTCPClient chrono_0("127.0.0.1", 1204,
-                       num_rom * 11); // create a TCP client for rank 0
-  ChTCPClient chrono_1("127.0.0.1", 1205,
-                       num_rom * 11); // create a TCP client for rank 1
-  ChTCPClient chrono_2("127.0.0.1", 1206,
-                       num_rom * 11); // create a TCP client for rank 2
-
-  if (node_id == 0) {
-    chrono_0.Initialize(); // initialize TCP connection for rank 1
-  } else if (node_id == 1) {
-    std::this_thread::sleep_for(std::chrono::milliseconds(
-        5000)); // wait for 2000 seconds to prevent duplicated connection
-    chrono_1.Initialize(); // initialize TCP connection for rank 2
-  } else if (node_id == 2) {
-    std::this_thread::sleep_for(std::chrono::milliseconds(
-        10000)); // wait for 2000 seconds to prevent duplicated connection
-    chrono_2.Initialize(); // initialize TCP connection for rank 2
+  // link to the ROM distributor, one TCP port per node. The connection
+  // retries until the distributor listens, then both sides exchange HELLO.
+  auto rom_transport = ChHilTransport::Create(
+      "tcp://127.0.0.1:" + std::to_string(1204 + node_id));
+  auto latency = std::make_shared<ChLatencyMonitor>();
+  if (!latency_file.empty()) {
+    latency->SetExport(latency_file, 1.0);
+    rom_transport->SetLatencyTracker(
+        std::make_shared<ChHilLatencyTracker>(latency, "distributor"));
   }
+  ChHilCoupler rom_link(rom_transport, max_lag);
+  if (!rom_link.Connect(node_id))
+    return 1;
 
   double sim_time = 0.f;
   double last_time = 0.f;
@@ -713,69 +710,33 @@ int main(int argc, char *argv[]) {
       manager->Update();
     }
 
-    // Synchronize
-    if (step_number == 0) {
-      std::vector<float> data_to_send;
-      data_to_send.push_back(1.0);
-      data_to_send.push_back(1.0);
-      data_to_send.push_back(1.0);
-      if (node_id == 0) {
-        chrono_0.Write(data_to_send);
-      } else if (node_id == 1) {
-        chrono_1.Write(data_to_send);
-      } else if (node_id == 2) {
-        chrono_2.Write(data_to_send);
-      }
-    }
+    // Interest region of this node, reported to the distributor
+    ChROM_InterestRegion region;
+    region.pos = my_vehicle.GetChassis()->GetPos();
+    region.radius = interest_radius;
 
     // Update zombies
     // ==================================================
     // TCP Synchronization Section
     // ==================================================
-    // read data from rom distributor 1
+    // newest frame of the rom distributor, if one arrived; the node only
+    // waits for the distributor when it is more than max_lag frames behind
     if (step_number % 20 == 0) {
-      if (node_id == 0) {
-        chrono_0.Read();
-      } else if (node_id == 1) {
-        chrono_1.Read();
-      } else if (node_id == 2) {
-        chrono_2.Read();
-      }
-
+      // spawn, update and despawn zombies of the ROMs of interest
       std::vector<float> recv_data;
-      if (node_id == 0) {
-        recv_data = chrono_0.GetRecvData();
-      } else if (node_id == 1) {
-        recv_data = chrono_1.GetRecvData();
-      } else if (node_id == 2) {
-        recv_data = chrono_2.GetRecvData();
-      }
+      if (rom_link.Receive(recv_data, sim_time))
+        zombie_manager.ApplyTimed(recv_data, rom_link.GetPeerTime());
 
-      for (int i = 0; i < num_rom; i++) {
-        zombie_vec[i]->Update(
-            ChVector<>(recv_data[0 + i * 11], recv_data[1 + i * 11],
-                       recv_data[2 + i * 11]),
-            ChVector<>(recv_data[3 + i * 11], recv_data[4 + i * 11],
-                       recv_data[5 + i * 11]),
-            recv_data[6 + i * 11], recv_data[7 + i * 11], recv_data[8 + i * 11],
-            recv_data[9 + i * 11], recv_data[10 + i * 11]);
-      }
-
-      // send data to distributor 1
+      // send the interest region to the distributor
       std::vector<float> data_to_send;
-      data_to_send.push_back(my_vehicle.GetChassis()->GetPos().x());
-      data_to_send.push_back(my_vehicle.GetChassis()->GetPos().y());
-      data_to_send.push_back(my_vehicle.GetChassis()->GetPos().z());
-
-      if (node_id == 0) {
-        chrono_0.Write(data_to_send);
-      } else if (node_id == 1) {
-        chrono_1.Write(data_to_send);
-      } else if (node_id == 2) {
-        chrono_2.Write(data_to_send);
-      }
+      ChROM_InterestFilter::EncodeRegion(region, data_to_send);
+      rom_link.Send(data_to_send, sim_time);
     }
 
+    // pose the zombies from their jitter buffers, every step
+    zombie_manager.Advance(sim_time);
+    latency->Update();
+
     if (output_state == 1 && step_number % 20 == 0) {
       output_buffer << sim_time << ",";
       output_buffer << my_vehicle.GetSpeed() << ",";
@@ -992,4 +953,18 @@ void AddCommandLineOptions(ChCLI &cli) {
                            // record 1 - record input
                            // record 2 - replay
   cli.AddOption<int>("Simulation", "output", "output vehicle state", "0");
+  cli.AddOption<double>("Simulation", "interest_radius",
+                        "Radius in which ROMs are received", "250.0");
+  cli.AddOption<double>("Simulation", "playout_delay",
+                        "Delay before received ROM states are shown [s]",
+                        "0.06");
+  cli.AddOption<int>("Simulation", "max_lag",
+                     "Frames the ROM distributor may fall behind before "
+                     "this node waits for it, 0 for lockstep",
+                     "10");
+  cli.AddOption<std::string>("Simulation", "latency",
+                             "Write the ROM link latencies to this CSV "
+                             "file, every second; needs --latency on the "
+                             "distributor",
+                             "");
 }
@@ -16,10 +16,20 @@
 // This is the ROM distributor side
 // simply launch this program, it will distribute simulation data to synchrono
 // rank 1 and rank 2, encapsulated in "test_HIL_rom_synchrono.cpp"
+//
+// The ROMs may be split across several distributors with --num_domains, one
+// ChROM_TrafficDomain each: launch one distributor per domain with its
+// --domain index. The map is cut along x so that each domain starts with as
+// many ROMs, the cuts then follow the load. Domain d serves its own three
+// ranks from port 1204 + 3 * d, with the ROMs it owns and the ROMs of its
+// neighbours within --halo of its region, so that the ranks keep seeing the
+// ROMs which cross the boundary.
 // =============================================================================
 
+#include <algorithm>
 #include <chrono>
 #include <iostream>
+#include <limits>
 #include <stdint.h>
 
 #include <fstream>
@@ -48,6 +58,9 @@
 
 #include "chrono_hil/ROM/driver/ChROM_IDMFollower.h"
 #include "chrono_hil/ROM/driver/ChROM_PathFollowerDriver.h"
+#include "chrono_hil/ROM/syn/ChROM_DomainPartition.h"
+#include "chrono_hil/ROM/syn/ChROM_InterestFilter.h"
+#include "chrono_hil/ROM/syn/ChROM_TrafficDomain.h"
 #include "chrono_hil/ROM/syn/Ch_8DOF_zombie.h"
 #include "chrono_hil/ROM/veh/Ch_8DOF_vehicle.h"
 #include "chrono_hil/timer/ChRealtimeCumulative.h"
@@ -78,14 +91,18 @@
 #include "chrono_synchrono/utils/SynDataLoader.h"
 #include "chrono_synchrono/utils/SynLog.h"
 
-#include "chrono_hil/network/tcp/ChTCPClient.h"
-#include "chrono_hil/network/tcp/ChTCPServer.h"
+#include "chrono_hil/network/ChHilCoupler.h"
+#include "chrono_hil/network/ChHilTransport.h"
+#include "chrono_hil/timer/ChLatencyMonitor.h"
 
 #include "chrono_hil/timer/ChRealtimeCumulative.h"
 // =============================================================================
 
 #define IP_OUT "127.0.0.1"
 #define PORT_IN_1 1204
+#define PORT_DOMAIN 1230 // link of domain d to domain d + 1 on PORT_DOMAIN + d
+#define BALANCE_PERIOD 250
+#define HALO_WIDTH 200.0
 
 // ==============================================================================
 int output = 0;
@@ -132,6 +149,38 @@ void ReadRomInitFile(std::string csv_filename, std::vector<rom_item> &rom_arr);
 // =====================================================
 
 int main(int argc, char *argv[]) {
+  ChCLI cli(argv[0]);
+  cli.AddOption<int>("syn", "k,max_lag",
+                     "Frames a rank may fall behind before the distributor "
+                     "waits for it, 0 for lockstep",
+                     "10");
+  cli.AddOption<std::string>("syn", "latency",
+                             "Write the link latencies to this CSV file, "
+                             "every second; needs --latency on the ranks",
+                             "");
+  cli.AddOption<int>("dom", "n,num_domains",
+                     "Number of distributors the ROMs are split across", "1");
+  cli.AddOption<int>("dom", "d,domain", "Domain of this distributor", "0");
+  cli.AddOption<std::string>("dom", "domain_host",
+                             "Host of the distributor of the previous domain",
+                             IP_OUT);
+  cli.AddOption<double>("dom", "halo",
+                        "Width beyond its region in which a domain sees the "
+                        "ROMs of its neighbours [m]",
+                        std::to_string(HALO_WIDTH));
+  if (!cli.Parse(argc, argv, true))
+    return 0;
+  const int max_lag = cli.GetAsType<int>("max_lag");
+  const std::string latency_file = cli.GetAsType<std::string>("latency");
+  const int num_domains = cli.GetAsType<int>("num_domains");
+  const int domain_index = cli.GetAsType<int>("domain");
+  const std::string domain_host = cli.GetAsType<std::string>("domain_host");
+  const double halo_width = cli.GetAsType<double>("halo");
+  if (num_domains < 1 || domain_index < 0 || domain_index >= num_domains) {
+    std::cout << "Invalid domain " << domain_index << " of " << num_domains
+              << std::endl;
+    return 1;
+  }
 
   std::vector<rom_item> rom_data;
   std::string filename = std::string(STRINGIFY(HIL_DATA_DIR)) +
@@ -151,70 +200,64 @@ int main(int argc, char *argv[]) {
   std::string audi_json =
       std::string(STRINGIFY(HIL_DATA_DIR)) + "/rom/audi/audi_rom.json";
 
-  std::vector<std::shared_ptr<Ch_8DOF_vehicle>>
-      rom_vec; // rom vector, for node 0
-  std::vector<std::shared_ptr<ChROM_PathFollowerDriver>>
-      driver_vec; // rom driver vector
-  std::vector<std::shared_ptr<ChROM_IDMFollower>>
-      idm_vec; // rom idm driver vector
-
   std::string output_file_path = "./rom_output.csv";
   std::ofstream output_filestream = std::ofstream(output_file_path);
   std::stringstream output_buffer;
 
   std::vector<DriverInputs> input_record;
 
-  // initialize vehicle and drivers
-  for (int i = 0; i < rom_data.size(); i++) {
+  // build ROM id with its drivers, for the ROMs of this domain at the start
+  // and for those migrating in
+  auto make_vehicle = [&](int id) {
+    const rom_item &item = rom_data[id];
     std::string rom_json;
-    if (rom_data[i].type == 0) {
+    if (item.type == 0) {
       rom_json = hmmwv_json;
-    } else if (rom_data[i].type == 1) {
+    } else if (item.type == 1) {
       rom_json = sedan_json;
-    } else if (rom_data[i].type == 2) {
+    } else if (item.type == 2) {
       rom_json = patrol_json;
-    } else if (rom_data[i].type == 3) {
+    } else if (item.type == 3) {
       rom_json = audi_json;
     }
 
+    ChROM_TrafficVehicle vehicle;
+    vehicle.id = id;
+    vehicle.leader_id = item.ld_id;
+
     // ROM_VEHICLE
-    std::shared_ptr<Ch_8DOF_vehicle> rom_veh =
-        chrono_types::make_shared<Ch_8DOF_vehicle>(
-            rom_json, rom_data[i].pos.z(), step_size, true);
-    rom_veh->SetInitPos(rom_data[i].pos);
-    rom_veh->SetInitRot(rom_data[i].rot.z());
-    rom_veh->Initialize(&my_system);
-    rom_vec.push_back(rom_veh);
+    vehicle.rom = chrono_types::make_shared<Ch_8DOF_vehicle>(
+        rom_json, item.pos.z(), step_size, true);
+    vehicle.rom->SetInitPos(item.pos);
+    vehicle.rom->SetInitRot(item.rot.z());
+    vehicle.rom->Initialize(&my_system);
 
     // DRIVER
     std::shared_ptr<ChBezierCurve> path;
-    if (rom_data[i].path == 2) {
+    if (item.path == 2) {
       path = ChBezierCurve::read(demo_data_path + "/paths/2.txt", true);
-    } else if (rom_data[i].path == 3) {
+    } else if (item.path == 3) {
       path = ChBezierCurve::read(demo_data_path + "/paths/3.txt", true);
-    } else if (rom_data[i].path == 5) {
+    } else if (item.path == 5) {
       path = ChBezierCurve::read(demo_data_path + "/paths/5.txt", true);
-    } else if (rom_data[i].path == 1) {
+    } else if (item.path == 1) {
       path = ChBezierCurve::read(demo_data_path + "/paths/1.txt", true);
-    } else if (rom_data[i].path == 6) {
+    } else if (item.path == 6) {
       path = ChBezierCurve::read(demo_data_path + "/paths/6.txt", true);
-    } else if (rom_data[i].path == 7) {
+    } else if (item.path == 7) {
       path = ChBezierCurve::read(demo_data_path + "/paths/7.txt", true);
     }
 
-    std::shared_ptr<ChROM_PathFollowerDriver> driver;
-    if (rom_data[i].path == 3) {
-      driver = chrono_types::make_shared<ChROM_PathFollowerDriver>(
-          rom_vec[i], path, 6.0, 10.0, 0.1, 0.0, 0.0, 0.5, 0.0, 0.0);
+    if (item.path == 3) {
+      vehicle.driver = chrono_types::make_shared<ChROM_PathFollowerDriver>(
+          vehicle.rom, path, 6.0, 10.0, 0.1, 0.0, 0.0, 0.5, 0.0, 0.0);
     } else {
-      driver = chrono_types::make_shared<ChROM_PathFollowerDriver>(
-          rom_vec[i], path, 6.0, 10.0, 0.3, 0.0, 0.0, 0.5, 0.0, 0.0);
+      vehicle.driver = chrono_types::make_shared<ChROM_PathFollowerDriver>(
+          vehicle.rom, path, 6.0, 10.0, 0.3, 0.0, 0.0, 0.5, 0.0, 0.0);
     }
 
-    driver_vec.push_back(driver);
-
     std::vector<double> params;
-    if (rom_data[i].idm_type == 0) {
+    if (item.idm_type == 0) {
       params.push_back(10.0);
       params.push_back(0.1);
       params.push_back(5.0);
@@ -223,7 +266,7 @@ int main(int argc, char *argv[]) {
       params.push_back(4.0);
       params.push_back(6.0);
 
-    } else if (rom_data[i].idm_type == 1) {
+    } else if (item.idm_type == 1) {
       params.push_back(9.0);
       params.push_back(0.2);
       params.push_back(6.0);
@@ -231,7 +274,7 @@ int main(int argc, char *argv[]) {
       params.push_back(2.1);
       params.push_back(4.0);
       params.push_back(6.0);
-    } else if (rom_data[i].idm_type == 2) {
+    } else if (item.idm_type == 2) {
       params.push_back(7.5);
       params.push_back(0.7);
       params.push_back(8.0);
@@ -240,10 +283,41 @@ int main(int argc, char *argv[]) {
       params.push_back(4.0);
       params.push_back(6.0);
     }
-    std::shared_ptr<ChROM_IDMFollower> idm_controller =
-        chrono_types::make_shared<ChROM_IDMFollower>(rom_vec[i], driver_vec[i],
-                                                     params);
-    idm_vec.push_back(idm_controller);
+    vehicle.idm = chrono_types::make_shared<ChROM_IDMFollower>(
+        vehicle.rom, vehicle.driver, params);
+    return vehicle;
+  };
+
+  // strips along x, starting with as many ROMs each
+  std::vector<double> start_x;
+  for (const rom_item &item : rom_data)
+    start_x.push_back(item.pos.x());
+  std::sort(start_x.begin(), start_x.end());
+  std::vector<double> x_cuts;
+  for (int d = 1; d < num_domains; d++)
+    x_cuts.push_back(start_x[d * start_x.size() / num_domains]);
+  ChROM_DomainPartition partition(x_cuts);
+
+  ChROM_TrafficDomain domain(partition, domain_index, &my_system,
+                             make_vehicle);
+  if (domain_index > 0)
+    domain.AddLink(domain_index - 1,
+                   ChHilTransport::Create(
+                       "tcp://" + domain_host + ":" +
+                       std::to_string(PORT_DOMAIN + domain_index - 1)));
+  if (domain_index + 1 < num_domains)
+    domain.AddLink(domain_index + 1,
+                   ChHilTransport::Create(
+                       "tcp-server://:" +
+                       std::to_string(PORT_DOMAIN + domain_index)));
+  domain.SetHaloWidth(halo_width);
+  if (num_domains > 1)
+    domain.EnableBalancing(BALANCE_PERIOD);
+
+  // initialize vehicle and drivers
+  for (int i = 0; i < rom_data.size(); i++) {
+    if (partition.GetOwner(rom_data[i].pos) == domain_index)
+      domain.AddVehicle(make_vehicle(i));
   }
 
   // Initialize terrain
@@ -280,35 +354,49 @@ int main(int argc, char *argv[]) {
   // create boost data streaming interface
   ChRealtimeCumulative realtime_timer;
 
-  ChTCPServer rom_distributor_0(
-      1204,
-      3); // create the 1st TCP server to send data to synchrono rank 1
-  ChTCPServer rom_distributor_1(
-      1205,
-      3); // creat the 2nd TCP server to send data to synchrono rank 2
-  ChTCPServer rom_distributor_2(
-      1206,
-      3); // creat the 2nd TCP server to send data to synchrono rank 2
+  // one TCP server per synchrono rank of this domain, each rank steps at
+  // its own rate and the distributor only waits for a rank more than
+  // max_lag frames behind
+  std::vector<std::shared_ptr<ChHilCoupler>> rom_links;
+  auto latency = std::make_shared<ChLatencyMonitor>();
+  if (!latency_file.empty())
+    latency->SetExport(latency_file, 1.0);
+  for (int r = 0; r < 3; r++) {
+    auto transport = ChHilTransport::Create(
+        "tcp-server://:" + std::to_string(PORT_IN_1 + 3 * domain_index + r));
+    if (!latency_file.empty())
+      transport->SetLatencyTracker(std::make_shared<ChHilLatencyTracker>(
+          latency, "rank" + std::to_string(r)));
+    rom_links.push_back(std::make_shared<ChHilCoupler>(transport, max_lag));
+  }
 
-  rom_distributor_0.Initialize(); // initialize connection to synchrono rank 1
-  rom_distributor_1.Initialize(); // initialize connection to synchrono rank 2
-  rom_distributor_2.Initialize(); // initialize connection to synchrono rank 2
+  // only ROMs within the interest region reported by each rank are sent
+  ChROM_InterestFilter interest_filter(3);
 
-  while (true) {
+  // ranks may connect in any order
+  for (auto &rom_link : rom_links) {
+    if (!rom_link->Connect(0))
+      return 1;
+  }
 
-    if (step_number == 0) {
-      rom_distributor_0.Read();
-      std::vector<float> recv_data_0;
-      recv_data_0 = rom_distributor_0.GetRecvData();
+  // then the distributors of the neighbour domains
+  domain.Initialize();
 
-      rom_distributor_1.Read();
-      std::vector<float> recv_data_1;
-      recv_data_1 = rom_distributor_1.GetRecvData();
+  // brake in the turns, and record the inputs of the focus ROMs
+  domain.SetInputFilter(
+      [&](const ChROM_TrafficVehicle &vehicle, DriverInputs &driver_inputs) {
+        if (abs(driver_inputs.m_steering) > 0.05 &&
+            vehicle.rom->GetVel().Length() > 4.0) {
+          driver_inputs.m_throttle = 0.0;
+          driver_inputs.m_braking = 0.2;
+        }
 
-      rom_distributor_2.Read();
-      std::vector<float> recv_data_2;
-      recv_data_2 = rom_distributor_2.GetRecvData();
-    }
+        if (output == 1 && step_number % 20 == 0 &&
+            std::count(focus_idx, focus_idx + 10, vehicle.id) > 0)
+          input_record.push_back(driver_inputs);
+      });
+
+  while (true) {
 
     time = my_system.GetChTime();
 
@@ -320,78 +408,63 @@ int main(int argc, char *argv[]) {
 
     // Advance simulation for one timestep for all modules
 
-    std::vector<float> data_to_send;
     if (step_number % 20 == 0) {
-      // send data to chrono
-      for (int i = 0; i < rom_data.size(); i++) {
-        ChVector<> rom_pos = rom_vec[i]->GetPos();
-        ChQuaternion<> rom_rot = rom_vec[i]->GetRot();
+      // gather the state of the ROMs of this domain and of the halo, by
+      // ROM id; the other ROMs have no position, never of interest
+      double nan = std::numeric_limits<double>::quiet_NaN();
+      std::vector<ChVector<>> rom_pos_vec(rom_data.size(),
+                                          ChVector<>(nan, nan, nan));
+      std::vector<float> rom_states(11 * rom_data.size(), 0.f);
+      auto gather = [&](int id, const ChVector<> &rom_pos,
+                        const ChQuaternion<> &rom_rot, double steering,
+                        const double *tire_rotation) {
         ChVector<> rom_rot_vec = rom_rot.Q_to_Euler123();
-        DriverInputs rom_inputs = rom_vec[i]->GetDriverInputs();
-
-        data_to_send.push_back(rom_pos.x());
-        data_to_send.push_back(rom_pos.y());
-        data_to_send.push_back(rom_pos.z());
-        data_to_send.push_back(rom_rot_vec.x());
-        data_to_send.push_back(rom_rot_vec.y());
-        data_to_send.push_back(rom_rot_vec.z());
-        data_to_send.push_back(rom_inputs.m_steering);
-        data_to_send.push_back(rom_vec[i]->GetTireRotation(0));
-        data_to_send.push_back(rom_vec[i]->GetTireRotation(1));
-        data_to_send.push_back(rom_vec[i]->GetTireRotation(2));
-        data_to_send.push_back(rom_vec[i]->GetTireRotation(3));
+        rom_pos_vec[id] = rom_pos;
+        float *state = &rom_states[11 * id];
+        state[0] = rom_pos.x();
+        state[1] = rom_pos.y();
+        state[2] = rom_pos.z();
+        state[3] = rom_rot_vec.x();
+        state[4] = rom_rot_vec.y();
+        state[5] = rom_rot_vec.z();
+        state[6] = steering;
+        for (int w = 0; w < 4; w++)
+          state[7 + w] = tire_rotation[w];
+      };
+      for (auto &entry : domain.GetVehicles()) {
+        const std::shared_ptr<Ch_8DOF_vehicle> &rom = entry.second.rom;
+        double tire_rotation[4];
+        for (int w = 0; w < 4; w++)
+          tire_rotation[w] = rom->GetTireRotation(w);
+        gather(entry.first, rom->GetPos(), rom->GetRot(),
+               rom->GetDriverInputs().m_steering, tire_rotation);
       }
-      rom_distributor_0.Write(
-          data_to_send); // send rom data to synchrono rank 1
-      rom_distributor_1.Write(
-          data_to_send); // send rom data to synchrono rank 1
-      rom_distributor_2.Write(
-          data_to_send); // send rom data to synchrono rank 1
-
-      // receive data from chrono_0
-      rom_distributor_0.Read();
-      // receive data from chrono_1
-      rom_distributor_1.Read();
-      // receive data from chrono_2
-      rom_distributor_2.Read();
-      std::vector<float> recv_data_0;
-      recv_data_0 = rom_distributor_0.GetRecvData();
-      std::vector<float> recv_data_1;
-      recv_data_1 = rom_distributor_1.GetRecvData();
-      std::vector<float> recv_data_2;
-      recv_data_2 = rom_distributor_2.GetRecvData();
-    }
-
-    for (int i = 0; i < rom_data.size(); i++) {
-      // Driver inputs
-      DriverInputs driver_inputs;
-      idm_vec[i]->Synchronize(
-          time, step_size,
-          (rom_vec[rom_data[i].ld_id]->GetPos() - rom_vec[i]->GetPos())
-              .Length(),
-          (rom_vec[rom_data[i].ld_id]->GetVel()).Length());
-      // driver_vec[i]->Advance(step_size);
-      driver_inputs = driver_vec[i]->GetDriverInput();
-      if (abs(driver_inputs.m_steering) > 0.05 &&
-          rom_vec[i]->GetVel().Length() > 4.0) {
-        driver_inputs.m_throttle = 0.0;
-        driver_inputs.m_braking = 0.2;
+      for (auto &entry : domain.GetGhosts()) {
+        const ChROM_Ghost &ghost = entry.second;
+        gather(entry.first, ghost.pos, ghost.rot, ghost.steering,
+               ghost.tire_rotation);
       }
 
-      if (output == 1) {
-        if (i == focus_idx[0] || i == focus_idx[1] || i == focus_idx[2] ||
-            i == focus_idx[3] || i == focus_idx[4] || i == focus_idx[5] ||
-            i == focus_idx[6] || i == focus_idx[7] || i == focus_idx[8] ||
-            i == focus_idx[9]) {
-          if (step_number % 20 == 0) {
-            input_record.push_back(driver_inputs);
-          }
-        }
+      // newest interest region reported by each synchrono rank, if any
+      std::vector<float> report;
+      for (size_t r = 0; r < rom_links.size(); r++) {
+        if (rom_links[r]->Receive(report, time))
+          interest_filter.SetRegion(r, report);
       }
 
-      rom_vec[i]->Advance(time, driver_inputs);
+      // send the ROMs of interest to each synchrono rank
+      std::vector<float> data_to_send;
+      for (size_t r = 0; r < rom_links.size(); r++) {
+        interest_filter.BuildFrame(r, rom_pos_vec, rom_states, 11,
+                                   data_to_send);
+        rom_links[r]->Send(data_to_send, time);
+      }
     }
 
+    // swap migrants and halo with the neighbour domains, then drive and
+    // advance the ROMs of this domain
+    domain.Advance(time, step_size);
+
     terrain.Advance(step_size);
     my_system.DoStepDynamics(step_size);
 
@@ -401,18 +474,25 @@ int main(int argc, char *argv[]) {
       if (step_number % 20 == 0) {
         output_buffer << time << ",";
 
+        // the focus ROMs of this domain, recorded in the order of their id
+        size_t k = 0;
         for (int j = 0; j < 10; j++) {
-          output_buffer << (rom_vec[focus_idx[j]]->GetVel()).Length() << ",";
-
-          output_buffer << input_record[j].m_throttle << ",";
-          output_buffer << input_record[j].m_braking << ",";
-          output_buffer << input_record[j].m_steering << ",";
-
-          ChQuaternion<> temp_qua = rom_vec[focus_idx[j]]->GetRot();
+          auto it = domain.GetVehicles().find(focus_idx[j]);
+          if (it == domain.GetVehicles().end() || k >= input_record.size())
+            continue;
+          const std::shared_ptr<Ch_8DOF_vehicle> &rom = it->second.rom;
+          output_buffer << (rom->GetVel()).Length() << ",";
+
+          output_buffer << input_record[k].m_throttle << ",";
+          output_buffer << input_record[k].m_braking << ",";
+          output_buffer << input_record[k].m_steering << ",";
+          k++;
+
+          ChQuaternion<> temp_qua = rom->GetRot();
           ChVector<> temp_vec = temp_qua.Q_to_Euler123();
           output_buffer << temp_vec.x() << ",";
-          output_buffer << rom_vec[focus_idx[j]]->GetGear() << ",";
-          output_buffer << rom_vec[focus_idx[j]]->GetMotorSpeed() << ",";
+          output_buffer << rom->GetGear() << ",";
+          output_buffer << rom->GetMotorSpeed() << ",";
         }
         output_buffer << std::endl;
 
@@ -427,6 +507,8 @@ int main(int argc, char *argv[]) {
       }
     }
 
+    latency->Update();
+
     // Increment frame number
     step_number++;
   }
@@ -0,0 +1,30 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// Jason Zhou
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Author: Jason Zhou
+// =============================================================================
+// Report of the checks of the HIL tests, one "name: PASSED" or "name: FAILED"
+// line per check
+// =============================================================================
+
+#ifndef CH_HIL_TEST_CHECK_H
+#define CH_HIL_TEST_CHECK_H
+
+#include <iostream>
+#include <string>
+
+/// Print the outcome of check name, returns ok
+inline bool Check(const std::string &name, bool ok) {
+  std::cout << name << ": " << (ok ? "PASSED" : "FAILED") << std::endl;
+  return ok;
+}
+
+#endif
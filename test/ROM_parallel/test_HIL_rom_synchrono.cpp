@@ -15,6 +15,8 @@
 // computation
 // This is the Synchrono side
 // Launch 2 ranks with rank_id as 1 and 2
+// With --rom_dds, no distributor is used: rank 1 simulates the ROMs and
+// publishes them with a SynRomVehicleAgent, over the SynChrono DDS heartbeat
 // =============================================================================
 
 #include <chrono>
@@ -43,6 +45,9 @@
 
 #include "chrono_hil/ROM/driver/ChROM_IDMFollower.h"
 #include "chrono_hil/ROM/driver/ChROM_PathFollowerDriver.h"
+#include "chrono_hil/ROM/syn/ChROM_InterestFilter.h"
+#include "chrono_hil/ROM/syn/ChROM_ZombieManager.h"
+#include "chrono_hil/ROM/syn/SynRomVehicleAgent.h"
 #include "chrono_hil/ROM/syn/Ch_8DOF_zombie.h"
 #include "chrono_hil/ROM/veh/Ch_8DOF_vehicle.h"
 #include "chrono_hil/timer/ChRealtimeCumulative.h"
@@ -73,8 +78,9 @@
 #include "chrono_synchrono/utils/SynDataLoader.h"
 #include "chrono_synchrono/utils/SynLog.h"
 
-#include "chrono_hil/network/tcp/ChTCPClient.h"
-#include "chrono_hil/network/tcp/ChTCPServer.h"
+#include "chrono_hil/network/ChHilCoupler.h"
+#include "chrono_hil/network/ChHilTransport.h"
+#include "chrono_hil/timer/ChSessionClock.h"
 
 #include "chrono_hil/timer/ChRealtimeCumulative.h"
 // =============================================================================
@@ -132,6 +138,21 @@ void AddCommandLineOptions(ChCLI &cli) {
   cli.AddOption<int>("syn", "n,num_nodes", "Number of Nodes", "1");
   cli.AddOption<std::vector<std::string>>(
       "DDS", "ip", "IP Addresses for initialPeersList", "127.0.0.1");
+  cli.AddOption<double>("syn", "r,interest_radius",
+                        "Radius in which ROMs are received", "100.0");
+  cli.AddOption<std::string>(
+      "syn", "t,transport",
+      "URI of the link to the ROM distributor (TCP on port 1203 + node_id "
+      "if empty)",
+      "");
+  cli.AddOption<int>("syn", "k,max_lag",
+                     "Frames the ROM distributor may fall behind before "
+                     "this node waits for it, 0 for lockstep",
+                     "10");
+  cli.AddOption<bool>("syn", "rom_dds",
+                      "Simulate the ROMs on rank 1 and share them over DDS "
+                      "instead of using the ROM distributor",
+                      "false");
 }
 
 int main(int argc, char *argv[]) {
@@ -146,6 +167,10 @@ int main(int argc, char *argv[]) {
   const int num_nodes = cli.GetAsType<int>("num_nodes");
   const std::vector<std::string> ip_list =
       cli.GetAsType<std::vector<std::string>>("ip");
+  const double interest_radius = cli.GetAsType<double>("interest_radius");
+  const std::string transport_uri = cli.GetAsType<std::string>("transport");
+  const bool rom_dds = cli.GetAsType<bool>("rom_dds");
+  const int max_lag = cli.GetAsType<int>("max_lag");
 
   ChSystemSMC my_system;
   my_system.Set_G_acc(ChVector<>(0.0, 0.0, -9.81));
@@ -190,7 +215,6 @@ int main(int argc, char *argv[]) {
 
   // Create the HMMWV vehicle, set parameters, and initialize
   WheeledVehicle my_vehicle((ChSystem *)&my_system, vehicle_filename);
-  std::vector<std::shared_ptr<Ch_8DOF_zombie>> zombie_vec;
 
   auto ego_chassis = my_vehicle.GetChassis();
   my_vehicle.Initialize(ChCoordsys<>(
@@ -218,18 +242,37 @@ int main(int argc, char *argv[]) {
   std::string rom_json =
       std::string(STRINGIFY(HIL_DATA_DIR)) + "/rom/hmmwv/hmmwv_rom.json";
 
-  for (int i = 0; i < num_rom; i++) {
-    auto rom_zombie =
-        chrono_types::make_shared<Ch_8DOF_zombie>(rom_json, init_height);
-    zombie_vec.push_back(rom_zombie);
-    rom_zombie->Initialize(&my_system);
-    std::cout << "zombie: " << i << std::endl;
-  }
+  // zombies are spawned as ROMs enter the interest region of this rank
+  ChROM_ZombieManager zombie_manager(
+      &my_system, [&](int) { return rom_json; }, init_height);
 
   // Add vehicle as an agent and initialize SynChronoManager
   auto agent = chrono_types::make_shared<SynWheeledVehicleAgent>(
       &my_vehicle, zombie_filename);
   syn_manager.AddAgent(agent);
+
+  // ROMs over DDS: rank 1 simulates them, all ranks show the others' ROMs
+  std::vector<std::shared_ptr<Ch_8DOF_vehicle>> rom_vec;
+  std::shared_ptr<SynRomVehicleAgent> rom_agent;
+  if (rom_dds) {
+    rom_agent =
+        chrono_types::make_shared<SynRomVehicleAgent>(communicator, &my_system);
+    if (node_id == 1) {
+      for (int i = 0; i < num_rom; i++) {
+        auto rom_veh = chrono_types::make_shared<Ch_8DOF_vehicle>(
+            rom_json, init_height, step_size);
+        rom_veh->SetInitPos(initLoc +
+                            ChVector<>(0.0, 0.0 + i * 3.0, init_height));
+        rom_veh->SetInitRot(0.0);
+        rom_veh->Initialize(&my_system);
+        rom_agent->AddVehicle(i, rom_veh);
+        rom_vec.push_back(rom_veh);
+      }
+    }
+    rom_agent->SetZombieManager(&zombie_manager, true);
+    syn_manager.AddAgent(rom_agent);
+  }
+
   syn_manager.Initialize(my_vehicle.GetSystem());
 
   // Initialize terrain
@@ -303,37 +346,49 @@ int main(int argc, char *argv[]) {
 
   // create boost data streaming interface
   ChRealtimeCumulative realtime_timer;
-
-  ChTCPClient chrono_1(
-      "127.0.0.1", PORT_IN_1,
-      num_rom * 11); // create a TCP client for rank 1 (may not be used)
-  ChTCPClient chrono_2(
-      "127.0.0.1", PORT_IN_2,
-      num_rom * 11); // create a TCP client for rank 2 (may not be used)
-  ChTCPClient chrono_3(
-      "127.0.0.1", PORT_IN_3,
-      num_rom * 11); // create a TCP client for rank 3 (may not be used)
-
-  if (node_id == 1) {
-    chrono_1.Initialize(); // initialize TCP connection for rank 1
-  } else if (node_id == 2) {
-    std::this_thread::sleep_for(std::chrono::milliseconds(
-        5000)); // wait for 2000 seconds to prevent duplicated connection
-    chrono_2.Initialize(); // initialize TCP connection for rank 2
-  } else if (node_id == 3) {
-    std::this_thread::sleep_for(std::chrono::milliseconds(
-        10000)); // wait for 2000 seconds to prevent duplicated connection
-    chrono_3.Initialize(); // initialize TCP connection for rank 2
+  bool paced = false;
+  double pace_start = 0.0;
+
+  // link to the rom distributor, only used by ranks 1 to 3
+  std::shared_ptr<ChHilTransport> rom_transport;
+  std::shared_ptr<ChHilCoupler> rom_link;
+  // session time of the distributor, which paces the ranks
+  std::shared_ptr<ChSessionClock> session;
+  if (!rom_dds && node_id >= 1 && node_id <= 3) {
+    std::string uri = transport_uri;
+    if (uri.empty())
+      uri = std::string("tcp://") + IP_OUT + ":" +
+            std::to_string(PORT_IN_1 + node_id - 1);
+    rom_transport = ChHilTransport::Create(uri);
+    if (!rom_transport)
+      return 1;
+    session = std::make_shared<ChSessionClock>(false);
+    auto tracker = std::make_shared<ChHilLatencyTracker>(nullptr, "rom");
+    tracker->SetSessionClock(session);
+    rom_transport->SetLatencyTracker(tracker);
+    realtime_timer.SetClock([session]() { return session->GetTime(); });
+    rom_link = std::make_shared<ChHilCoupler>(rom_transport, max_lag);
+    if (!rom_link->Connect(node_id)) // connect to the rom distributor
+      return 1;
   }
 
+  // cost of the ROM exchange, to compare the distributor and DDS paths
+  double rom_sync_time = 0.0;
+  int num_rom_sync = 0;
+
   while (time <= t_end) {
 
     time = my_system.GetChTime();
 
-    if (step_number == 1) {
+    // paced from the first step; a node following the session time of the
+    // distributor starts pacing once that time is known
+    if (!paced && step_number >= 1 &&
+        (!session || session->IsSynchronized())) {
       realtime_timer.Reset();
-    } else if (step_number != 1 && step_number != 0 && node_id == 1) {
-      realtime_timer.Spin(time);
+      pace_start = time;
+      paced = true;
+    } else if (paced && node_id == 1) {
+      realtime_timer.Spin(time - pace_start);
     }
 
     // End simulation
@@ -370,61 +425,59 @@ int main(int argc, char *argv[]) {
     // terrain.Synchronize(time);
 
     // ==================================================
-    // TCP Synchronization Section
+    // ROM Synchronization Section
     // ==================================================
-    // read data from rom distributor 1
-    if (step_number % 10 == 0) {
-      if (node_id == 1) {
-        chrono_1.Read();
-      } else if (node_id == 2) {
-        chrono_2.Read();
-      } else if (node_id == 3) {
-        chrono_3.Read();
-      }
-
+    // read data from rom distributor
+    auto t_rom_0 = std::chrono::steady_clock::now();
+    if (step_number % 10 == 0 && rom_link) {
+      // newest ROM frame of the distributor, if one arrived since the last
+      // exchange; spawn, update and despawn the zombies of interest
       std::vector<float> recv_data;
-      if (node_id == 1) {
-        recv_data = chrono_1.GetRecvData();
-      } else if (node_id == 2) {
-        recv_data = chrono_2.GetRecvData();
-      } else if (node_id == 3) {
-        recv_data = chrono_3.GetRecvData();
-      }
-
-      for (int i = 0; i < num_rom; i++) {
-        zombie_vec[i]->Update(
-            ChVector<>(recv_data[0 + i * 11], recv_data[1 + i * 11],
-                       recv_data[2 + i * 11]),
-            ChVector<>(recv_data[3 + i * 11], recv_data[4 + i * 11],
-                       recv_data[5 + i * 11]),
-            recv_data[6 + i * 11], recv_data[7 + i * 11], recv_data[8 + i * 11],
-            recv_data[9 + i * 11], recv_data[10 + i * 11]);
-      }
+      if (rom_link->Receive(recv_data, time))
+        zombie_manager.ApplyTimed(recv_data, rom_link->GetPeerTime());
 
-      // send data to distributor 1
+      // report the interest region to the distributor
+      ChROM_InterestRegion region;
+      region.pos = my_vehicle.GetChassis()->GetPos();
+      region.radius = interest_radius;
       std::vector<float> data_to_send;
-      data_to_send.push_back(my_vehicle.GetChassis()->GetPos().x());
-      data_to_send.push_back(my_vehicle.GetChassis()->GetPos().y());
-      data_to_send.push_back(my_vehicle.GetChassis()->GetPos().z());
-
-      if (node_id == 1) {
-        chrono_1.Write(data_to_send);
-      } else if (node_id == 2) {
-        chrono_2.Write(data_to_send);
-      } else if (node_id == 3) {
-        chrono_3.Write(data_to_send);
-      }
+      ChROM_InterestFilter::EncodeRegion(region, data_to_send);
+      rom_link->Send(data_to_send, time);
+
+      rom_sync_time += std::chrono::duration<double>(
+                           std::chrono::steady_clock::now() - t_rom_0)
+                           .count();
+      num_rom_sync++;
     }
     // ==================================================
-    // END OF TCP Synchronization Section
+    // END OF ROM Synchronization Section
     // ==================================================
+    zombie_manager.Advance(time);
+
     my_vehicle.Synchronize(time, driver_inputs, terrain);
     my_vehicle.Advance(step_size);
 
+    // the ROMs of rank 1 follow the schedule of the ROM distributor
+    DriverInputs rom_inputs;
+    rom_inputs.m_throttle = (time >= 3.0 && time < 8.0) ? 0.5 : 0.0;
+    rom_inputs.m_braking = (time >= 8.0 && time < 12.0) ? 0.6 : 0.0;
+    rom_inputs.m_steering = 0.0;
+    for (auto &rom_veh : rom_vec)
+      rom_veh->Advance(time, rom_inputs);
+
     terrain.Advance(step_size);
     my_system.DoStepDynamics(step_size);
     if (node_id == 1 || node_id == 2 || node_id == 3) {
+      // with --rom_dds the ROM agent is updated within the heartbeat
+      auto t_syn_0 = std::chrono::steady_clock::now();
       syn_manager.Synchronize(time);
+      if (rom_dds) {
+        rom_sync_time += std::chrono::duration<double>(
+                             std::chrono::steady_clock::now() - t_syn_0)
+                             .count();
+        if (step_number % int(std::round(heartbeat / step_size)) == 0)
+          num_rom_sync++;
+      }
     }
 
     std::cout << "time:" << time << std::endl;
@@ -436,4 +489,29 @@ int main(int argc, char *argv[]) {
     // Increment frame number
     step_number++;
   }
+
+  if (num_rom_sync > 0) {
+    std::cout << (rom_dds ? "DDS heartbeat" : "ROM distributor link")
+              << ": " << 1e6 * rom_sync_time / num_rom_sync
+              << " us per exchange" << std::endl;
+  }
+  if (rom_agent) {
+    std::cout << "ROM batches: sent " << rom_agent->GetNumBatchesSent()
+              << " / " << rom_agent->GetBytesSent() << " bytes, received "
+              << rom_agent->GetNumBatchesReceived() << " / "
+              << rom_agent->GetBytesReceived() << " bytes" << std::endl;
+  } else if (rom_link) {
+    ChHilTransportStats stats = rom_transport->GetStats();
+    std::cout << "ROM frames: received " << stats.frames_received << " / "
+              << stats.bytes_received << " bytes" << std::endl;
+    const ChHilCouplerStats &coupling = rom_link->GetStats();
+    std::cout << "ROM coupling: mean age " << coupling.GetMeanAge()
+              << " s, max age " << coupling.max_age << " s, "
+              << coupling.frames_superseded << " frames superseded, waited "
+              << coupling.waits << " times for " << coupling.wait_time << " s"
+              << std::endl;
+    std::cout << "session clock: offset " << session->GetOffset()
+              << " s, drift " << 1e6 * session->GetDrift() << " ppm, +-"
+              << 1e6 * session->GetUncertainty() << " us" << std::endl;
+  }
 }
@@ -44,6 +44,7 @@
 
 #include "chrono_hil/ROM/driver/ChROM_IDMFollower.h"
 #include "chrono_hil/ROM/driver/ChROM_PathFollowerDriver.h"
+#include "chrono_hil/ROM/syn/ChROM_InterestFilter.h"
 #include "chrono_hil/ROM/syn/Ch_8DOF_zombie.h"
 #include "chrono_hil/ROM/veh/Ch_8DOF_vehicle.h"
 #include "chrono_hil/timer/ChRealtimeCumulative.h"
@@ -74,8 +75,9 @@
 #include "chrono_synchrono/utils/SynDataLoader.h"
 #include "chrono_synchrono/utils/SynLog.h"
 
-#include "chrono_hil/network/tcp/ChTCPClient.h"
-#include "chrono_hil/network/tcp/ChTCPServer.h"
+#include "chrono_hil/network/ChHilCoupler.h"
+#include "chrono_hil/network/ChHilTransport.h"
+#include "chrono_hil/timer/ChSessionClock.h"
 
 #include "chrono_hil/timer/ChRealtimeCumulative.h"
 // =============================================================================
@@ -107,6 +109,24 @@ ChVector<> trackPoint(0.0, 0.0, 1.75);
 // =====================================================
 
 int main(int argc, char *argv[]) {
+  // read from cli
+  ChCLI cli(argv[0]);
+  cli.AddOption<std::vector<std::string>>(
+      "syn", "t,transport", "URIs of the links to the synchrono ranks",
+      "tcp-server://:" + std::to_string(PORT_IN_1) + ",tcp-server://:" +
+          std::to_string(PORT_IN_2) + ",tcp-server://:" +
+          std::to_string(PORT_IN_3));
+  cli.AddOption<int>("syn", "k,max_lag",
+                     "Frames a rank may fall behind before the distributor "
+                     "waits for it, 0 for lockstep",
+                     "10");
+
+  if (!cli.Parse(argc, argv, true))
+    return 0;
+
+  const std::vector<std::string> transport_uris =
+      cli.GetAsType<std::vector<std::string>>("transport");
+  const int max_lag = cli.GetAsType<int>("max_lag");
 
   ChSystemSMC my_system;
   my_system.Set_G_acc(ChVector<>(0.0, 0.0, -9.81));
@@ -174,19 +194,28 @@ int main(int argc, char *argv[]) {
   // create boost data streaming interface
   ChRealtimeCumulative realtime_timer;
 
-  ChTCPServer rom_distributor_1(
-      PORT_IN_1,
-      3); // create the 1st TCP server to send data to synchrono rank 1
-  ChTCPServer rom_distributor_2(
-      PORT_IN_2,
-      3); // creat the 2nd TCP server to send data to synchrono rank 2
-  ChTCPServer rom_distributor_3(
-      PORT_IN_3,
-      3); // creat the 2nd TCP server to send data to synchrono rank 2
+  // one link to each synchrono rank, each rank steps at its own rate. The
+  // distributor holds the session clock the ranks pace against.
+  auto session = std::make_shared<ChSessionClock>(true);
+  std::vector<std::shared_ptr<ChHilCoupler>> rom_links;
+  for (const std::string &uri : transport_uris) {
+    auto transport = ChHilTransport::Create(uri);
+    if (!transport)
+      return 1;
+    auto tracker = std::make_shared<ChHilLatencyTracker>(nullptr, uri);
+    tracker->SetSessionClock(session);
+    transport->SetLatencyTracker(tracker);
+    rom_links.push_back(std::make_shared<ChHilCoupler>(transport, max_lag));
+  }
+
+  // only ROMs within the interest region reported by each rank are sent
+  ChROM_InterestFilter interest_filter(rom_links.size());
 
-  rom_distributor_1.Initialize(); // initialize connection to synchrono rank 1
-  rom_distributor_2.Initialize(); // initialize connection to synchrono rank 2
-  rom_distributor_3.Initialize(); // initialize connection to synchrono rank 2
+  // wait for the connection of each synchrono rank, in any order
+  for (auto &rom_link : rom_links) {
+    if (!rom_link->Connect(0))
+      return 1;
+  }
 
   while (time <= t_end) {
 
@@ -228,58 +257,52 @@ int main(int argc, char *argv[]) {
 
     // Advance simulation for one timestep for all modules
 
-    std::vector<float> data_to_send;
     if (step_number % 10 == 0) {
-      // send data to chrono
+      // gather the state of all ROMs
+      std::vector<ChVector<>> rom_pos_vec;
+      std::vector<float> rom_states;
       for (int i = 0; i < num_rom; i++) {
         ChVector<> rom_pos = rom_vec[i]->GetPos();
         ChQuaternion<> rom_rot = rom_vec[i]->GetRot();
         ChVector<> rom_rot_vec = rom_rot.Q_to_Euler123();
         DriverInputs rom_inputs = rom_vec[i]->GetDriverInputs();
 
-        data_to_send.push_back(rom_pos.x());
-        data_to_send.push_back(rom_pos.y());
-        data_to_send.push_back(rom_pos.z());
-        data_to_send.push_back(rom_rot_vec.x());
-        data_to_send.push_back(rom_rot_vec.y());
-        data_to_send.push_back(rom_rot_vec.z());
-        data_to_send.push_back(rom_inputs.m_steering);
-        data_to_send.push_back(rom_vec[i]->GetTireRotation(0));
-        data_to_send.push_back(rom_vec[i]->GetTireRotation(1));
-        data_to_send.push_back(rom_vec[i]->GetTireRotation(2));
-        data_to_send.push_back(rom_vec[i]->GetTireRotation(3));
+        rom_pos_vec.push_back(rom_pos);
+        rom_states.push_back(rom_pos.x());
+        rom_states.push_back(rom_pos.y());
+        rom_states.push_back(rom_pos.z());
+        rom_states.push_back(rom_rot_vec.x());
+        rom_states.push_back(rom_rot_vec.y());
+        rom_states.push_back(rom_rot_vec.z());
+        rom_states.push_back(rom_inputs.m_steering);
+        rom_states.push_back(rom_vec[i]->GetTireRotation(0));
+        rom_states.push_back(rom_vec[i]->GetTireRotation(1));
+        rom_states.push_back(rom_vec[i]->GetTireRotation(2));
+        rom_states.push_back(rom_vec[i]->GetTireRotation(3));
       }
-      rom_distributor_1.Write(
-          data_to_send); // send rom data to synchrono rank 1
-      rom_distributor_2.Write(
-          data_to_send); // send rom data to synchrono rank 2
-      rom_distributor_3.Write(
-          data_to_send); // send rom data to synchrono rank 3
-
-      // receive data from chrono_1
-      rom_distributor_1.Read();
-      std::vector<float> recv_data_1;
-      recv_data_1 = rom_distributor_1.GetRecvData();
-      for (int i = 0; i < recv_data_1.size(); i++) {
-        std::cout << recv_data_1[i] << ",";
+
+      // take the newest interest region reported by each synchrono rank,
+      // if any arrived
+      std::vector<float> report;
+      for (size_t r = 0; r < rom_links.size(); r++) {
+        if (rom_links[r]->Receive(report, time))
+          interest_filter.SetRegion(r, report);
       }
-      std::cout << std::endl;
 
-      // receive data from chrono_2
-      rom_distributor_2.Read();
-      std::vector<float> recv_data_2;
-      recv_data_2 = rom_distributor_2.GetRecvData();
-      for (int i = 0; i < recv_data_2.size(); i++) {
-        std::cout << recv_data_2[i] << ",";
+      // send the ROMs of interest to each synchrono rank, only waits for a
+      // rank more than max_lag frames behind
+      std::vector<float> data_to_send;
+      for (size_t r = 0; r < rom_links.size(); r++) {
+        interest_filter.BuildFrame(r, rom_pos_vec, rom_states, 11,
+                                   data_to_send);
+        rom_links[r]->Send(data_to_send, time);
       }
-      std::cout << std::endl;
 
-      // receive data from chrono_3
-      rom_distributor_3.Read();
-      std::vector<float> recv_data_3;
-      recv_data_3 = rom_distributor_3.GetRecvData();
-      for (int i = 0; i < recv_data_3.size(); i++) {
-        std::cout << recv_data_3[i] << ",";
+      std::cout << "ROMs of interest / lag [frames] / age [s]:";
+      for (size_t r = 0; r < rom_links.size(); r++) {
+        const ChHilCouplerStats &stats = rom_links[r]->GetStats();
+        std::cout << " " << interest_filter.GetNumActive(r) << "/"
+                  << stats.lag << "/" << stats.age;
       }
       std::cout << std::endl;
     }
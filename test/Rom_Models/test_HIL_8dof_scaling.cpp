@@ -38,6 +38,8 @@
 #include "chrono_hil/ROM/driver/ChROM_IDMFollower.h"
 #include "chrono_hil/ROM/driver/ChROM_PathFollowerDriver.h"
 #include "chrono_hil/ROM/veh/Ch_8DOF_vehicle.h"
+#include "chrono_hil/pipeline/ChRenderMirror.h"
+#include "chrono_hil/pipeline/ChRenderPipeline.h"
 #include "chrono_hil/timer/ChRealtimeCumulative.h"
 
 #include "chrono/core/ChBezierCurve.h"
@@ -46,6 +48,7 @@
 
 #include "chrono/utils/ChUtilsInputOutput.h"
 #include "chrono_hil/timer/ChRealtimeCumulative.h"
+#include "chrono_hil/timer/ChRealtimeMonitor.h"
 #include "chrono_sensor/ChSensorManager.h"
 #include "chrono_sensor/filters/ChFilterAccess.h"
 #include "chrono_sensor/filters/ChFilterCameraNoise.h"
@@ -151,33 +154,48 @@ int main(int argc, char *argv[]) {
   attached_body->SetCollide(false);
   attached_body->SetBodyFixed(true);
 
-  // Create camera
-  // Create the camera sensor
-  auto manager = chrono_types::make_shared<ChSensorManager>(&my_system);
-  float intensity = 1.2;
-  manager->scene->AddPointLight({0, 0, 1e8}, {intensity, intensity, intensity},
-                                1e12);
-  manager->scene->SetAmbientLight({.1, .1, .1});
-  manager->scene->SetSceneEpsilon(1e-3);
-  manager->scene->EnableDynamicOrigin(true);
-  manager->scene->SetOriginOffsetThreshold(500.f);
-
-  auto cam = chrono_types::make_shared<ChCameraSensor>(
-      attached_body, // body camera is attached to
-      35,            // update rate in Hz
-      chrono::ChFrame<double>(
-          ChVector<>(20.0, -35.0, 1.0),
-          Q_from_Euler123(ChVector<>(0.0, 0.0, C_PI / 2))), // offset pose
-      1920,                                                 // image width
-      1080,                                                 // image
-      1.608f, 1); // fov, lag, exposure cam->SetName("Camera Sensor");
-
-  cam->PushFilter(
-      chrono_types::make_shared<ChFilterVisualize>(1920, 1080, "test", false));
-  // Provide the host access to the RGBA8 buffer
-  // cam->PushFilter(chrono_types::make_shared<ChFilterRGBA8Access>());
-  manager->AddSensor(cam);
-  // manager->Update();
+  // The sensors render a mirror of the bodies in their own system, on a
+  // render thread one frame behind the dynamics
+  ChSystemSMC render_system;
+  ChRenderPipeline pipeline;
+  ChRenderMirror mirror(pipeline, &render_system);
+  mirror.AddSystem(&my_system);
+  auto attached_mirror = mirror.AddBody(attached_body);
+
+  // Create the camera sensor, on the render thread which owns its context
+  std::shared_ptr<ChSensorManager> manager;
+  pipeline.SetInit([&]() {
+    manager = chrono_types::make_shared<ChSensorManager>(&render_system);
+    float intensity = 1.2;
+    manager->scene->AddPointLight({0, 0, 1e8},
+                                  {intensity, intensity, intensity}, 1e12);
+    manager->scene->SetAmbientLight({.1, .1, .1});
+    manager->scene->SetSceneEpsilon(1e-3);
+    manager->scene->EnableDynamicOrigin(true);
+    manager->scene->SetOriginOffsetThreshold(500.f);
+
+    auto cam = chrono_types::make_shared<ChCameraSensor>(
+        attached_mirror, // body camera is attached to
+        35,              // update rate in Hz
+        chrono::ChFrame<double>(
+            ChVector<>(20.0, -35.0, 1.0),
+            Q_from_Euler123(ChVector<>(0.0, 0.0, C_PI / 2))), // offset pose
+        1920,                                                 // image width
+        1080,                                                 // image
+        1.608f, 1); // fov, lag, exposure cam->SetName("Camera Sensor");
+
+    cam->PushFilter(chrono_types::make_shared<ChFilterVisualize>(
+        1920, 1080, "test", false));
+    // Provide the host access to the RGBA8 buffer
+    // cam->PushFilter(chrono_types::make_shared<ChFilterRGBA8Access>());
+    manager->AddSensor(cam);
+  });
+  pipeline.AddConsumer(
+      [&](const ChPoseSnapshot &snapshot) { mirror.Apply(snapshot); });
+  pipeline.AddConsumer(
+      [&](const ChPoseSnapshot &snapshot) { manager->Update(); });
+  pipeline.SetExit([&]() { manager.reset(); });
+  pipeline.Start();
 
   // Set the time response for steering and throttle keyboard inputs.
   double steering_time = 1.0; // time to go from 0 to +1 (or from 0 to -1)
@@ -197,8 +215,11 @@ int main(int argc, char *argv[]) {
 
   t_end = 14.0;
 
-  auto tt_0 = std::chrono::high_resolution_clock::now();
-  double start_time;
+  // RTF, frame time and phase summary every 2 s of wall time
+  ChRealtimeMonitor monitor(step_size);
+  int dynamics_phase = monitor.AddPhase("dynamics");
+  int publish_phase = monitor.AddPhase("publish");
+  monitor.SetPrint(2.0);
 
   while (time <= t_end) {
 
@@ -234,31 +255,28 @@ int main(int argc, char *argv[]) {
     // terrain.Synchronize(time);
 
     // Advance simulation for one timestep for all modules
+    monitor.BeginPhase(dynamics_phase);
     for (int i = 0; i < num_rom; i++) {
       rom_vec[i]->Advance(time, driver_inputs);
     }
     terrain.Advance(step_size);
     my_system.DoStepDynamics(step_size);
 
-    manager->Update();
+    monitor.BeginPhase(publish_phase);
+    pipeline.Publish(my_system.GetChTime());
 
-    if (step_number == 0) {
-      auto tt_1 = std::chrono::high_resolution_clock::now();
-      start_time =
-          std::chrono::duration_cast<std::chrono::duration<double>>(tt_1 - tt_0)
-              .count();
-    }
-
-    if (step_number != 0 && step_number % 2000 == 0) {
-      auto tt_2 = std::chrono::high_resolution_clock::now();
-      auto wall_time =
-          std::chrono::duration_cast<std::chrono::duration<double>>(tt_2 - tt_0)
-              .count() -
-          start_time;
-      std::cout << "RTF: " << wall_time / time << std::endl;
-    }
+    // the first step includes the start up of the render thread
+    monitor.EndFrame(my_system.GetChTime());
+    if (step_number == 0)
+      monitor.Reset(my_system.GetChTime());
 
     // Increment frame number
     step_number++;
   }
+
+  pipeline.Stop();
+  std::cout << "render: " << pipeline.GetNumConsumed() << " frames, "
+            << pipeline.GetNumSkipped() << " skipped, latency p99 "
+            << 1e3 * pipeline.GetLatency().GetPercentile(99.0) << " ms"
+            << std::endl;
 }
\ No newline at end of file
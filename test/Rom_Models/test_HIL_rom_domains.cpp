@@ -0,0 +1,410 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// Jason Zhou
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Authors: Jason Zhou
+// =============================================================================
+//
+// Check of the ROM traffic domains: two lanes of IDM-driven ROMs cross three
+// domains split along x, one process per domain (ChHilNetHarness::RunForked)
+// linked by shared-memory transports. ROMs migrate with their full state,
+// and follow leaders owned by the next domain through the halo.
+//
+// The same scenario is first run in a single domain. At every step, each
+// domain compares the state of the ROMs it owns bit for bit with the single
+// domain trajectory, which the processes inherit from the parent. The
+// domains report their ROM counts through a shared mapping:
+//   identical   all domains follow the single domain trajectory, every ROM
+//               is owned by exactly one domain at every step, ROMs migrate,
+//               no leader goes missing and the halo shows the ROMs of the
+//               neighbours with their pose in the single domain trajectory
+//   balanced    the same with load balancing, timing each domain with its
+//               thread CPU clock: the boundaries follow the ROMs, giving a
+//               lower ROM count in the most loaded domain
+//
+//   loop        a ring of ROMs on a closed path, split in two domains across
+//               its center: the ROMs drive on along the ring past the end of
+//               its first lap, and the two domains follow the single domain
+//               trajectory
+//
+// The traffic starts in the first two domains and drives into the third.
+//
+// =============================================================================
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <new>
+#include <vector>
+
+#include <sys/mman.h>
+#include <time.h>
+
+#include "chrono/core/ChBezierCurve.h"
+#include "chrono/physics/ChSystemSMC.h"
+
+#include "chrono_hil/ROM/syn/ChROM_DomainPartition.h"
+#include "chrono_hil/ROM/syn/ChROM_TrafficDomain.h"
+#include "chrono_hil/network/ChHilNetHarness.h"
+#include "test/ChHilTestCheck.h"
+
+using namespace chrono;
+using namespace chrono::hil;
+
+#define NUM_DOMAINS 3
+#define NUM_LANES 2
+#define NUM_PER_LANE 8
+#define NUM_ROMS (NUM_LANES * NUM_PER_LANE)
+#define SPACING 12.0
+#define LANE_WIDTH 4.0
+#define STEP_SIZE 2e-3
+#define NUM_STEPS 6000
+#define BALANCE_PERIOD 250
+#define RING_ROMS 4
+#define RING_RADIUS 15.0
+#define RING_POINTS 24
+#define RING_STEPS 12000
+#define RING_LAPS 1.25
+#define RING_OFF_PATH 2.0
+#define MAX_STEPS RING_STEPS
+
+std::string rom_json =
+    std::string(STRINGIFY(HIL_DATA_DIR)) + "/rom/sedan/sedan_rom.json";
+
+// the straight lanes, or the ring around the origin
+struct Scenario {
+  bool ring;
+  int num_roms;
+  int num_steps;
+};
+
+const Scenario lanes = {false, NUM_ROMS, NUM_STEPS};
+const Scenario ring = {true, RING_ROMS, RING_STEPS};
+
+// polar angle of ROM id on the ring
+double RingAngle(int id) { return id * CH_C_2PI / RING_ROMS; }
+
+// ROM id starts in lane id / NUM_PER_LANE, behind the next ROM of its lane,
+// or on the ring behind ROM id + 1
+ChVector<> InitPos(const Scenario &scenario, int id) {
+  if (scenario.ring)
+    return ChVector<>(RING_RADIUS * std::cos(RingAngle(id)),
+                      RING_RADIUS * std::sin(RingAngle(id)), 0.5);
+  return ChVector<>((id % NUM_PER_LANE) * SPACING,
+                    (id / NUM_PER_LANE) * LANE_WIDTH, 0.5);
+}
+
+// ROM id follows the next ROM of its lane, the first ROM of each lane has a
+// free road; on the ring, every ROM follows the next one counterclockwise
+ChROM_TrafficVehicle MakeVehicle(const Scenario &scenario, int id,
+                                 ChSystem *system) {
+  ChROM_TrafficVehicle vehicle;
+  vehicle.id = id;
+  vehicle.rom = chrono_types::make_shared<Ch_8DOF_vehicle>(rom_json, 0.5,
+                                                          STEP_SIZE, true);
+  vehicle.rom->SetInitPos(InitPos(scenario, id));
+
+  std::vector<ChVector<>> points;
+  std::shared_ptr<ChBezierCurve> path;
+  if (scenario.ring) {
+    vehicle.leader_id = (id + 1) % RING_ROMS;
+    vehicle.rom->SetInitRot(RingAngle(id) + CH_C_PI_2);
+    for (int i = 0; i < RING_POINTS; i++) {
+      double angle = i * CH_C_2PI / RING_POINTS;
+      points.push_back(ChVector<>(RING_RADIUS * std::cos(angle),
+                                  RING_RADIUS * std::sin(angle), 0.5));
+    }
+    path = chrono_types::make_shared<ChBezierCurve>(points, true);
+  } else {
+    int k = id % NUM_PER_LANE;
+    double y = InitPos(scenario, id).y();
+    vehicle.leader_id = k + 1 < NUM_PER_LANE ? id + 1 : -1;
+    vehicle.rom->SetInitRot(0.0);
+    for (int i = 0; i < 30; i++)
+      points.push_back(ChVector<>(-50.0 + 25.0 * i, y, 0.5));
+    path = chrono_types::make_shared<ChBezierCurve>(points);
+  }
+  vehicle.rom->Initialize(system);
+
+  vehicle.driver = chrono_types::make_shared<ChROM_PathFollowerDriver>(
+      vehicle.rom, path, 6.0, scenario.ring ? 5.0 : 10.0, 0.3, 0.0, 0.0, 0.5,
+      0.0, 0.0);
+
+  std::vector<double> params = {10.0, 0.1, 5.0, 3.5, 2.5, 4.0, 6.0};
+  vehicle.idm = chrono_types::make_shared<ChROM_IDMFollower>(
+      vehicle.rom, vehicle.driver, params);
+  vehicle.idm->SetSto(true, 0.5, 0.5, 0.2, 0.2);
+  vehicle.idm->SetSeed(id);
+  return vehicle;
+}
+
+// CPU time of the calling thread [s]
+double ThreadTime() {
+  timespec t;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &t);
+  return t.tv_sec + 1e-9 * t.tv_nsec;
+}
+
+// states of all ROMs at the end of each step, by step then id
+typedef std::vector<std::vector<Ch_8DOF_state>> Trajectory;
+
+// bit for bit the same ROM state
+bool SameState(const Ch_8DOF_state &a, const Ch_8DOF_state &b) {
+  bool same = a.veh.m_x == b.veh.m_x && a.veh.m_y == b.veh.m_y &&
+              a.veh.m_u == b.veh.m_u && a.veh.m_v == b.veh.m_v &&
+              a.veh.m_psi == b.veh.m_psi && a.veh.m_wz == b.veh.m_wz &&
+              a.veh.m_motor_speed == b.veh.m_motor_speed;
+  for (int w = 0; w < 4; w++)
+    same = same && a.tires[w].m_omega == b.tires[w].m_omega;
+  return same;
+}
+
+// written by the domain processes, read by the parent once they are done
+struct SharedResults {
+  int counts[NUM_DOMAINS][MAX_STEPS]; // ROMs owned at each step
+  uint64_t migrations[NUM_DOMAINS];
+  uint64_t rebalances[NUM_DOMAINS];
+};
+
+// pose of a ghost, taken at the beginning of a step, the same as at the end
+// of the previous step in reference
+bool SameGhost(const ChROM_Ghost &ghost, const Ch_8DOF_state &reference) {
+  ChQuaternion<> rot;
+  rot.Q_from_Euler123(ChVector<>(reference.veh.m_phi, 0, reference.veh.m_psi));
+  return ghost.pos.x() == reference.veh.m_x &&
+         ghost.pos.y() == reference.veh.m_y && ghost.rot == rot;
+}
+
+// one domain, stepped by the harness; compares its ROMs and its halo with
+// reference at every step if there is one, records the trajectory otherwise
+class DomainEndpoint : public ChHilNetEndpoint {
+public:
+  DomainEndpoint(const Scenario &scenario,
+                 const ChROM_DomainPartition &partition, int rank,
+                 const std::string &prefix, bool balance,
+                 const Trajectory *reference, SharedResults *results)
+      : m_scenario(scenario), m_partition(partition), m_rank(rank),
+        m_prefix(prefix), m_balance(balance), m_reference(reference),
+        m_results(results) {}
+
+  virtual void Initialize(ChHilNetHarness &harness) override {
+    m_domain = std::make_unique<ChROM_TrafficDomain>(
+        m_partition, m_rank, &m_system,
+        [this](int id) { return MakeVehicle(m_scenario, id, &m_system); });
+    // domain r serves the link to domain r + 1
+    if (m_rank > 0)
+      m_domain->AddLink(m_rank - 1, harness.Open("shm://" + m_prefix +
+                                                 std::to_string(m_rank - 1)));
+    if (m_rank + 1 < m_partition.GetNumDomains())
+      m_domain->AddLink(m_rank + 1, harness.Open("shm-server://" + m_prefix +
+                                                 std::to_string(m_rank)));
+    m_domain->SetHaloWidth(40.0);
+    if (m_balance) {
+      m_domain->EnableBalancing(BALANCE_PERIOD);
+      m_domain->SetCostClock(ThreadTime);
+    }
+
+    // each domain only builds the ROMs starting in its region
+    for (int id = 0; id < m_scenario.num_roms; id++) {
+      if (m_partition.GetOwner(InitPos(m_scenario, id)) == m_rank)
+        m_domain->AddVehicle(MakeVehicle(m_scenario, id, &m_system));
+    }
+    m_domain->Initialize();
+  }
+
+  // the harness time follows the wall clock in a forked run, the domain
+  // steps on its own count to stay on the time of the single domain
+  virtual void Advance(double time) override {
+    if (m_step >= m_scenario.num_steps)
+      return;
+    m_domain->Advance(m_step * STEP_SIZE, STEP_SIZE);
+
+    Ch_8DOF_state state;
+    if (!m_reference)
+      m_trajectory.emplace_back(m_scenario.num_roms);
+    for (auto &entry : m_domain->GetVehicles()) {
+      entry.second.rom->GetState(state);
+      if (!m_reference)
+        m_trajectory.back()[entry.first] = state;
+      else if (!SameState(state, (*m_reference)[m_step][entry.first]))
+        m_mismatches++;
+    }
+    if (m_reference && m_step > 0) {
+      for (auto &entry : m_domain->GetGhosts()) {
+        if (!SameGhost(entry.second, (*m_reference)[m_step - 1][entry.first]))
+          m_mismatches++;
+      }
+    }
+    if (m_results)
+      m_results->counts[m_rank][m_step] =
+          static_cast<int>(m_domain->GetVehicles().size());
+    m_step++;
+  }
+
+  virtual bool Check() override {
+    if (m_results) {
+      m_results->migrations[m_rank] = m_domain->GetNumMigratedIn();
+      m_results->rebalances[m_rank] = m_domain->GetNumRebalances();
+    }
+    std::cout << "domain " << m_rank << ": "
+              << m_domain->GetVehicles().size() << " ROMs at the end, "
+              << m_domain->GetNumMigratedIn() << " migrated in, "
+              << m_mismatches << " states off the single domain, "
+              << m_domain->GetNumMissingLeaders() << " missing leaders"
+              << std::endl;
+    return m_step == m_scenario.num_steps && m_mismatches == 0 &&
+           m_domain->GetNumMissingLeaders() == 0;
+  }
+
+  const Trajectory &GetTrajectory() const { return m_trajectory; }
+
+private:
+  Scenario m_scenario;
+  ChROM_DomainPartition m_partition;
+  int m_rank;
+  std::string m_prefix;
+  bool m_balance;
+  const Trajectory *m_reference;
+  SharedResults *m_results;
+
+  ChSystemSMC m_system;
+  std::unique_ptr<ChROM_TrafficDomain> m_domain;
+  int m_step = 0;
+  uint64_t m_mismatches = 0;
+  Trajectory m_trajectory;
+};
+
+// runs the scenario in the domains cut at x_cuts, one process each; returns
+// the ROM count of the most loaded domain, averaged over the steps, negative
+// on failure
+double RunSplit(const Scenario &scenario, const std::vector<double> &x_cuts,
+                const std::string &prefix, const Trajectory &reference,
+                bool balance, double &seconds) {
+  ChROM_DomainPartition partition(x_cuts);
+  int num_domains = partition.GetNumDomains();
+
+  void *shared = mmap(nullptr, sizeof(SharedResults), PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_ANONYMOUS, -1, 0);
+  if (shared == MAP_FAILED)
+    return -1.0;
+  SharedResults *results = new (shared) SharedResults();
+
+  ChHilNetHarness harness(STEP_SIZE);
+  for (int r = 0; r < num_domains; r++)
+    harness.AddEndpoint("domain " + std::to_string(r),
+                        std::make_shared<DomainEndpoint>(
+                            scenario, partition, r, prefix, balance,
+                            &reference, results));
+
+  auto t_0 = std::chrono::steady_clock::now();
+  bool passed = harness.RunForked(scenario.num_steps);
+  seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                          t_0)
+                .count();
+
+  // every ROM owned by exactly one domain at every step
+  double mean_max = 0.0;
+  for (int step = 0; step < scenario.num_steps; step++) {
+    int max_count = 0, total = 0;
+    for (int r = 0; r < num_domains; r++) {
+      max_count = std::max(max_count, results->counts[r][step]);
+      total += results->counts[r][step];
+    }
+    passed = passed && total == scenario.num_roms;
+    mean_max += max_count;
+  }
+  mean_max /= scenario.num_steps;
+
+  uint64_t migrations = 0, rebalances = 0;
+  for (int r = 0; r < num_domains; r++) {
+    migrations += results->migrations[r];
+    rebalances += results->rebalances[r];
+  }
+  std::cout << migrations << " migrations, " << rebalances
+            << " boundary moves, " << mean_max
+            << " ROMs in the most loaded domain" << std::endl;
+  passed = passed && migrations > 0 && (!balance || rebalances > 0);
+
+  munmap(shared, sizeof(SharedResults));
+  return passed ? mean_max : -1.0;
+}
+
+// runs the scenario with all ROMs in one domain, recording its trajectory
+bool RunSingle(const Scenario &scenario, Trajectory &trajectory) {
+  auto single = std::make_shared<DomainEndpoint>(
+      scenario, ChROM_DomainPartition(), 0, "", false, nullptr, nullptr);
+  ChHilNetHarness harness(STEP_SIZE);
+  harness.AddEndpoint("single domain", single);
+  bool passed = harness.RunLockstep(scenario.num_steps);
+  trajectory = single->GetTrajectory();
+  return passed;
+}
+
+// every ROM of the ring trajectory turns more than RING_LAPS around the
+// origin and ends on the ring
+bool DrivesLoop(const Trajectory &trajectory) {
+  bool passed = true;
+  for (int id = 0; id < RING_ROMS; id++) {
+    double turned = 0.0;
+    for (size_t step = 1; step < trajectory.size(); step++) {
+      const auto &a = trajectory[step - 1][id].veh;
+      const auto &b = trajectory[step][id].veh;
+      double delta = std::atan2(b.m_y, b.m_x) - std::atan2(a.m_y, a.m_x);
+      turned += std::remainder(delta, CH_C_2PI);
+    }
+    const auto &end = trajectory.back()[id].veh;
+    double off_path = std::abs(std::hypot(end.m_x, end.m_y) - RING_RADIUS);
+    std::cout << "ring ROM " << id << ": " << turned / CH_C_2PI
+              << " laps, ends " << off_path << " m off the ring" << std::endl;
+    passed = passed && turned > RING_LAPS * CH_C_2PI &&
+             off_path < RING_OFF_PATH;
+  }
+  return passed;
+}
+
+int main(int argc, char *argv[]) {
+  // reference, all ROMs in one domain
+  auto t_0 = std::chrono::steady_clock::now();
+  Trajectory reference;
+  bool single_ok = RunSingle(lanes, reference);
+  double single_seconds = std::chrono::duration<double>(
+                              std::chrono::steady_clock::now() - t_0)
+                              .count();
+
+  // three strips along x, each linked to its neighbours
+  double split_seconds, balanced_seconds, ring_seconds;
+  double split_max = RunSplit(lanes, {40.0, 100.0}, "hil_domain_", reference,
+                              false, split_seconds);
+  bool ok = Check("identical", single_ok && split_max >= 0.0);
+
+  // same strips, moving with the load
+  double balanced_max = RunSplit(lanes, {40.0, 100.0}, "hil_balanced_",
+                                 reference, true, balanced_seconds);
+  ok = Check("balanced", single_ok && balanced_max >= 0.0 &&
+                             split_max >= 0.0 && balanced_max < split_max) &&
+       ok;
+
+  // the ring, in one domain then in two halves across its center
+  Trajectory ring_reference;
+  bool ring_ok = RunSingle(ring, ring_reference) && DrivesLoop(ring_reference);
+  ring_ok = RunSplit(ring, {0.0}, "hil_ring_", ring_reference, false,
+                     ring_seconds) >= 0.0 &&
+            ring_ok;
+  ok = Check("loop", ring_ok) && ok;
+
+  std::cout << "single domain " << single_seconds << " s, " << NUM_DOMAINS
+            << " domains " << split_seconds << " s, balanced "
+            << balanced_seconds << " s, ring in 2 domains " << ring_seconds
+            << " s" << std::endl;
+  return ok ? 0 : 1;
+}
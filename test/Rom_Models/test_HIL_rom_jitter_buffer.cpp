@@ -0,0 +1,137 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// Jason Zhou
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Authors: Jason Zhou
+// =============================================================================
+//
+// Check of the ROM jitter buffer: a ROM driving on a circle sends its state
+// every 40 ms, states arrive with up to 20 ms of jitter, some are lost, and
+// one 150 ms outage happens. The pose shown at render rate is compared with
+// the true trajectory, and with showing the last received state.
+//
+// =============================================================================
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "chrono_hil/ROM/syn/ChROM_SnapshotBuffer.h"
+
+using namespace chrono;
+using namespace chrono::hil;
+
+#define RADIUS 30.0
+#define SPEED 15.0
+#define WHEEL_RADIUS 0.4
+#define SEND_PERIOD 0.04
+#define MAX_JITTER 0.02
+#define RENDER_STEP 0.01
+#define PLAYOUT_DELAY 0.06
+#define T_END 20.0
+
+ChROM_Snapshot Truth(double t) {
+  double a = SPEED / RADIUS * t;
+  ChROM_Snapshot s;
+  s.pos = ChVector<>(RADIUS * std::sin(a), RADIUS * (1.0 - std::cos(a)), 0.5);
+  // yaw reported in [-pi, pi), wheel phase in [0, 2 pi), as sent by the ROM
+  s.rot = ChVector<>(0.0, 0.0, std::remainder(a, 2.0 * M_PI));
+  for (int w = 0; w < 4; w++)
+    s.tire_rot[w] = std::fmod(SPEED / WHEEL_RADIUS * t, 2.0 * M_PI);
+  return s;
+}
+
+int main(int argc, char *argv[]) {
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<double> jitter(0.0, MAX_JITTER);
+
+  ChROM_SnapshotBuffer buffer(PLAYOUT_DELAY);
+
+  // arrival time and send time of every state which gets through
+  std::vector<std::pair<double, double>> arrivals;
+  for (int k = 0; k * SEND_PERIOD < T_END; k++) {
+    double t_send = k * SEND_PERIOD;
+    if (k % 25 == 7)
+      continue; // lost
+    if (t_send > 10.0 && t_send < 10.15)
+      continue; // outage
+    arrivals.push_back({t_send + jitter(rng), t_send});
+  }
+
+  size_t next = 0;
+  ChROM_Snapshot last_received;
+  bool received = false;
+
+  double max_err = 0.0, sum_err2 = 0.0;
+  double max_err_snap = 0.0, sum_err2_snap = 0.0;
+  double max_jump = 0.0, max_jump_snap = 0.0;
+  int num_samples = 0;
+  int num_reversals = 0;
+
+  ChROM_Snapshot prev, prev_snap;
+  bool has_prev = false;
+  for (double t = 0.0; t < T_END; t += RENDER_STEP) {
+    while (next < arrivals.size() && arrivals[next].first <= t) {
+      double t_send = arrivals[next].second;
+      buffer.Push(t_send, Truth(t_send));
+      last_received = Truth(t_send);
+      received = true;
+      next++;
+    }
+
+    ChROM_Snapshot out;
+    if (!buffer.Sample(t, out) || t < 2.0 * PLAYOUT_DELAY)
+      continue;
+
+    // the buffer shows the past on purpose, compare with the state it aims
+    // at; showing the last received state aims at the present
+    double err = (out.pos - Truth(t - PLAYOUT_DELAY).pos).Length();
+    double err_snap = (last_received.pos - Truth(t).pos).Length();
+    max_err = std::max(max_err, err);
+    max_err_snap = std::max(max_err_snap, err_snap);
+    sum_err2 += err * err;
+    sum_err2_snap += err_snap * err_snap;
+    num_samples++;
+
+    if (has_prev) {
+      // render-to-render motion, the true motion is SPEED * RENDER_STEP
+      max_jump = std::max(max_jump, (out.pos - prev.pos).Length());
+      max_jump_snap =
+          std::max(max_jump_snap, (last_received.pos - prev_snap.pos).Length());
+      for (int w = 0; w < 4; w++)
+        num_reversals += out.tire_rot[w] < prev.tire_rot[w];
+    }
+    prev = out;
+    prev_snap = last_received;
+    has_prev = received;
+  }
+
+  double rms = std::sqrt(sum_err2 / num_samples);
+  double rms_snap = std::sqrt(sum_err2_snap / num_samples);
+  std::cout << "true motion per render step: " << SPEED * RENDER_STEP << " m"
+            << std::endl;
+  std::cout << "last received state: rms error " << rms_snap << " m, max "
+            << max_err_snap << " m, max jump " << max_jump_snap << " m"
+            << std::endl;
+  std::cout << "jitter buffer:       rms error " << rms << " m, max "
+            << max_err << " m, max jump " << max_jump << " m" << std::endl;
+  std::cout << "samples interpolated " << buffer.GetNumInterpolated()
+            << ", extrapolated " << buffer.GetNumExtrapolated() << ", held "
+            << buffer.GetNumHeld() << ", wheel reversals " << num_reversals
+            << std::endl;
+
+  bool passed = rms < 0.01 && max_err < 0.5 &&
+                max_jump < 2.0 * SPEED * RENDER_STEP && num_reversals == 0;
+  std::cout << "jitter buffer: " << (passed ? "PASSED" : "FAILED")
+            << std::endl;
+  return passed ? 0 : 1;
+}
@@ -0,0 +1,120 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// Jason Zhou
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Authors: Jason Zhou
+// =============================================================================
+//
+// Check of the compact ROM state batch used by SynRomVehicleAgent: round trip
+// accuracy, rejection of damaged batches, and size and encoding cost against
+// the float frame sent by the ROM distributor.
+//
+// =============================================================================
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <random>
+
+#include "chrono_hil/ROM/syn/ChROM_StateBatch.h"
+
+using namespace chrono;
+using namespace chrono::hil;
+
+#define NUM_ROM 500
+#define NUM_REPEAT 2000
+
+// difference of two angles, in [-pi, pi)
+double AngleDiff(double a, double b) {
+  return std::remainder(a - b, 2.0 * M_PI);
+}
+
+int main(int argc, char *argv[]) {
+  std::mt19937 rng(7);
+  std::uniform_real_distribution<double> uniform(-1.0, 1.0);
+
+  ChROM_StateBatch batch;
+  batch.time = 12.345;
+  batch.source = 3;
+  batch.states.resize(NUM_ROM);
+  for (int i = 0; i < NUM_ROM; i++) {
+    ChROM_State &s = batch.states[i];
+    s.id = 1000 + i;
+    s.pos = ChVector<>(500.0 * uniform(rng), 500.0 * uniform(rng),
+                       0.5 + 0.1 * uniform(rng));
+    // yaw beyond +-pi, wheel phases accumulated over many turns
+    s.rot = ChVector<>(0.1 * uniform(rng), 0.1 * uniform(rng),
+                       10.0 * uniform(rng));
+    s.steering = uniform(rng);
+    for (int w = 0; w < 4; w++)
+      s.tire_rot[w] = 1000.0 * (uniform(rng) + 1.0);
+  }
+
+  std::vector<uint8_t> buffer;
+  batch.Encode(buffer);
+
+  ChROM_StateBatch decoded;
+  bool ok = decoded.Decode(buffer.data(), buffer.size()) &&
+            decoded.time == batch.time && decoded.source == batch.source &&
+            decoded.states.size() == batch.states.size();
+
+  double max_pos = 0.0, max_angle = 0.0, max_steering = 0.0, max_phase = 0.0;
+  for (int i = 0; ok && i < NUM_ROM; i++) {
+    const ChROM_State &a = batch.states[i];
+    const ChROM_State &b = decoded.states[i];
+    ok = ok && a.id == b.id;
+    max_pos = std::max(max_pos, (a.pos - b.pos).Length());
+    max_angle = std::max(max_angle, std::abs(AngleDiff(a.rot.x(), b.rot.x())));
+    max_angle = std::max(max_angle, std::abs(AngleDiff(a.rot.y(), b.rot.y())));
+    max_angle = std::max(max_angle, std::abs(AngleDiff(a.rot.z(), b.rot.z())));
+    max_steering =
+        std::max(max_steering, (double)std::abs(a.steering - b.steering));
+    for (int w = 0; w < 4; w++)
+      max_phase = std::max(max_phase,
+                           std::abs(AngleDiff(a.tire_rot[w], b.tire_rot[w])));
+  }
+  std::cout << "max error: pos " << max_pos << " m, angle " << max_angle
+            << " rad, steering " << max_steering << ", wheel phase "
+            << max_phase << " rad" << std::endl;
+
+  bool accurate = ok && max_pos < 1e-4 && max_angle < 1e-4 &&
+                  max_steering < 1e-4 && max_phase < 1e-4;
+  std::cout << "round trip: " << (accurate ? "PASSED" : "FAILED") << std::endl;
+
+  // damaged batches are rejected and leave the batch untouched
+  ChROM_StateBatch other;
+  std::vector<uint8_t> bad = buffer;
+  bad[0] ^= 0xFF;
+  bool rejected = !other.Decode(bad.data(), bad.size()) &&
+                  !other.Decode(buffer.data(), buffer.size() - 1) &&
+                  !other.Decode(buffer.data(), 4) && other.states.empty();
+  std::cout << "damaged batches: " << (rejected ? "PASSED" : "FAILED")
+            << std::endl;
+
+  // size and cost against the float frame of the distributor, which holds
+  // 3 counters and (id + 11 floats) per ROM
+  size_t frame_bytes = (3 + NUM_ROM * 12) * sizeof(float);
+  std::cout << NUM_ROM << " ROMs: batch " << buffer.size() << " bytes, float "
+            << "frame " << frame_bytes << " bytes ("
+            << 100.0 * buffer.size() / frame_bytes << "%)" << std::endl;
+
+  auto t_0 = std::chrono::steady_clock::now();
+  for (int r = 0; r < NUM_REPEAT; r++) {
+    batch.Encode(buffer);
+    decoded.Decode(buffer.data(), buffer.size());
+  }
+  double seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - t_0)
+                       .count();
+  std::cout << "encode + decode: " << 1e9 * seconds / (NUM_REPEAT * NUM_ROM)
+            << " ns per ROM" << std::endl;
+
+  return (accurate && rejected) ? 0 : 1;
+}
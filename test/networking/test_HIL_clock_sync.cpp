@@ -0,0 +1,126 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// Jason Zhou
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Author: Jason Zhou
+// =============================================================================
+// Check of the session clock. A master and a node exchange one frame per
+// millisecond over a loopback link delaying frames by 1 ms plus up to 0.5 ms
+// of jitter. The clock of the node starts 7 s ahead and runs 500 ppm fast.
+// After a few seconds the node must estimate the drift and read the same
+// session time as the master, much closer than a one-time offset would give,
+// and its session time must never go backwards. Before its first sample,
+// the node reads its time since its first reading, not the 7 s of its clock.
+// =============================================================================
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <thread>
+
+#include "chrono_hil/network/ChHilTransport.h"
+#include "chrono_hil/timer/ChSessionClock.h"
+#include "test/ChHilTestCheck.h"
+
+using namespace chrono;
+using namespace chrono::hil;
+
+#define NUM_STEPS 6000
+#define STEP_TIME 0.001
+#define CLOCK_OFFSET 7.0
+#define CLOCK_SKEW 500e-6
+
+// one end of the link, exchanges empty frames
+void RunEnd(std::shared_ptr<ChHilTransport> link,
+            std::shared_ptr<ChSessionClock> session, bool &monotonic) {
+  link->Initialize();
+  auto t_0 = std::chrono::steady_clock::now();
+  std::vector<float> frame;
+  int64_t last = INT64_MIN;
+  for (int step = 0; step < NUM_STEPS; step++) {
+    std::this_thread::sleep_until(
+        t_0 + std::chrono::duration<double>((step + 1) * STEP_TIME));
+    while (link->PollFrame(frame, false)) {
+    }
+    link->SendFrame({static_cast<float>(step)});
+
+    if (session->IsSynchronized()) {
+      int64_t now = session->GetSessionNs();
+      if (last != INT64_MIN)
+        monotonic = monotonic && now >= last;
+      last = now;
+    }
+  }
+}
+
+int main(int argc, char *argv[]) {
+  auto master = std::make_shared<ChSessionClock>(true);
+  auto node = std::make_shared<ChSessionClock>(false);
+  auto t_0 = std::chrono::steady_clock::now();
+  node->SetLocalClock([t_0]() {
+    double t = std::chrono::duration<double>(
+                   std::chrono::steady_clock::now() - t_0)
+                   .count();
+    return static_cast<int64_t>(1e9 * (CLOCK_OFFSET + t * (1 + CLOCK_SKEW)));
+  });
+
+  // nothing received yet
+  int64_t unsynced = node->GetSessionNs();
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  unsynced = node->GetSessionNs() - unsynced;
+  bool ok_unsynced = !node->IsSynchronized() && unsynced >= 0 &&
+                     node->GetSessionNs() * 1e-9 < 1.0;
+
+  std::string query = "?delay=1&jitter=0.5";
+  auto server = ChHilTransport::Create("loopback-server://clock" + query);
+  auto client = ChHilTransport::Create("loopback://clock" + query);
+  auto master_tracker = std::make_shared<ChHilLatencyTracker>(nullptr, "m");
+  auto node_tracker = std::make_shared<ChHilLatencyTracker>(nullptr, "n");
+  master_tracker->SetSessionClock(master);
+  node_tracker->SetSessionClock(node);
+  server->SetLatencyTracker(master_tracker);
+  client->SetLatencyTracker(node_tracker);
+
+  // session time the node would read with the first offset only
+  double first_offset = 0.0;
+  bool monotonic = true, master_monotonic = true;
+  std::thread master_thread(RunEnd, server, master,
+                            std::ref(master_monotonic));
+  std::thread first_thread([&]() {
+    while (!node->IsSynchronized())
+      std::this_thread::sleep_for(std::chrono::microseconds(100));
+    first_offset = node->GetOffset();
+  });
+  RunEnd(client, node, monotonic);
+  master_thread.join();
+  first_thread.join();
+
+  // both read at the same instant
+  int64_t node_local = node->GetLocalNs();
+  double error = (node->GetSessionNs() - master->GetSessionNs()) * 1e-9;
+  double first_error =
+      node_local * 1e-9 + first_offset - master->GetSessionNs() * 1e-9;
+  // the session clock runs at 1 / (1 + skew) of the node clock
+  double drift_error = node->GetDrift() - (1.0 / (1.0 + CLOCK_SKEW) - 1.0);
+
+  std::cout << "session time error " << 1e6 * error << " us (one-time offset "
+            << 1e6 * first_error << " us), drift "
+            << 1e6 * node->GetDrift() << " ppm (error " << 1e6 * drift_error
+            << " ppm), uncertainty " << 1e6 * node->GetUncertainty() << " us"
+            << std::endl;
+
+  bool ok = Check("unsynchronized", ok_unsynced);
+  ok = Check("session time", std::abs(error) < 300e-6 &&
+                                 std::abs(error) < std::abs(first_error)) &&
+       ok;
+  ok = Check("drift", std::abs(drift_error) < 100e-6) && ok;
+  ok = Check("monotonic", monotonic && master_monotonic) && ok;
+  return ok ? 0 : 1;
+}
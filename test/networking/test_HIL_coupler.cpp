@@ -0,0 +1,126 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// Jason Zhou
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Author: Jason Zhou
+// =============================================================================
+// Check of the bounded-staleness coupler: a distributor and a node exchange
+// one frame per 2 ms step, and the node stalls for 300 ms halfway. In
+// lockstep the distributor stalls with it; with a bound of max_lag frames it
+// stalls for the part of the hiccup beyond max_lag steps only, and not at all
+// with a large bound. Frames received are never older than the previous
+// ones. The node connects over TCP before the distributor listens, the HELLO
+// exchange replaces the startup sleeps.
+// =============================================================================
+
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+#include "chrono_hil/network/ChHilCoupler.h"
+
+using namespace chrono;
+using namespace chrono::hil;
+
+#define NUM_STEPS 500
+#define STEP_TIME 0.002
+#define HICCUP_STEP 200
+#define HICCUP_TIME 0.3
+
+struct SideResult {
+  ChHilCouplerStats stats;
+  int peer_id = -1;
+  bool ordered = true; // payloads received in increasing order
+  double seconds = 0.0;
+};
+
+// one side of the coupling, sends its step number every step
+void RunSide(std::shared_ptr<ChHilTransport> link, int id, int max_lag,
+             bool hiccup, SideResult &result) {
+  ChHilCoupler coupler(link, max_lag);
+  if (!coupler.Connect(id))
+    return;
+  result.peer_id = coupler.GetPeerId();
+
+  auto t_0 = std::chrono::steady_clock::now();
+  float last = -1.f;
+  std::vector<float> payload;
+  for (int step = 0; step < NUM_STEPS; step++) {
+    double time = step * STEP_TIME;
+    std::this_thread::sleep_until(
+        t_0 + std::chrono::duration<double>(time + STEP_TIME));
+    if (hiccup && step == HICCUP_STEP)
+      std::this_thread::sleep_for(std::chrono::duration<double>(HICCUP_TIME));
+
+    if (coupler.Receive(payload, time)) {
+      result.ordered = result.ordered && payload.size() == 1 &&
+                       payload[0] > last;
+      last = payload[0];
+    }
+    coupler.Send({static_cast<float>(step)}, time);
+  }
+  result.seconds = std::chrono::duration<double>(
+                       std::chrono::steady_clock::now() - t_0)
+                       .count();
+  result.stats = coupler.GetStats();
+}
+
+// returns the result of the distributor, which does not stall by itself
+SideResult RunSession(const std::string &server_uri,
+                      const std::string &client_uri, int max_lag) {
+  SideResult distributor, node;
+  // the node starts first
+  std::thread node_thread(RunSide, ChHilTransport::Create(client_uri), 1,
+                          max_lag, true, std::ref(node));
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  RunSide(ChHilTransport::Create(server_uri), 0, max_lag, false, distributor);
+  node_thread.join();
+
+  std::cout << "max_lag " << max_lag << ": distributor " << distributor.seconds
+            << " s, blocked " << distributor.stats.waits << " times for "
+            << distributor.stats.wait_time << " s, max lag "
+            << distributor.stats.max_lag << " frames; node mean age "
+            << node.stats.GetMeanAge() << " s, "
+            << node.stats.frames_superseded << " frames superseded"
+            << std::endl;
+
+  bool ok = distributor.peer_id == 1 && node.peer_id == 0 &&
+            distributor.ordered && node.ordered;
+  if (!ok)
+    distributor.seconds = -1.0;
+  return distributor;
+}
+
+int main(int argc, char *argv[]) {
+  SideResult handshake =
+      RunSession("tcp-server://:1231", "tcp://127.0.0.1:1231", 10);
+  SideResult lockstep =
+      RunSession("loopback-server://coupler", "loopback://coupler", 0);
+  SideResult bounded =
+      RunSession("loopback-server://coupler", "loopback://coupler", 50);
+  SideResult free_running =
+      RunSession("loopback-server://coupler", "loopback://coupler", 1000);
+
+  bool connected = handshake.seconds > 0.0;
+  std::cout << "handshake over tcp: " << (connected ? "PASSED" : "FAILED")
+            << std::endl;
+
+  // 50 frames of 2 ms absorb 100 ms of the 300 ms hiccup
+  bool stalls = lockstep.seconds > 0.0 && bounded.seconds > 0.0 &&
+                free_running.seconds > 0.0 &&
+                lockstep.stats.wait_time > 0.8 * HICCUP_TIME &&
+                bounded.stats.wait_time < HICCUP_TIME - 0.05 &&
+                bounded.stats.max_lag <= 51 &&
+                free_running.stats.waits == 0;
+  std::cout << "bounded staleness: " << (stalls ? "PASSED" : "FAILED")
+            << std::endl;
+
+  return (connected && stalls) ? 0 : 1;
+}
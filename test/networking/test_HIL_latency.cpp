@@ -0,0 +1,166 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// Jason Zhou
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Author: Jason Zhou
+// =============================================================================
+// Check of the latency instrumentation. The histogram percentiles are
+// compared with exact ones. Then two ends of a loopback link exchange one
+// frame per millisecond, each end delaying what it receives by 5 ms plus up
+// to 1 ms of jitter, and the client clock runs 3.2 s ahead. The trackers
+// must recover the clock offset and report one-way delays and round trips
+// matching the injected delay, and the frames must arrive unchanged.
+// =============================================================================
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <random>
+#include <thread>
+
+#include "chrono_hil/network/ChHilTransport.h"
+#include "chrono_hil/timer/ChLatencyMonitor.h"
+#include "test/ChHilTestCheck.h"
+
+using namespace chrono;
+using namespace chrono::hil;
+
+#define NUM_STEPS 1000
+#define STEP_TIME 0.001
+#define DELAY_MS 5.0
+#define JITTER_MS 1.0
+#define CLOCK_OFFSET 3.2
+
+// percentiles against the sorted samples, within the bucket resolution
+bool CheckHistogram() {
+  std::mt19937 rng(3);
+  std::lognormal_distribution<double> dist(std::log(2e-3), 0.8);
+  std::vector<double> samples(100000);
+  ChLatencyHistogram histogram;
+  for (double &s : samples) {
+    s = dist(rng);
+    histogram.Record(s);
+  }
+  std::sort(samples.begin(), samples.end());
+
+  double max_error = 0.0;
+  for (double p : {1.0, 50.0, 90.0, 99.0, 99.9, 100.0}) {
+    size_t rank = static_cast<size_t>(std::ceil(p / 100.0 * samples.size()));
+    double exact = samples[std::max<size_t>(rank, 1) - 1];
+    double error = std::abs(histogram.GetPercentile(p) - exact) / exact;
+    max_error = std::max(max_error, error);
+  }
+  std::cout << "largest percentile error " << 100.0 * max_error << "%"
+            << std::endl;
+  return max_error < 0.01 && histogram.GetCount() == samples.size() &&
+         std::abs(histogram.GetMax() - samples.back()) < 1e-9;
+}
+
+// one end of the link, sends its step number and checks what it receives
+void RunEnd(std::shared_ptr<ChHilTransport> link, bool &intact) {
+  link->Initialize();
+  auto t_0 = std::chrono::steady_clock::now();
+  float last = -1.f;
+  std::vector<float> frame;
+  for (int step = 0; step < NUM_STEPS; step++) {
+    std::this_thread::sleep_until(
+        t_0 + std::chrono::duration<double>((step + 1) * STEP_TIME));
+    while (link->PollFrame(frame, false)) {
+      intact = intact && frame.size() == 3 && frame[0] == last + 1 &&
+               frame[1] == 0.5f && frame[2] == -1.f;
+      last = frame[0];
+    }
+    link->SendFrame({static_cast<float>(step), 0.5f, -1.f});
+  }
+}
+
+int main(int argc, char *argv[]) {
+  bool ok = Check("histogram percentiles", CheckHistogram());
+
+  std::string query = "?delay=" + std::to_string(DELAY_MS) +
+                      "&jitter=" + std::to_string(JITTER_MS);
+  auto server = ChHilTransport::Create("loopback-server://latency" + query);
+  auto client = ChHilTransport::Create("loopback://latency" + query);
+
+  auto monitor = std::make_shared<ChLatencyMonitor>();
+  auto server_tracker =
+      std::make_shared<ChHilLatencyTracker>(monitor, "server");
+  auto client_tracker =
+      std::make_shared<ChHilLatencyTracker>(monitor, "client");
+  client_tracker->SetClock([]() {
+    return static_cast<int64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch() +
+            std::chrono::duration<double>(CLOCK_OFFSET))
+            .count());
+  });
+  server->SetLatencyTracker(server_tracker);
+  client->SetLatencyTracker(client_tracker);
+
+  bool server_intact = true, client_intact = true;
+  std::thread server_thread(RunEnd, server, std::ref(server_intact));
+  RunEnd(client, client_intact);
+  server_thread.join();
+
+  ok = Check("frames intact", server_intact && client_intact) && ok;
+
+  // the offset is seen from each end, peer clock minus local clock
+  std::cout << "offset: server " << server_tracker->GetOffset()
+            << " s, client " << client_tracker->GetOffset() << " s"
+            << std::endl;
+  ok = Check("clock offset",
+             std::abs(server_tracker->GetOffset() - CLOCK_OFFSET) < 1e-3 &&
+                 std::abs(client_tracker->GetOffset() + CLOCK_OFFSET) <
+                     1e-3) &&
+       ok;
+
+  // frames are held from the first poll after their arrival, up to one
+  // step after it
+  double min_one_way = DELAY_MS * 1e-3;
+  double max_one_way = (DELAY_MS + JITTER_MS) * 1e-3 + 2.0 * STEP_TIME;
+  bool delays = true;
+  for (const std::string end : {"server", "client"}) {
+    ChLatencyHistogram one_way = monitor->GetHistogram(end + ".one_way");
+    ChLatencyHistogram rtt = monitor->GetHistogram(end + ".rtt");
+    std::cout << end << " one-way p50 " << one_way.GetPercentile(50.0) * 1e3
+              << " ms, p99 " << one_way.GetPercentile(99.0) * 1e3
+              << " ms; rtt p50 " << rtt.GetPercentile(50.0) * 1e3
+              << " ms, p99 " << rtt.GetPercentile(99.0) * 1e3 << " ms"
+              << std::endl;
+    delays = delays && one_way.GetCount() > NUM_STEPS / 2 &&
+             one_way.GetPercentile(50.0) > min_one_way - 1e-3 &&
+             one_way.GetPercentile(50.0) < max_one_way &&
+             rtt.GetPercentile(50.0) > 2.0 * min_one_way &&
+             rtt.GetPercentile(50.0) < 2.0 * max_one_way;
+  }
+  ok = Check("one-way and round trip delays", delays) && ok;
+
+  // export
+  std::string json = "test_HIL_latency.json";
+  std::string csv = "test_HIL_latency.csv";
+  std::remove(csv.c_str());
+  monitor->ExportJSON(json);
+  monitor->ExportCSV(csv);
+  std::ifstream json_file(json), csv_file(csv);
+  std::string json_text((std::istreambuf_iterator<char>(json_file)),
+                        std::istreambuf_iterator<char>());
+  int csv_lines = 0;
+  for (std::string line; std::getline(csv_file, line);)
+    csv_lines++;
+  ok = Check("export", json_text.find("\"server.one_way\"") !=
+                               std::string::npos &&
+                           csv_lines == 5) &&
+       ok;
+
+  return ok ? 0 : 1;
+}
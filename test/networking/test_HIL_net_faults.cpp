@@ -0,0 +1,257 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// Jason Zhou
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Author: Jason Zhou
+// =============================================================================
+// Check of the transports under network faults, with ChHilNetHarness. A
+// server streams a numbered state to three clients, each behind another bad
+// link: loss, duplication and reordering; heavy loss and jitter; and a
+// bandwidth cap below the stream rate. The clients keep the newest state and
+// acknowledge it, the server resends the final state until it is
+// acknowledged. Every client must end with the final state, intact, and the
+// capped link must deliver at its cap.
+//
+// The scenario runs in lockstep twice, and must deliver the same frames at
+// the same times both times. A shorter version then runs over TCP with one
+// process per endpoint.
+// =============================================================================
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <string>
+
+#include "chrono_hil/network/ChHilFaultTransport.h"
+#include "chrono_hil/network/ChHilNetHarness.h"
+#include "test/ChHilTestCheck.h"
+
+using namespace chrono;
+using namespace chrono::hil;
+
+#define STATE_LEN 64
+#define RESEND_PERIOD 10
+#define CAP_KBIT 1600 // 200 kB/s, the stream needs 264 kB/s
+
+// state number seq
+float StateValue(int seq, int i) { return std::sin(0.01f * seq + i); }
+
+// sends state number step until num_send, then the last one until acked
+class StateServer : public ChHilNetEndpoint {
+public:
+  StateServer(const std::vector<std::string> &uris, int num_send)
+      : m_uris(uris), m_num_send(num_send), m_acked(uris.size(), -1) {}
+
+  virtual void Initialize(ChHilNetHarness &harness) override {
+    for (const std::string &uri : m_uris)
+      m_links.push_back(harness.Open(uri));
+    for (auto &link : m_links)
+      link->Initialize();
+  }
+
+  virtual void Advance(double time) override {
+    int seq = std::min(m_step, m_num_send - 1);
+    m_frame.assign(2 + STATE_LEN, 0.f);
+    m_frame[0] = static_cast<float>(seq);
+    m_frame[1] = static_cast<float>(time);
+    for (int i = 0; i < STATE_LEN; i++)
+      m_frame[2 + i] = StateValue(seq, i);
+
+    for (size_t c = 0; c < m_links.size(); c++) {
+      while (m_links[c]->PollFrame(m_ack, false)) {
+        if (m_ack.size() == 1)
+          m_acked[c] = std::max(m_acked[c], static_cast<int>(m_ack[0]));
+      }
+      bool resend = m_step % RESEND_PERIOD == 0 && m_acked[c] < seq;
+      if (m_step < m_num_send || resend)
+        m_links[c]->SendFrame(m_frame);
+    }
+    m_step++;
+  }
+
+  virtual bool Check() override {
+    bool ok = true;
+    for (int acked : m_acked)
+      ok = ok && acked == m_num_send - 1;
+    return ok;
+  }
+
+private:
+  std::vector<std::string> m_uris;
+  int m_num_send;
+  std::vector<int> m_acked;
+  std::vector<std::shared_ptr<ChHilTransport>> m_links;
+  std::vector<float> m_frame;
+  std::vector<float> m_ack;
+  int m_step = 0;
+};
+
+// keeps the newest state received and acknowledges it
+class StateClient : public ChHilNetEndpoint {
+public:
+  StateClient(const std::string &uri, const std::string &name, int num_send)
+      : m_uri(uri), m_name(name), m_num_send(num_send) {}
+
+  virtual void Initialize(ChHilNetHarness &harness) override {
+    m_harness = &harness;
+    m_link = harness.Open(m_uri);
+    m_link->Initialize();
+  }
+
+  virtual void Advance(double time) override {
+    bool received = false;
+    while (m_link->PollFrame(m_frame, false)) {
+      received = true;
+      if (m_first_time < 0.0)
+        m_first_time = time;
+      m_last_time = time;
+      // trace of the deliveries, to compare runs
+      m_digest = m_digest * 31 + static_cast<uint64_t>(m_frame[0]) * 1000003 +
+                 static_cast<uint64_t>(std::llround(time * 1e6));
+
+      int seq = static_cast<int>(m_frame[0]);
+      bool intact = m_frame.size() == 2 + STATE_LEN;
+      for (int i = 0; intact && i < STATE_LEN; i++)
+        intact = m_frame[2 + i] == StateValue(seq, i);
+      if (!intact) {
+        m_corrupt++;
+      } else if (seq <= m_seq) {
+        m_stale++; // duplicate, overtaken or resent
+      } else {
+        m_seq = seq;
+        m_state.assign(m_frame.begin() + 2, m_frame.end());
+        m_harness->GetMonitor().Record(m_name + ".delivery",
+                                       time - m_frame[1]);
+      }
+    }
+    if (received)
+      m_link->SendFrame({static_cast<float>(m_seq)});
+  }
+
+  virtual bool Check() override {
+    bool final_state = m_seq == m_num_send - 1;
+    for (int i = 0; final_state && i < STATE_LEN; i++)
+      final_state = m_state[i] == StateValue(m_seq, i);
+    std::cout << m_name << ": state " << m_seq << ", " << m_stale
+              << " stale frames, " << m_corrupt << " corrupt" << std::endl;
+    return final_state && m_corrupt == 0;
+  }
+
+  std::shared_ptr<ChHilFaultTransport> GetFaults() const {
+    return std::dynamic_pointer_cast<ChHilFaultTransport>(m_link);
+  }
+
+  /// Bytes per second received while frames were arriving
+  double GetRate() const {
+    double span = m_last_time - m_first_time;
+    return span > 0.0 ? m_link->GetStats().bytes_received / span : 0.0;
+  }
+
+  int GetStale() const { return m_stale; }
+  uint64_t GetDigest() const { return m_digest; }
+
+private:
+  std::string m_uri;
+  std::string m_name;
+  int m_num_send;
+  ChHilNetHarness *m_harness = nullptr;
+  std::shared_ptr<ChHilTransport> m_link;
+  std::vector<float> m_frame;
+  std::vector<float> m_state;
+  int m_seq = -1;
+  int m_stale = 0;
+  int m_corrupt = 0;
+  double m_first_time = -1.0;
+  double m_last_time = 0.0;
+  uint64_t m_digest = 0;
+};
+
+// faults on the frames received by each client
+std::vector<std::string> ClientFaults() {
+  return {"delay=5&jitter=2&loss=10&dup=5&reorder=5&seed=1",
+          "delay=20&jitter=10&loss=30&seed=2",
+          "delay=1&rate=" + std::to_string(CAP_KBIT) + "&seed=3"};
+}
+
+struct LockstepResult {
+  bool passed;
+  std::vector<std::shared_ptr<StateClient>> clients;
+};
+
+LockstepResult RunLockstep(const std::string &prefix) {
+  const double step = 1e-3;
+  const int num_send = 2000;
+  std::vector<std::string> faults = ClientFaults();
+
+  ChHilNetHarness harness(step);
+  std::vector<std::string> server_uris;
+  LockstepResult result;
+  for (size_t c = 0; c < faults.size(); c++) {
+    std::string channel = prefix + std::to_string(c);
+    server_uris.push_back("loopback-server://" + channel + "?loss=20&seed=" +
+                          std::to_string(10 + c));
+    result.clients.push_back(std::make_shared<StateClient>(
+        "loopback://" + channel + "?" + faults[c], "client" + std::to_string(c),
+        num_send));
+  }
+  harness.AddEndpoint("server",
+                      std::make_shared<StateServer>(server_uris, num_send));
+  for (size_t c = 0; c < result.clients.size(); c++)
+    harness.AddEndpoint("client" + std::to_string(c), result.clients[c]);
+
+  result.passed = harness.RunLockstep(4000);
+  harness.Report();
+  return result;
+}
+
+int main(int argc, char *argv[]) {
+  LockstepResult first = RunLockstep("faults_a");
+  LockstepResult second = RunLockstep("faults_b");
+
+  bool ok = Check("lockstep delivery", first.passed && second.passed);
+
+  bool same = true;
+  for (size_t c = 0; c < first.clients.size(); c++)
+    same = same &&
+           first.clients[c]->GetDigest() == second.clients[c]->GetDigest();
+  ok = Check("repeatable", same) && ok;
+
+  auto faults = first.clients[0]->GetFaults();
+  std::cout << faults->GetNumDropped() << " dropped, "
+            << faults->GetNumDuplicated() << " duplicated, "
+            << faults->GetNumReordered() << " reordered" << std::endl;
+  ok = Check("faults injected", faults->GetNumDropped() > 0 &&
+                                    faults->GetNumDuplicated() > 0 &&
+                                    faults->GetNumReordered() > 0 &&
+                                    first.clients[0]->GetStale() > 0) &&
+       ok;
+
+  double cap = 1e3 / 8 * CAP_KBIT;
+  double rate = first.clients[2]->GetRate();
+  std::cout << "capped link " << 1e-3 * rate << " kB/s, cap " << 1e-3 * cap
+            << " kB/s" << std::endl;
+  ok = Check("bandwidth cap", rate <= 1.01 * cap && rate > 0.9 * cap) && ok;
+
+  // one process per endpoint, over TCP
+  const int num_send = 500;
+  std::string faults_uri = "?delay=2&jitter=1&loss=10&dup=5&reorder=5";
+  ChHilNetHarness forked(2e-3);
+  forked.AddEndpoint("server",
+                     std::make_shared<StateServer>(
+                         std::vector<std::string>{"tcp-server://:15739" +
+                                                  faults_uri},
+                         num_send));
+  forked.AddEndpoint("client", std::make_shared<StateClient>(
+                                   "tcp://127.0.0.1:15739" + faults_uri,
+                                   "client", num_send));
+  ok = Check("forked delivery", forked.RunForked(1000)) && ok;
+
+  return ok ? 0 : 1;
+}
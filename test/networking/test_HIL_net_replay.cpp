@@ -0,0 +1,151 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// Jason Zhou
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Author: Jason Zhou
+// =============================================================================
+// Records the traffic of a node talking to two paced peers, then plays the
+// log back into a fresh node with ChHilReplayer standing in for the peers:
+// as fast as possible, at the recorded pace, and four times faster. The node
+// must receive the same frames and answer the same way as in the recording.
+// =============================================================================
+
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <thread>
+
+#include "chrono_hil/network/ChHilReplayer.h"
+#include "chrono_hil/network/ChHilTransport.h"
+
+using namespace chrono::hil;
+
+#define NUM_PEERS 2
+#define NUM_STEPS 300
+#define PEER_PERIOD 0.002
+#define LOG_FILE "test_HIL_net_replay.hillog"
+
+// peer: sends a frame every PEER_PERIOD, built from the last answer
+void RunPeer(std::string uri, int peer) {
+  auto link = ChHilTransport::Create(uri);
+  link->Initialize();
+
+  auto t_0 = std::chrono::steady_clock::now();
+  float answer = 0.f;
+  std::vector<float> frame;
+  for (int step = 0; step < NUM_STEPS; step++) {
+    std::this_thread::sleep_until(
+        t_0 + std::chrono::microseconds(
+                  static_cast<int64_t>(1e6 * PEER_PERIOD * step)));
+    frame.assign(8 + 4 * peer, 0.f);
+    for (size_t i = 0; i < frame.size(); i++)
+      frame[i] = 0.5f * answer + step + peer * 100 + i;
+    link->SendFrame(frame);
+    link->PollFrame(frame);
+    answer = frame[0];
+  }
+}
+
+// node: answers every frame, returns a checksum of the answers
+double RunNode(const std::string &uri_fmt) {
+  std::vector<std::shared_ptr<ChHilTransport>> links;
+  for (int p = 0; p < NUM_PEERS; p++) {
+    char uri[256];
+    std::snprintf(uri, sizeof(uri), uri_fmt.c_str(), p, p);
+    links.push_back(ChHilTransport::Create(uri));
+    links.back()->Initialize();
+  }
+
+  double checksum = 0.0;
+  std::vector<float> frame;
+  for (int step = 0; step < NUM_STEPS; step++) {
+    for (auto &link : links) {
+      link->PollFrame(frame);
+      float sum = 0.f;
+      for (float v : frame)
+        sum += v;
+      std::vector<float> answer = {0.01f * sum, float(frame.size())};
+      link->SendFrame(answer);
+      checksum += answer[0];
+    }
+  }
+  return checksum;
+}
+
+// replays the log into a fresh node, returns the node checksum
+double Replay(double speed, double &seconds, bool &matched) {
+  std::vector<std::shared_ptr<ChHilReplayer>> replayers;
+  for (int p = 0; p < NUM_PEERS; p++) {
+    auto link = ChHilTransport::Create("loopback-server://replay_" +
+                                       std::to_string(p));
+    replayers.push_back(std::make_shared<ChHilReplayer>(link, p));
+    replayers.back()->Load(LOG_FILE);
+    replayers.back()->SetSpeed(speed);
+  }
+
+  auto t_0 = std::chrono::steady_clock::now();
+  std::vector<std::thread> threads;
+  for (auto &replayer : replayers)
+    threads.emplace_back([replayer]() { replayer->Run(); });
+  double checksum = RunNode("loopback://replay_%d");
+  for (auto &thread : threads)
+    thread.join();
+  seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() -
+                                          t_0)
+                .count();
+
+  matched = true;
+  for (auto &replayer : replayers) {
+    matched = matched && replayer->GetNumMismatched() == 0 &&
+              replayer->GetNumPlayed() == NUM_STEPS &&
+              replayer->GetNumReceived() == NUM_STEPS;
+  }
+  std::cout << "  speed " << speed << ": " << seconds << " s, peer 0 max lag "
+            << 1e3 * replayers[0]->GetMaxLag() << " ms, node response mean "
+            << 1e6 * replayers[0]->GetMeanResponse() << " us (recorded "
+            << 1e6 * replayers[0]->GetMeanRecordedResponse() << " us)"
+            << std::endl;
+  return checksum;
+}
+
+int main(int argc, char *argv[]) {
+  // recording run, the node logs the traffic of both peers
+  std::cout << "recording" << std::endl;
+  auto t_0 = std::chrono::steady_clock::now();
+  std::vector<std::thread> peers;
+  for (int p = 0; p < NUM_PEERS; p++)
+    peers.emplace_back(RunPeer, "loopback-server://record_" + std::to_string(p),
+                       p);
+  double recorded = RunNode("loopback://record_%d?record=" LOG_FILE "&peer=%d");
+  for (auto &peer : peers)
+    peer.join();
+  double t_recorded = std::chrono::duration<double>(
+                          std::chrono::steady_clock::now() - t_0)
+                          .count();
+  std::cout << "  " << t_recorded << " s" << std::endl;
+
+  double t_fast, t_real, t_4x;
+  bool match_fast, match_real, match_4x;
+  double fast = Replay(0.0, t_fast, match_fast);
+  double real = Replay(1.0, t_real, match_real);
+  double x4 = Replay(4.0, t_4x, match_4x);
+
+  bool same = fast == recorded && real == recorded && x4 == recorded &&
+              match_fast && match_real && match_4x;
+  std::cout << "replay matches the recording: " << (same ? "PASSED" : "FAILED")
+            << std::endl;
+
+  bool paced = t_real > 0.9 * t_recorded && t_4x < 0.5 * t_real &&
+               t_fast < t_4x;
+  std::cout << "replay pace: " << (paced ? "PASSED" : "FAILED") << std::endl;
+
+  std::remove(LOG_FILE);
+  return (same && paced) ? 0 : 1;
+}
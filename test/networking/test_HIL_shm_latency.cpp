@@ -0,0 +1,167 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// Jason Zhou
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Author: Jason Zhou
+// =============================================================================
+// Round-trip latency of the shared-memory transport against loopback TCP.
+// A forked child echoes every frame back to the parent, which reports the
+// latency distribution. The last part kills a client and checks that the
+// server picks up the client that re-attaches.
+// =============================================================================
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <signal.h>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+
+#include "chrono_hil/network/shm/ChSHMClient.h"
+#include "chrono_hil/network/shm/ChSHMServer.h"
+#include "chrono_hil/network/tcp/ChTCPClient.h"
+#include "chrono_hil/network/tcp/ChTCPServer.h"
+
+using namespace chrono;
+using namespace chrono::hil;
+
+#define SHM_NAME "hil_shm_latency"
+#define PORT_TCP 1223
+#define DATA_LEN 32
+#define NUM_WARMUP 1000
+#define NUM_ROUNDS 50000
+
+template <class Server>
+void PingPong(Server &server, const std::string &label) {
+  std::vector<float> data(DATA_LEN, 1.f);
+  std::vector<double> rtt;
+  rtt.reserve(NUM_ROUNDS);
+
+  for (int i = 0; i < NUM_WARMUP + NUM_ROUNDS; i++) {
+    data[0] = i;
+    auto t_0 = std::chrono::steady_clock::now();
+    server.Write(data);
+    server.Read();
+    auto t_1 = std::chrono::steady_clock::now();
+    if (server.GetRecvData()[0] != i)
+      std::cout << label << ": unexpected echo" << std::endl;
+    if (i >= NUM_WARMUP)
+      rtt.push_back(std::chrono::duration<double, std::micro>(t_1 - t_0)
+                        .count());
+  }
+
+  // end marker
+  data[0] = -1.f;
+  server.Write(data);
+
+  std::sort(rtt.begin(), rtt.end());
+  double mean = 0.0;
+  for (double t : rtt)
+    mean += t / rtt.size();
+  std::cout << label << " round trip [us]: mean=" << mean
+            << " p50=" << rtt[rtt.size() / 2]
+            << " p99=" << rtt[rtt.size() * 99 / 100]
+            << " max=" << rtt.back() << std::endl;
+}
+
+template <class Client> void Echo(Client &client) {
+  while (true) {
+    client.Read();
+    std::vector<float> data = client.GetRecvData();
+    if (data[0] < 0.f)
+      break;
+    client.Write(data);
+  }
+}
+
+void BenchSHM() {
+  pid_t pid = fork();
+  if (pid == 0) {
+    ChSHMClient client(SHM_NAME, DATA_LEN);
+    client.Initialize();
+    Echo(client);
+    _exit(0);
+  }
+
+  ChSHMServer server(SHM_NAME, DATA_LEN);
+  server.Initialize();
+  PingPong(server, "shm");
+  waitpid(pid, nullptr, 0);
+}
+
+void BenchTCP() {
+  pid_t pid = fork();
+  if (pid == 0) {
+    ChTCPClient client("127.0.0.1", PORT_TCP, DATA_LEN);
+    while (true) {
+      try {
+        client.Initialize();
+        break;
+      } catch (std::exception &) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+      }
+    }
+    Echo(client);
+    _exit(0);
+  }
+
+  ChTCPServer server(PORT_TCP, DATA_LEN);
+  server.Initialize();
+  PingPong(server, "tcp");
+  waitpid(pid, nullptr, 0);
+}
+
+bool TestReconnect() {
+  ChSHMServer server(SHM_NAME, DATA_LEN);
+
+  // first client dies without detaching
+  pid_t pid = fork();
+  if (pid == 0) {
+    ChSHMClient client(SHM_NAME, DATA_LEN);
+    client.Initialize();
+    client.Read();
+    kill(getpid(), SIGKILL);
+  }
+  server.Initialize();
+  server.Write(std::vector<float>(DATA_LEN, 0.f));
+  waitpid(pid, nullptr, 0);
+
+  // second client takes over and announces itself
+  pid = fork();
+  if (pid == 0) {
+    ChSHMClient client(SHM_NAME, DATA_LEN);
+    client.Initialize();
+    client.Write(std::vector<float>(DATA_LEN, 42.f));
+    Echo(client);
+    _exit(0);
+  }
+
+  server.Read();
+  bool ok = server.GetRecvData()[0] == 42.f;
+
+  server.Write(std::vector<float>(DATA_LEN, 7.f));
+  server.Read();
+  ok = ok && server.GetRecvData()[0] == 7.f && server.GetNumClients() == 1;
+
+  server.Write(std::vector<float>(DATA_LEN, -1.f));
+  waitpid(pid, nullptr, 0);
+  return ok;
+}
+
+int main(int argc, char *argv[]) {
+  BenchSHM();
+  BenchTCP();
+
+  bool reconnect = TestReconnect();
+  std::cout << "shm reconnection: " << (reconnect ? "PASSED" : "FAILED")
+            << std::endl;
+  return reconnect ? 0 : 1;
+}
@@ -0,0 +1,166 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// Jason Zhou
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Author: Jason Zhou
+// =============================================================================
+// Runs the ROM distributor / SynChrono node protocol (interest-filtered ROM
+// frames down, interest region reports up) in one process, with one thread
+// per node, over any ChHilTransport. The run is repeated over the in-process
+// loopback transport to check that it is deterministic, then the per-step
+// cost of each transport is reported.
+// =============================================================================
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <thread>
+
+#include "chrono_hil/ROM/syn/ChROM_InterestFilter.h"
+#include "chrono_hil/network/ChHilTransport.h"
+
+using namespace chrono;
+using namespace chrono::hil;
+
+#define NUM_NODES 3
+#define NUM_ROM 200
+#define STATE_LEN 11
+#define NUM_STEPS 2000
+
+// ROMs driving on concentric circles
+void RomStates(int step, std::vector<ChVector<>> &rom_pos,
+               std::vector<float> &rom_states) {
+  rom_pos.resize(NUM_ROM);
+  rom_states.assign(NUM_ROM * STATE_LEN, 0.f);
+  for (int i = 0; i < NUM_ROM; i++) {
+    double r = 20.0 + 2.0 * (i % 50);
+    double a = 0.01 * step * (1 + i % 3) + i;
+    rom_pos[i] = ChVector<>(r * std::cos(a), r * std::sin(a), 0.5);
+    rom_states[i * STATE_LEN + 0] = rom_pos[i].x();
+    rom_states[i * STATE_LEN + 1] = rom_pos[i].y();
+    rom_states[i * STATE_LEN + 2] = rom_pos[i].z();
+    rom_states[i * STATE_LEN + 5] = a;
+  }
+}
+
+// node: applies the frames it receives and reports its region, returns a
+// checksum of everything received
+double RunNode(std::shared_ptr<ChHilTransport> link, int node) {
+  link->Initialize();
+
+  double checksum = 0.0;
+  std::vector<float> frame;
+  for (int step = 0; step < NUM_STEPS; step++) {
+    link->PollFrame(frame);
+    for (size_t i = 0; i < frame.size(); i++)
+      checksum += frame[i] * (i % 7 + 1);
+
+    // the node vehicle moves along the x axis
+    ChROM_InterestRegion region;
+    region.pos = ChVector<>(-60.0 + 40.0 * node + 0.01 * step, 0.0, 0.0);
+    region.radius = 40.0;
+    std::vector<float> report;
+    ChROM_InterestFilter::EncodeRegion(region, report);
+    link->SendFrame(report);
+  }
+  return checksum;
+}
+
+// runs the distributor in the calling thread, returns the node checksums
+std::vector<double> RunSession(const std::vector<std::string> &server_uris,
+                               const std::vector<std::string> &client_uris,
+                               double &seconds) {
+  std::vector<std::shared_ptr<ChHilTransport>> links;
+  for (auto &uri : server_uris)
+    links.push_back(ChHilTransport::Create(uri));
+
+  std::vector<double> checksums(NUM_NODES);
+  std::vector<std::thread> nodes;
+  for (int n = 0; n < NUM_NODES; n++) {
+    nodes.emplace_back([&, n]() {
+      checksums[n] = RunNode(ChHilTransport::Create(client_uris[n]), n);
+    });
+  }
+
+  for (auto &link : links)
+    link->Initialize();
+
+  ChROM_InterestFilter interest_filter(NUM_NODES);
+  std::vector<ChVector<>> rom_pos;
+  std::vector<float> rom_states;
+  std::vector<float> frame;
+
+  auto t_0 = std::chrono::steady_clock::now();
+  for (int step = 0; step < NUM_STEPS; step++) {
+    RomStates(step, rom_pos, rom_states);
+    for (int n = 0; n < NUM_NODES; n++) {
+      interest_filter.BuildFrame(n, rom_pos, rom_states, STATE_LEN, frame);
+      links[n]->SendFrame(frame);
+    }
+    for (int n = 0; n < NUM_NODES; n++) {
+      links[n]->PollFrame(frame);
+      interest_filter.SetRegion(n, frame);
+    }
+  }
+  seconds =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - t_0)
+          .count();
+
+  for (auto &node : nodes)
+    node.join();
+
+  ChHilTransportStats stats = links[0]->GetStats();
+  std::cout << "  node 0 link: sent " << stats.frames_sent << " frames / "
+            << stats.bytes_sent << " bytes, received "
+            << stats.frames_received << " frames / " << stats.bytes_received
+            << " bytes" << std::endl;
+  return checksums;
+}
+
+std::vector<double> RunSession(const std::string &server_fmt,
+                               const std::string &client_fmt, int base,
+                               double &seconds) {
+  std::vector<std::string> server_uris, client_uris;
+  for (int n = 0; n < NUM_NODES; n++) {
+    server_uris.push_back(server_fmt + std::to_string(base + n));
+    client_uris.push_back(client_fmt + std::to_string(base + n));
+  }
+  return RunSession(server_uris, client_uris, seconds);
+}
+
+int main(int argc, char *argv[]) {
+  double t_1, t_2;
+  std::cout << "loopback, run 1" << std::endl;
+  auto run_1 = RunSession("loopback-server://rom_", "loopback://rom_", 0, t_1);
+  std::cout << "loopback, run 2" << std::endl;
+  auto run_2 = RunSession("loopback-server://rom_", "loopback://rom_", 0, t_2);
+
+  bool deterministic = run_1 == run_2 && run_1[0] != 0.0;
+  std::cout << "deterministic replay: " << (deterministic ? "PASSED" : "FAILED")
+            << std::endl;
+
+  double t_tcp, t_shm;
+  std::cout << "tcp" << std::endl;
+  auto run_tcp =
+      RunSession("tcp-server://:", "tcp://127.0.0.1:", 1230, t_tcp);
+  std::cout << "shm" << std::endl;
+  auto run_shm = RunSession("shm-server://hil_rom_", "shm://hil_rom_", 0,
+                            t_shm);
+
+  bool consistent = run_tcp == run_1 && run_shm == run_1;
+  std::cout << "same result over tcp and shm: "
+            << (consistent ? "PASSED" : "FAILED") << std::endl;
+
+  std::cout << "cost per distributor step [us]: loopback="
+            << 1e6 * t_1 / NUM_STEPS << " tcp=" << 1e6 * t_tcp / NUM_STEPS
+            << " shm=" << 1e6 * t_shm / NUM_STEPS << std::endl;
+
+  return (deterministic && consistent) ? 0 : 1;
+}
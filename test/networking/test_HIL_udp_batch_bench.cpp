@@ -0,0 +1,119 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// Jason Zhou
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Author: Jason Zhou
+// =============================================================================
+// Benchmark of the batched UDP path (sendmmsg/recvmmsg) against one syscall
+// per datagram. Reports datagrams per second per core, measured with the CPU
+// time of the sending and the receiving thread over loopback.
+// =============================================================================
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <stdint.h>
+#include <thread>
+#include <time.h>
+
+#include "chrono_hil/network/udp/ChBoostInStreamer.h"
+#include "chrono_hil/network/udp/ChBoostOutStreamer.h"
+
+using namespace chrono;
+using namespace chrono::hil;
+
+#define IP_OUT "127.0.0.1"
+#define PORT_BENCH 1222
+#define DATA_LEN 32 // 128 bytes, about the size of one ROM state slice
+#define BATCH_SIZE 32
+#define BENCH_SECONDS 2.0
+
+double ThreadCPUTime() {
+  timespec ts;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return ts.tv_sec + 1e-9 * ts.tv_nsec;
+}
+
+void RunBenchmark(bool batched) {
+  ChBoostInStreamer receiver(PORT_BENCH, DATA_LEN);
+  ChBoostOutStreamer sender(IP_OUT, PORT_BENCH);
+  sender.SetBatchSize(BATCH_SIZE);
+
+  std::atomic<bool> sending(true);
+  std::atomic<bool> receiving(true);
+  uint64_t num_recv = 0;
+  double recv_cpu = 0.0;
+
+  std::thread recv_thread([&]() {
+    double cpu_0 = ThreadCPUTime();
+    while (true) {
+      bool end = false;
+      if (batched) {
+        int n = receiver.SynchronizeBatch(BATCH_SIZE * 2);
+        for (int i = 0; i < n; i++)
+          end |= receiver.GetBatchFrame(i)[0] < 0.f;
+        num_recv += n;
+      } else {
+        receiver.Synchronize();
+        end = receiver.GetRecvData()[0] < 0.f;
+        num_recv++;
+      }
+      if (end)
+        break;
+    }
+    recv_cpu = ThreadCPUTime() - cpu_0;
+    receiving = false;
+  });
+
+  uint64_t num_sent = 0;
+  double cpu_0 = ThreadCPUTime();
+  auto t_0 = std::chrono::steady_clock::now();
+  while (std::chrono::duration<double>(std::chrono::steady_clock::now() - t_0)
+             .count() < BENCH_SECONDS) {
+    for (int f = 0; f < BATCH_SIZE; f++) {
+      for (int i = 0; i < DATA_LEN; i++)
+        sender.AddData(i);
+      if (batched) {
+        sender.QueueFrame();
+      } else {
+        sender.Synchronize();
+        num_sent++;
+      }
+    }
+    if (batched)
+      num_sent += sender.SynchronizeBatch();
+  }
+  double send_cpu = ThreadCPUTime() - cpu_0;
+
+  // end markers, until the receiver has seen one
+  while (receiving) {
+    for (int i = 0; i < DATA_LEN; i++)
+      sender.AddData(-1.f);
+    sender.Synchronize();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+  recv_thread.join();
+
+  std::cout << (batched ? "batched   " : "unbatched ")
+            << " send: " << num_sent / send_cpu << " datagrams/s/core"
+            << "  recv: " << num_recv / recv_cpu << " datagrams/s/core"
+            << "  (received " << 100.0 * num_recv / num_sent << "%)"
+            << std::endl;
+}
+
+int main(int argc, char *argv[]) {
+#ifndef __linux__
+  std::cout << "sendmmsg/recvmmsg not available, benchmarking the fallback"
+            << std::endl;
+#endif
+  RunBenchmark(false);
+  RunBenchmark(true);
+  return 0;
+}
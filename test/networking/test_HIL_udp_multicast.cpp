@@ -0,0 +1,145 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// Jason Zhou
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Author: Jason Zhou
+// =============================================================================
+// Loopback test of the UDP multicast fan-out. One ChBoostOutStreamer sends to
+// a multicast group joined by two ChBoostInStreamer receivers on the loopback
+// interface, then gap detection is checked with hand-crafted sequence numbers.
+// =============================================================================
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <stdint.h>
+#include <thread>
+
+#include "chrono_hil/network/udp/ChBoostInStreamer.h"
+#include "chrono_hil/network/udp/ChBoostOutStreamer.h"
+
+using namespace chrono;
+using namespace chrono::hil;
+
+#define GROUP_ADDR "239.255.0.1"
+#define LOOPBACK_ADDR "127.0.0.1"
+#define PORT_MULTICAST 1220
+#define PORT_GAP 1221
+#define NUM_FRAMES 1000
+#define DATA_LEN 4
+
+bool TestFanOut() {
+  std::atomic<int> num_done(0);
+  bool ok[2] = {true, true};
+
+  ChBoostInStreamer receiver_0(GROUP_ADDR, PORT_MULTICAST, DATA_LEN,
+                               LOOPBACK_ADDR);
+  ChBoostInStreamer receiver_1(GROUP_ADDR, PORT_MULTICAST, DATA_LEN,
+                               LOOPBACK_ADDR);
+  ChBoostInStreamer *receivers[2] = {&receiver_0, &receiver_1};
+
+  std::vector<std::thread> threads;
+  for (int r = 0; r < 2; r++) {
+    receivers[r]->EnableSequenceNumbers(true);
+    threads.emplace_back([&, r]() {
+      int expected = 0;
+      while (true) {
+        receivers[r]->Synchronize();
+        std::vector<float> data = receivers[r]->GetRecvData();
+        if (data[0] < 0.f)
+          break; // end marker
+        if (data[0] != expected || data[3] != 3.f * expected) {
+          ok[r] = false;
+        }
+        expected = data[0] + 1;
+      }
+      num_done++;
+    });
+  }
+
+  ChBoostOutStreamer sender(GROUP_ADDR, PORT_MULTICAST);
+  sender.SetMulticast(1, LOOPBACK_ADDR);
+  sender.EnableSequenceNumbers(true);
+
+  for (int i = 0; i < NUM_FRAMES; i++) {
+    sender.AddData(i);
+    sender.AddData(1.f * i);
+    sender.AddData(2.f * i);
+    sender.AddData(3.f * i);
+    sender.Synchronize(); // sent once, received by both
+    std::this_thread::sleep_for(std::chrono::microseconds(50));
+  }
+
+  // keep sending end markers until both receivers are done
+  while (num_done < 2) {
+    for (int j = 0; j < DATA_LEN; j++)
+      sender.AddData(-1.f);
+    sender.Synchronize();
+    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+  }
+
+  for (auto &t : threads)
+    t.join();
+
+  for (int r = 0; r < 2; r++) {
+    std::cout << "receiver " << r
+              << ": received=" << receivers[r]->GetNumReceived()
+              << " lost=" << receivers[r]->GetNumLost()
+              << " dropped=" << receivers[r]->GetNumDropped() << std::endl;
+    if (receivers[r]->GetNumLost() != 0)
+      ok[r] = false;
+  }
+
+  return ok[0] && ok[1];
+}
+
+bool TestGapDetection() {
+  ChBoostInStreamer receiver(PORT_GAP, 1);
+  receiver.EnableSequenceNumbers(true);
+
+  // raw datagrams, sequence numbers 3 and 4 are lost, 4 arrives late
+  boost::asio::io_service io_service;
+  udp::socket socket(io_service);
+  socket.open(udp::v4());
+  udp::endpoint endpoint(address::from_string(LOOPBACK_ADDR), PORT_GAP);
+
+  uint32_t seqs[6] = {0, 1, 2, 5, 4, 6};
+  for (int i = 0; i < 6; i++) {
+    struct {
+      uint32_t seq;
+      float value;
+    } datagram = {seqs[i], (float)seqs[i]};
+    socket.send_to(boost::asio::buffer(&datagram, sizeof(datagram)), endpoint);
+  }
+
+  float last = -1.f;
+  for (int i = 0; i < 5; i++) {
+    receiver.Synchronize();
+    last = receiver.GetRecvData()[0];
+  }
+
+  std::cout << "gap test: received=" << receiver.GetNumReceived()
+            << " lost=" << receiver.GetNumLost()
+            << " dropped=" << receiver.GetNumDropped() << std::endl;
+
+  return receiver.GetNumReceived() == 5 && receiver.GetNumLost() == 2 &&
+         receiver.GetNumDropped() == 1 && last == 6.f;
+}
+
+int main(int argc, char *argv[]) {
+  bool fan_out = TestFanOut();
+  std::cout << "multicast fan-out: " << (fan_out ? "PASSED" : "FAILED")
+            << std::endl;
+
+  bool gaps = TestGapDetection();
+  std::cout << "gap detection: " << (gaps ? "PASSED" : "FAILED") << std::endl;
+
+  return (fan_out && gaps) ? 0 : 1;
+}
@@ -0,0 +1,157 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// Jason Zhou
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Author: Jason Zhou
+// =============================================================================
+// Test of the frame arena:
+//   bump        allocations are aligned, consecutive, and counted
+//   growth      a frame past the block goes to the heap, the next Reset
+//               grows the block, and the same frame then fits
+//   containers  pmr vectors and strings of a frame, reset frame after frame
+//   threads     each thread has its own arena
+//   steady      a steady frame (payload, formatted line, sensor copy) does
+//               not call operator new once the arena has grown
+// =============================================================================
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <thread>
+
+#include "chrono_hil/memory/ChFrameArena.h"
+#include "test/ChHilTestCheck.h"
+
+using namespace chrono::hil;
+
+// calls of the global operator new, to catch the mallocs of a frame
+std::atomic<uint64_t> num_news(0);
+
+void *operator new(size_t size) {
+  num_news++;
+  void *p = std::malloc(size ? size : 1);
+  if (!p)
+    throw std::bad_alloc();
+  return p;
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete(void *p, size_t) noexcept { std::free(p); }
+
+bool TestBump() {
+  ChFrameArena arena(1024);
+  auto *a = static_cast<char *>(arena.allocate(3, 1));
+  auto *b = static_cast<char *>(arena.allocate(8, 8));
+  auto *c = static_cast<char *>(arena.allocate(64, 64));
+  bool ok = reinterpret_cast<uintptr_t>(b) % 8 == 0 &&
+            reinterpret_cast<uintptr_t>(c) % 64 == 0 && b >= a + 3 &&
+            b < a + 3 + 8 && c > b;
+  ok = ok && arena.GetStats().allocations == 3 &&
+       arena.GetStats().bytes == 75 && arena.GetStats().heap_allocations == 0;
+
+  // the next frame starts from the beginning of the block
+  arena.Reset();
+  auto *d = static_cast<char *>(arena.allocate(3, 1));
+  return ok && d == a && arena.GetStats().allocations == 1 &&
+         arena.GetFrameStats().allocations == 3;
+}
+
+bool TestGrowth() {
+  ChFrameArena arena(1024);
+  auto frame = [&]() {
+    for (int i = 0; i < 8; i++)
+      (void)arena.allocate(256, 8);
+    arena.Reset();
+  };
+
+  frame();
+  bool ok = arena.GetFrameStats().heap_allocations > 0 &&
+            arena.GetSize() >= 8 * 256 && arena.GetNumHeapFrames() == 1;
+  size_t size = arena.GetSize();
+  for (int i = 0; i < 10; i++) {
+    frame();
+    ok = ok && arena.GetFrameStats().heap_allocations == 0;
+  }
+  return ok && arena.GetSize() == size && arena.GetNumHeapFrames() == 1 &&
+         arena.GetNumFrames() == 11;
+}
+
+bool TestContainers() {
+  ChFrameArena arena(256);
+  bool ok = true;
+  for (int frame = 0; frame < 100; frame++) {
+    ChFrameVector<float> payload(&arena);
+    for (int i = 0; i < 50; i++)
+      payload.push_back((float)(frame + i));
+    ChFrameString line(&arena);
+    line += "frame ";
+    line += std::to_string(frame).c_str();
+    ok = ok && payload.size() == 50 && payload[49] == (float)(frame + 49) &&
+         line.size() > 6 && line.get_allocator().resource() == &arena;
+    arena.Reset();
+  }
+  // the vector outgrew the first block; the later frames fit
+  return ok && arena.GetFrameStats().heap_allocations == 0 &&
+         arena.GetSize() > 256 && arena.GetNumFrames() == 100;
+}
+
+bool TestThreads() {
+  ChFrameArena *main_arena = &ChFrameArena::GetThreadArena();
+  ChFrameArena *other_arena = nullptr;
+  std::thread other(
+      [&]() { other_arena = &ChFrameArena::GetThreadArena(); });
+  other.join();
+  return other_arena && other_arena != main_arena &&
+         main_arena == &ChFrameArena::GetThreadArena();
+}
+
+bool TestSteady() {
+  ChFrameArena &arena = ChFrameArena::GetThreadArena();
+  float lidar[1024] = {};
+  auto frame = [&](int step) {
+    bool ok;
+    {
+      ChFrameVector<float> payload(&arena);
+      payload.reserve(16);
+      for (int i = 0; i < 16; i++)
+        payload.push_back((float)(step * i));
+      ChFrameString line(&arena);
+      char number[32];
+      for (float value : payload) {
+        std::snprintf(number, sizeof(number), "%.3f,", value);
+        line += number;
+      }
+      ChFrameVector<float> points(lidar, lidar + 1024, &arena);
+      ok = !line.empty() && points.size() == 1024;
+    }
+    arena.Reset();
+    return ok;
+  };
+
+  bool ok = true;
+  for (int step = 0; step < 10; step++)
+    ok = frame(step) && ok;
+  uint64_t news = num_news;
+  for (int step = 10; step < 1000; step++)
+    ok = frame(step) && ok;
+  return ok && num_news == news && arena.GetFrameStats().allocations > 0;
+}
+
+int main(int argc, char *argv[]) {
+  bool ok = Check("bump", TestBump());
+  ok = Check("growth", TestGrowth()) && ok;
+  ok = Check("containers", TestContainers()) && ok;
+  ok = Check("threads", TestThreads()) && ok;
+  ok = Check("steady", TestSteady()) && ok;
+  return ok ? 0 : 1;
+}
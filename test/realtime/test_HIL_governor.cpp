@@ -0,0 +1,115 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// Jason Zhou
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Author: Jason Zhou
+// =============================================================================
+// Check of the frame time governor:
+//   degrade     overloaded windows lower the knobs by increasing priority,
+//               one level per window, down to their last level
+//   hysteresis  loads between the two thresholds change nothing
+//   restore     good windows in a row raise the knobs by decreasing priority
+//   backoff     a restore followed by an overload doubles the good windows
+//               needed for the next restore
+//   scheduler   a task knob of a scheduler halves the rate of a task which
+//               overloads the frames, and restores it once it is cheap again
+// =============================================================================
+
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+#include "chrono_hil/timer/ChFrameGovernor.h"
+#include "chrono_hil/timer/ChTaskScheduler.h"
+#include "test/ChHilTestCheck.h"
+
+using namespace chrono::hil;
+
+#define STEP 1e-3
+#define WINDOW 10
+
+// feed windows of frames of load times the step, returns the changes
+int Feed(ChFrameGovernor &governor, int windows, double load) {
+  int changes = 0;
+  for (int i = 0; i < windows * WINDOW; i++)
+    changes += governor.Update(load * STEP, 0.0);
+  return changes;
+}
+
+int main(int argc, char *argv[]) {
+  ChFrameGovernor governor(STEP);
+  governor.SetWindow(WINDOW, 2);
+  governor.SetPrint(false);
+  int render_level = 0;
+  int render = governor.AddKnob(
+      "render", 3, [&](int level) { render_level = level; }, -1);
+  int lidar = governor.AddKnob("lidar", 2, [](int level) {}, 0);
+
+  bool ok_degrade = Feed(governor, 1, 1.2) == 1 && render_level == 1 &&
+                    governor.GetLevel(lidar) == 0;
+  ok_degrade = ok_degrade && Feed(governor, 1, 1.2) == 1 &&
+               governor.GetLevel(render) == 2 && governor.GetLevel(lidar) == 0;
+  ok_degrade = ok_degrade && Feed(governor, 3, 1.2) == 1 &&
+               governor.GetLevel(lidar) == 1;
+  ok_degrade = ok_degrade && governor.GetDecisions().size() == 3;
+
+  // overruns alone degrade: a mean load of 0.62 with 20% of the frames late
+  ChFrameGovernor late(STEP);
+  late.SetWindow(WINDOW);
+  late.SetPrint(false);
+  late.AddKnob("log", 2, [](int level) {});
+  for (int i = 0; i < WINDOW; i++)
+    late.Update((i < 2 ? 1.1 : 0.5) * STEP, 0.0);
+  ok_degrade = ok_degrade && late.GetLevel(0) == 1;
+  bool ok = Check("degrade", ok_degrade);
+
+  ok = Check("hysteresis", Feed(governor, 10, 0.75) == 0) && ok;
+
+  // 2 good windows per restore
+  bool ok_restore = Feed(governor, 1, 0.3) == 0 &&
+                    Feed(governor, 1, 0.3) == 1 &&
+                    governor.GetLevel(lidar) == 0 && render_level == 2;
+  ok_restore = ok_restore && Feed(governor, 2, 0.3) == 1 && render_level == 1;
+  ok = Check("restore", ok_restore) && ok;
+
+  // the restore of render did not hold, the next one takes 4 windows
+  bool ok_backoff = Feed(governor, 1, 1.2) == 1 && render_level == 2;
+  ok_backoff = ok_backoff && Feed(governor, 3, 0.3) == 0 &&
+               Feed(governor, 1, 0.3) == 1 && render_level == 1;
+  const ChGovernorDecision &last = governor.GetDecisions().back();
+  ok_backoff = ok_backoff && last.knob == render && last.level == 1 &&
+               last.load < 0.31;
+  ok = Check("backoff", ok_backoff) && ok;
+
+  // a task of 2 ms per run in frames of 1 ms, cheap after 0.5 s
+  ChFrameGovernor task_governor(STEP);
+  task_governor.SetWindow(WINDOW, 2);
+  ChTaskScheduler scheduler(STEP);
+  bool expensive = true;
+  int task = scheduler.AddTask("render", STEP, [&](double time) {
+    if (expensive)
+      std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  });
+  task_governor.AddTaskKnob(scheduler, task, 4);
+  scheduler.SetGovernor(&task_governor);
+
+  int frame = 0;
+  for (; frame < 500; frame++)
+    scheduler.Step(frame * STEP);
+  bool ok_scheduler = scheduler.GetPeriod(task) > 2 * STEP;
+  expensive = false;
+  for (; frame < 1000; frame++)
+    scheduler.Step(frame * STEP);
+  ok_scheduler = ok_scheduler && scheduler.GetPeriod(task) == STEP &&
+                 task_governor.GetLevel(0) == 0;
+  ok = Check("scheduler", ok_scheduler) && ok;
+
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,178 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// Jason Zhou
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Author: Jason Zhou
+// =============================================================================
+// Stress test of the lock-free primitives, to run under ThreadSanitizer
+// (HIL_REALTIME_TSAN) as well:
+//   spsc        every item arrives once, in order, through a small ring
+//   mpsc        the items of 4 producers all arrive once, each producer's
+//               in order
+//   triple      the reader only sees whole buffers, never older ones
+//   seqlock     3 readers only see states of one single write, never older
+//               ones
+// =============================================================================
+
+#include <atomic>
+#include <cstdint>
+#include <iostream>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "chrono_hil/pipeline/ChMPSCQueue.h"
+#include "chrono_hil/pipeline/ChSPSCRing.h"
+#include "chrono_hil/pipeline/ChSeqlock.h"
+#include "chrono_hil/pipeline/ChTripleBuffer.h"
+#include "test/ChHilTestCheck.h"
+
+using namespace chrono::hil;
+
+#define NUM_ITEMS 200000
+#define NUM_PRODUCERS 4
+#define NUM_READERS 3
+
+// state whose words must all come from the same write
+struct State {
+  uint64_t version;
+  double values[7];
+};
+
+bool IsWhole(const State &state) {
+  for (double value : state.values) {
+    if (value != (double)state.version)
+      return false;
+  }
+  return true;
+}
+
+State MakeState(uint64_t version) {
+  State state;
+  state.version = version;
+  for (double &value : state.values)
+    value = (double)version;
+  return state;
+}
+
+bool TestSPSC() {
+  auto ring = std::make_unique<ChSPSCRing<uint64_t, 64>>();
+  std::thread producer([&]() {
+    for (uint64_t i = 0; i < NUM_ITEMS; i++) {
+      while (!ring->TryPush(i))
+        std::this_thread::yield();
+    }
+  });
+
+  bool ok = true;
+  uint64_t value;
+  for (uint64_t i = 0; i < NUM_ITEMS; i++) {
+    while (!ring->TryPop(value))
+      std::this_thread::yield();
+    ok = ok && value == i;
+  }
+  producer.join();
+  return ok && !ring->TryPop(value) && ring->Size() == 0;
+}
+
+bool TestMPSC() {
+  auto queue = std::make_unique<ChMPSCQueue<uint64_t, 128>>();
+  std::vector<std::thread> producers;
+  for (uint64_t p = 0; p < NUM_PRODUCERS; p++) {
+    producers.emplace_back([&, p]() {
+      for (uint64_t i = 0; i < NUM_ITEMS / NUM_PRODUCERS; i++) {
+        // producer in the high bits, sequence in the low ones
+        while (!queue->TryPush((p << 32) | i))
+          std::this_thread::yield();
+      }
+    });
+  }
+
+  bool ok = true;
+  std::vector<uint64_t> next(NUM_PRODUCERS, 0);
+  uint64_t value;
+  for (uint64_t i = 0; i < NUM_ITEMS; i++) {
+    while (!queue->TryPop(value))
+      std::this_thread::yield();
+    uint64_t p = value >> 32;
+    ok = ok && p < NUM_PRODUCERS && (value & 0xffffffff) == next[p];
+    if (p < NUM_PRODUCERS)
+      next[p]++;
+  }
+  for (auto &producer : producers)
+    producer.join();
+  return ok && !queue->TryPop(value);
+}
+
+bool TestTriple() {
+  ChTripleBuffer<State> buffer;
+  std::atomic<bool> done(false);
+  std::thread writer([&]() {
+    for (uint64_t i = 1; i <= NUM_ITEMS; i++) {
+      buffer.GetWriteBuffer() = MakeState(i);
+      buffer.Publish();
+    }
+    done = true;
+  });
+
+  bool ok = true;
+  uint64_t last = 0;
+  while (true) {
+    // read before Update, which then sees the last buffer published
+    bool finished = done;
+    if (buffer.Update()) {
+      const State &state = buffer.GetReadBuffer();
+      ok = ok && IsWhole(state) && state.version > last;
+      last = state.version;
+    } else if (finished) {
+      break;
+    } else {
+      std::this_thread::yield();
+    }
+  }
+  writer.join();
+  // the last state published is always taken
+  return ok && buffer.GetReadBuffer().version == NUM_ITEMS;
+}
+
+bool TestSeqlock() {
+  ChSeqlock<State> seqlock;
+  std::atomic<bool> done(false);
+  std::atomic<bool> ok(true);
+  std::vector<std::thread> readers;
+  for (int r = 0; r < NUM_READERS; r++) {
+    readers.emplace_back([&]() {
+      uint64_t last = 0;
+      while (!done) {
+        State state = seqlock.Load();
+        if (!IsWhole(state) || state.version < last)
+          ok = false;
+        last = state.version;
+        std::this_thread::yield();
+      }
+    });
+  }
+
+  for (uint64_t i = 1; i <= NUM_ITEMS; i++)
+    seqlock.Store(MakeState(i));
+  done = true;
+  for (auto &reader : readers)
+    reader.join();
+  return ok && seqlock.GetVersion() == NUM_ITEMS &&
+         seqlock.Load().version == NUM_ITEMS;
+}
+
+int main(int argc, char *argv[]) {
+  bool ok = Check("spsc", TestSPSC());
+  ok = Check("mpsc", TestMPSC()) && ok;
+  ok = Check("triple", TestTriple()) && ok;
+  ok = Check("seqlock", TestSeqlock()) && ok;
+  return ok ? 0 : 1;
+}
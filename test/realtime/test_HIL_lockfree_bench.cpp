@@ -0,0 +1,174 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// Jason Zhou
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Author: Jason Zhou
+// =============================================================================
+// Throughput of the lock-free primitives, against a mutex and a deque for
+// the queues. Prints millions of operations per second; fails only if
+// items are lost. The figures depend on the cores the threads land on:
+// pin the test (taskset) for comparable runs.
+// =============================================================================
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "chrono_hil/pipeline/ChMPSCQueue.h"
+#include "chrono_hil/pipeline/ChSPSCRing.h"
+#include "chrono_hil/pipeline/ChSeqlock.h"
+#include "chrono_hil/pipeline/ChTripleBuffer.h"
+
+using namespace chrono::hil;
+
+#define NUM_ITEMS 2000000
+#define NUM_PRODUCERS 4
+#define CAPACITY 1024
+
+double Now() {
+  return std::chrono::duration<double>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+void Print(const std::string &name, uint64_t ops, double seconds) {
+  std::cout << std::left << std::setw(24) << name << std::right << std::fixed
+            << std::setprecision(2) << std::setw(8) << 1e-6 * ops / seconds
+            << " Mops/s" << std::endl;
+}
+
+// bounded queue under a mutex, the hand-rolled baseline
+class LockedQueue {
+public:
+  bool TryPush(uint64_t value) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_items.size() == CAPACITY)
+      return false;
+    m_items.push_back(value);
+    return true;
+  }
+  bool TryPop(uint64_t &value) {
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if (m_items.empty())
+      return false;
+    value = m_items.front();
+    m_items.pop_front();
+    return true;
+  }
+
+private:
+  std::mutex m_mutex;
+  std::deque<uint64_t> m_items;
+};
+
+// time to pass the items of producers threads to the calling thread [s],
+// and the sum of the items
+template <typename Queue>
+double RunQueue(Queue &queue, uint64_t producers, uint64_t &sum) {
+  double start = Now();
+  std::vector<std::thread> threads;
+  for (uint64_t p = 0; p < producers; p++) {
+    threads.emplace_back([&]() {
+      for (uint64_t i = 0; i < NUM_ITEMS / producers; i++) {
+        while (!queue.TryPush(i))
+          std::this_thread::yield();
+      }
+    });
+  }
+  sum = 0;
+  uint64_t value;
+  for (uint64_t i = 0; i < NUM_ITEMS / producers * producers; i++) {
+    while (!queue.TryPop(value))
+      std::this_thread::yield();
+    sum += value;
+  }
+  for (auto &thread : threads)
+    thread.join();
+  return Now() - start;
+}
+
+int main(int argc, char *argv[]) {
+  bool ok = true;
+  uint64_t sum;
+  // sum of the items of producers
+  auto expected = [](uint64_t producers) {
+    uint64_t n = NUM_ITEMS / producers;
+    return producers * n * (n - 1) / 2;
+  };
+
+  auto spsc = std::make_unique<ChSPSCRing<uint64_t, CAPACITY>>();
+  Print("spsc ring", NUM_ITEMS, RunQueue(*spsc, 1, sum));
+  ok = ok && sum == expected(1);
+  auto locked = std::make_unique<LockedQueue>();
+  Print("spsc mutex", NUM_ITEMS, RunQueue(*locked, 1, sum));
+  ok = ok && sum == expected(1);
+
+  auto mpsc = std::make_unique<ChMPSCQueue<uint64_t, CAPACITY>>();
+  Print("mpsc queue", NUM_ITEMS, RunQueue(*mpsc, NUM_PRODUCERS, sum));
+  ok = ok && sum == expected(NUM_PRODUCERS);
+  Print("mpsc mutex", NUM_ITEMS, RunQueue(*locked, NUM_PRODUCERS, sum));
+  ok = ok && sum == expected(NUM_PRODUCERS);
+
+  // publications with a reader taking the latest
+  ChTripleBuffer<uint64_t> buffer;
+  std::atomic<bool> done(false);
+  std::thread reader([&]() {
+    while (!done) {
+      if (!buffer.Update())
+        std::this_thread::yield();
+    }
+  });
+  double start = Now();
+  for (uint64_t i = 0; i < NUM_ITEMS; i++) {
+    buffer.GetWriteBuffer() = i;
+    buffer.Publish();
+  }
+  Print("triple buffer publish", NUM_ITEMS, Now() - start);
+  done = true;
+  reader.join();
+
+  // writes of a 64 byte state with a reader, then uncontended reads
+  struct State {
+    double values[8];
+  };
+  ChSeqlock<State> seqlock;
+  done = false;
+  std::thread seq_reader([&]() {
+    while (!done) {
+      seqlock.Load();
+      std::this_thread::yield();
+    }
+  });
+  State state = {};
+  start = Now();
+  for (uint64_t i = 0; i < NUM_ITEMS; i++) {
+    state.values[0] = (double)i;
+    seqlock.Store(state);
+  }
+  Print("seqlock store", NUM_ITEMS, Now() - start);
+  done = true;
+  seq_reader.join();
+
+  double total = 0.0;
+  start = Now();
+  for (uint64_t i = 0; i < NUM_ITEMS; i++)
+    total += seqlock.Load().values[0];
+  Print("seqlock load", NUM_ITEMS, Now() - start);
+  ok = ok && total == (double)NUM_ITEMS * (NUM_ITEMS - 1);
+
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,140 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// Jason Zhou
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Author: Jason Zhou
+// =============================================================================
+// Check of the real-time pacer. An idle 1 kHz loop must wake up close to its
+// deadlines for a fraction of the CPU time a busy wait takes. A loop with
+// one frame running 5 periods too long must then end late by that overrun
+// with HIL_PACER_DROP, and on time with HIL_PACER_SLEW and HIL_PACER_BURST.
+// Only the burst runs the next frames late, back to back.
+//
+// The bounds leave room for the wake up latency of a loaded machine or a
+// virtual machine, where a sleep now and then ends a few ms late; a check
+// of the policies is tried again, up to TRIALS times, when such a wake up
+// spoils it.
+// =============================================================================
+
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+#include <time.h>
+
+#include "chrono_hil/timer/ChRealtimePacer.h"
+#include "test/ChHilTestCheck.h"
+
+using namespace chrono;
+using namespace chrono::hil;
+
+#define PERIOD 1e-3
+#define NUM_FRAMES 2000
+#define OVERRUN_FRAMES 300
+#define OVERRUN_FRAME 100
+#define OVERRUN 5e-3
+#define SLEW 0.25
+#define TRIALS 5
+
+// CPU time of the process [s]
+double CPUTime() {
+  timespec t;
+  clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &t);
+  return t.tv_sec + 1e-9 * t.tv_nsec;
+}
+
+// CPU share of an idle loop paced by wait
+template <typename Wait> double IdleLoad(Wait wait) {
+  double wall = ChRealtimePacer::Now();
+  double cpu = CPUTime();
+  for (int i = 0; i < NUM_FRAMES; i++)
+    wait(i);
+  return (CPUTime() - cpu) / (ChRealtimePacer::Now() - wall);
+}
+
+// runs the loop with one long frame, returns how late it ends [s] and how
+// many of the 3 frames after the long one overran
+double RunOverrun(ChRealtimeCatchUp policy, ChRealtimePacer &pacer,
+                  int &late_after) {
+  pacer.SetCatchUp(policy, SLEW);
+  pacer.Reset();
+  double start = ChRealtimePacer::Now();
+  late_after = 0;
+  for (int i = 0; i < OVERRUN_FRAMES; i++) {
+    if (i == OVERRUN_FRAME)
+      std::this_thread::sleep_for(std::chrono::duration<double>(OVERRUN));
+    double lateness = pacer.Wait();
+    if (i > OVERRUN_FRAME && i <= OVERRUN_FRAME + 3 && lateness > 0.0)
+      late_after++;
+  }
+  double late = ChRealtimePacer::Now() - start - OVERRUN_FRAMES * PERIOD;
+  std::cout << "  " << pacer.GetNumOverruns() << " overruns, max lateness "
+            << 1e3 * pacer.GetMaxLateness() << " ms, delay "
+            << 1e3 * pacer.GetDelay() << " ms, ends " << 1e3 * late
+            << " ms late, " << late_after << " late frames after the overrun"
+            << std::endl;
+  return late;
+}
+
+int main(int argc, char *argv[]) {
+  // idle loop, busy wait as ChRealtimeCumulative did, then paced
+  double t_0 = ChRealtimePacer::Now();
+  double busy = IdleLoad([t_0](int i) {
+    while (ChRealtimePacer::Now() - t_0 < (i + 1) * PERIOD) {
+    }
+  });
+  ChRealtimePacer pacer(PERIOD);
+  double paced = IdleLoad([&pacer](int i) { pacer.Wait(); });
+
+  const ChLatencyHistogram &wake = pacer.GetWakeError();
+  std::cout << "busy wait " << 100 * busy << "% CPU, pacer " << 100 * paced
+            << "% CPU, wake up error p50 " << 1e6 * wake.GetPercentile(50)
+            << " us, p90 " << 1e6 * wake.GetPercentile(90) << " us, p99 "
+            << 1e6 * wake.GetPercentile(99) << " us, "
+            << pacer.GetNumOverruns() << " overruns" << std::endl;
+
+  bool ok = Check("accuracy", wake.GetCount() > 0 &&
+                                  wake.GetPercentile(50) < 50e-6 &&
+                                  wake.GetPercentile(90) < 500e-6 &&
+                                  pacer.GetNumOverruns() < NUM_FRAMES / 20);
+  ok = Check("cpu", paced < 0.4 && paced < 0.5 * busy) && ok;
+
+  // one frame 5 periods too long; the drop also keeps the time lost to
+  // late wake ups
+  bool pass = false;
+  std::cout << "drop" << std::endl;
+  for (int i = 0; i < TRIALS && !pass; i++) {
+    int late_after;
+    double late = RunOverrun(HIL_PACER_DROP, pacer, late_after);
+    pass = late > OVERRUN - 2 * PERIOD &&
+           std::abs(late - pacer.GetDelay()) < 1e-3 && late_after == 0;
+  }
+  ok = Check("drop", pass) && ok;
+
+  pass = false;
+  std::cout << "slew" << std::endl;
+  for (int i = 0; i < TRIALS && !pass; i++) {
+    int late_after;
+    double late = RunOverrun(HIL_PACER_SLEW, pacer, late_after);
+    pass = std::abs(late) < 1e-3 && pacer.GetDelay() == 0.0 && late_after == 0;
+  }
+  ok = Check("slew", pass) && ok;
+
+  pass = false;
+  std::cout << "burst" << std::endl;
+  for (int i = 0; i < TRIALS && !pass; i++) {
+    int late_after;
+    double late = RunOverrun(HIL_PACER_BURST, pacer, late_after);
+    pass = std::abs(late) < 1e-3 && late_after == 3;
+  }
+  ok = Check("burst", pass) && ok;
+
+  return ok ? 0 : 1;
+}
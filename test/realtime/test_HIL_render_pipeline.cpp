@@ -0,0 +1,168 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// Jason Zhou
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Author: Jason Zhou
+// =============================================================================
+// Headless check of the render pipeline:
+//   buffer      the triple buffer hands over the latest published buffer
+//   snapshot    a slow consumer only ever sees the poses of one single step,
+//               in order, while the physics publishes 100 bodies per step
+//   overlap     1 ms of physics and 1 ms of rendering per frame take about
+//               1 ms per frame pipelined, against 2 ms in series
+//   init        Start returns once a slow init is over, the init and exit
+//               run on the render thread
+// =============================================================================
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+#include "chrono_hil/pipeline/ChRenderPipeline.h"
+#include "chrono_hil/timer/ChRealtimePacer.h"
+#include "test/ChHilTestCheck.h"
+
+using namespace chrono;
+using namespace chrono::hil;
+
+#define NUM_BODIES 100
+#define NUM_FRAMES 2000
+#define WORK 1e-3
+#define OVERLAP_FRAMES 300
+
+void SleepFor(double seconds) {
+  std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+}
+
+// wall time of frames of 1 ms of physics and 1 ms of rendering
+double RunFrames(bool pipelined) {
+  ChRenderPipeline pipeline;
+  auto render = [](const ChPoseSnapshot &snapshot) { SleepFor(WORK); };
+  if (pipelined) {
+    pipeline.AddConsumer(render);
+    pipeline.Start();
+  }
+
+  double start = ChRealtimePacer::Now();
+  for (int i = 0; i < OVERLAP_FRAMES; i++) {
+    SleepFor(WORK);
+    if (pipelined)
+      pipeline.Publish(i * WORK);
+    else
+      render(ChPoseSnapshot());
+  }
+  return ChRealtimePacer::Now() - start;
+}
+
+bool TestInit() {
+  ChRenderPipeline pipeline;
+  std::atomic<bool> init_done(false);
+  std::thread::id init_thread, render_thread, exit_thread;
+  pipeline.SetInit([&]() {
+    SleepFor(50e-3);
+    init_thread = std::this_thread::get_id();
+    init_done = true;
+  });
+  std::atomic<bool> consumed(false);
+  pipeline.AddConsumer([&](const ChPoseSnapshot &snapshot) {
+    render_thread = std::this_thread::get_id();
+    consumed = true;
+  });
+  pipeline.SetExit([&]() { exit_thread = std::this_thread::get_id(); });
+  pipeline.Start();
+  bool ready = init_done;
+
+  pipeline.Publish(0.0);
+  double end = ChRealtimePacer::Now() + 1.0;
+  while (!consumed && ChRealtimePacer::Now() < end)
+    SleepFor(1e-3);
+  pipeline.Stop();
+  return ready && consumed && init_thread != std::this_thread::get_id() &&
+         render_thread == init_thread && exit_thread == init_thread;
+}
+
+int main(int argc, char *argv[]) {
+  // single thread hand over
+  ChTripleBuffer<int> buffer;
+  bool ok_buffer = !buffer.Update();
+  buffer.GetWriteBuffer() = 1;
+  buffer.Publish();
+  buffer.GetWriteBuffer() = 2;
+  buffer.Publish();
+  ok_buffer = ok_buffer && buffer.Update() && buffer.GetReadBuffer() == 2 &&
+              !buffer.Update();
+  buffer.GetWriteBuffer() = 3;
+  buffer.Publish();
+  ok_buffer = ok_buffer && buffer.Update() && buffer.GetReadBuffer() == 3;
+  bool ok = Check("buffer", ok_buffer);
+
+  // body i of step f is at (f, i, time of f)
+  ChRenderPipeline pipeline;
+  uint64_t frame = 0;
+  for (int i = 0; i < NUM_BODIES; i++) {
+    pipeline.AddSource([&frame, i]() {
+      return ChBodyPose{ChVector<>((double)frame, i, frame * WORK),
+                        ChQuaternion<>(1, 0, 0, 0)};
+    });
+  }
+
+  uint64_t torn = 0;
+  uint64_t out_of_order = 0;
+  int64_t last = -1;
+  pipeline.AddConsumer([&](const ChPoseSnapshot &snapshot) {
+    if ((int64_t)snapshot.frame <= last)
+      out_of_order++;
+    last = snapshot.frame;
+    for (int i = 0; i < NUM_BODIES; i++) {
+      const ChVector<> &pos = snapshot.poses[i].pos;
+      if (pos.x() != snapshot.frame || pos.y() != i ||
+          pos.z() != snapshot.time)
+        torn++;
+      // a render frame of a few physics steps
+      if (i == NUM_BODIES / 2)
+        SleepFor(0.3 * WORK);
+    }
+  });
+  pipeline.Start();
+  for (frame = 0; frame < NUM_FRAMES; frame++) {
+    // a step of the physics, with some jitter
+    auto spin = ChRealtimePacer::Now() + (frame % 7) * 20e-6;
+    while (ChRealtimePacer::Now() < spin) {
+    }
+    pipeline.Publish(frame * WORK);
+  }
+  SleepFor(10 * WORK);
+  pipeline.Stop();
+
+  std::cout << "  " << pipeline.GetNumPublished() << " published, "
+            << pipeline.GetNumConsumed() << " consumed, "
+            << pipeline.GetNumSkipped() << " skipped, " << torn
+            << " torn poses, latency p50 "
+            << 1e3 * pipeline.GetLatency().GetPercentile(50.0) << " ms"
+            << std::endl;
+  ok = Check("snapshot",
+             torn == 0 && out_of_order == 0 && pipeline.GetNumConsumed() > 0 &&
+                 pipeline.GetNumSkipped() > 0 &&
+                 pipeline.GetNumConsumed() + pipeline.GetNumSkipped() ==
+                     NUM_FRAMES &&
+                 last == NUM_FRAMES - 1) &&
+       ok;
+
+  double serial = RunFrames(false);
+  double pipelined = RunFrames(true);
+  std::cout << "  serial " << 1e3 * serial / OVERLAP_FRAMES
+            << " ms per frame, pipelined "
+            << 1e3 * pipelined / OVERLAP_FRAMES << " ms per frame"
+            << std::endl;
+  ok = Check("overlap", pipelined < 0.7 * serial) && ok;
+  ok = Check("init", TestInit()) && ok;
+  return ok ? 0 : 1;
+}
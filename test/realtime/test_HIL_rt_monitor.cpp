@@ -0,0 +1,105 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// Jason Zhou
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Author: Jason Zhou
+// =============================================================================
+// Check of the real-time monitor on a paced 2 ms loop with a dynamics and a
+// render phase. Every 100th frame, the render phase runs 5 ms too long: the
+// monitor must count these frames as deadline misses and blame the render
+// phase, while the frames stretched by a late wake up of the pacer are not
+// misses. The publisher sleeps longer than its period, which must not slow
+// down the loop.
+// =============================================================================
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+
+#include "chrono_hil/timer/ChRealtimeMonitor.h"
+#include "chrono_hil/timer/ChRealtimePacer.h"
+#include "test/ChHilTestCheck.h"
+
+using namespace chrono;
+using namespace chrono::hil;
+
+#define STEP 2e-3
+#define NUM_FRAMES 1500
+#define STALL_EVERY 100
+#define STALL 5e-3
+#define PUBLISH_PERIOD 0.2
+
+void SleepFor(double seconds) {
+  std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+}
+
+int main(int argc, char *argv[]) {
+  ChRealtimeMonitor monitor(STEP);
+  int dynamics = monitor.AddPhase("dynamics");
+  int render = monitor.AddPhase("render");
+  int wait = monitor.AddPhase("wait");
+  monitor.SetWaitPhase(wait);
+
+  std::atomic<int> published(0);
+  monitor.SetPublisher(PUBLISH_PERIOD, [&](const ChRealtimeSummary &s) {
+    std::cout << s.ToString() << std::endl;
+    published++;
+    // a slow sink, e.g. a file on a busy disk
+    SleepFor(2 * PUBLISH_PERIOD);
+  });
+
+  ChRealtimePacer pacer(STEP);
+  pacer.SetCatchUp(HIL_PACER_BURST);
+  double longest_end = 0.0;
+  int stalled = 0;
+  for (int i = 0; i < NUM_FRAMES; i++) {
+    monitor.BeginPhase(dynamics);
+    SleepFor(0.2e-3);
+    monitor.BeginPhase(render);
+    if (i % STALL_EVERY == STALL_EVERY - 1) {
+      SleepFor(STALL);
+      stalled++;
+    }
+    monitor.BeginPhase(wait);
+    pacer.Wait();
+
+    double t = ChRealtimeMonitor::Now();
+    monitor.EndFrame((i + 1) * STEP);
+    longest_end = std::max(longest_end, ChRealtimeMonitor::Now() - t);
+  }
+
+  int blamed = 0;
+  for (const ChRealtimeMiss &miss : monitor.GetMisses()) {
+    if (miss.phase == render && miss.phase_times[render] >= STALL)
+      blamed++;
+  }
+  std::cout << monitor.GetNumMisses() << " misses for " << stalled
+            << " stalls, " << blamed << " blamed on render, RTF "
+            << monitor.GetRTF() << ", frame p50 "
+            << 1e3 * monitor.GetFrameTimes().GetPercentile(50.0)
+            << " ms, jitter p99 "
+            << 1e3 * monitor.GetJitter().GetPercentile(99.0)
+            << " ms, longest EndFrame " << 1e6 * longest_end << " us, "
+            << published << " summaries" << std::endl;
+
+  // a late wake up of the machine may add a few misses of its own
+  bool ok = Check("misses", monitor.GetNumMisses() >= (uint64_t)stalled &&
+                                blamed == stalled);
+  ok = Check("phases",
+             monitor.GetPhaseTimes(render).GetMax() >= STALL &&
+                 monitor.GetPhaseTimes(dynamics).GetPercentile(50.0) <
+                     STEP &&
+                 monitor.GetFrameTimes().GetMax() >= STALL) &&
+       ok;
+  ok = Check("rtf", std::abs(monitor.GetRTF() - 1.0) < 0.05) && ok;
+  ok = Check("publish", published >= 2 && longest_end < 2e-3) && ok;
+  return ok ? 0 : 1;
+}
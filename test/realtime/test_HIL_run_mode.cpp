@@ -0,0 +1,100 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// Jason Zhou
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Author: Jason Zhou
+// =============================================================================
+// Check of the run modes of a loop driven by the task scheduler:
+//   parse     realtime, fast and factors parse, garbage is refused
+//   defaults  only real-time runs have visualization, an input file makes
+//             the inputs scripted
+//   realtime  1000 frames of 1 ms take 1 s
+//   scaled    10000 frames at x10 also take 1 s, at a rate of 10
+//   fast      the same frames run unthrottled, far faster than x10
+// The paced runs last 1 s of wall time each, and their rate is held to the
+// schedule of the pacer: on a loaded machine, the frames it reports late and
+// could not make up for lower the expected rate.
+// =============================================================================
+
+#include <cmath>
+#include <iostream>
+
+#include "chrono_hil/timer/ChRunMode.h"
+#include "chrono_hil/timer/ChTaskScheduler.h"
+#include "test/ChHilTestCheck.h"
+
+using namespace chrono;
+using namespace chrono::hil;
+
+#define STEP 1e-3
+#define WINDOW 1.0    // wall time of a paced run [s]
+#define TOLERANCE 0.05 // on the rate, relative
+
+// rate of num_frames frames of a loop with a network task, run in mode;
+// paced_rate is the rate the pacer was set for, less the wall time it lost
+// to overruns and has not made up
+double Run(ChRunMode &mode, int num_frames, double &paced_rate) {
+  ChTaskScheduler scheduler(STEP);
+  scheduler.AddTask("network", 10 * STEP, [](double time) {});
+  scheduler.SetRealtime(true);
+  mode.Apply(scheduler);
+  for (int i = 0; i <= num_frames; i++) {
+    scheduler.Step(i * STEP);
+    mode.Update(i * STEP);
+  }
+  mode.Report();
+  double sim = num_frames * STEP;
+  paced_rate =
+      sim / (sim / mode.GetFactor() + scheduler.GetPacer().GetDelay());
+  return mode.GetRate();
+}
+
+int main(int argc, char *argv[]) {
+  bool ok = true;
+
+  ChRunMode mode;
+  bool parsed = mode.GetType() == HIL_RUN_REALTIME && mode.Parse("x20") &&
+                mode.GetType() == HIL_RUN_SCALED && mode.GetFactor() == 20.0 &&
+                mode.GetName() == "x20" && mode.Parse("0.5x") &&
+                mode.GetFactor() == 0.5 && mode.Parse("fast") &&
+                mode.GetType() == HIL_RUN_FAST && !mode.IsPaced() &&
+                mode.Parse("1") && mode.GetType() == HIL_RUN_REALTIME;
+  parsed = parsed && !mode.Parse("x") && !mode.Parse("-2") &&
+           !mode.Parse("quick") && mode.GetType() == HIL_RUN_REALTIME;
+  ok = Check("parse", parsed) && ok;
+
+  ChRunMode realtime;
+  ChRunMode scaled(HIL_RUN_SCALED, 10.0);
+  ChRunMode fast(HIL_RUN_FAST);
+  bool defaults = !realtime.IsHeadless() && scaled.IsHeadless() &&
+                  fast.IsHeadless() && fast.IsInteractive();
+  fast.SetInputFile("inputs.txt");
+  realtime.SetHeadless(true);
+  defaults = defaults && !fast.IsInteractive() && realtime.IsHeadless();
+  ok = Check("defaults", defaults) && ok;
+
+  double paced_rate;
+  double rate = Run(realtime, static_cast<int>(WINDOW / STEP), paced_rate);
+  ok = Check("realtime", std::abs(rate - paced_rate) < TOLERANCE * paced_rate &&
+                             paced_rate > 1.0 - TOLERANCE) &&
+       ok;
+
+  int scaled_frames = static_cast<int>(WINDOW * 10.0 / STEP);
+  double scaled_rate = Run(scaled, scaled_frames, paced_rate);
+  std::cout << "x10 paced at " << paced_rate << " after overruns"
+            << std::endl;
+  ok = Check("scaled",
+             std::abs(scaled_rate - paced_rate) < TOLERANCE * paced_rate) &&
+       ok;
+
+  double fast_rate = Run(fast, scaled_frames, paced_rate);
+  ok = Check("fast", fast_rate > 10.0 * scaled_rate) && ok;
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,214 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// Jason Zhou
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Author: Jason Zhou
+// =============================================================================
+// Check of the multirate task scheduler:
+//   stagger  render, network, logging and HUD tasks of 10 ms and 20 ms on a
+//            1 ms loop never share a frame, where fixed phases pile them up
+//   step     a 10 ms task keeps its rate and phase when the step size halves
+//   budget   a low priority task due in a frame over budget runs in the next,
+//            the dynamics between two Step calls count in the budget
+//   worker   a slow worker task is skipped, without holding up the loop
+//   realtime frames are paced to the step
+//   input    a task run after the wait samples at the start of the frame,
+//            a task run before it one wait earlier
+// =============================================================================
+
+#include <chrono>
+#include <cmath>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "chrono_hil/timer/ChTaskScheduler.h"
+#include "test/ChHilTestCheck.h"
+
+using namespace chrono;
+using namespace chrono::hil;
+
+#define STEP 1e-3
+#define NUM_FRAMES 1000
+
+void SleepFor(double seconds) {
+  std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+}
+
+// largest number of tasks run in one frame
+int PeakTasks(double phase) {
+  ChTaskScheduler scheduler(STEP);
+  int count = 0;
+  auto task = [&count](double time) { count++; };
+  scheduler.AddTask("render", 20e-3, task, 0, phase);
+  scheduler.AddTask("network", 10e-3, task, 0, phase);
+  scheduler.AddTask("hud", 20e-3, task, 0, phase);
+  scheduler.AddTask("log", 10e-3, task, 0, phase);
+  scheduler.AddTask("lidar", 10e-3, task, 0, phase);
+
+  int peak = 0;
+  int total = 0;
+  for (int i = 0; i < NUM_FRAMES; i++) {
+    count = 0;
+    scheduler.Step(i * STEP);
+    peak = std::max(peak, count);
+    total += count;
+  }
+  std::cout << "  phase " << phase << ": " << total << " runs, peak " << peak
+            << " per frame" << std::endl;
+  return total == 400 ? peak : -1;
+}
+
+int main(int argc, char *argv[]) {
+  std::cout << "stagger" << std::endl;
+  int fixed = PeakTasks(0.0);
+  int staggered = PeakTasks(HIL_TASK_AUTO_PHASE);
+  bool ok = Check("stagger", fixed == 5 && staggered == 1);
+
+  // the step halves at 0.5 s, the 10 ms task must keep running at 3 ms past
+  // each multiple of 10 ms
+  {
+    ChTaskScheduler scheduler(STEP);
+    std::vector<double> runs;
+    scheduler.AddTask("network", 10e-3,
+                      [&runs](double time) { runs.push_back(time); }, 0,
+                      3e-3);
+    double time = 0.0;
+    for (int i = 0; i < 500; i++, time += STEP)
+      scheduler.Step(time);
+    scheduler.SetStep(0.5 * STEP);
+    for (int i = 0; i < 1000; i++, time += 0.5 * STEP)
+      scheduler.Step(time);
+
+    bool on_phase = true;
+    for (size_t i = 0; i < runs.size(); i++)
+      on_phase = on_phase && std::abs(runs[i] - (i * 10e-3 + 3e-3)) < 1e-9;
+    std::cout << "  " << runs.size() << " runs in " << time << " s"
+              << std::endl;
+    ok = Check("step", runs.size() == 100 && on_phase) && ok;
+  }
+
+  // the render runs over the budget in frame 0, the log due with it waits
+  // for frame 1
+  {
+    ChTaskScheduler scheduler(STEP);
+    scheduler.SetBudget(0.5e-3);
+    std::vector<double> logs;
+    scheduler.AddTask("render", 20e-3, [](double time) { SleepFor(1e-3); },
+                      1, 0.0);
+    int log = scheduler.AddTask(
+        "log", 10e-3, [&logs](double time) { logs.push_back(time); }, -1,
+        0.0);
+    for (int i = 0; i < 40; i++)
+      scheduler.Step(i * STEP);
+
+    std::cout << "  log at";
+    for (double t : logs)
+      std::cout << " " << 1e3 * t;
+    std::cout << " ms, " << scheduler.GetStats(log).deferred << " deferred"
+              << std::endl;
+    ok = Check("budget", logs.size() == 4 && std::abs(logs[0] - 1e-3) < 1e-9 &&
+                             std::abs(logs[1] - 10e-3) < 1e-9 &&
+                             std::abs(logs[2] - 21e-3) < 1e-9 &&
+                             scheduler.GetStats(log).deferred == 2) &&
+         ok;
+  }
+
+  // 1 ms of dynamics after each Step, the log always waits for a frame
+  {
+    ChTaskScheduler scheduler(STEP);
+    scheduler.SetBudget(0.5e-3);
+    int log =
+        scheduler.AddTask("log", 10e-3, [](double time) {}, -1, 0.0);
+    for (int i = 0; i < 40; i++) {
+      scheduler.Step(i * STEP);
+      SleepFor(1e-3);
+    }
+    ok = Check("budget dynamics", scheduler.GetStats(log).deferred == 3 &&
+                                      scheduler.GetStats(log).runs == 4) &&
+         ok;
+  }
+
+  // a 30 ms worker task due every 10 ms
+  {
+    ChTaskScheduler scheduler(STEP);
+    int slow = scheduler.AddTask("file", 10e-3,
+                                 [](double time) { SleepFor(30e-3); }, 0,
+                                 HIL_TASK_AUTO_PHASE, HIL_TASK_WORKER);
+    double longest = 0.0;
+    for (int i = 0; i < 200; i++) {
+      double start = ChRealtimePacer::Now();
+      scheduler.Step(i * STEP);
+      longest = std::max(longest, ChRealtimePacer::Now() - start);
+      SleepFor(0.5 * STEP);
+    }
+    const ChTaskStats &stats = scheduler.GetStats(slow);
+    std::cout << "  " << stats.skipped << " skipped, longest step "
+              << 1e6 * longest << " us" << std::endl;
+    ok = Check("worker", stats.skipped > 0 && longest < 2e-3) && ok;
+  }
+
+  // 200 paced frames of 1 ms
+  {
+    ChTaskScheduler scheduler(STEP);
+    ChRealtimeMonitor monitor(STEP);
+    int network = scheduler.AddTask("network", 10e-3, [](double time) {});
+    scheduler.AddTask("render", 20e-3,
+                      [](double time) { SleepFor(0.2e-3); });
+    scheduler.SetRealtime(true);
+    scheduler.SetMonitor(&monitor);
+    double start = ChRealtimePacer::Now();
+    for (int i = 0; i < 200; i++)
+      scheduler.Step(i * STEP);
+    double wall = ChRealtimePacer::Now() - start;
+    scheduler.Report();
+    std::cout << "  " << 1e3 * wall << " ms, " << monitor.GetNumPhases()
+              << " monitor phases" << std::endl;
+    ok = Check("realtime", std::abs(wall - 0.2) < 0.02 &&
+                               scheduler.GetStats(network).runs == 20 &&
+                               monitor.GetNumFrames() == 200 &&
+                               monitor.GetNumPhases() == 4) &&
+         ok;
+  }
+
+  // inputs sampled every 4 frames of 2 ms, before and after the wait
+  {
+    ChTaskScheduler scheduler(2 * STEP);
+    std::vector<double> before, after;
+    scheduler.AddTask(
+        "input before", 8e-3,
+        [&](double time) { before.push_back(ChRealtimePacer::Now()); }, 0,
+        0.0);
+    int input = scheduler.AddTask(
+        "input after", 8e-3,
+        [&](double time) { after.push_back(ChRealtimePacer::Now()); }, 0,
+        0.0);
+    scheduler.SetAfterWait(input);
+    scheduler.SetRealtime(true);
+    // the dynamics of each frame start when Step returns
+    std::vector<double> dynamics;
+    for (int i = 0; i < 40; i++) {
+      scheduler.Step(i * 2 * STEP);
+      if (i % 4 == 0)
+        dynamics.push_back(ChRealtimePacer::Now());
+    }
+    double held_before = 0.0, held_after = 0.0;
+    for (size_t i = 1; i < dynamics.size(); i++) {
+      held_before = std::max(held_before, dynamics[i] - before[i]);
+      held_after = std::max(held_after, dynamics[i] - after[i]);
+    }
+    std::cout << "  input held " << 1e6 * held_before << " us before the "
+              << "wait, " << 1e6 * held_after << " us after it" << std::endl;
+    ok = Check("input", after.size() == 10 && before.size() == 10 &&
+                            held_after < 0.2e-3 && held_before > 1e-3) &&
+         ok;
+  }
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,130 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// Jason Zhou
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Author: Jason Zhou
+// =============================================================================
+// Check of the thread placement:
+//   cpulist     cpulist strings are parsed as the kernel writes them
+//   profile     the roles of a JSON runtime profile are read, a profile
+//               with a field of the wrong type is refused
+//   affinity    a thread placed by itself or by its owner runs on its core
+//   fallback    a refused real-time policy or core is reported and the
+//               thread keeps its previous placement; whether SCHED_FIFO is
+//               granted depends on the permissions of the test
+// =============================================================================
+
+#include <atomic>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <thread>
+
+#include "chrono_hil/timer/ChThreadPlacement.h"
+#include "test/ChHilTestCheck.h"
+
+using namespace chrono::hil;
+
+// placement of a new thread after it applied role name
+ChThreadRole PlaceThread(ChThreadPlacement &placement, const std::string &name,
+                         bool &applied) {
+  ChThreadRole current;
+  std::thread thread([&]() {
+    applied = placement.Apply(name);
+    current = ChThreadPlacement::GetCurrent();
+  });
+  thread.join();
+  return current;
+}
+
+int main(int argc, char *argv[]) {
+  bool ok = Check("cpulist",
+                  ChThreadPlacement::ParseCPUList("0-2,5\n") ==
+                          std::vector<int>({0, 1, 2, 5}) &&
+                      ChThreadPlacement::ParseCPUList("3,1,1") ==
+                          std::vector<int>({1, 3}) &&
+                      ChThreadPlacement::ParseCPUList("").empty() &&
+                      ChThreadPlacement::ParseCPUList("x,4,3-2") ==
+                          std::vector<int>({4}));
+
+  const char *profile = "test_HIL_thread_placement.json";
+  {
+    std::ofstream file(profile);
+    file << "{ \"lock_memory\": false, \"threads\": {\n"
+            "  \"physics\": { \"cpus\": [1], \"policy\": \"fifo\", "
+            "\"priority\": 80 },\n"
+            "  \"render\": { \"cpus\": \"0-1\" } } }\n";
+  }
+  ChThreadPlacement loaded;
+  ok = Check("profile", loaded.Load(profile) && loaded.HasRole("physics") &&
+                            loaded.HasRole("render") &&
+                            !loaded.HasRole("io") && !loaded.GetLockMemory()) &&
+       ok;
+  {
+    std::ofstream file(profile);
+    file << "{ \"threads\": { \"physics\": { \"cpus\": 3 } } }\n";
+  }
+  ok = Check("malformed", !ChThreadPlacement().Load(profile)) && ok;
+  std::remove(profile);
+
+  // the last core this process may run on
+  std::vector<int> cpus = ChThreadPlacement::GetCurrent().cpus;
+  ChThreadRole pinned;
+  pinned.cpus = {cpus.back()};
+  ChThreadPlacement placement;
+  placement.SetRole("pinned", pinned);
+
+  bool applied = false;
+  ChThreadRole self = PlaceThread(placement, "pinned", applied);
+  bool ok_affinity = applied && self.cpus == pinned.cpus;
+
+  // placed by its owner before it reads its placement
+  std::atomic<bool> placed(false);
+  ChThreadRole owned;
+  std::thread worker([&]() {
+    while (!placed)
+      std::this_thread::yield();
+    owned = ChThreadPlacement::GetCurrent();
+  });
+  ok_affinity = placement.Apply("pinned", worker) && ok_affinity;
+  placed = true;
+  worker.join();
+  ok_affinity = ok_affinity && owned.cpus == pinned.cpus &&
+                ChThreadPlacement::GetCurrent().cpus == cpus;
+  ok = Check("affinity", ok_affinity) && ok;
+
+  // granted, or refused and left as it was
+  ChThreadRole fifo;
+  fifo.policy = HIL_THREAD_FIFO;
+  fifo.priority = 10;
+  placement.SetRole("fifo", fifo);
+  ChThreadRole rt = PlaceThread(placement, "fifo", applied);
+  bool ok_fallback = applied ? rt.policy == HIL_THREAD_FIFO && rt.priority == 10
+                             : rt.policy == HIL_THREAD_OTHER;
+  std::cout << "  SCHED_FIFO " << (applied ? "granted" : "refused")
+            << std::endl;
+
+  // always refused
+  ChThreadRole invalid;
+  invalid.cpus = {1023};
+  invalid.policy = HIL_THREAD_FIFO;
+  invalid.priority = 150;
+  placement.SetRole("invalid", invalid);
+  rt = PlaceThread(placement, "invalid", applied);
+  ok_fallback = ok_fallback && !applied && rt.policy == HIL_THREAD_OTHER &&
+                rt.cpus == cpus;
+
+  // roles without a profile entry are left alone
+  rt = PlaceThread(placement, "unknown", applied);
+  ok_fallback = ok_fallback && applied && rt.cpus == cpus;
+  ok = Check("fallback", ok_fallback) && ok;
+
+  return ok ? 0 : 1;
+}
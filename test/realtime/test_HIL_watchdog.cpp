@@ -0,0 +1,196 @@
+// =============================================================================
+// CHRONO-HIL - https://github.com/zzhou292/chrono-HIL
+//
+// Copyright (c) 2014 projectchrono.org
+// Jason Zhou
+// All rights reserved.
+//
+// Use of this source code is governed by a BSD-style license that can be found
+// in the LICENSE file at the top level of the distribution
+//
+// =============================================================================
+// Author: Jason Zhou
+// =============================================================================
+// Check of the watchdog, on threads blocked on purpose:
+//   healthy   a loop beating every 1 ms never stalls
+//   stall     a loop blocked for 150 ms is caught within a few ms of its
+//             20 ms threshold, once, with its state dumped, then recovers
+//   failsafe  the action of a stalled loop zeroes the throttle it was
+//             sending
+//   reset     a receive blocked in ChBoostInStreamer::Synchronize, with no
+//             sender, is interrupted by the action, and the reopened
+//             socket receives again
+//   poll      a receiver interrupted between receives, then polled, is
+//             reopened and sees the next datagram
+// =============================================================================
+
+#include <atomic>
+#include <chrono>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+#include "chrono_hil/network/udp/ChBoostInStreamer.h"
+#include "chrono_hil/network/udp/ChBoostOutStreamer.h"
+#include "chrono_hil/timer/ChRealtimePacer.h"
+#include "chrono_hil/timer/ChWatchdog.h"
+#include "test/ChHilTestCheck.h"
+
+using namespace chrono;
+using namespace chrono::hil;
+
+#define THRESHOLD 20e-3
+#define PORT 5217
+
+void SleepFor(double seconds) {
+  std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+}
+
+// beat loop of watchdog every 1 ms for duration [s]
+void BeatFor(ChWatchdog &watchdog, int loop, double duration) {
+  double end = ChRealtimePacer::Now() + duration;
+  while (ChRealtimePacer::Now() < end) {
+    watchdog.Beat(loop);
+    SleepFor(1e-3);
+  }
+}
+
+bool TestHealthy() {
+  ChWatchdog watchdog;
+  int loop = watchdog.Watch("healthy", THRESHOLD);
+  watchdog.Start();
+  // stopped by the loop, which is not watched once it ends
+  std::thread thread([&]() {
+    BeatFor(watchdog, loop, 0.1);
+    watchdog.Stop();
+  });
+  thread.join();
+  return watchdog.GetNumStalls(loop) == 0 && !watchdog.IsStalled(loop);
+}
+
+bool TestStall() {
+  ChWatchdog watchdog;
+  std::atomic<double> blocked(0.0);
+  std::atomic<double> caught(0.0);
+  std::atomic<int> actions(0);
+  ChWatchdogStall dump;
+  int loop = watchdog.Watch("stall", THRESHOLD, [&](const ChWatchdogStall &s) {
+    caught = ChRealtimePacer::Now();
+    dump = s;
+    actions++;
+  });
+  watchdog.Start();
+
+  std::thread thread([&]() {
+    BeatFor(watchdog, loop, 0.05);
+    watchdog.Activity(loop);
+    watchdog.SetState(loop, "blocked");
+    watchdog.Beat(loop);
+    blocked = ChRealtimePacer::Now();
+    SleepFor(0.15);
+    watchdog.SetState(loop, "running");
+    BeatFor(watchdog, loop, 0.05);
+    watchdog.Stop();
+  });
+  thread.join();
+
+  double latency = caught - blocked - THRESHOLD;
+  std::cout << "  caught " << 1e3 * latency << " ms past the threshold, "
+            << "longest stall " << 1e3 * watchdog.GetMaxStall(loop) << " ms"
+            << std::endl;
+  bool ok = actions == 1 && watchdog.GetNumStalls(loop) == 1 &&
+            latency >= 0.0 && latency < 10e-3 && !watchdog.IsStalled(loop) &&
+            watchdog.GetMaxStall(loop) >= 0.15;
+  ok = ok && dump.name == "stall" && dump.state == "blocked" &&
+       dump.beats > 10 && dump.activity >= THRESHOLD;
+#ifdef __linux__
+  // asleep in the kernel
+  ok = ok && !dump.thread.empty() && dump.thread[0] == 'S';
+#endif
+  return ok;
+}
+
+bool TestFailSafe() {
+  ChWatchdog watchdog;
+  watchdog.SetPrint(false);
+  std::atomic<float> throttle(0.8f);
+  int loop = watchdog.Watch("main loop", THRESHOLD,
+                            [&](const ChWatchdogStall &s) { throttle = 0.f; });
+  watchdog.Start();
+  std::thread thread([&]() {
+    BeatFor(watchdog, loop, 0.02);
+    SleepFor(0.1);
+  });
+  SleepFor(0.03);
+  bool before = throttle == 0.8f;
+  thread.join();
+  watchdog.Stop();
+  return before && throttle == 0.f && watchdog.GetNumStalls(loop) == 1;
+}
+
+bool TestReset() {
+  ChBoostInStreamer receiver(PORT, 2);
+  ChWatchdog watchdog;
+  int loop = watchdog.Watch(
+      "receive", THRESHOLD,
+      [&](const ChWatchdogStall &s) { receiver.Interrupt(); });
+
+  // 1 until the receive returns
+  std::atomic<int> first(1);
+  std::atomic<bool> sent(false);
+  int second = 1;
+  watchdog.Start();
+  std::thread thread([&]() {
+    watchdog.Beat(loop);
+    watchdog.SetState(loop, "receive");
+    // nobody sends: blocked until the watchdog interrupts the receive
+    first = receiver.Synchronize();
+    while (!sent) {
+      watchdog.Beat(loop);
+      SleepFor(1e-3);
+    }
+    second = receiver.Synchronize();
+    watchdog.Stop();
+  });
+
+  double end = ChRealtimePacer::Now() + 2.0;
+  while (first == 1 && ChRealtimePacer::Now() < end)
+    SleepFor(1e-3);
+  ChBoostOutStreamer sender("127.0.0.1", PORT);
+  sender.AddData(1.f);
+  sender.AddData(2.f);
+  sender.Synchronize();
+  sent = true;
+  thread.join();
+
+  const std::vector<float> &data = receiver.GetRecvData();
+  return first == -1 && second == 0 && data.size() == 2 && data[1] == 2.f &&
+         watchdog.GetNumStalls(loop) == 1;
+}
+
+bool TestPoll() {
+  ChBoostInStreamer receiver(PORT + 1, 2);
+  receiver.Interrupt();
+  bool empty = receiver.Available() == 0;
+
+  ChBoostOutStreamer sender("127.0.0.1", PORT + 1);
+  sender.AddData(3.f);
+  sender.AddData(4.f);
+  sender.Synchronize();
+  double end = ChRealtimePacer::Now() + 1.0;
+  while (receiver.Available() == 0 && ChRealtimePacer::Now() < end)
+    SleepFor(1e-3);
+
+  bool received = receiver.Available() > 0 && receiver.Synchronize() == 0;
+  const std::vector<float> &data = receiver.GetRecvData();
+  return empty && received && data.size() == 2 && data[1] == 4.f;
+}
+
+int main(int argc, char *argv[]) {
+  bool ok = Check("healthy", TestHealthy());
+  ok = Check("stall", TestStall()) && ok;
+  ok = Check("failsafe", TestFailSafe()) && ok;
+  ok = Check("reset", TestReset()) && ok;
+  ok = Check("poll", TestPoll()) && ok;
+  return ok ? 0 : 1;
+}